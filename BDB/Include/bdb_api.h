@@ -113,6 +113,74 @@ extern "C" {
 #define BDBC_TC_LINK_KEY_EXCHANGE_TIMEOUT      (5)      /* bdbcTCLinkKeyExchangeTimeout */
 #endif
 
+/* Network steering join candidate ranking. Define BDB_NS_RANK_JOIN_CANDIDATES
+ * in bdb_options.h to try discovered networks strongest parent first and to
+ * push networks that recently failed to join to the back of the list. */
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+#ifndef BDB_NS_JOIN_BLACKLIST_SIZE
+#define BDB_NS_JOIN_BLACKLIST_SIZE             (4)      /* Networks remembered as failed */
+#endif
+#ifndef BDB_NS_JOIN_BLACKLIST_RUNS
+#define BDB_NS_JOIN_BLACKLIST_RUNS             (3)      /* Steering runs a failed network stays demoted */
+#endif
+#endif
+
+/* Network steering scan planner. Define BDB_NS_SCAN_PLANNER in bdb_options.h
+ * to discover up to BDB_NS_SCAN_CHANNELS_PER_REQUEST channels per request,
+ * channels that had joinable networks earlier first, and to stop scanning
+ * once a joinable network with a parent of at least BDB_NS_SCAN_GOOD_LQI and
+ * room for this device is found. */
+#ifdef BDB_NS_SCAN_PLANNER
+#ifdef ENABLE_SUBG_IF
+#error "BDB_NS_SCAN_PLANNER supports 2.4GHz channel masks only"
+#endif
+#ifndef BDB_NS_SCAN_CHANNELS_PER_REQUEST
+#define BDB_NS_SCAN_CHANNELS_PER_REQUEST       (4)      /* Channels per discovery request */
+#endif
+#ifndef BDB_NS_SCAN_GOOD_LQI
+#define BDB_NS_SCAN_GOOD_LQI                   (128)    /* Parent LQI that ends the scan early */
+#endif
+#endif
+
+/* Rejoin history. Define BDB_REJOIN_HISTORY in bdb_options.h to remember the
+ * (channel, PAN, parent) tuples of recent joins and rejoins in PDM record
+ * PDM_ID_BDB_REJOIN_HISTORY. Rejoin with discovery then scans the last good
+ * channel first and the other remembered channels next, before widening to
+ * the rest of the primary and secondary channel sets. */
+#ifdef BDB_REJOIN_HISTORY
+#ifdef ENABLE_SUBG_IF
+#error "BDB_REJOIN_HISTORY supports 2.4GHz channel masks only"
+#endif
+#ifndef BDB_REJOIN_HISTORY_SIZE
+#define BDB_REJOIN_HISTORY_SIZE                (4)      /* Remembered (channel, PAN, parent) tuples */
+#endif
+#endif
+
+/* Network formation channel survey. Define BDB_NF_CHANNEL_SURVEY in
+ * bdb_options.h to run an ED scan and an active scan over the channel set
+ * before forming, and to form on the channel with the lowest energy plus
+ * BDB_NF_SURVEY_PAN_WEIGHT per network heard. The per channel results stay
+ * available through BDB_psNfGetChannelSurvey(). */
+#ifdef BDB_NF_CHANNEL_SURVEY
+#if (defined ENABLE_SUBG_IF) || (defined NCP_HOST)
+#error "BDB_NF_CHANNEL_SURVEY supports 2.4GHz single chip builds only"
+#endif
+#ifndef BDB_NF_SURVEY_PAN_WEIGHT
+#define BDB_NF_SURVEY_PAN_WEIGHT               (32)     /* Score of one network, in ED levels */
+#endif
+#endif
+
+/* Touchlink scan table. Define BDB_TL_SCAN_TABLE in bdb_options.h to keep up
+ * to BDB_TL_SCAN_TABLE_SIZE scan responses, one per target IEEE address,
+ * ordered by priority request then corrected link quality. The initiator
+ * touchlinks with the first target and moves on to the next one without a
+ * new scan if the target does not answer. */
+#ifdef BDB_TL_SCAN_TABLE
+#ifndef BDB_TL_SCAN_TABLE_SIZE
+#define BDB_TL_SCAN_TABLE_SIZE                 (4)      /* Scan responses kept */
+#endif
+#endif
+
 /* BDB Constants used by nodes supporting touchlink */
 #ifndef BDBC_TL_INTERPAN_TRANS_ID_LIFETIME
 #define BDBC_TL_INTERPAN_TRANS_ID_LIFETIME      (8)     /* bdbcTLInterPANTransIdLifetime */
@@ -48,6 +48,11 @@
 #include "bdb_fr.h"
 #include "dbg.h"
 #include "rnd_pub.h"
+#ifdef BDB_REJOIN_HISTORY
+#include "zps_nwk_nib.h"
+#include "PDM.h"
+#include "PDM_IDs.h"
+#endif
 #include <string.h>
 #include <stdlib.h>
 /****************************************************************************/
@@ -58,21 +63,45 @@
 #ifndef BDBC_IMP_MAX_REJOIN_CYCLES
 #define BDBC_IMP_MAX_REJOIN_CYCLES                      (3)
 #endif
+#ifdef BDB_REJOIN_HISTORY
+#define REJOIN_FIRST_WITH_DISC                          E_REJOIN_WITH_DISC_ON_LAST_GOOD_CH
+#else
+#define REJOIN_FIRST_WITH_DISC                          E_REJION_WITH_DISC_ON_PRIMARY_CH
+#endif
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
 typedef enum
 {
     E_REJOIN_WITHOUT_DISC = 0,
+#ifdef BDB_REJOIN_HISTORY
+    E_REJOIN_WITH_DISC_ON_LAST_GOOD_CH,
+    E_REJOIN_WITH_DISC_ON_HISTORY_CH,
+#endif
     E_REJION_WITH_DISC_ON_PRIMARY_CH,
     E_REJOIN_WITH_DISC_ON_SECONDARY_CH,
     E_REJOIN_ATTEMPT_OVER
 }teRejoinType;
+
+#ifdef BDB_REJOIN_HISTORY
+typedef struct
+{
+    uint64 u64ExtPanId;
+    uint16 u16PanId;
+    uint16 u16ParentAddr;
+    uint8  u8Channel;       /* 0 = free entry */
+    uint8  u8SuccessCount;
+} tsRejoinHistoryEntry;
+#endif
 /****************************************************************************/
 /***        Local Function Prototypes                                     ***/
 /****************************************************************************/
 PRIVATE void vInitAttribs(void);
 PRIVATE void bdb_vStart(bool_t bColdInit);
+#ifdef BDB_REJOIN_HISTORY
+PRIVATE void vRejoinHistoryLoad(void);
+PRIVATE uint32 u32RejoinHistoryChannelMask(bool_t bLastGoodOnly);
+#endif
 /****************************************************************************/
 /***        Exported Variables                                            ***/
 /****************************************************************************/
@@ -88,6 +117,10 @@ uint32 u32BackUpApsChannelMask;
 tsBeaconFilterType  sBeaconFilter;
 uint64 au64ExtPanListForBeaconFilter[BEACON_FILTER_EXT_PAN_LIST_SIZE];
 bool_t (*prbCancelRejoinAction)(void)   = NULL;
+#ifdef BDB_REJOIN_HISTORY
+static tsRejoinHistoryEntry asRejoinHistory[BDB_REJOIN_HISTORY_SIZE];   /* Most recent success first */
+static uint32 u32RejoinScannedChannels;                                 /* Scanned in this rejoin cycle */
+#endif
 
 /****************************************************************************/
 /***        Exported Functions                                            ***/
@@ -145,6 +178,10 @@ PUBLIC void BDB_vInit(BDB_tsInitArgs *psInitArgs)
 
     /* Initialize BDB attributes */
     vInitAttribs();
+
+#ifdef BDB_REJOIN_HISTORY
+    vRejoinHistoryLoad();
+#endif
     
     /* Assign Link keys */
     sBDB.pu8DefaultTCLinkKey  = ((psLinkKey = *(ZPS_psAplDefaultTrustCenterAPSLinkKey())) == NULL ) ? NULL : psLinkKey->au8LinkKey;
@@ -465,6 +502,9 @@ PUBLIC uint8 BDB_u8PickChannel(uint32 u32ChannelMask)
  *      a. Rejoin without discovery (direct rejoin)
  *      b. Rejoin with discovery on primary channel set
  *      c. Rejoin with discovery on secondary channel set
+ *  With BDB_REJOIN_HISTORY, b. is preceded by rejoin with discovery on the
+ *  last good channel and then on the other channels in the rejoin history,
+ *  and b. and c. skip the channels already scanned in the cycle.
  *  If any of the above rejoin attempt was successful then
  *  BDB_EVENT_REJOIN_SUCCESS event is generated via APP_vBdbCallback.
  *
@@ -518,7 +558,7 @@ PUBLIC void BDB_vRejoinCycle(bool_t bSkipDirectJoin)
     {
         /* If previous rejoin cycles were all failures then start fresh */
         u8RejoinCycles = 1;
-        eRejoinType = E_REJION_WITH_DISC_ON_PRIMARY_CH;
+        eRejoinType = REJOIN_FIRST_WITH_DISC;
     }
     else if(u8RejoinCycles == 0)
     {
@@ -528,7 +568,7 @@ PUBLIC void BDB_vRejoinCycle(bool_t bSkipDirectJoin)
 
         if(bSkipDirectJoin)
         {
-            eRejoinType = E_REJION_WITH_DISC_ON_PRIMARY_CH;
+            eRejoinType = REJOIN_FIRST_WITH_DISC;
         }
         else
         {
@@ -540,7 +580,7 @@ PUBLIC void BDB_vRejoinCycle(bool_t bSkipDirectJoin)
     if(eRejoinType >= E_REJOIN_ATTEMPT_OVER)
     {
         u8RejoinCycles++;
-        eRejoinType = E_REJION_WITH_DISC_ON_PRIMARY_CH;
+        eRejoinType = REJOIN_FIRST_WITH_DISC;
     }
 
     if(u8RejoinCycles < BDBC_IMP_MAX_REJOIN_CYCLES)
@@ -564,6 +604,25 @@ PUBLIC void BDB_vRejoinCycle(bool_t bSkipDirectJoin)
                     DBG_vPrintf(TRACE_BDB,"A without Disc           ");
                 }
                     break;
+#ifdef BDB_REJOIN_HISTORY
+                case E_REJOIN_WITH_DISC_ON_LAST_GOOD_CH:
+                    u32RejoinScannedChannels = 0;
+                    ZPS_eAplAibSetApsChannelMask(u32RejoinHistoryChannelMask(TRUE));
+                    DBG_vPrintf(TRACE_BDB,"H with Disc on Last Good ");
+                    break;
+                case E_REJOIN_WITH_DISC_ON_HISTORY_CH:
+                    ZPS_eAplAibSetApsChannelMask(u32RejoinHistoryChannelMask(FALSE) & ~u32RejoinScannedChannels);
+                    DBG_vPrintf(TRACE_BDB,"H with Disc on History   ");
+                    break;
+                case E_REJION_WITH_DISC_ON_PRIMARY_CH:
+                    ZPS_eAplAibSetApsChannelMask(sBDB.sAttrib.u32bdbPrimaryChannelSet & ~u32RejoinScannedChannels);
+                    DBG_vPrintf(TRACE_BDB,"B with Disc on Primary   ");
+                    break;
+                case E_REJOIN_WITH_DISC_ON_SECONDARY_CH:
+                    ZPS_eAplAibSetApsChannelMask(sBDB.sAttrib.u32bdbSecondaryChannelSet & ~u32RejoinScannedChannels);
+                    DBG_vPrintf(TRACE_BDB,"C with Disc on Secondary ");
+                    break;
+#else
                 case E_REJION_WITH_DISC_ON_PRIMARY_CH:
                     ZPS_eAplAibSetApsChannelMask(sBDB.sAttrib.u32bdbPrimaryChannelSet);
                     DBG_vPrintf(TRACE_BDB,"B with Disc on Primary   ");
@@ -572,6 +631,7 @@ PUBLIC void BDB_vRejoinCycle(bool_t bSkipDirectJoin)
                     ZPS_eAplAibSetApsChannelMask(sBDB.sAttrib.u32bdbSecondaryChannelSet);
                     DBG_vPrintf(TRACE_BDB,"C with Disc on Secondary ");
                     break;
+#endif
                 default:
                     break;
             }
@@ -580,8 +640,14 @@ PUBLIC void BDB_vRejoinCycle(bool_t bSkipDirectJoin)
 
             if (pau32ApsChannelMask[0])
             {
+#ifdef BDB_REJOIN_HISTORY
+                if(eRejoinType != E_REJOIN_WITHOUT_DISC)
+                {
+                    u32RejoinScannedChannels |= pau32ApsChannelMask[0];
+                }
+#endif
                 BDB_vSetRejoinFilter();
-                eStatus = ZPS_eAplZdoRejoinNetwork(eRejoinType);
+                eStatus = ZPS_eAplZdoRejoinNetwork(eRejoinType != E_REJOIN_WITHOUT_DISC);
 
                 if(eStatus == ZPS_E_SUCCESS)
                 {
@@ -680,12 +746,96 @@ PUBLIC void BDB_vRejoinSuccess()
 
     /* Store EPID for future rejoin */
     ZPS_eAplAibSetApsUseExtendedPanId(ZPS_u64NwkNibGetEpid( ZPS_pvAplZdoGetNwkHandle()));
+#ifdef BDB_REJOIN_HISTORY
+    BDB_vRejoinHistoryUpdate();
+#endif
 
     sBDB.sAttrib.ebdbCommissioningStatus = E_BDB_COMMISSIONING_STATUS_SUCCESS;
     sBdbEvent.eEventType = BDB_EVENT_REJOIN_SUCCESS;
     APP_vBdbCallback(&sBdbEvent);
 }
 
+#ifdef BDB_REJOIN_HISTORY
+/****************************************************************************
+ *
+ * NAME: BDB_vRejoinHistoryUpdate
+ *
+ * DESCRIPTION:
+ *  Records the current channel, PAN and parent in the rejoin history after a
+ *  successful join or rejoin and persists the history. The tuple moves to the
+ *  front of the history and its success count is incremented. When the
+ *  history is full the least successful entry is replaced, the oldest one on
+ *  a tie, but never the last good one.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *
+ * RETURNS:
+ *  void
+ *
+ ****************************************************************************/
+PUBLIC void BDB_vRejoinHistoryUpdate(void)
+{
+    ZPS_tsNwkNib *psNib = ZPS_psNwkNibGetHandle(ZPS_pvAplZdoGetNwkHandle());
+    tsRejoinHistoryEntry sEntry;
+    uint8 i, u8Slot;
+
+    sEntry.u64ExtPanId    = psNib->sPersist.u64ExtPanId;
+    sEntry.u16PanId       = psNib->sPersist.u16VsPanId;
+    sEntry.u16ParentAddr  = psNib->sPersist.u16VsParentAddr;
+    sEntry.u8Channel      = psNib->sPersist.u8VsChannel;
+    sEntry.u8SuccessCount = 0;
+
+    if((sEntry.u8Channel < BDB_CHANNEL_MIN) || (sEntry.u8Channel > BDB_CHANNEL_MAX))
+    {
+        return;
+    }
+
+    /* Entries are kept packed, so the tuple is found before the first free one */
+    u8Slot = BDB_REJOIN_HISTORY_SIZE;
+    for(i = 0; i < BDB_REJOIN_HISTORY_SIZE; i++)
+    {
+        if(asRejoinHistory[i].u8Channel == 0)
+        {
+            u8Slot = i;
+            break;
+        }
+        if((asRejoinHistory[i].u64ExtPanId == sEntry.u64ExtPanId) &&
+           (asRejoinHistory[i].u16PanId == sEntry.u16PanId) &&
+           (asRejoinHistory[i].u16ParentAddr == sEntry.u16ParentAddr) &&
+           (asRejoinHistory[i].u8Channel == sEntry.u8Channel))
+        {
+            sEntry.u8SuccessCount = asRejoinHistory[i].u8SuccessCount;
+            u8Slot = i;
+            break;
+        }
+    }
+
+    if(u8Slot == BDB_REJOIN_HISTORY_SIZE)
+    {
+        u8Slot = BDB_REJOIN_HISTORY_SIZE - 1;
+        for(i = 1; i < BDB_REJOIN_HISTORY_SIZE; i++)
+        {
+            if(asRejoinHistory[i].u8SuccessCount <= asRejoinHistory[u8Slot].u8SuccessCount)
+            {
+                u8Slot = i;
+            }
+        }
+    }
+
+    if(sEntry.u8SuccessCount < 0xFF)
+    {
+        sEntry.u8SuccessCount++;
+    }
+
+    memmove(&asRejoinHistory[1], &asRejoinHistory[0], u8Slot * sizeof(tsRejoinHistoryEntry));
+    asRejoinHistory[0] = sEntry;
+
+    DBG_vPrintf(TRACE_BDB,"BDB: Rejoin history Ch %d Pan %04x Parent %04x count %d\n",
+                sEntry.u8Channel, sEntry.u16PanId, sEntry.u16ParentAddr, sEntry.u8SuccessCount);
+    PDM_eSaveRecordData(PDM_ID_BDB_REJOIN_HISTORY, asRejoinHistory, sizeof(asRejoinHistory));
+}
+#endif
+
 /****************************************************************************/
 /***        Local Functions                                               ***/
 /****************************************************************************/
@@ -846,6 +996,76 @@ PUBLIC void BDB_vRejoinTimerCb(void *pvParam)
     BDB_vRejoinCycle(TRUE);
 }
 
+#ifdef BDB_REJOIN_HISTORY
+/****************************************************************************
+ *
+ * NAME: vRejoinHistoryLoad
+ *
+ * DESCRIPTION:
+ *  Restores the rejoin history from PDM, or starts with an empty history if
+ *  the record is missing or has a different size.
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PRIVATE void vRejoinHistoryLoad(void)
+{
+    uint16 u16ByteRead = 0;
+
+    if((PDM_E_STATUS_OK != PDM_eReadDataFromRecord(PDM_ID_BDB_REJOIN_HISTORY,
+                                                   asRejoinHistory,
+                                                   sizeof(asRejoinHistory),
+                                                   &u16ByteRead)) ||
+       (u16ByteRead != sizeof(asRejoinHistory)))
+    {
+        memset(asRejoinHistory, 0, sizeof(asRejoinHistory));
+    }
+}
+
+/****************************************************************************
+ *
+ * NAME: u32RejoinHistoryChannelMask
+ *
+ * DESCRIPTION:
+ *  Builds a channel mask from the rejoin history entries of the network to
+ *  rejoin, apsUseExtendedPanId or else the EPID in the NIB. Entries of other
+ *  networks are ignored unless neither is set.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *                  bLastGoodOnly       TRUE for the most recent entry only
+ *
+ * RETURNS:
+ *  Channel mask, 0 if the history holds no entry for the network
+ *
+ ****************************************************************************/
+PRIVATE uint32 u32RejoinHistoryChannelMask(bool_t bLastGoodOnly)
+{
+    uint64 u64Epid = ZPS_u64AplAibGetApsUseExtendedPanId();
+    uint32 u32Mask = 0;
+    uint8 i;
+
+    if(u64Epid == 0)
+    {
+        u64Epid = ZPS_u64NwkNibGetEpid(ZPS_pvAplZdoGetNwkHandle());
+    }
+
+    for(i = 0; (i < BDB_REJOIN_HISTORY_SIZE) && (asRejoinHistory[i].u8Channel != 0); i++)
+    {
+        if((u64Epid != 0) && (asRejoinHistory[i].u64ExtPanId != u64Epid))
+        {
+            continue;
+        }
+        u32Mask |= (1UL << asRejoinHistory[i].u8Channel);
+        if(bLastGoodOnly)
+        {
+            break;
+        }
+    }
+    return u32Mask;
+}
+#endif
+
 
 /****************************************************************************
  *
@@ -878,6 +1098,9 @@ PUBLIC void BDB_vSetRejoinFilter()
         sBeaconFilter.u8ListSize = BEACON_FILTER_EXT_PAN_LIST_SIZE;
         sBeaconFilter.u16FilterMap |= BF_BITMAP_WHITELIST;
     }
+
+    /* the beacon handler works from a compiled copy of the filter */
+    ZPS_vAppRefreshBeaconFilter();
 }
 
 /****************************************************************************
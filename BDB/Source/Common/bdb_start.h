@@ -62,6 +62,9 @@ PUBLIC uint8 BDB_u8PickChannel(uint32 u32ChannelMask);
 PUBLIC void BDB_vRejoinCycle(bool_t bSkipDirectJoin);
 PUBLIC void BDB_vRejoinSuccess(void);
 PUBLIC void BDB_vRejoinTimerCb(void *pvParam);
+#ifdef BDB_REJOIN_HISTORY
+PUBLIC void BDB_vRejoinHistoryUpdate(void);
+#endif
 
 /****************************************************************************/
 /***        Exported Variables                                            ***/
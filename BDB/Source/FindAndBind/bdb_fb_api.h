@@ -60,6 +60,26 @@ extern "C" {
 #define BDB_FB_NUMBER_OF_ENDPOINTS                              ZCL_NUMBER_OF_ENDPOINTS
 #endif
 
+/* Simple descriptor cache. Define BDB_FB_SIMPLE_DESC_CACHE in bdb_options.h to
+ * remember the simple descriptors and IEEE addresses of targets, so repeated
+ * Find and Bind runs against the same targets skip the ZDP requests. Entries of
+ * a device are dropped when it sends a device announce. */
+#ifdef BDB_FB_SIMPLE_DESC_CACHE
+/* number of (IEEE address, endpoint) entries, least recently used is replaced */
+#ifndef BDB_FB_SD_CACHE_SIZE
+#define BDB_FB_SD_CACHE_SIZE                                    8
+#endif
+
+/* in and out clusters kept per entry, larger descriptors are not cached */
+#ifndef BDB_FB_SD_CACHE_MAX_CLUSTERS
+#define BDB_FB_SD_CACHE_MAX_CLUSTERS                            16
+#endif
+/* cache hits are replayed through ZPS_tsAfZdpEvent.uLists.au16Data[34] */
+#if (BDB_FB_SD_CACHE_MAX_CLUSTERS > 34)
+#error BDB_FB_SD_CACHE_MAX_CLUSTERS must not exceed 34
+#endif
+#endif
+
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
@@ -82,6 +102,23 @@ typedef struct
     uint64 u64IeeeAddr;
 }tsFB_TargetInfo;
 
+#ifdef BDB_FB_SIMPLE_DESC_CACHE
+/* Simple Descriptor Cache Entry */
+typedef struct
+{
+    uint64 u64IeeeAddr;
+    uint16 u16NwkAddr;
+    uint16 u16LastUsed;
+    uint16 u16ProfileId;
+    uint16 u16DeviceId;
+    uint8  u8DeviceVersion;
+    uint8  u8Endpoint;
+    uint8  u8InClusterCount;
+    uint8  u8OutClusterCount;
+    uint16 au16Clusters[BDB_FB_SD_CACHE_MAX_CLUSTERS];
+}tsFB_SimpleDescCacheEntry;
+#endif
+
 /* Find and Bind Structure */
 typedef struct
 {
@@ -106,6 +143,9 @@ PUBLIC void BDB_vFbExitAsTarget(uint8 u8SourceEndpoint);
 
 PUBLIC void BDB_vFbTimerCb(void *pvParam);
 PUBLIC void BDB_vFbHandleStopIdentification(tsZCL_CallBackEvent *pCallBackEvent);
+#ifdef BDB_FB_SIMPLE_DESC_CACHE
+PUBLIC void BDB_vFbFlushSimpleDescCache(void);
+#endif
 /****************************************************************************/
 /***        External Variables                                            ***/
 /****************************************************************************/
@@ -84,6 +84,18 @@ PRIVATE void vFbSendAddGroupCommand(uint8      u8SourceEndpoint,
                                        uint8        u8DstEndpoint,
                                        uint16       u16ShortAddress,
                                        bool_t       bGroupCast);
+#ifdef BDB_FB_SIMPLE_DESC_CACHE
+PRIVATE bool_t bFbHandleCachedSimpleDesc(uint8 u8TargetIndex,
+                                         uint64 u64IeeeAddr);
+PRIVATE tsFB_SimpleDescCacheEntry* psFbFindCachedSimpleDesc(uint64 u64IeeeAddr,
+                                                            uint16 u16NwkAddr,
+                                                            uint8  u8Endpoint);
+PRIVATE uint64 u64FbLookupCachedIeeeAddr(uint16 u16NwkAddr);
+PRIVATE void vFbCacheSimpleDesc(ZPS_tsAfZdpEvent   *psAfZdpEvent,
+                                uint64             u64IeeeAddr);
+PRIVATE void vFbInvalidateCachedDevice(uint16 u16NwkAddr,
+                                       uint64 u64IeeeAddr);
+#endif
                                         
 /****************************************************************************/
 /***        Exported Variables                                            ***/
@@ -94,6 +106,10 @@ PUBLIC uint8 u8TimerBdbFb;
 /***        Local Variables                                               ***/
 /****************************************************************************/
 PRIVATE tsFindAndBind sFindAndBind = {0};
+#ifdef BDB_FB_SIMPLE_DESC_CACHE
+PRIVATE tsFB_SimpleDescCacheEntry asFbSimpleDescCache[BDB_FB_SD_CACHE_SIZE];
+PRIVATE uint16 u16FbSimpleDescCacheClock;
+#endif
 /****************************************************************************/
 /***        Exported Functions                                            ***/
 /****************************************************************************/
@@ -217,6 +233,23 @@ PUBLIC void BDB_vFbHandleQueryResponse(tsZCL_CallBackEvent *pCallBackEvent)
         }
         /* check if IEEE address of device is available */
         u64IeeeAddr  = ZPS_u64AplZdoLookupIeeeAddr(pCallBackEvent->pZPSevent->uEvent.sApsDataIndEvent.uSrcAddress.u16Addr);
+
+#ifdef BDB_FB_SIMPLE_DESC_CACHE
+        if(i < BDB_FB_MAX_TARGET_DEVICES)
+        {
+            if(!u64IeeeAddr)
+            {
+                /* Address learnt from an earlier Find and Bind run */
+                u64IeeeAddr = u64FbLookupCachedIeeeAddr(sFindAndBind.asTargetInfo[i].u16NwkAddr);
+                sFindAndBind.asTargetInfo[i].u64IeeeAddr = u64IeeeAddr;
+            }
+            /* Known descriptor, bind without any ZDP request */
+            if(u64IeeeAddr && bFbHandleCachedSimpleDesc(i, u64IeeeAddr))
+            {
+                return;
+            }
+        }
+#endif
         
         DBG_vPrintf(TRACE_FB_INTIATOR, "BDB_vFbHandleQueryResponse event %0x\r\n", pCallBackEvent->eEventType);
         if(!u64IeeeAddr )
@@ -260,6 +293,16 @@ PUBLIC void vFbZdpHandler(ZPS_tsAfEvent *pZPSevent)
     if((ZPS_EVENT_APS_DATA_INDICATION == pZPSevent->eType) &&
             (0 == pZPSevent->uEvent.sApsDataIndEvent.u8DstEndpoint))
     {
+#ifdef BDB_FB_SIMPLE_DESC_CACHE
+        if(ZPS_ZDP_DEVICE_ANNCE_REQ_CLUSTER_ID == pZPSevent->uEvent.sApsDataIndEvent.u16ClusterId)
+        {
+            /* Device has (re)joined, its addresses or descriptors may have changed */
+            zps_bAplZdpUnpackDevicAnnounce(pZPSevent, &sAfZdpEvent);
+            vFbInvalidateCachedDevice(sAfZdpEvent.uZdpData.sDeviceAnnce.u16NwkAddr,
+                                      sAfZdpEvent.uZdpData.sDeviceAnnce.u64IeeeAddr);
+            return;
+        }
+#endif
         for(i=0; i < BDB_FB_MAX_TARGET_DEVICES;i++)
         {
 
@@ -283,6 +326,17 @@ PUBLIC void vFbZdpHandler(ZPS_tsAfEvent *pZPSevent)
                 DBG_vPrintf(TRACE_FB_INTIATOR, "ZDP_SIMPLE_DESC_RSP_CLUSTER_ID \r\n");
                 if(sAfZdpEvent.uZdpData.sSimpleDescRsp.u16NwkAddrOfInterest == sFindAndBind.asTargetInfo[i].u16NwkAddr )
                 {
+#ifdef BDB_FB_SIMPLE_DESC_CACHE
+                    if(sFindAndBind.asTargetInfo[i].u64IeeeAddr)
+                    {
+                        vFbCacheSimpleDesc(&sAfZdpEvent, sFindAndBind.asTargetInfo[i].u64IeeeAddr);
+                    }
+                    else
+                    {
+                        vFbCacheSimpleDesc(&sAfZdpEvent,
+                                           ZPS_u64AplZdoLookupIeeeAddr(sFindAndBind.asTargetInfo[i].u16NwkAddr));
+                    }
+#endif
                     /* Handle simple descriptor response: check for match and bind */
                     vFbHandleSimpleDescResp(&sAfZdpEvent);
                     /* As we have handled this target , free the entry */
@@ -383,6 +437,29 @@ PUBLIC void BDB_vFbTimerCb(void *pvParam)
 
 }
 
+#ifdef BDB_FB_SIMPLE_DESC_CACHE
+/****************************************************************************
+ *
+ * NAME: BDB_vFbFlushSimpleDescCache
+ *
+ * DESCRIPTION:
+ *  Empties the simple descriptor cache, so the next Find and Bind run requests
+ *  the IEEE address and simple descriptor of every target again. Application
+ *  should call it when the node leaves the network.
+ *
+ * PARAMETERS:  Name                            Usage
+ *
+ * RETURNS:
+ *  void
+ *
+ ****************************************************************************/
+PUBLIC void BDB_vFbFlushSimpleDescCache(void)
+{
+    memset(asFbSimpleDescCache, 0, sizeof(asFbSimpleDescCache));
+    u16FbSimpleDescCacheClock = 0;
+}
+#endif
+
 /****************************************************************************/
 /***        Local Functions                                               ***/
 /****************************************************************************/
@@ -1001,6 +1078,237 @@ PRIVATE void vFbSendAddGroupCommand(uint8      u8SourceEndpoint,
     APP_vBdbCallback(&sBdbEvent); 
 }
 
+#ifdef BDB_FB_SIMPLE_DESC_CACHE
+/****************************************************************************
+ *
+ * NAME: bFbHandleCachedSimpleDesc
+ *
+ * DESCRIPTION:
+ * Looks up the simple descriptor of a target in the cache. On a hit the
+ * descriptor is handled exactly as a received simple descriptor response and
+ * the target entry is freed.
+ *
+ * PARAMETERS:  Name                            Usage
+ *              u8TargetIndex                   index in asTargetInfo
+ *              u64IeeeAddr                     IEEE address of the target
+ * RETURNS:
+ * TRUE if the descriptor was cached, FALSE if it must be requested
+ *
+ ****************************************************************************/
+PRIVATE bool_t bFbHandleCachedSimpleDesc(uint8 u8TargetIndex,
+                                         uint64 u64IeeeAddr)
+{
+    ZPS_tsAfZdpEvent sAfZdpEvent;
+    ZPS_tsAplZdpSimpleDescType *psSimpleDesc;
+    tsFB_SimpleDescCacheEntry *psEntry;
+    tsFB_TargetInfo *psTarget = &sFindAndBind.asTargetInfo[u8TargetIndex];
+
+    psEntry = psFbFindCachedSimpleDesc(u64IeeeAddr, psTarget->u16NwkAddr, psTarget->u8DstEndpoint);
+    if(psEntry == NULL)
+    {
+        return FALSE;
+    }
+    psEntry->u16LastUsed = ++u16FbSimpleDescCacheClock;
+
+    DBG_vPrintf(TRACE_FB_INTIATOR, "Cached simple descriptor for %04x ep %d\r\n",
+                psTarget->u16NwkAddr, psTarget->u8DstEndpoint);
+
+    /* Rebuild the response as zps_bAplZdpUnpackSimpleDescResponse would */
+    memset(&sAfZdpEvent, 0, sizeof(ZPS_tsAfZdpEvent));
+    sAfZdpEvent.u16ClusterId = ZPS_ZDP_SIMPLE_DESC_RSP_CLUSTER_ID;
+    sAfZdpEvent.uZdpData.sSimpleDescRsp.u8Status = ZPS_NWK_ENUM_SUCCESS;
+    sAfZdpEvent.uZdpData.sSimpleDescRsp.u16NwkAddrOfInterest = psTarget->u16NwkAddr;
+    sAfZdpEvent.uZdpData.sSimpleDescRsp.u8Length = 8 + 2 * (psEntry->u8InClusterCount + psEntry->u8OutClusterCount);
+
+    psSimpleDesc = &sAfZdpEvent.uZdpData.sSimpleDescRsp.sSimpleDescriptor;
+    psSimpleDesc->u8Endpoint = psEntry->u8Endpoint;
+    psSimpleDesc->u16ApplicationProfileId = psEntry->u16ProfileId;
+    psSimpleDesc->u16DeviceId = psEntry->u16DeviceId;
+    psSimpleDesc->uBitUnion.u8Value = psEntry->u8DeviceVersion;
+    psSimpleDesc->u8InClusterCount = psEntry->u8InClusterCount;
+    psSimpleDesc->u8OutClusterCount = psEntry->u8OutClusterCount;
+    memcpy(sAfZdpEvent.uLists.au16Data, psEntry->au16Clusters,
+           (psEntry->u8InClusterCount + psEntry->u8OutClusterCount) * sizeof(uint16));
+    psSimpleDesc->pu16InClusterList = &sAfZdpEvent.uLists.au16Data[0];
+    psSimpleDesc->pu16OutClusterList = &sAfZdpEvent.uLists.au16Data[psEntry->u8InClusterCount];
+
+    /* Same state as after a requested descriptor, no query response timeout */
+    sFindAndBind.eFBState = E_FB_WAIT_FOR_SIMPLE_DESCRIPTOR_RESPONSE_STATE;
+    vFbHandleSimpleDescResp(&sAfZdpEvent);
+    /* As we have handled this target , free the entry */
+    memset(psTarget, 0, sizeof(tsFB_TargetInfo));
+    return TRUE;
+}
+
+/****************************************************************************
+ *
+ * NAME: psFbFindCachedSimpleDesc
+ *
+ * DESCRIPTION:
+ * Finds the cache entry of a target endpoint. An entry recorded under another
+ * network address is stale and is dropped.
+ *
+ * PARAMETERS:  Name                            Usage
+ *              u64IeeeAddr                     IEEE address of the target
+ *              u16NwkAddr                      network address of the target
+ *              u8Endpoint                      target endpoint
+ * RETURNS:
+ * Cache entry, NULL if not cached
+ *
+ ****************************************************************************/
+PRIVATE tsFB_SimpleDescCacheEntry* psFbFindCachedSimpleDesc(uint64 u64IeeeAddr,
+                                                            uint16 u16NwkAddr,
+                                                            uint8  u8Endpoint)
+{
+    uint8 i;
+
+    for(i = 0; i < BDB_FB_SD_CACHE_SIZE; i++)
+    {
+        if((asFbSimpleDescCache[i].u8Endpoint == u8Endpoint) &&
+           (asFbSimpleDescCache[i].u8Endpoint != 0) &&
+           (asFbSimpleDescCache[i].u64IeeeAddr == u64IeeeAddr))
+        {
+            if(asFbSimpleDescCache[i].u16NwkAddr != u16NwkAddr)
+            {
+                memset(&asFbSimpleDescCache[i], 0, sizeof(tsFB_SimpleDescCacheEntry));
+                return NULL;
+            }
+            return &asFbSimpleDescCache[i];
+        }
+    }
+    return NULL;
+}
+
+/****************************************************************************
+ *
+ * NAME: u64FbLookupCachedIeeeAddr
+ *
+ * DESCRIPTION:
+ * Looks up the IEEE address recorded with a network address in the cache
+ *
+ * PARAMETERS:  Name                            Usage
+ *              u16NwkAddr                      network address of the target
+ * RETURNS:
+ * IEEE address, 0 if not cached
+ *
+ ****************************************************************************/
+PRIVATE uint64 u64FbLookupCachedIeeeAddr(uint16 u16NwkAddr)
+{
+    uint8 i;
+
+    for(i = 0; i < BDB_FB_SD_CACHE_SIZE; i++)
+    {
+        if((asFbSimpleDescCache[i].u8Endpoint != 0) &&
+           (asFbSimpleDescCache[i].u16NwkAddr == u16NwkAddr))
+        {
+            return asFbSimpleDescCache[i].u64IeeeAddr;
+        }
+    }
+    return 0;
+}
+
+/****************************************************************************
+ *
+ * NAME: vFbCacheSimpleDesc
+ *
+ * DESCRIPTION:
+ * Stores a successful simple descriptor response in the cache, replacing the
+ * entry of the same endpoint, a free entry or the least recently used one.
+ *
+ * PARAMETERS:  Name                            Usage
+ *              psAfZdpEvent                    unpacked simple descriptor response
+ *              u64IeeeAddr                     IEEE address of the target
+ * RETURNS:
+ * None
+ *
+ ****************************************************************************/
+PRIVATE void vFbCacheSimpleDesc(ZPS_tsAfZdpEvent   *psAfZdpEvent,
+                                uint64             u64IeeeAddr)
+{
+    ZPS_tsAplZdpSimpleDescType *psSimpleDesc = &psAfZdpEvent->uZdpData.sSimpleDescRsp.sSimpleDescriptor;
+    tsFB_SimpleDescCacheEntry *psEntry = NULL;
+    uint16 u16Age, u16OldestAge = 0;
+    uint8 i;
+
+    if((u64IeeeAddr == 0) ||
+       (ZPS_NWK_ENUM_SUCCESS != psAfZdpEvent->uZdpData.sSimpleDescRsp.u8Status) ||
+       (psSimpleDesc->u8Endpoint == 0) ||
+       ((psSimpleDesc->u8InClusterCount + psSimpleDesc->u8OutClusterCount) > BDB_FB_SD_CACHE_MAX_CLUSTERS))
+    {
+        return;
+    }
+
+    for(i = 0; i < BDB_FB_SD_CACHE_SIZE; i++)
+    {
+        if(asFbSimpleDescCache[i].u8Endpoint == 0)
+        {
+            if((psEntry == NULL) || (psEntry->u8Endpoint != 0))
+            {
+                psEntry = &asFbSimpleDescCache[i];
+            }
+            continue;
+        }
+        if((asFbSimpleDescCache[i].u64IeeeAddr == u64IeeeAddr) &&
+           (asFbSimpleDescCache[i].u8Endpoint == psSimpleDesc->u8Endpoint))
+        {
+            psEntry = &asFbSimpleDescCache[i];
+            break;
+        }
+        /* Ages relative to the clock so a wrapped clock keeps the order */
+        u16Age = u16FbSimpleDescCacheClock - asFbSimpleDescCache[i].u16LastUsed;
+        if((psEntry == NULL) || ((psEntry->u8Endpoint != 0) && (u16Age > u16OldestAge)))
+        {
+            psEntry = &asFbSimpleDescCache[i];
+            u16OldestAge = u16Age;
+        }
+    }
+
+    psEntry->u64IeeeAddr = u64IeeeAddr;
+    psEntry->u16NwkAddr = psAfZdpEvent->uZdpData.sSimpleDescRsp.u16NwkAddrOfInterest;
+    psEntry->u16LastUsed = ++u16FbSimpleDescCacheClock;
+    psEntry->u16ProfileId = psSimpleDesc->u16ApplicationProfileId;
+    psEntry->u16DeviceId = psSimpleDesc->u16DeviceId;
+    psEntry->u8DeviceVersion = psSimpleDesc->uBitUnion.u8Value;
+    psEntry->u8Endpoint = psSimpleDesc->u8Endpoint;
+    psEntry->u8InClusterCount = psSimpleDesc->u8InClusterCount;
+    psEntry->u8OutClusterCount = psSimpleDesc->u8OutClusterCount;
+    /* In clusters then out clusters, as in the unpacked response */
+    memcpy(psEntry->au16Clusters, psAfZdpEvent->uLists.au16Data,
+           (psSimpleDesc->u8InClusterCount + psSimpleDesc->u8OutClusterCount) * sizeof(uint16));
+}
+
+/****************************************************************************
+ *
+ * NAME: vFbInvalidateCachedDevice
+ *
+ * DESCRIPTION:
+ * Drops the cache entries of an announced device, and of any other device
+ * previously known under its network address.
+ *
+ * PARAMETERS:  Name                            Usage
+ *              u16NwkAddr                      announced network address
+ *              u64IeeeAddr                     announced IEEE address
+ * RETURNS:
+ * None
+ *
+ ****************************************************************************/
+PRIVATE void vFbInvalidateCachedDevice(uint16 u16NwkAddr,
+                                       uint64 u64IeeeAddr)
+{
+    uint8 i;
+
+    for(i = 0; i < BDB_FB_SD_CACHE_SIZE; i++)
+    {
+        if((asFbSimpleDescCache[i].u8Endpoint != 0) &&
+           ((asFbSimpleDescCache[i].u64IeeeAddr == u64IeeeAddr) ||
+            (asFbSimpleDescCache[i].u16NwkAddr == u16NwkAddr)))
+        {
+            memset(&asFbSimpleDescCache[i], 0, sizeof(tsFB_SimpleDescCacheEntry));
+        }
+    }
+}
+#endif
+
 /****************************************************************************/
 /***        END OF FILE                                                   ***/
 /****************************************************************************/
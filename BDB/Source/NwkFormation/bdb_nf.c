@@ -57,9 +57,15 @@
 /***        Local Function Prototypes                                     ***/
 /****************************************************************************/
 PRIVATE void vNfDiscoverNwk(void);
+PRIVATE void vNfInitStartParams(uint8 u8Channel);
 PRIVATE void vNfFormDistributedNwk(void);
 PRIVATE void vNfRetryNwkFormation(void);
 PRIVATE bool_t bNfSearchDiscNt(uint64 u64EpId, uint16 u16PanId);
+#ifdef BDB_NF_CHANNEL_SURVEY
+PRIVATE void vNfStartChannelSurvey(void);
+PRIVATE void vNfSurveyEdScanDone(ZPS_tsNwkNlmeCfmEdScan *psEdScan);
+PRIVATE void vNfSurveyFormNwk(void);
+#endif
 #if (BDB_SET_DEFAULT_TC_POLICY == TRUE) 
 PRIVATE bool_t vNfTcCallback (uint16 u16ShortAddress,
                              uint64 u64DeviceAddress,
@@ -79,6 +85,9 @@ static tsStartParams sStartParams;
 static bool_t bDoPrimaryScan;
 static uint32 u32ScanChannels;
 static uint32 u32BackUpApsChannelMask;
+#ifdef BDB_NF_CHANNEL_SURVEY
+static BDB_tsNfChannelSurvey sNfChannelSurvey;
+#endif
 
 /****************************************************************************/
 /***        Exported Functions                                            ***/
@@ -95,6 +104,10 @@ static uint32 u32BackUpApsChannelMask;
  *  Above network formation are tried on primary channel set first. If nwk
  *  formation failed on primary channel set then it's tried on secondary 
  *  channel set. Channels are actively scanned to choose unique pan id.
+ *
+ *  With BDB_NF_CHANNEL_SURVEY, each channel set is first surveyed with an
+ *  ED scan and an active scan and the network is formed on the channel with
+ *  the lowest BDB_u16NfChannelScore().
  * 
  *  ZPS_eAplZdoStartStack is used to form centralized network.
  *  
@@ -209,6 +222,10 @@ PUBLIC BDB_teStatus BDB_eNfStartNwkFormation(void)
 
 #endif
 
+#ifdef BDB_NF_CHANNEL_SURVEY
+    memset(&sNfChannelSurvey, 0, sizeof(sNfChannelSurvey));
+    vNfStartChannelSurvey();
+#else
     if(ZPS_ZDO_DEVICE_COORD == ZPS_eAplZdoGetDeviceType())
     {
         DBG_vPrintf(TRACE_BDB,"BDB: Forming Centralized Nwk \n");
@@ -222,6 +239,7 @@ PUBLIC BDB_teStatus BDB_eNfStartNwkFormation(void)
         eNF_State = E_NF_WAIT_DISCOVERY;
         vNfDiscoverNwk();
     }
+#endif
     return BDB_E_SUCCESS;
 }
 
@@ -257,6 +275,10 @@ PUBLIC void BDB_vNfStateMachine(BDB_tsZpsAfEvent *psZpsAfEvent)
                                                 FALSE);     // bDisableAuthentications
                     sBDB.sAttrib.bbdbNodeIsOnANetwork = TRUE;
                     sBDB.sAttrib.ebdbCommissioningStatus = E_BDB_COMMISSIONING_STATUS_SUCCESS;
+#ifdef BDB_NF_CHANNEL_SURVEY
+                    /* Formed on the surveyed channel, give back the whole set */
+                    ZPS_eAplAibSetApsChannelMask(u32ScanChannels);
+#endif
 
                     sBDB.eState = E_STATE_BASE_ACTIVE;
                     eNF_State = E_NF_IDLE;
@@ -287,12 +309,85 @@ PUBLIC void BDB_vNfStateMachine(BDB_tsZpsAfEvent *psZpsAfEvent)
         case E_NF_WAIT_FORM_DISTRIBUTED:
                 break;
 
+#ifdef BDB_NF_CHANNEL_SURVEY
+        case E_NF_WAIT_SURVEY_ED_SCAN:
+            switch(psZpsAfEvent->sStackEvent.eType)
+            {
+                case ZPS_EVENT_NWK_ED_SCAN:
+                    vNfSurveyEdScanDone(&psZpsAfEvent->sStackEvent.uEvent.sNwkEdScanConfirmEvent);
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        case E_NF_WAIT_SURVEY_DISCOVERY:
+            switch(psZpsAfEvent->sStackEvent.eType)
+            {
+                case ZPS_EVENT_NWK_DISCOVERY_COMPLETE:
+                    vNfSurveyFormNwk();
+                    break;
+                default:
+                    break;
+            }
+            break;
+#endif
+
         default:
             break;
     }
 }
 
 
+#ifdef BDB_NF_CHANNEL_SURVEY
+/****************************************************************************
+ *
+ * NAME: BDB_psNfGetChannelSurvey
+ *
+ * DESCRIPTION:
+ *  Gives access to the channel survey of the last network formation, e.g.
+ *  for a later frequency agility decision.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *
+ * RETURNS:
+ *  Channel survey results
+ *
+ ****************************************************************************/
+PUBLIC BDB_tsNfChannelSurvey *BDB_psNfGetChannelSurvey(void)
+{
+    return &sNfChannelSurvey;
+}
+
+/****************************************************************************
+ *
+ * NAME: BDB_u16NfChannelScore
+ *
+ * DESCRIPTION:
+ *  Scores a surveyed channel as its ED level plus BDB_NF_SURVEY_PAN_WEIGHT
+ *  for every network heard on it; lower is better.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *                  u8Channel           Channel to score
+ *
+ * RETURNS:
+ *  Channel score, 0xFFFF if the channel was not surveyed
+ *
+ ****************************************************************************/
+PUBLIC uint16 BDB_u16NfChannelScore(uint8 u8Channel)
+{
+    uint8 u8Index = u8Channel - BDB_CHANNEL_MIN;
+
+    if((u8Channel < BDB_CHANNEL_MIN) || (u8Channel > BDB_CHANNEL_MAX) ||
+       !(sNfChannelSurvey.u32Channels & (1UL << u8Channel)))
+    {
+        return 0xFFFF;
+    }
+    return sNfChannelSurvey.au8Energy[u8Index] +
+           (uint16)sNfChannelSurvey.au8PanCount[u8Index] * BDB_NF_SURVEY_PAN_WEIGHT;
+}
+#endif
+
 /****************************************************************************/
 /***        Local Functions                                               ***/
 /****************************************************************************/
@@ -343,19 +438,7 @@ PRIVATE void vNfDiscoverNwk()
     ZPS_teStatus eStatus;
 
     /* Set the start up parameters - To be used later while forming - ZPS_EVENT_NWK_DISCOVERY_COMPLETE */
-    sStartParams.sNwkParams.u8LogicalChannel = BDB_u8PickChannel(u32ScanChannels);
-    sStartParams.sNwkParams.u16NwkAddr = RND_u32GetRand(1, 0xfffe);
-
-    if (sStartParams.sNwkParams.u64ExtPanId == 0)
-    {
-        sStartParams.sNwkParams.u64ExtPanId = RND_u32GetRand(1, 0xffffffff);
-        sStartParams.sNwkParams.u64ExtPanId <<= 32;
-        sStartParams.sNwkParams.u64ExtPanId |= RND_u32GetRand(0, 0xffffffff);
-    }
-    if (sStartParams.sNwkParams.u16PanId == 0)
-    {
-        sStartParams.sNwkParams.u16PanId = RND_u32GetRand( 1, 0xfffe);
-    }
+    vNfInitStartParams(BDB_u8PickChannel(u32ScanChannels));
 
 #ifdef ENABLE_SUBG_IF
     void *pvNwk = ZPS_pvAplZdoGetNwkHandle();
@@ -376,6 +459,38 @@ PRIVATE void vNfDiscoverNwk()
     }
 }
 
+/****************************************************************************
+ *
+ * NAME: vNfInitStartParams
+ *
+ * DESCRIPTION:
+ *  Sets the distributed network start up parameters. A random network
+ *  address is chosen, and a random PAN id and EPID if not already set.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *                  u8Channel           Channel to form the network on
+ *
+ * RETURNS:
+ *  void
+ *
+ ****************************************************************************/
+PRIVATE void vNfInitStartParams(uint8 u8Channel)
+{
+    sStartParams.sNwkParams.u8LogicalChannel = u8Channel;
+    sStartParams.sNwkParams.u16NwkAddr = RND_u32GetRand(1, 0xfffe);
+
+    if (sStartParams.sNwkParams.u64ExtPanId == 0)
+    {
+        sStartParams.sNwkParams.u64ExtPanId = RND_u32GetRand(1, 0xffffffff);
+        sStartParams.sNwkParams.u64ExtPanId <<= 32;
+        sStartParams.sNwkParams.u64ExtPanId |= RND_u32GetRand(0, 0xffffffff);
+    }
+    if (sStartParams.sNwkParams.u16PanId == 0)
+    {
+        sStartParams.sNwkParams.u16PanId = RND_u32GetRand( 1, 0xfffe);
+    }
+}
+
 /****************************************************************************
  *
  * NAME: vNfFormDistributedNwk
@@ -475,6 +590,9 @@ PRIVATE void vNfRetryNwkFormation(void)
         u32ScanChannels = sBDB.sAttrib.u32bdbSecondaryChannelSet;
 
         ZPS_eAplAibSetApsChannelMask(u32ScanChannels);
+#ifdef BDB_NF_CHANNEL_SURVEY
+        vNfStartChannelSurvey();
+#else
         if(ZPS_ZDO_DEVICE_COORD == ZPS_eAplZdoGetDeviceType())
         {
             DBG_vPrintf(TRACE_BDB,"BDB: Forming Centralized Nwk \n");
@@ -488,6 +606,7 @@ PRIVATE void vNfRetryNwkFormation(void)
             eNF_State = E_NF_WAIT_DISCOVERY;
             vNfDiscoverNwk();
         }
+#endif
     }
 }
 
@@ -520,6 +639,183 @@ PRIVATE bool_t bNfSearchDiscNt(uint64 u64EpId, uint16 u16PanId)
     return eSL_SearchExtendedPanId(u64EpId, u16PanId);
 #endif
 }
+#ifdef BDB_NF_CHANNEL_SURVEY
+/****************************************************************************
+ *
+ * NAME: vNfStartChannelSurvey
+ *
+ * DESCRIPTION:
+ *  Starts the channel survey of the current channel set with an ED scan.
+ *  If the scan cannot be started the survey continues without energy
+ *  levels.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *
+ * RETURNS:
+ *  void
+ *
+ ****************************************************************************/
+PRIVATE void vNfStartChannelSurvey(void)
+{
+    ZPS_tsNwkNlmeReqRsp sNlmeReqRsp;
+    ZPS_tsNwkNlmeSyncCfm sNlmeSyncCfm;
+
+    DBG_vPrintf(TRACE_BDB,"BDB: Survey Ch Mask 0x%08x \n", u32ScanChannels);
+
+    sNlmeReqRsp.u8Type = ZPS_NWK_NLME_REQ_ED_SCAN;
+    sNlmeReqRsp.u8ParamLength = sizeof(ZPS_tsNwkNlmeReqEdScan);
+    sNlmeReqRsp.u16Pad = 0;
+    sNlmeReqRsp.uParam.sReqEdScan.sScan.u32ScanChannels = u32ScanChannels;
+    sNlmeReqRsp.uParam.sReqEdScan.sScan.u8ScanDuration = sBDB.sAttrib.u8bdbScanDuration;
+
+    eNF_State = E_NF_WAIT_SURVEY_ED_SCAN;
+    ZPS_vNwkHandleNlmeReqRsp(ZPS_pvAplZdoGetNwkHandle(), &sNlmeReqRsp, &sNlmeSyncCfm);
+
+    switch(sNlmeSyncCfm.u8Status)
+    {
+        case ZPS_NWK_NLME_CFM_DEFERRED:
+            /* Results come with ZPS_EVENT_NWK_ED_SCAN */
+            break;
+        case ZPS_NWK_NLME_CFM_OK:
+            vNfSurveyEdScanDone(&sNlmeSyncCfm.uParam.sCfmEdScan);
+            break;
+        default:
+            DBG_vPrintf(TRACE_BDB,"BDB: ED scan failed %d !\n", sNlmeSyncCfm.u8Status);
+            vNfSurveyEdScanDone(NULL);
+            break;
+    }
+}
+
+/****************************************************************************
+ *
+ * NAME: vNfSurveyEdScanDone
+ *
+ * DESCRIPTION:
+ *  Stores the ED scan levels, one per scanned channel in ascending channel
+ *  order, and starts the active scan of the channel set.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *                  psEdScan            ED scan confirm, NULL if it failed
+ *
+ * RETURNS:
+ *  void
+ *
+ ****************************************************************************/
+PRIVATE void vNfSurveyEdScanDone(ZPS_tsNwkNlmeCfmEdScan *psEdScan)
+{
+    ZPS_teStatus eStatus;
+    uint8 u8Channel, u8Result = 0;
+
+    for(u8Channel = BDB_CHANNEL_MIN; u8Channel <= BDB_CHANNEL_MAX; u8Channel++)
+    {
+        if(u32ScanChannels & (1UL << u8Channel))
+        {
+            sNfChannelSurvey.au8Energy[u8Channel - BDB_CHANNEL_MIN] = 0;
+            if((psEdScan != NULL) && (psEdScan->u8Status == MAC_ENUM_SUCCESS) &&
+               (u8Result < psEdScan->u8ResultListSize))
+            {
+                sNfChannelSurvey.au8Energy[u8Channel - BDB_CHANNEL_MIN] = psEdScan->au8EnergyDetect[u8Result++];
+            }
+        }
+    }
+
+    eNF_State = E_NF_WAIT_SURVEY_DISCOVERY;
+    ZPS_vNwkNibClearDiscoveryNT(ZPS_pvAplZdoGetNwkHandle());
+    eStatus = ZPS_eAplZdoDiscoverNetworks(u32ScanChannels);
+    if(ZPS_E_SUCCESS != eStatus)
+    {
+        /* Choose on energy alone */
+        DBG_vPrintf(TRACE_BDB,"BDB: ZPS_eAplZdoDiscoverNetworks failed %04x !\n", eStatus);
+        vNfSurveyFormNwk();
+    }
+}
+
+/****************************************************************************
+ *
+ * NAME: vNfSurveyFormNwk
+ *
+ * DESCRIPTION:
+ *  Counts the networks heard on each surveyed channel, picks the channel
+ *  with the lowest score and forms the network on it. A centralized network
+ *  is formed with the APS channel mask narrowed to that channel. A
+ *  distributed network reuses the survey discovery to choose unique ids.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *
+ * RETURNS:
+ *  void
+ *
+ ****************************************************************************/
+PRIVATE void vNfSurveyFormNwk(void)
+{
+    ZPS_tsNwkNetworkDescr *psNwkDescr;
+    uint8 u8NumOfNwks = 0;
+    uint8 u8Channel, u8Best = 0;
+    uint16 u16Score, u16BestScore = 0xFFFF;
+    uint8 i;
+
+    for(u8Channel = BDB_CHANNEL_MIN; u8Channel <= BDB_CHANNEL_MAX; u8Channel++)
+    {
+        if(u32ScanChannels & (1UL << u8Channel))
+        {
+            sNfChannelSurvey.au8PanCount[u8Channel - BDB_CHANNEL_MIN] = 0;
+        }
+    }
+    sNfChannelSurvey.u32Channels |= u32ScanChannels;
+
+    /* One descriptor per network and channel */
+    psNwkDescr = ZPS_psGetNetworkDescriptors(&u8NumOfNwks);
+    for(i = 0; (psNwkDescr != NULL) && (i < u8NumOfNwks); i++)
+    {
+        u8Channel = psNwkDescr[i].u8LogicalChan;
+        if((u8Channel >= BDB_CHANNEL_MIN) && (u8Channel <= BDB_CHANNEL_MAX) &&
+           (sNfChannelSurvey.au8PanCount[u8Channel - BDB_CHANNEL_MIN] < 0xFF))
+        {
+            sNfChannelSurvey.au8PanCount[u8Channel - BDB_CHANNEL_MIN]++;
+        }
+    }
+
+    /* Lowest score wins, the lower channel on a tie */
+    for(u8Channel = BDB_CHANNEL_MIN; u8Channel <= BDB_CHANNEL_MAX; u8Channel++)
+    {
+        if(u32ScanChannels & (1UL << u8Channel))
+        {
+            u16Score = BDB_u16NfChannelScore(u8Channel);
+            DBG_vPrintf(TRACE_BDB,"BDB: Ch %d energy %d nwks %d score %d\n", u8Channel,
+                        sNfChannelSurvey.au8Energy[u8Channel - BDB_CHANNEL_MIN],
+                        sNfChannelSurvey.au8PanCount[u8Channel - BDB_CHANNEL_MIN], u16Score);
+            if(u16Score < u16BestScore)
+            {
+                u16BestScore = u16Score;
+                u8Best = u8Channel;
+            }
+        }
+    }
+
+    if(u8Best == 0)
+    {
+        /* Empty channel set */
+        vNfRetryNwkFormation();
+        return;
+    }
+
+    if(ZPS_ZDO_DEVICE_COORD == ZPS_eAplZdoGetDeviceType())
+    {
+        DBG_vPrintf(TRACE_BDB,"BDB: Forming Centralized Nwk on Ch %d \n", u8Best);
+        ZPS_eAplAibSetApsChannelMask(1UL << u8Best);
+        eNF_State = E_NF_WAIT_FORM_CENTRALIZED;
+        BDB_vNfFormCentralizedNwk();
+    }
+    else //(ZPS_ZDO_DEVICE_ROUTER == ZPS_eAplZdoGetDeviceType())
+    {
+        DBG_vPrintf(TRACE_BDB,"BDB: Forming Distributed Nwk on Ch %d \n", u8Best);
+        vNfInitStartParams(u8Best);
+        eNF_State = E_NF_WAIT_FORM_DISTRIBUTED;
+        vNfFormDistributedNwk();
+    }
+}
+#endif
+
 #if (BDB_SET_DEFAULT_TC_POLICY == TRUE)
 /****************************************************************************
  *
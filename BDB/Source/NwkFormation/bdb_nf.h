@@ -50,15 +50,32 @@ typedef enum
     E_NF_IDLE,
     E_NF_WAIT_FORM_CENTRALIZED,
     E_NF_WAIT_DISCOVERY,
-    E_NF_WAIT_FORM_DISTRIBUTED
+    E_NF_WAIT_FORM_DISTRIBUTED,
+#ifdef BDB_NF_CHANNEL_SURVEY
+    E_NF_WAIT_SURVEY_ED_SCAN,
+    E_NF_WAIT_SURVEY_DISCOVERY
+#endif
 }teNF_State;
 
+#ifdef BDB_NF_CHANNEL_SURVEY
+typedef struct
+{
+    uint32 u32Channels;                                         /* Channels with results */
+    uint8  au8Energy[BDB_CHANNEL_MAX - BDB_CHANNEL_MIN + 1];    /* ED scan level */
+    uint8  au8PanCount[BDB_CHANNEL_MAX - BDB_CHANNEL_MIN + 1];  /* Networks heard in the active scan */
+} BDB_tsNfChannelSurvey;
+#endif
+
 /****************************************************************************/
 /***        Exported Functions                                            ***/
 /****************************************************************************/
 PUBLIC BDB_teStatus BDB_eNfStartNwkFormation(void);
 PUBLIC void BDB_vNfStateMachine(BDB_tsZpsAfEvent *psZpsAfEvent);
 PUBLIC void BDB_vNfFormCentralizedNwk(void);
+#ifdef BDB_NF_CHANNEL_SURVEY
+PUBLIC BDB_tsNfChannelSurvey *BDB_psNfGetChannelSurvey(void);
+PUBLIC uint16 BDB_u16NfChannelScore(uint8 u8Channel);
+#endif
 
 /****************************************************************************/
 /***        Exported Variables                                            ***/
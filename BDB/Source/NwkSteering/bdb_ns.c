@@ -36,16 +36,42 @@
 #include "bdb_start.h"
 #include "dbg.h"
 #include "pdum_gen.h"
+#if (defined BDB_NS_RANK_JOIN_CANDIDATES) || (defined BDB_NS_SCAN_PLANNER)
+#include "zps_nwk_nib.h"
+#endif
 #include <string.h>
 #include <stdlib.h>
 
 /****************************************************************************/
 /***        Macro Definitions                                             ***/
 /****************************************************************************/
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+/* Join candidate score weights; a parent with room for this device type
+ * always outranks one without, then link quality, then shallower depth */
+#define BDB_NS_SCORE_CAPACITY                   (512)
+#define BDB_NS_SCORE_DEPTH_STEP                 (8)
+#define BDB_NS_SCORE_MAX_DEPTH                  (15)
+#endif
 
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+typedef struct
+{
+    uint16 u16Score;        /* Best parent score on this network */
+    uint8  u8UpdateId;      /* Newest nwkUpdateId heard on this network */
+    uint8  u8DescrIndex;    /* Index into ZPS_psGetNetworkDescriptors() */
+    bool_t bDemoted;        /* Failed to join recently */
+} tsNsJoinCandidate;
+
+typedef struct
+{
+    uint64 u64ExtPanId;
+    uint8  u8LogicalChan;
+    uint8  u8RunsLeft;      /* 0 = free entry */
+} tsNsJoinBlacklistEntry;
+#endif
 
 /****************************************************************************/
 /***        Local Function Prototypes                                     ***/
@@ -61,6 +87,18 @@ PRIVATE void vNsTclkResendVerKey(void);
 PRIVATE void vNsLeaveNwk(void);
 PRIVATE void vNsTerminateNwkSteering(void);
 PRIVATE void vNsSendPermitJoin(void);
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+PRIVATE void vNsRankJoinCandidates(ZPS_tsNwkNetworkDescr *pNwkDescr, uint8 u8NumOfNwks);
+PRIVATE void vNsScoreJoinCandidate(ZPS_tsNwkNetworkDescr *psNwkDescr, tsNsJoinCandidate *psCandidate);
+PRIVATE bool_t bNsJoinCandidateBetter(tsNsJoinCandidate *psCandidate, tsNsJoinCandidate *psOther);
+PRIVATE tsNsJoinBlacklistEntry *psNsFindBlacklistEntry(uint64 u64ExtPanId, uint8 u8LogicalChan);
+PRIVATE void vNsBlacklistJoinCandidate(uint64 u64ExtPanId, uint8 u8LogicalChan);
+PRIVATE void vNsAgeJoinBlacklist(void);
+#endif
+#ifdef BDB_NS_SCAN_PLANNER
+PRIVATE uint32 u32NsPlanScanRequest(void);
+PRIVATE bool_t bNsScanPlanAccept(void);
+#endif
 
 /****************************************************************************/
 /***        Exported Variables                                            ***/
@@ -74,6 +112,19 @@ PUBLIC uint8 u8TimerBdbNs;
 static bool_t              bDoPrimaryScan;  //vDoPrimaryScan
 static uint32              u32ScanChannels; //vScanChannels
 static uint8               u8ScanChannel;
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+static tsNsJoinCandidate      asNsJoinCandidates[ZPS_NWK_MAX_DISC_NWK_DESCRS];
+static uint8                  u8NsNumJoinCandidates;
+static tsNsJoinBlacklistEntry asNsJoinBlacklist[BDB_NS_JOIN_BLACKLIST_SIZE];
+static uint64                 u64NsJoinExtPanId;    /* Network of the current join attempt */
+static uint8                  u8NsJoinLogicalChan;
+#endif
+#ifdef BDB_NS_SCAN_PLANNER
+static uint8               au8NsChannelHits[BDB_CHANNEL_MAX - BDB_CHANNEL_MIN + 1]; /* Discoveries with joinable networks */
+static uint32              u32NsScanPending;    /* Channels of the set not requested yet */
+static uint32              u32NsScanCarry;      /* Channels with weak networks to scan again */
+static uint32              u32NsScanHitCounted; /* Channels already counted in this run */
+#endif
 
 /****************************************************************************/
 /***        Exported Functions                                            ***/
@@ -187,6 +238,14 @@ PUBLIC BDB_teStatus BDB_eNsStartNwkSteering(void)
         u32ScanChannels = sBDB.sAttrib.u32bdbPrimaryChannelSet;
         u8ScanChannel = BDB_CHANNEL_MIN;
         bAssociationJoin = FALSE;
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+        vNsAgeJoinBlacklist();
+#endif
+#ifdef BDB_NS_SCAN_PLANNER
+        u32NsScanPending = u32ScanChannels;
+        u32NsScanCarry = 0;
+        u32NsScanHitCounted = 0;
+#endif
         vNsDiscoverNwk();
         return BDB_E_SUCCESS;
     }
@@ -229,6 +288,14 @@ PUBLIC void BDB_vNsStateMachine(BDB_tsZpsAfEvent *psZpsAfEvent)
                                  suitable network is application specific
 
                                  Trying all but must have been filtered through beacon filtering. */
+#ifdef BDB_NS_SCAN_PLANNER
+                        if(!bNsScanPlanAccept())
+                        {
+                            /* Only weak networks so far, scan them again with the next channels */
+                            vNsDiscoverNwk();
+                            break;
+                        }
+#endif
                         eNS_State = E_NS_WAIT_JOIN;
                         vNsTryNwkJoin(TRUE, &(psZpsAfEvent->sStackEvent.uEvent.sNwkDiscoveryEvent));
                     }
@@ -393,6 +460,10 @@ PUBLIC void BDB_vNsStateMachine(BDB_tsZpsAfEvent *psZpsAfEvent)
                     {
                         DBG_vPrintf(TRACE_BDB,"ZPS_EVENT_NWK_LEAVE_CONFIRM status %d \n",
                                                psZpsAfEvent->sStackEvent.uEvent.sNwkLeaveConfirmEvent.eStatus);
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+                        /* Joined but the TC link key exchange failed */
+                        vNsBlacklistJoinCandidate(u64NsJoinExtPanId, u8NsJoinLogicalChan);
+#endif
                         sBDB.sAttrib.ebdbCommissioningStatus = E_BDB_COMMISSIONING_STATUS_TCLK_EX_FAILURE;
                         sBDB.sAttrib.bbdbNodeIsOnANetwork = FALSE;
                         eNS_State = E_NS_IDLE;
@@ -514,7 +585,8 @@ PUBLIC void BDB_vNsTimerCb(void *pvParam)
  *
  * DESCRIPTION:
  * Attempts discovery on each of the channels, if unsuccessful initiate
- * discovery on next channel
+ * discovery on next channel. With BDB_NS_SCAN_PLANNER, each request covers
+ * a group of channels chosen by u32NsPlanScanRequest().
  *
  * RETURNS:
  * void
@@ -522,6 +594,10 @@ PUBLIC void BDB_vNsTimerCb(void *pvParam)
  ****************************************************************************/
 PRIVATE void vNsDiscoverNwk()
 {
+#ifdef BDB_NS_SCAN_PLANNER
+    uint32 u32Request;
+#endif
+
     if((!u32ScanChannels) || (u8ScanChannel > BDB_CHANNEL_MAX))
     {
         /* 8.3.12 If vDoPrimaryScan is equal to FALSE or bdbSecondaryChannelSet is equal to
@@ -538,6 +614,10 @@ PRIVATE void vNsDiscoverNwk()
             bDoPrimaryScan = FALSE;
             u32ScanChannels = sBDB.sAttrib.u32bdbSecondaryChannelSet;
             u8ScanChannel = BDB_CHANNEL_MIN;
+#ifdef BDB_NS_SCAN_PLANNER
+            u32NsScanPending = u32ScanChannels;
+            u32NsScanCarry = 0;
+#endif
             vNsDiscoverNwk();
             return;
         }
@@ -549,6 +629,26 @@ PRIVATE void vNsDiscoverNwk()
 
     /* 8.3-2 The node SHALL perform a channel scan in order to discover which networks
              are available within its radio range on a set of channels. */
+#ifdef BDB_NS_SCAN_PLANNER
+    u32Request = u32NsPlanScanRequest();
+    if(!u32NsScanPending)
+    {
+        /* Last request of the set, the scan channel checks see the set as done */
+        u8ScanChannel = BDB_CHANNEL_MAX + 1;
+    }
+    if(u32Request)
+    {
+        BDB_vSetAssociationFilter();
+        ZPS_vNwkNibClearDiscoveryNT(ZPS_pvAplZdoGetNwkHandle());
+        eNS_State = E_NS_WAIT_DISCOVERY;
+        if(ZPS_E_SUCCESS == ZPS_eAplZdoDiscoverNetworks(u32Request))
+        {
+            DBG_vPrintf(TRACE_BDB,"BDB: Disc on Ch Mask 0x%08x from 0x%08x\n", u32Request, u32ScanChannels);
+            /* Rest of the process starts after DicsoveryComplete event. */
+            return;
+        }
+    }
+#else
     while(u8ScanChannel <= BDB_CHANNEL_MAX)
     {
         if(u32ScanChannels & (1<<u8ScanChannel))
@@ -570,11 +670,134 @@ PRIVATE void vNsDiscoverNwk()
         }
         u8ScanChannel++;
    }
+#endif
 
     vNsDiscoverNwk();
     return;
 }
 
+#ifdef BDB_NS_SCAN_PLANNER
+/****************************************************************************
+ *
+ * NAME: u32NsPlanScanRequest
+ *
+ * DESCRIPTION:
+ *  Plans the next discovery request: up to BDB_NS_SCAN_CHANNELS_PER_REQUEST
+ *  channels of the set not requested yet, those with the most earlier hits
+ *  first and then in channel order, plus the channels carried over with weak
+ *  networks from the previous request.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *
+ * RETURNS:
+ *  Channel mask of the request, 0 if nothing is left to scan
+ *
+ ****************************************************************************/
+PRIVATE uint32 u32NsPlanScanRequest(void)
+{
+    uint32 u32Request = u32NsScanCarry;
+    uint8 u8Channel, u8Best, u8Count;
+
+    u32NsScanCarry = 0;
+    for(u8Count = 0; (u8Count < BDB_NS_SCAN_CHANNELS_PER_REQUEST) && u32NsScanPending; u8Count++)
+    {
+        u8Best = 0;
+        for(u8Channel = BDB_CHANNEL_MIN; u8Channel <= BDB_CHANNEL_MAX; u8Channel++)
+        {
+            if((u32NsScanPending & (1UL << u8Channel)) &&
+               ((u8Best == 0) ||
+                (au8NsChannelHits[u8Channel - BDB_CHANNEL_MIN] > au8NsChannelHits[u8Best - BDB_CHANNEL_MIN])))
+            {
+                u8Best = u8Channel;
+            }
+        }
+        if(u8Best == 0)
+        {
+            /* Only channels outside BDB_CHANNEL_MIN..MAX left */
+            u32NsScanPending = 0;
+            break;
+        }
+        u32NsScanPending &= ~(1UL << u8Best);
+        u32Request |= (1UL << u8Best);
+    }
+    return u32Request;
+}
+
+/****************************************************************************
+ *
+ * NAME: bNsScanPlanAccept
+ *
+ * DESCRIPTION:
+ *  Counts the channels with joinable networks in the completed discovery
+ *  as hits, and decides whether to try joining now. Joining goes ahead when
+ *  nothing joinable was found, when the set is fully scanned, or when a
+ *  joinable network has a parent with room for this device and a link
+ *  quality of at least BDB_NS_SCAN_GOOD_LQI. Otherwise the channels with
+ *  weak networks are carried into the next request so they are ranked
+ *  together with the networks found there.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *
+ * RETURNS:
+ *  TRUE to try joining the discovered networks, FALSE to keep scanning
+ *
+ ****************************************************************************/
+PRIVATE bool_t bNsScanPlanAccept(void)
+{
+    ZPS_tsNwkNetworkDescr *pNwkDescr;
+    ZPS_tsNwkNib *psNib = ZPS_psNwkNibGetHandle(ZPS_pvAplZdoGetNwkHandle());
+    ZPS_tsNwkDiscNtEntry *psEntry;
+    uint64 u64UseEpid = ZPS_u64AplAibGetApsUseExtendedPanId();
+    bool_t bRouter = (ZPS_ZDO_DEVICE_ROUTER == ZPS_eAplZdoGetDeviceType());
+    uint32 u32Joinable = 0;
+    uint8 u8NumOfNwks, u8Channel, i;
+
+    pNwkDescr = ZPS_psGetNetworkDescriptors(&u8NumOfNwks);
+    for(i = 0; i < u8NumOfNwks; i++)
+    {
+        u8Channel = pNwkDescr[i].u8LogicalChan;
+        if((pNwkDescr[i].u8PermitJoining) &&
+           ((0 == u64UseEpid) || (pNwkDescr[i].u64ExtPanId == u64UseEpid)) &&
+           (u8Channel >= BDB_CHANNEL_MIN) && (u8Channel <= BDB_CHANNEL_MAX))
+        {
+            u32Joinable |= (1UL << u8Channel);
+        }
+    }
+
+    for(u8Channel = BDB_CHANNEL_MIN; u8Channel <= BDB_CHANNEL_MAX; u8Channel++)
+    {
+        if((u32Joinable & ~u32NsScanHitCounted & (1UL << u8Channel)) &&
+           (au8NsChannelHits[u8Channel - BDB_CHANNEL_MIN] < 0xFF))
+        {
+            au8NsChannelHits[u8Channel - BDB_CHANNEL_MIN]++;
+        }
+    }
+    u32NsScanHitCounted |= u32Joinable;
+
+    if((!u32Joinable) || (!u32NsScanPending))
+    {
+        return TRUE;
+    }
+
+    for(i = 0; i < psNib->sTblSize.u8NtDisc; i++)
+    {
+        psEntry = &psNib->sTbl.psNtDisc[i];
+        if((psEntry->uAncAttrs.bfBitfields.u1Used) &&
+           (psEntry->uAncAttrs.bfBitfields.u1JoinPermit) &&
+           (psEntry->u8LinkQuality >= BDB_NS_SCAN_GOOD_LQI) &&
+           ((0 == u64UseEpid) || (psEntry->u64ExtPanId == u64UseEpid)) &&
+           (bRouter ? psEntry->uAncAttrs.bfBitfields.u1ZrCapacity : psEntry->uAncAttrs.bfBitfields.u1ZedCapacity))
+        {
+            return TRUE;
+        }
+    }
+
+    DBG_vPrintf(TRACE_BDB,"BDB: Weak nwks on Ch Mask 0x%08x, keep scanning\n", u32Joinable);
+    u32NsScanCarry = u32Joinable;
+    return FALSE;
+}
+#endif
+
 /****************************************************************************
  *
  * NAME: vNsTerminateNwkSteering
@@ -602,7 +825,8 @@ PRIVATE void vNsTerminateNwkSteering()
  *
  * DESCRIPTION:
  * Attempts to join each of the discovered networks, if unsuccessful initiate
- * discovery on next channel
+ * discovery on next channel. With BDB_NS_RANK_JOIN_CANDIDATES the networks
+ * are tried in ranked order rather than discovery order.
  *
  * RETURNS:
  * void
@@ -615,6 +839,7 @@ PRIVATE void vNsTryNwkJoin(bool_t bStartWithIndex0,
     static uint8           u8RecSameNwkRetryAttempts = 0;
     static uint8           u8NumOfNwks;
     ZPS_tsNwkNetworkDescr  *pNwkDescr;
+    ZPS_tsNwkNetworkDescr  *psNwkCandidate;
     ZPS_teStatus           eStatus = ZPS_E_SUCCESS;
 
     if( bStartWithIndex0 )
@@ -622,13 +847,25 @@ PRIVATE void vNsTryNwkJoin(bool_t bStartWithIndex0,
         u8NwkIndex = 0;
     }
     pNwkDescr = ZPS_psGetNetworkDescriptors( &u8NumOfNwks );
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+    if( bStartWithIndex0 )
+    {
+        vNsRankJoinCandidates(pNwkDescr, u8NumOfNwks);
+    }
+    u8NumOfNwks = u8NsNumJoinCandidates;
+#endif
 
     DBG_vPrintf(TRACE_BDB,"BDB: vNsTryNwkJoin - try %d index %d of %d Nwks \n", u8RecSameNwkRetryAttempts, u8NwkIndex, u8NumOfNwks);
     while(u8NwkIndex < u8NumOfNwks)
     {
-        if((pNwkDescr[u8NwkIndex].u8PermitJoining) && \
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+        psNwkCandidate = &pNwkDescr[asNsJoinCandidates[u8NwkIndex].u8DescrIndex];
+#else
+        psNwkCandidate = &pNwkDescr[u8NwkIndex];
+#endif
+        if((psNwkCandidate->u8PermitJoining) && \
            ((0 == ZPS_u64AplAibGetApsUseExtendedPanId()) ||\
-            (pNwkDescr[u8NwkIndex].u64ExtPanId == ZPS_u64AplAibGetApsUseExtendedPanId())))
+            (psNwkCandidate->u64ExtPanId == ZPS_u64AplAibGetApsUseExtendedPanId())))
         {
             /* 8.3-6 The node SHALL attempt to join the network found using MAC association. */
 
@@ -638,16 +875,20 @@ PRIVATE void vNsTryNwkJoin(bool_t bStartWithIndex0,
                      NetworkRetryAttempts times in succession is RECOMMENDED)... */
             u8RecSameNwkRetryAttempts++;
 
-            vNsTryNwkJoinAppCb(&pNwkDescr[u8NwkIndex]);
+            vNsTryNwkJoinAppCb(psNwkCandidate);
 
             if( ( u8RecSameNwkRetryAttempts < BDBC_REC_SAME_NETWORK_RETRY_ATTEMPTS ) && \
                ( u8RecSameNwkRetryAttempts < BDBC_MAX_SAME_NETWORK_RETRY_ATTEMPTS ) )
             {
                 DBG_vPrintf(TRACE_BDB, "BDB: Try To join %016llx on Ch %d\n",
-                                       pNwkDescr[u8NwkIndex].u64ExtPanId,
-                                       pNwkDescr[u8NwkIndex].u8LogicalChan);
+                                       psNwkCandidate->u64ExtPanId,
+                                       psNwkCandidate->u8LogicalChan);
                 eNS_State = E_NS_WAIT_JOIN;
-                eStatus = ZPS_eAplZdoJoinNetwork(&pNwkDescr[u8NwkIndex]);
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+                u64NsJoinExtPanId = psNwkCandidate->u64ExtPanId;
+                u8NsJoinLogicalChan = psNwkCandidate->u8LogicalChan;
+#endif
+                eStatus = ZPS_eAplZdoJoinNetwork(psNwkCandidate);
                 if(eStatus == ZPS_E_SUCCESS)
                 {
                     /* Wait for join complete */
@@ -660,6 +901,9 @@ PRIVATE void vNsTryNwkJoin(bool_t bStartWithIndex0,
             }
             else
             {
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+                vNsBlacklistJoinCandidate(psNwkCandidate->u64ExtPanId, psNwkCandidate->u8LogicalChan);
+#endif
                 u8RecSameNwkRetryAttempts = 0;
                 u8NwkIndex++;
             }
@@ -691,6 +935,254 @@ PRIVATE void vNsTryNwkJoin(bool_t bStartWithIndex0,
     vNsDiscoverNwk();
 }
 
+#ifdef BDB_NS_RANK_JOIN_CANDIDATES
+/****************************************************************************
+ *
+ * NAME: vNsRankJoinCandidates
+ *
+ * DESCRIPTION:
+ *  Builds asNsJoinCandidates from the discovered networks that are open for
+ *  joining and match apsUseExtendedPanId, best candidate first. Networks with
+ *  equal rank keep their discovery order.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *                  pNwkDescr       R   Discovered network descriptors
+ *                  u8NumOfNwks     R   Number of descriptors
+ *
+ * RETURNS:
+ *  void
+ *
+ ****************************************************************************/
+PRIVATE void vNsRankJoinCandidates(ZPS_tsNwkNetworkDescr *pNwkDescr, uint8 u8NumOfNwks)
+{
+    tsNsJoinCandidate sCandidate;
+    uint8 i, j;
+
+    u8NsNumJoinCandidates = 0;
+    for(i = 0; (i < u8NumOfNwks) && (u8NsNumJoinCandidates < ZPS_NWK_MAX_DISC_NWK_DESCRS); i++)
+    {
+        if((!pNwkDescr[i].u8PermitJoining) ||
+           ((0 != ZPS_u64AplAibGetApsUseExtendedPanId()) &&
+            (pNwkDescr[i].u64ExtPanId != ZPS_u64AplAibGetApsUseExtendedPanId())))
+        {
+            continue;
+        }
+
+        sCandidate.u8DescrIndex = i;
+        vNsScoreJoinCandidate(&pNwkDescr[i], &sCandidate);
+
+        /* Insertion sort, the list is at most ZPS_NWK_MAX_DISC_NWK_DESCRS long */
+        j = u8NsNumJoinCandidates;
+        while((j > 0) && bNsJoinCandidateBetter(&sCandidate, &asNsJoinCandidates[j - 1]))
+        {
+            asNsJoinCandidates[j] = asNsJoinCandidates[j - 1];
+            j--;
+        }
+        asNsJoinCandidates[j] = sCandidate;
+        u8NsNumJoinCandidates++;
+
+        DBG_vPrintf(TRACE_BDB, "BDB: Candidate %016llx Ch %d score %d upd %d%s\n",
+                               pNwkDescr[i].u64ExtPanId, pNwkDescr[i].u8LogicalChan,
+                               sCandidate.u16Score, sCandidate.u8UpdateId,
+                               sCandidate.bDemoted ? " demoted" : "");
+    }
+}
+
+/****************************************************************************
+ *
+ * NAME: vNsScoreJoinCandidate
+ *
+ * DESCRIPTION:
+ *  Scores a discovered network from the potential parents recorded for it
+ *  in the discovery neighbour table: capacity for this device type, link
+ *  quality and depth of the best parent, and the newest nwkUpdateId heard.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *                  psNwkDescr      R   Network descriptor to score
+ *                  psCandidate     W   Score, update id and demotion flag
+ *
+ * RETURNS:
+ *  void
+ *
+ ****************************************************************************/
+PRIVATE void vNsScoreJoinCandidate(ZPS_tsNwkNetworkDescr *psNwkDescr, tsNsJoinCandidate *psCandidate)
+{
+    ZPS_tsNwkNib *psNib = ZPS_psNwkNibGetHandle(ZPS_pvAplZdoGetNwkHandle());
+    ZPS_tsNwkDiscNtEntry *psEntry;
+    bool_t bRouter = (ZPS_ZDO_DEVICE_ROUTER == ZPS_eAplZdoGetDeviceType());
+    bool_t bFirst = TRUE;
+    uint16 u16Score;
+    uint8 i;
+
+    psCandidate->u16Score = 0;
+    psCandidate->u8UpdateId = 0;
+    psCandidate->bDemoted = (NULL != psNsFindBlacklistEntry(psNwkDescr->u64ExtPanId, psNwkDescr->u8LogicalChan));
+
+    for(i = 0; i < psNib->sTblSize.u8NtDisc; i++)
+    {
+        psEntry = &psNib->sTbl.psNtDisc[i];
+        if((!psEntry->uAncAttrs.bfBitfields.u1Used) ||
+           (!psEntry->uAncAttrs.bfBitfields.u1JoinPermit) ||
+           (psEntry->u64ExtPanId != psNwkDescr->u64ExtPanId) ||
+           (psEntry->u8LogicalChan != psNwkDescr->u8LogicalChan))
+        {
+            continue;
+        }
+
+        u16Score = psEntry->u8LinkQuality +
+                   (BDB_NS_SCORE_MAX_DEPTH - psEntry->uAncAttrs.bfBitfields.u4Depth) * BDB_NS_SCORE_DEPTH_STEP;
+        if(bRouter ? psEntry->uAncAttrs.bfBitfields.u1ZrCapacity : psEntry->uAncAttrs.bfBitfields.u1ZedCapacity)
+        {
+            u16Score += BDB_NS_SCORE_CAPACITY;
+        }
+        if(u16Score > psCandidate->u16Score)
+        {
+            psCandidate->u16Score = u16Score;
+        }
+
+        /* nwkUpdateId wraps, so compare as a sequence number */
+        if(bFirst || ((int8)(psEntry->u8NwkUpdateId - psCandidate->u8UpdateId) > 0))
+        {
+            psCandidate->u8UpdateId = psEntry->u8NwkUpdateId;
+            bFirst = FALSE;
+        }
+    }
+
+    /* No parent recorded, fall back to the aggregated descriptor flags */
+    if(bFirst && (bRouter ? psNwkDescr->u8RouterCapacity : psNwkDescr->u8EndDeviceCapacity))
+    {
+        psCandidate->u16Score = BDB_NS_SCORE_CAPACITY;
+    }
+}
+
+/****************************************************************************
+ *
+ * NAME: bNsJoinCandidateBetter
+ *
+ * DESCRIPTION:
+ *  Orders join candidates: networks not demoted first, then by score, then
+ *  by the newer nwkUpdateId.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *                  psCandidate     R   Candidate being placed
+ *                  psOther         R   Candidate already in the list
+ *
+ * RETURNS:
+ *  TRUE if psCandidate should be tried before psOther
+ *
+ ****************************************************************************/
+PRIVATE bool_t bNsJoinCandidateBetter(tsNsJoinCandidate *psCandidate, tsNsJoinCandidate *psOther)
+{
+    if(psCandidate->bDemoted != psOther->bDemoted)
+    {
+        return !psCandidate->bDemoted;
+    }
+    if(psCandidate->u16Score != psOther->u16Score)
+    {
+        return (psCandidate->u16Score > psOther->u16Score);
+    }
+    return ((int8)(psCandidate->u8UpdateId - psOther->u8UpdateId) > 0);
+}
+
+/****************************************************************************
+ *
+ * NAME: psNsFindBlacklistEntry
+ *
+ * DESCRIPTION:
+ *  Looks up a network in the join blacklist.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *                  u64ExtPanId     R   Extended PAN id of the network
+ *                  u8LogicalChan   R   Channel the network was found on
+ *
+ * RETURNS:
+ *  Blacklist entry, NULL if the network has not failed recently
+ *
+ ****************************************************************************/
+PRIVATE tsNsJoinBlacklistEntry *psNsFindBlacklistEntry(uint64 u64ExtPanId, uint8 u8LogicalChan)
+{
+    uint8 i;
+
+    for(i = 0; i < BDB_NS_JOIN_BLACKLIST_SIZE; i++)
+    {
+        if((asNsJoinBlacklist[i].u8RunsLeft != 0) &&
+           (asNsJoinBlacklist[i].u64ExtPanId == u64ExtPanId) &&
+           (asNsJoinBlacklist[i].u8LogicalChan == u8LogicalChan))
+        {
+            return &asNsJoinBlacklist[i];
+        }
+    }
+    return NULL;
+}
+
+/****************************************************************************
+ *
+ * NAME: vNsBlacklistJoinCandidate
+ *
+ * DESCRIPTION:
+ *  Demotes a network that failed to join for the next
+ *  BDB_NS_JOIN_BLACKLIST_RUNS steering runs. When the blacklist is full the
+ *  entry closest to expiry is reused. The blacklist is not persisted, it
+ *  only covers failures since the last reset.
+ *
+ * PARAMETERS:      Name            RW  Usage
+ *                  u64ExtPanId     R   Extended PAN id of the network
+ *                  u8LogicalChan   R   Channel the network was found on
+ *
+ * RETURNS:
+ *  void
+ *
+ ****************************************************************************/
+PRIVATE void vNsBlacklistJoinCandidate(uint64 u64ExtPanId, uint8 u8LogicalChan)
+{
+    tsNsJoinBlacklistEntry *psEntry;
+    uint8 i;
+
+    psEntry = psNsFindBlacklistEntry(u64ExtPanId, u8LogicalChan);
+    if(psEntry == NULL)
+    {
+        psEntry = &asNsJoinBlacklist[0];
+        for(i = 1; i < BDB_NS_JOIN_BLACKLIST_SIZE; i++)
+        {
+            if(asNsJoinBlacklist[i].u8RunsLeft < psEntry->u8RunsLeft)
+            {
+                psEntry = &asNsJoinBlacklist[i];
+            }
+        }
+        psEntry->u64ExtPanId = u64ExtPanId;
+        psEntry->u8LogicalChan = u8LogicalChan;
+    }
+
+    /* One extra run as the current run is aged on the next start */
+    psEntry->u8RunsLeft = BDB_NS_JOIN_BLACKLIST_RUNS + 1;
+    DBG_vPrintf(TRACE_BDB, "BDB: Demote %016llx on Ch %d\n", u64ExtPanId, u8LogicalChan);
+}
+
+/****************************************************************************
+ *
+ * NAME: vNsAgeJoinBlacklist
+ *
+ * DESCRIPTION:
+ *  Ages the join blacklist by one steering run.
+ *
+ * RETURNS:
+ *  void
+ *
+ ****************************************************************************/
+PRIVATE void vNsAgeJoinBlacklist(void)
+{
+    uint8 i;
+
+    for(i = 0; i < BDB_NS_JOIN_BLACKLIST_SIZE; i++)
+    {
+        if(asNsJoinBlacklist[i].u8RunsLeft != 0)
+        {
+            asNsJoinBlacklist[i].u8RunsLeft--;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  *
  * NAME: vNsAfterNwkJoin
@@ -729,6 +1221,9 @@ PRIVATE void vNsAfterNwkJoin(void)
 
     /* Copy the network pan id into the aps use pan id after successful join */
     ZPS_eAplAibSetApsUseExtendedPanId(ZPS_u64NwkNibGetEpid( ZPS_pvAplZdoGetNwkHandle()));
+#ifdef BDB_REJOIN_HISTORY
+    BDB_vRejoinHistoryUpdate();
+#endif
 
     eNS_State = E_NS_IDLE;
     sBdbEvent.eEventType = BDB_EVENT_NWK_STEERING_SUCCESS;
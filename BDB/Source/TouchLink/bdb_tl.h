@@ -60,7 +60,13 @@ extern "C" {
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
-
+#if (defined JENNIC_CHIP_FAMILY_JN516x) || (defined JENNIC_CHIP_FAMILY_JN517x)
+/* Software AES-128 decrypt context, round keys expanded once per key */
+typedef struct
+{
+    uint8 au8RoundKey[176];
+}tsECB_DecryptContext;
+#endif
 
 
 /****************************************************************************/
@@ -85,6 +91,11 @@ PUBLIC bool_t BDB_bTlIsKeySupported(uint8 u8KeyIndex);
 PUBLIC uint8 BDB_u8TlGetRandomPrimary(void);
 PUBLIC uint8 BDB_u8TlNewUpdateID(uint8 u8ID1, uint8 u8ID2 );
 #if (defined JENNIC_CHIP_FAMILY_JN516x) || (defined JENNIC_CHIP_FAMILY_JN517x)
+PUBLIC void vECB_DecryptInit(tsECB_DecryptContext *psContext,
+                             uint8* au8Key);
+PUBLIC void vECB_DecryptBlock(const tsECB_DecryptContext *psContext,
+                              uint8* au8InData,
+                              uint8* au8OutData);
 PUBLIC void vECB_Decrypt(uint8* au8Key,
                          uint8* au8InData,
                          uint8* au8OutData);
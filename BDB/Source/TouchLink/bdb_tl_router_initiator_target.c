@@ -49,6 +49,7 @@
 #include "bdb_tl.h"
 #include "app_common.h"
 #include "Log.h"
+#include <string.h>
 /****************************************************************************/
 /***        Macro Definitions                                             ***/
 /****************************************************************************/
@@ -94,6 +95,9 @@
 #define LED1  (1 << 1)
 #define LED2  (1)
 
+/* Touchlink priority request, bit 5 of the ZLL information of a scan response */
+#define TL_PRIORITY_REQUEST     TL_TIME_WINDOW
+
 
 
 
@@ -210,6 +214,14 @@ PRIVATE void vTlHandleNwkUpdateRequest(void * pvNwk,
 
 PUBLIC void BDB_vTlSetGroupAddress(uint16 u16GroupStart, uint8 u8NumGroups);
 PRIVATE bool_t bSearchDiscNt(ZPS_tsNwkNib *psNib, uint64 u64EpId, uint16 u16PanId);
+#ifdef BDB_TL_SCAN_TABLE
+PRIVATE void vTlResetScanTable(void);
+PRIVATE void vTlAddScanResult(ZPS_tsInterPanAddress *psSrcAddr,
+                              tsCLD_ZllCommission_ScanRspCommandPayload *psScanRsp,
+                              uint16 u16AdjustedLqi);
+PRIVATE bool_t bTlScanResultBetter(tsZllScanTarget *psResult, tsZllScanTarget *psOther);
+PRIVATE bool_t bTlSelectNextScanTarget(void);
+#endif
 
 /****************************************************************************/
 /***        Exported Variables                                            ***/
@@ -236,6 +248,11 @@ ZPS_tsInterPanAddress       sDstAddr;
 tsZllScanTarget sScanTarget;
 PRIVATE uint8 au8TempKeyStore[16];
 static tsStartParams sStartParams;
+#ifdef BDB_TL_SCAN_TABLE
+PRIVATE tsZllScanTarget asTlScanTable[BDB_TL_SCAN_TABLE_SIZE];     /* Best target first */
+PRIVATE uint8 u8TlScanTableCount;
+PRIVATE uint8 u8TlScanTableNext;
+#endif
 
 
 /****************************************************************************/
@@ -389,6 +406,9 @@ PUBLIC void BDB_vTlStateMachine( tsBDB_ZCLEvent *psEvent)
             {
                 sCommission.u8Count = 0;
                 sScanTarget.u16LQI = 0;
+#ifdef BDB_TL_SCAN_TABLE
+                vTlResetScanTable();
+#endif
                 ZTIMER_eStart(u8TimerBdbTl, ZTIMER_TIME_MSEC(10));
                 sCommission.eState = E_SCANNING;
                 sCommission.u32TransactionId = RND_u32GetRand(1, 0xffffffff);
@@ -675,6 +695,17 @@ jumpHere:
             {
 #ifdef USE_LOG
                 vLog_Printf(TRACE_COMMISSION,LOG_DEBUG, "Wait Info time out\n");
+#endif
+#ifdef BDB_TL_SCAN_TABLE
+                if (bTlSelectNextScanTarget())
+                {
+                    /* Try the next target from the scan, no need to scan again */
+                    DBG_vPrintf(TRACE_SCAN, "Next scan target %016llx\n", sScanTarget.sScanDetails.sSrcAddr.uAddress.u64Addr);
+                    sCommission.eState = E_SCAN_DONE;
+                    ZTIMER_eStop(u8TimerBdbTl);
+                    ZTIMER_eStart(u8TimerBdbTl, ZTIMER_TIME_MSEC(5));
+                    return;
+                }
 #endif
                 vTlEndCommissioning(pvNwk, E_IDLE, 0);
                 return;
@@ -942,6 +973,9 @@ jumpHere:
                      ZTIMER_eStop(u8TimerBdbTl);
                     sCommission.u8Count = 0;
                     sScanTarget.u16LQI = 0;
+#ifdef BDB_TL_SCAN_TABLE
+                    vTlResetScanTable();
+#endif
                     ZTIMER_eStart(u8TimerBdbTl, ZTIMER_TIME_MSEC(10));
                     sCommission.eState = E_SCANNING;
                     sCommission.u32TransactionId = RND_u32GetRand(1, 0xffffffff);
@@ -1444,6 +1478,10 @@ PRIVATE void vTlSendScanRequest(void *pvNwk, tsCommissionData *psCommission)
     if (psCommission->u32ScanChannels == 0)
     {
         // all done
+#ifdef BDB_TL_SCAN_TABLE
+        /* Best target of the table, none if the table is empty */
+        bTlSelectNextScanTarget();
+#endif
         psCommission->eState = E_SCAN_DONE;
         DBG_vPrintf(TRACE_SCAN_REQ, "Scan Set complete\n");
         ZTIMER_eStart(u8TimerBdbTl, ZTIMER_TIME_MSEC(5));
@@ -1689,6 +1727,9 @@ PRIVATE void vTlHandleScanResponse(void *pvNwk,
         }
     }
 
+#ifdef BDB_TL_SCAN_TABLE
+    vTlAddScanResult(psSrcAddr, psScanRsp, u16AdjustedLqi);
+#else
     if (u16AdjustedLqi > psScanTarget->u16LQI) {
         psScanTarget->u16LQI = u16AdjustedLqi;
         /*
@@ -1703,6 +1744,7 @@ PRIVATE void vTlHandleScanResponse(void *pvNwk,
         psScanTarget->sScanDetails.sSrcAddr = *psSrcAddr;
         psScanTarget->sScanDetails.sScanRspPayload = *psScanRsp;
     }
+#endif
 
 }
 
@@ -2446,6 +2488,139 @@ PRIVATE bool_t bSearchDiscNt(ZPS_tsNwkNib *psNib, uint64 u64EpId, uint16 u16PanI
     return TRUE;
 }
 
+#ifdef BDB_TL_SCAN_TABLE
+/****************************************************************************
+ *
+ * NAME:  vTlResetScanTable
+ *
+ * DESCRIPTION: empties the scan table before a new scan
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PRIVATE void vTlResetScanTable(void)
+{
+    u8TlScanTableCount = 0;
+    u8TlScanTableNext = 0;
+}
+
+/****************************************************************************
+ *
+ * NAME:  vTlAddScanResult
+ *
+ * DESCRIPTION: adds an accepted scan response to the scan table, keeping one
+ * entry per target IEEE address and the table ordered best first. A repeated
+ * response refreshes the stored payload and keeps the best link quality seen.
+ * When the table is full the worst entry is dropped.
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PRIVATE void vTlAddScanResult(ZPS_tsInterPanAddress *psSrcAddr,
+                              tsCLD_ZllCommission_ScanRspCommandPayload *psScanRsp,
+                              uint16 u16AdjustedLqi)
+{
+    tsZllScanTarget sResult;
+    uint8 i;
+
+    sResult.sScanDetails.sSrcAddr = *psSrcAddr;
+    sResult.sScanDetails.sScanRspPayload = *psScanRsp;
+    sResult.u16LQI = u16AdjustedLqi;
+
+    /* Take out an earlier response of the same target */
+    for (i = 0; i < u8TlScanTableCount; i++)
+    {
+        if (asTlScanTable[i].sScanDetails.sSrcAddr.uAddress.u64Addr == psSrcAddr->uAddress.u64Addr)
+        {
+            if (asTlScanTable[i].u16LQI > sResult.u16LQI)
+            {
+                sResult.u16LQI = asTlScanTable[i].u16LQI;
+            }
+            u8TlScanTableCount--;
+            memmove(&asTlScanTable[i], &asTlScanTable[i + 1], (u8TlScanTableCount - i) * sizeof(tsZllScanTarget));
+            break;
+        }
+    }
+
+    /* Find its place, after every better entry */
+    for (i = 0; i < u8TlScanTableCount; i++)
+    {
+        if (bTlScanResultBetter(&sResult, &asTlScanTable[i]))
+        {
+            break;
+        }
+    }
+    if (i >= BDB_TL_SCAN_TABLE_SIZE)
+    {
+#ifdef USE_LOG
+        vLog_Printf(TRACE_SCAN,LOG_DEBUG, "Scan table full, drop %d\n", sResult.u16LQI);
+#endif
+        return;
+    }
+    if (u8TlScanTableCount == BDB_TL_SCAN_TABLE_SIZE)
+    {
+        u8TlScanTableCount--;
+    }
+    memmove(&asTlScanTable[i + 1], &asTlScanTable[i], (u8TlScanTableCount - i) * sizeof(tsZllScanTarget));
+    asTlScanTable[i] = sResult;
+    u8TlScanTableCount++;
+#ifdef USE_LOG
+    vLog_Printf(TRACE_SCAN,LOG_DEBUG, "Accept %d at %d\n", sResult.u16LQI, i);
+#endif
+}
+
+/****************************************************************************
+ *
+ * NAME:  bTlScanResultBetter
+ *
+ * DESCRIPTION: orders scan results: a priority request first, then the higher
+ * corrected link quality, then the lower IEEE address so the order does not
+ * depend on when the responses arrived
+ *
+ * RETURNS:
+ * TRUE if psResult goes before psOther
+ *
+ ****************************************************************************/
+PRIVATE bool_t bTlScanResultBetter(tsZllScanTarget *psResult, tsZllScanTarget *psOther)
+{
+    uint8 u8Priority = psResult->sScanDetails.sScanRspPayload.u8ZllInfo & TL_PRIORITY_REQUEST;
+    uint8 u8OtherPriority = psOther->sScanDetails.sScanRspPayload.u8ZllInfo & TL_PRIORITY_REQUEST;
+
+    if (u8Priority != u8OtherPriority)
+    {
+        return (u8Priority != 0);
+    }
+    if (psResult->u16LQI != psOther->u16LQI)
+    {
+        return (psResult->u16LQI > psOther->u16LQI);
+    }
+    return (psResult->sScanDetails.sSrcAddr.uAddress.u64Addr < psOther->sScanDetails.sSrcAddr.uAddress.u64Addr);
+}
+
+/****************************************************************************
+ *
+ * NAME:  bTlSelectNextScanTarget
+ *
+ * DESCRIPTION: makes the next entry of the scan table the touchlink target
+ *
+ * RETURNS:
+ * TRUE if there was one, FALSE with no target (u16LQI of 0) otherwise
+ *
+ ****************************************************************************/
+PRIVATE bool_t bTlSelectNextScanTarget(void)
+{
+    if (u8TlScanTableNext < u8TlScanTableCount)
+    {
+        sScanTarget = asTlScanTable[u8TlScanTableNext++];
+        return TRUE;
+    }
+    sScanTarget.u16LQI = 0;
+    return FALSE;
+}
+#endif
+
 
 /****************************************************************************/
 /***        END OF FILE                                                   ***/
@@ -11,9 +11,10 @@ recommended for non-classified by the National Institute of Standards
 and Technology(NIST), USA. Now-a-days AES is being used for almost 
 all encryption applications all around the world.
 
-THE MAIN FEATURE OF THIS AES ENCRYPTION PROGRAM IS NOT EFFICIENCY; IT
-IS SIMPLICITY AND READABILITY. THIS SOURCE CODE IS PROVIDED FOR ALL
-TO UNDERSTAND THE AES ALGORITHM.
+Reworked for the TouchLink key transport: only decryption with a 128 bit
+key is kept, the S-boxes and the InvMixColumns products are constant
+lookup tables, and the round keys live in a context owned by the caller,
+so the code holds no global state and is reentrant.
 
 Comments are provided as needed to understand the program. But the 
 user must read some AES documentation to understand the underlying 
@@ -34,60 +35,25 @@ http://en.wikipedia.org/wiki/Advanced_Encryption_Standard
 /****************************************************************************/
 #if (defined JENNIC_CHIP_FAMILY_JN516x) || (defined JENNIC_CHIP_FAMILY_JN517x)
 #include <jendefs.h>
+#include "bdb_api.h"
+#include "bdb_tl.h"
 
-
-// xtime is a macro that finds the product of {02} and the argument to xtime modulo {1b}
-#define xtime(x)   ((x<<1) ^ (((x>>7) & 1) * 0x1b))
-
-// Multiplty is a macro used to multiply numbers in the field GF(2^8)
-#define Multiply(x,y) (((y & 1) * x) ^ ((y>>1 & 1) * xtime(x)) ^ ((y>>2 & 1) * xtime(xtime(x))) ^ ((y>>3 & 1) * xtime(xtime(xtime(x)))) ^ ((y>>4 & 1) * xtime(xtime(xtime(xtime(x))))))
-
-
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
 #define Nb  4
 #define Nk  (128/32)            // 4
 #define Nr (Nk + 6)             // 10
 
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+/* All tables are const so they stay in flash and the code keeps no mutable
+ * state: every call works on the context it is given. */
 
-
-
-// The array that stores the round keys.
-unsigned char RoundKey[240];
-
-// The Key input to the AES Program
-uint8 Key[16];
-
-// in - it is the array that holds the CipherText to be decrypted.
-// out - it is the array that holds the output of the for decryption.
-// state - the array that holds the intermediate results during decryption.
-uint8 in[16], out[16], state[4][4];
-
-PRIVATE uint8 getSBoxInvert(int num)
-{
-uint8 rsbox[256] =
-{ 0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb
-, 0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb
-, 0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e
-, 0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25
-, 0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92
-, 0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84
-, 0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06
-, 0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b
-, 0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73
-, 0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e
-, 0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b
-, 0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4
-, 0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f
-, 0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef
-, 0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61
-, 0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d };
-
-return rsbox[num];
-}
-
-PRIVATE uint8 getSBoxValue(int num)
+/* Forward S-box, used by the key expansion */
+PRIVATE const uint8 au8SBox[256] =
 {
-    uint8 sbox[256] =   {
-    //0     1    2      3     4    5     6     7      8    9     A      B    C     D     E     F
     0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
     0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
     0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
@@ -103,256 +69,277 @@ PRIVATE uint8 getSBoxValue(int num)
     0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
     0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
     0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
-    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16 };
-    return sbox[num];
-}
-
-// The round constant word array, Rcon[i], contains the values given by
-// x to th e power (i-1) being powers of x (x is denoted as {02}) in the field GF(2^8)
-// Note that i starts at 1, not 0).
-uint8 Rcon[255] = {
-    0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36, 0x6c, 0xd8, 0xab, 0x4d, 0x9a,
-    0x2f, 0x5e, 0xbc, 0x63, 0xc6, 0x97, 0x35, 0x6a, 0xd4, 0xb3, 0x7d, 0xfa, 0xef, 0xc5, 0x91, 0x39,
-    0x72, 0xe4, 0xd3, 0xbd, 0x61, 0xc2, 0x9f, 0x25, 0x4a, 0x94, 0x33, 0x66, 0xcc, 0x83, 0x1d, 0x3a,
-    0x74, 0xe8, 0xcb, 0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36, 0x6c, 0xd8,
-    0xab, 0x4d, 0x9a, 0x2f, 0x5e, 0xbc, 0x63, 0xc6, 0x97, 0x35, 0x6a, 0xd4, 0xb3, 0x7d, 0xfa, 0xef,
-    0xc5, 0x91, 0x39, 0x72, 0xe4, 0xd3, 0xbd, 0x61, 0xc2, 0x9f, 0x25, 0x4a, 0x94, 0x33, 0x66, 0xcc,
-    0x83, 0x1d, 0x3a, 0x74, 0xe8, 0xcb, 0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b,
-    0x36, 0x6c, 0xd8, 0xab, 0x4d, 0x9a, 0x2f, 0x5e, 0xbc, 0x63, 0xc6, 0x97, 0x35, 0x6a, 0xd4, 0xb3,
-    0x7d, 0xfa, 0xef, 0xc5, 0x91, 0x39, 0x72, 0xe4, 0xd3, 0xbd, 0x61, 0xc2, 0x9f, 0x25, 0x4a, 0x94,
-    0x33, 0x66, 0xcc, 0x83, 0x1d, 0x3a, 0x74, 0xe8, 0xcb, 0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20,
-    0x40, 0x80, 0x1b, 0x36, 0x6c, 0xd8, 0xab, 0x4d, 0x9a, 0x2f, 0x5e, 0xbc, 0x63, 0xc6, 0x97, 0x35,
-    0x6a, 0xd4, 0xb3, 0x7d, 0xfa, 0xef, 0xc5, 0x91, 0x39, 0x72, 0xe4, 0xd3, 0xbd, 0x61, 0xc2, 0x9f,
-    0x25, 0x4a, 0x94, 0x33, 0x66, 0xcc, 0x83, 0x1d, 0x3a, 0x74, 0xe8, 0xcb, 0x8d, 0x01, 0x02, 0x04,
-    0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36, 0x6c, 0xd8, 0xab, 0x4d, 0x9a, 0x2f, 0x5e, 0xbc, 0x63,
-    0xc6, 0x97, 0x35, 0x6a, 0xd4, 0xb3, 0x7d, 0xfa, 0xef, 0xc5, 0x91, 0x39, 0x72, 0xe4, 0xd3, 0xbd,
-    0x61, 0xc2, 0x9f, 0x25, 0x4a, 0x94, 0x33, 0x66, 0xcc, 0x83, 0x1d, 0x3a, 0x74, 0xe8, 0xcb  };
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
 
+/* Inverse S-box */
+PRIVATE const uint8 au8InvSBox[256] =
+{
+    0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
+    0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
+    0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
+    0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
+    0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
+    0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
+    0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
+    0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
+    0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
+    0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
+    0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
+    0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
+    0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
+    0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
+    0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
+    0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
+};
+
+/* GF(2^8) multiplication by 0x09, for InvMixColumns */
+PRIVATE const uint8 au8Mul09[256] =
+{
+    0x00, 0x09, 0x12, 0x1b, 0x24, 0x2d, 0x36, 0x3f, 0x48, 0x41, 0x5a, 0x53, 0x6c, 0x65, 0x7e, 0x77,
+    0x90, 0x99, 0x82, 0x8b, 0xb4, 0xbd, 0xa6, 0xaf, 0xd8, 0xd1, 0xca, 0xc3, 0xfc, 0xf5, 0xee, 0xe7,
+    0x3b, 0x32, 0x29, 0x20, 0x1f, 0x16, 0x0d, 0x04, 0x73, 0x7a, 0x61, 0x68, 0x57, 0x5e, 0x45, 0x4c,
+    0xab, 0xa2, 0xb9, 0xb0, 0x8f, 0x86, 0x9d, 0x94, 0xe3, 0xea, 0xf1, 0xf8, 0xc7, 0xce, 0xd5, 0xdc,
+    0x76, 0x7f, 0x64, 0x6d, 0x52, 0x5b, 0x40, 0x49, 0x3e, 0x37, 0x2c, 0x25, 0x1a, 0x13, 0x08, 0x01,
+    0xe6, 0xef, 0xf4, 0xfd, 0xc2, 0xcb, 0xd0, 0xd9, 0xae, 0xa7, 0xbc, 0xb5, 0x8a, 0x83, 0x98, 0x91,
+    0x4d, 0x44, 0x5f, 0x56, 0x69, 0x60, 0x7b, 0x72, 0x05, 0x0c, 0x17, 0x1e, 0x21, 0x28, 0x33, 0x3a,
+    0xdd, 0xd4, 0xcf, 0xc6, 0xf9, 0xf0, 0xeb, 0xe2, 0x95, 0x9c, 0x87, 0x8e, 0xb1, 0xb8, 0xa3, 0xaa,
+    0xec, 0xe5, 0xfe, 0xf7, 0xc8, 0xc1, 0xda, 0xd3, 0xa4, 0xad, 0xb6, 0xbf, 0x80, 0x89, 0x92, 0x9b,
+    0x7c, 0x75, 0x6e, 0x67, 0x58, 0x51, 0x4a, 0x43, 0x34, 0x3d, 0x26, 0x2f, 0x10, 0x19, 0x02, 0x0b,
+    0xd7, 0xde, 0xc5, 0xcc, 0xf3, 0xfa, 0xe1, 0xe8, 0x9f, 0x96, 0x8d, 0x84, 0xbb, 0xb2, 0xa9, 0xa0,
+    0x47, 0x4e, 0x55, 0x5c, 0x63, 0x6a, 0x71, 0x78, 0x0f, 0x06, 0x1d, 0x14, 0x2b, 0x22, 0x39, 0x30,
+    0x9a, 0x93, 0x88, 0x81, 0xbe, 0xb7, 0xac, 0xa5, 0xd2, 0xdb, 0xc0, 0xc9, 0xf6, 0xff, 0xe4, 0xed,
+    0x0a, 0x03, 0x18, 0x11, 0x2e, 0x27, 0x3c, 0x35, 0x42, 0x4b, 0x50, 0x59, 0x66, 0x6f, 0x74, 0x7d,
+    0xa1, 0xa8, 0xb3, 0xba, 0x85, 0x8c, 0x97, 0x9e, 0xe9, 0xe0, 0xfb, 0xf2, 0xcd, 0xc4, 0xdf, 0xd6,
+    0x31, 0x38, 0x23, 0x2a, 0x15, 0x1c, 0x07, 0x0e, 0x79, 0x70, 0x6b, 0x62, 0x5d, 0x54, 0x4f, 0x46
+};
+
+/* GF(2^8) multiplication by 0x0b, for InvMixColumns */
+PRIVATE const uint8 au8Mul0b[256] =
+{
+    0x00, 0x0b, 0x16, 0x1d, 0x2c, 0x27, 0x3a, 0x31, 0x58, 0x53, 0x4e, 0x45, 0x74, 0x7f, 0x62, 0x69,
+    0xb0, 0xbb, 0xa6, 0xad, 0x9c, 0x97, 0x8a, 0x81, 0xe8, 0xe3, 0xfe, 0xf5, 0xc4, 0xcf, 0xd2, 0xd9,
+    0x7b, 0x70, 0x6d, 0x66, 0x57, 0x5c, 0x41, 0x4a, 0x23, 0x28, 0x35, 0x3e, 0x0f, 0x04, 0x19, 0x12,
+    0xcb, 0xc0, 0xdd, 0xd6, 0xe7, 0xec, 0xf1, 0xfa, 0x93, 0x98, 0x85, 0x8e, 0xbf, 0xb4, 0xa9, 0xa2,
+    0xf6, 0xfd, 0xe0, 0xeb, 0xda, 0xd1, 0xcc, 0xc7, 0xae, 0xa5, 0xb8, 0xb3, 0x82, 0x89, 0x94, 0x9f,
+    0x46, 0x4d, 0x50, 0x5b, 0x6a, 0x61, 0x7c, 0x77, 0x1e, 0x15, 0x08, 0x03, 0x32, 0x39, 0x24, 0x2f,
+    0x8d, 0x86, 0x9b, 0x90, 0xa1, 0xaa, 0xb7, 0xbc, 0xd5, 0xde, 0xc3, 0xc8, 0xf9, 0xf2, 0xef, 0xe4,
+    0x3d, 0x36, 0x2b, 0x20, 0x11, 0x1a, 0x07, 0x0c, 0x65, 0x6e, 0x73, 0x78, 0x49, 0x42, 0x5f, 0x54,
+    0xf7, 0xfc, 0xe1, 0xea, 0xdb, 0xd0, 0xcd, 0xc6, 0xaf, 0xa4, 0xb9, 0xb2, 0x83, 0x88, 0x95, 0x9e,
+    0x47, 0x4c, 0x51, 0x5a, 0x6b, 0x60, 0x7d, 0x76, 0x1f, 0x14, 0x09, 0x02, 0x33, 0x38, 0x25, 0x2e,
+    0x8c, 0x87, 0x9a, 0x91, 0xa0, 0xab, 0xb6, 0xbd, 0xd4, 0xdf, 0xc2, 0xc9, 0xf8, 0xf3, 0xee, 0xe5,
+    0x3c, 0x37, 0x2a, 0x21, 0x10, 0x1b, 0x06, 0x0d, 0x64, 0x6f, 0x72, 0x79, 0x48, 0x43, 0x5e, 0x55,
+    0x01, 0x0a, 0x17, 0x1c, 0x2d, 0x26, 0x3b, 0x30, 0x59, 0x52, 0x4f, 0x44, 0x75, 0x7e, 0x63, 0x68,
+    0xb1, 0xba, 0xa7, 0xac, 0x9d, 0x96, 0x8b, 0x80, 0xe9, 0xe2, 0xff, 0xf4, 0xc5, 0xce, 0xd3, 0xd8,
+    0x7a, 0x71, 0x6c, 0x67, 0x56, 0x5d, 0x40, 0x4b, 0x22, 0x29, 0x34, 0x3f, 0x0e, 0x05, 0x18, 0x13,
+    0xca, 0xc1, 0xdc, 0xd7, 0xe6, 0xed, 0xf0, 0xfb, 0x92, 0x99, 0x84, 0x8f, 0xbe, 0xb5, 0xa8, 0xa3
+};
+
+/* GF(2^8) multiplication by 0x0d, for InvMixColumns */
+PRIVATE const uint8 au8Mul0d[256] =
+{
+    0x00, 0x0d, 0x1a, 0x17, 0x34, 0x39, 0x2e, 0x23, 0x68, 0x65, 0x72, 0x7f, 0x5c, 0x51, 0x46, 0x4b,
+    0xd0, 0xdd, 0xca, 0xc7, 0xe4, 0xe9, 0xfe, 0xf3, 0xb8, 0xb5, 0xa2, 0xaf, 0x8c, 0x81, 0x96, 0x9b,
+    0xbb, 0xb6, 0xa1, 0xac, 0x8f, 0x82, 0x95, 0x98, 0xd3, 0xde, 0xc9, 0xc4, 0xe7, 0xea, 0xfd, 0xf0,
+    0x6b, 0x66, 0x71, 0x7c, 0x5f, 0x52, 0x45, 0x48, 0x03, 0x0e, 0x19, 0x14, 0x37, 0x3a, 0x2d, 0x20,
+    0x6d, 0x60, 0x77, 0x7a, 0x59, 0x54, 0x43, 0x4e, 0x05, 0x08, 0x1f, 0x12, 0x31, 0x3c, 0x2b, 0x26,
+    0xbd, 0xb0, 0xa7, 0xaa, 0x89, 0x84, 0x93, 0x9e, 0xd5, 0xd8, 0xcf, 0xc2, 0xe1, 0xec, 0xfb, 0xf6,
+    0xd6, 0xdb, 0xcc, 0xc1, 0xe2, 0xef, 0xf8, 0xf5, 0xbe, 0xb3, 0xa4, 0xa9, 0x8a, 0x87, 0x90, 0x9d,
+    0x06, 0x0b, 0x1c, 0x11, 0x32, 0x3f, 0x28, 0x25, 0x6e, 0x63, 0x74, 0x79, 0x5a, 0x57, 0x40, 0x4d,
+    0xda, 0xd7, 0xc0, 0xcd, 0xee, 0xe3, 0xf4, 0xf9, 0xb2, 0xbf, 0xa8, 0xa5, 0x86, 0x8b, 0x9c, 0x91,
+    0x0a, 0x07, 0x10, 0x1d, 0x3e, 0x33, 0x24, 0x29, 0x62, 0x6f, 0x78, 0x75, 0x56, 0x5b, 0x4c, 0x41,
+    0x61, 0x6c, 0x7b, 0x76, 0x55, 0x58, 0x4f, 0x42, 0x09, 0x04, 0x13, 0x1e, 0x3d, 0x30, 0x27, 0x2a,
+    0xb1, 0xbc, 0xab, 0xa6, 0x85, 0x88, 0x9f, 0x92, 0xd9, 0xd4, 0xc3, 0xce, 0xed, 0xe0, 0xf7, 0xfa,
+    0xb7, 0xba, 0xad, 0xa0, 0x83, 0x8e, 0x99, 0x94, 0xdf, 0xd2, 0xc5, 0xc8, 0xeb, 0xe6, 0xf1, 0xfc,
+    0x67, 0x6a, 0x7d, 0x70, 0x53, 0x5e, 0x49, 0x44, 0x0f, 0x02, 0x15, 0x18, 0x3b, 0x36, 0x21, 0x2c,
+    0x0c, 0x01, 0x16, 0x1b, 0x38, 0x35, 0x22, 0x2f, 0x64, 0x69, 0x7e, 0x73, 0x50, 0x5d, 0x4a, 0x47,
+    0xdc, 0xd1, 0xc6, 0xcb, 0xe8, 0xe5, 0xf2, 0xff, 0xb4, 0xb9, 0xae, 0xa3, 0x80, 0x8d, 0x9a, 0x97
+};
+
+/* GF(2^8) multiplication by 0x0e, for InvMixColumns */
+PRIVATE const uint8 au8Mul0e[256] =
+{
+    0x00, 0x0e, 0x1c, 0x12, 0x38, 0x36, 0x24, 0x2a, 0x70, 0x7e, 0x6c, 0x62, 0x48, 0x46, 0x54, 0x5a,
+    0xe0, 0xee, 0xfc, 0xf2, 0xd8, 0xd6, 0xc4, 0xca, 0x90, 0x9e, 0x8c, 0x82, 0xa8, 0xa6, 0xb4, 0xba,
+    0xdb, 0xd5, 0xc7, 0xc9, 0xe3, 0xed, 0xff, 0xf1, 0xab, 0xa5, 0xb7, 0xb9, 0x93, 0x9d, 0x8f, 0x81,
+    0x3b, 0x35, 0x27, 0x29, 0x03, 0x0d, 0x1f, 0x11, 0x4b, 0x45, 0x57, 0x59, 0x73, 0x7d, 0x6f, 0x61,
+    0xad, 0xa3, 0xb1, 0xbf, 0x95, 0x9b, 0x89, 0x87, 0xdd, 0xd3, 0xc1, 0xcf, 0xe5, 0xeb, 0xf9, 0xf7,
+    0x4d, 0x43, 0x51, 0x5f, 0x75, 0x7b, 0x69, 0x67, 0x3d, 0x33, 0x21, 0x2f, 0x05, 0x0b, 0x19, 0x17,
+    0x76, 0x78, 0x6a, 0x64, 0x4e, 0x40, 0x52, 0x5c, 0x06, 0x08, 0x1a, 0x14, 0x3e, 0x30, 0x22, 0x2c,
+    0x96, 0x98, 0x8a, 0x84, 0xae, 0xa0, 0xb2, 0xbc, 0xe6, 0xe8, 0xfa, 0xf4, 0xde, 0xd0, 0xc2, 0xcc,
+    0x41, 0x4f, 0x5d, 0x53, 0x79, 0x77, 0x65, 0x6b, 0x31, 0x3f, 0x2d, 0x23, 0x09, 0x07, 0x15, 0x1b,
+    0xa1, 0xaf, 0xbd, 0xb3, 0x99, 0x97, 0x85, 0x8b, 0xd1, 0xdf, 0xcd, 0xc3, 0xe9, 0xe7, 0xf5, 0xfb,
+    0x9a, 0x94, 0x86, 0x88, 0xa2, 0xac, 0xbe, 0xb0, 0xea, 0xe4, 0xf6, 0xf8, 0xd2, 0xdc, 0xce, 0xc0,
+    0x7a, 0x74, 0x66, 0x68, 0x42, 0x4c, 0x5e, 0x50, 0x0a, 0x04, 0x16, 0x18, 0x32, 0x3c, 0x2e, 0x20,
+    0xec, 0xe2, 0xf0, 0xfe, 0xd4, 0xda, 0xc8, 0xc6, 0x9c, 0x92, 0x80, 0x8e, 0xa4, 0xaa, 0xb8, 0xb6,
+    0x0c, 0x02, 0x10, 0x1e, 0x34, 0x3a, 0x28, 0x26, 0x7c, 0x72, 0x60, 0x6e, 0x44, 0x4a, 0x58, 0x56,
+    0x37, 0x39, 0x2b, 0x25, 0x0f, 0x01, 0x13, 0x1d, 0x47, 0x49, 0x5b, 0x55, 0x7f, 0x71, 0x63, 0x6d,
+    0xd7, 0xd9, 0xcb, 0xc5, 0xef, 0xe1, 0xf3, 0xfd, 0xa7, 0xa9, 0xbb, 0xb5, 0x9f, 0x91, 0x83, 0x8d
+};
+
+/* The round constant word array, Rcon[i], contains the values given by
+ * x to the power (i-1) being powers of x (x is denoted as {02}) in the field
+ * GF(2^8). Only the Nr values used by a 128 bit key are kept. */
+PRIVATE const uint8 au8Rcon[Nr] =
+{
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36
+};
 
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
 
-// This function produces Nb(Nr+1) round keys. The round keys are used in each round to decrypt the states.
-PUBLIC void KeyExpansion()
+/****************************************************************************
+ *
+ * NAME: vECB_DecryptInit
+ *
+ * DESCRIPTION:
+ * Expands a 128 bit key into the Nb(Nr+1) round keys of a decrypt context.
+ * The context can then decrypt any number of blocks with that key.
+ *
+ * PARAMETERS:  Name            Usage
+ *              psContext       context to set up
+ *              au8Key          16 byte key
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PUBLIC void vECB_DecryptInit(tsECB_DecryptContext *psContext,
+                             uint8* au8Key)
 {
-    int i,j;
-    unsigned char temp[4],k;
+    uint8 *pu8RoundKey = psContext->au8RoundKey;
+    uint8 au8Temp[4], u8Temp;
+    int i;
 
-    // The first round key is the key itself.
-    for(i=0;i<Nk;i++)
+    /* The first round key is the key itself */
+    for(i = 0; i < Nk * 4; i++)
     {
-        RoundKey[i*4]=Key[i*4];
-        RoundKey[i*4+1]=Key[i*4+1];
-        RoundKey[i*4+2]=Key[i*4+2];
-        RoundKey[i*4+3]=Key[i*4+3];
+        pu8RoundKey[i] = au8Key[i];
     }
 
-    // All other round keys are found from the previous round keys.
-    while (i < (Nb * (Nr+1)))
+    /* All other round keys are found from the previous round keys */
+    for(i = Nk; i < Nb * (Nr + 1); i++)
     {
-        for(j=0;j<4;j++)
-        {
-            temp[j]=RoundKey[(i-1) * 4 + j];
-        }
-        if (i % Nk == 0)
-        {
-            // This function rotates the 4 bytes in a word to the left once.
-            // [a0,a1,a2,a3] becomes [a1,a2,a3,a0]
-
-            // Function RotWord()
-            {
-                k = temp[0];
-                temp[0] = temp[1];
-                temp[1] = temp[2];
-                temp[2] = temp[3];
-                temp[3] = k;
-            }
-
-            // SubWord() is a function that takes a four-byte input word and
-            // applies the S-box to each of the four bytes to produce an output word.
-
-            // Function Subword()
-            {
-                temp[0]=getSBoxValue(temp[0]);
-                temp[1]=getSBoxValue(temp[1]);
-                temp[2]=getSBoxValue(temp[2]);
-                temp[3]=getSBoxValue(temp[3]);
-            }
-
-            temp[0] =  temp[0] ^ Rcon[i/Nk];
-        }
-#if (Nk > 6)
-        else if (Nk > 6 && i % Nk == 4)
-        {
-            // Function Subword() TODO: warning
-            {
-                temp[0]=getSBoxValue(temp[0]);
-                temp[1]=getSBoxValue(temp[1]);
-                temp[2]=getSBoxValue(temp[2]);
-                temp[3]=getSBoxValue(temp[3]);
-            }
-        }
-#endif
-        RoundKey[i*4+0] = RoundKey[(i-Nk)*4+0] ^ temp[0];
-        RoundKey[i*4+1] = RoundKey[(i-Nk)*4+1] ^ temp[1];
-        RoundKey[i*4+2] = RoundKey[(i-Nk)*4+2] ^ temp[2];
-        RoundKey[i*4+3] = RoundKey[(i-Nk)*4+3] ^ temp[3];
-        i++;
-    }
-}
-
+        au8Temp[0] = pu8RoundKey[(i - 1) * 4 + 0];
+        au8Temp[1] = pu8RoundKey[(i - 1) * 4 + 1];
+        au8Temp[2] = pu8RoundKey[(i - 1) * 4 + 2];
+        au8Temp[3] = pu8RoundKey[(i - 1) * 4 + 3];
 
-// This function adds the round key to state.
-// The round key is added to the state by an XOR function.
-PUBLIC void AddRoundKey(int round)
-{
-    int i,j;
-    for(i=0;i<4;i++)
-    {
-        for(j=0;j<4;j++)
+        if((i % Nk) == 0)
         {
-            state[j][i] ^= RoundKey[round * Nb * 4 + i * Nb + j];
+            /* SubWord(RotWord(temp)) ^ Rcon */
+            u8Temp = au8Temp[0];
+            au8Temp[0] = au8SBox[au8Temp[1]] ^ au8Rcon[(i / Nk) - 1];
+            au8Temp[1] = au8SBox[au8Temp[2]];
+            au8Temp[2] = au8SBox[au8Temp[3]];
+            au8Temp[3] = au8SBox[u8Temp];
         }
-    }
-}
-
-// The SubBytes Function Substitutes the values in the
-// state matrix with values in an S-box.
-PUBLIC void InvSubBytes()
-{
-    int i,j;
-    for(i=0;i<4;i++)
-    {
-        for(j=0;j<4;j++)
-        {
-            state[i][j] = getSBoxInvert(state[i][j]);
 
-        }
+        pu8RoundKey[i * 4 + 0] = pu8RoundKey[(i - Nk) * 4 + 0] ^ au8Temp[0];
+        pu8RoundKey[i * 4 + 1] = pu8RoundKey[(i - Nk) * 4 + 1] ^ au8Temp[1];
+        pu8RoundKey[i * 4 + 2] = pu8RoundKey[(i - Nk) * 4 + 2] ^ au8Temp[2];
+        pu8RoundKey[i * 4 + 3] = pu8RoundKey[(i - Nk) * 4 + 3] ^ au8Temp[3];
     }
 }
 
-// The ShiftRows() function shifts the rows in the state to the left.
-// Each row is shifted with different offset.
-// Offset = Row number. So the first row is not shifted.
-PUBLIC void InvShiftRows()
+/****************************************************************************
+ *
+ * NAME: vECB_DecryptBlock
+ *
+ * DESCRIPTION:
+ * Decrypts one 16 byte block with the round keys of the context. The state
+ * is kept column by column, as the block is laid out, so the input and output
+ * need no transposition. In and out may be the same buffer.
+ *
+ * PARAMETERS:  Name            Usage
+ *              psContext       context set up by vECB_DecryptInit
+ *              au8InData       16 byte cipher text
+ *              au8OutData      16 byte plain text
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PUBLIC void vECB_DecryptBlock(const tsECB_DecryptContext *psContext,
+                              uint8* au8InData,
+                              uint8* au8OutData)
 {
-    unsigned char temp;
-
-    // Rotate first row 1 columns to right
-    temp=state[1][3];
-    state[1][3]=state[1][2];
-    state[1][2]=state[1][1];
-    state[1][1]=state[1][0];
-    state[1][0]=temp;
-
-    // Rotate second row 2 columns to right
-    temp=state[2][0];
-    state[2][0]=state[2][2];
-    state[2][2]=temp;
-
-    temp=state[2][1];
-    state[2][1]=state[2][3];
-    state[2][3]=temp;
+    const uint8 *pu8RoundKey = &psContext->au8RoundKey[Nr * Nb * 4];
+    uint8 au8State[Nb * 4], au8Shifted[Nb * 4];
+    uint8 a, b, c, d;
+    int i, iRound;
 
-    // Rotate third row 3 columns to right
-    temp=state[3][0];
-    state[3][0]=state[3][1];
-    state[3][1]=state[3][2];
-    state[3][2]=state[3][3];
-    state[3][3]=temp;
-}
-
-// MixColumns function mixes the columns of the state matrix.
-// The method used to multiply may be difficult to understand for the inexperienced.
-// Please use the references to gain more information.
-PUBLIC void InvMixColumns()
-{
-    int i;
-    unsigned char a,b,c,d;
-    for(i=0;i<4;i++)
+    /* Add the last round key to the state before starting the rounds */
+    for(i = 0; i < Nb * 4; i++)
     {
-
-        a = state[0][i];
-        b = state[1][i];
-        c = state[2][i];
-        d = state[3][i];
-
-
-        state[0][i] = Multiply(a, 0x0e) ^ Multiply(b, 0x0b) ^ Multiply(c, 0x0d) ^ Multiply(d, 0x09);
-        state[1][i] = Multiply(a, 0x09) ^ Multiply(b, 0x0e) ^ Multiply(c, 0x0b) ^ Multiply(d, 0x0d);
-        state[2][i] = Multiply(a, 0x0d) ^ Multiply(b, 0x09) ^ Multiply(c, 0x0e) ^ Multiply(d, 0x0b);
-        state[3][i] = Multiply(a, 0x0b) ^ Multiply(b, 0x0d) ^ Multiply(c, 0x09) ^ Multiply(d, 0x0e);
+        au8State[i] = au8InData[i] ^ pu8RoundKey[i];
     }
-}
-
-// InvCipher is the main function that decrypts the CipherText.
-PUBLIC void InvCipher()
-{
-    int i,j,round=0;
 
-    //Copy the input CipherText to state array.
-    for(i=0;i<4;i++)
+    for(iRound = Nr - 1; iRound >= 0; iRound--)
     {
-        for(j=0;j<4;j++)
+        pu8RoundKey -= Nb * 4;
+
+        /* InvShiftRows and InvSubBytes: row r of column c comes from column c - r */
+        for(i = 0; i < Nb * 4; i++)
         {
-            state[j][i] = in[i*4 + j];
+            au8Shifted[i] = au8InvSBox[au8State[((i + 16 - ((i & 3) * 4)) & 15)]] ^ pu8RoundKey[i];
         }
-    }
 
-    // Add the First round key to the state before starting the rounds.
-    AddRoundKey(Nr);
-
-    // There will be Nr rounds.
-    // The first Nr-1 rounds are identical.
-    // These Nr-1 rounds are executed in the loop below.
-    for(round=Nr-1;round>0;round--)
-    {
-        InvShiftRows();
-        InvSubBytes();
-        AddRoundKey(round);
-        InvMixColumns();
-    }
-
-    // The last round is given below.
-    // The MixColumns function is not here in the last round.
-    InvShiftRows();
-    InvSubBytes();
-    AddRoundKey(0);
+        if(iRound == 0)
+        {
+            /* The last round has no InvMixColumns */
+            for(i = 0; i < Nb * 4; i++)
+            {
+                au8OutData[i] = au8Shifted[i];
+            }
+            break;
+        }
 
-    // The decryption process is over.
-    // Copy the state array to output array.
-    for(i=0;i<4;i++)
-    {
-        for(j=0;j<4;j++)
+        /* InvMixColumns */
+        for(i = 0; i < Nb * 4; i += 4)
         {
-            out[i*4+j]=state[j][i];
+            a = au8Shifted[i + 0];
+            b = au8Shifted[i + 1];
+            c = au8Shifted[i + 2];
+            d = au8Shifted[i + 3];
+            au8State[i + 0] = au8Mul0e[a] ^ au8Mul0b[b] ^ au8Mul0d[c] ^ au8Mul09[d];
+            au8State[i + 1] = au8Mul09[a] ^ au8Mul0e[b] ^ au8Mul0b[c] ^ au8Mul0d[d];
+            au8State[i + 2] = au8Mul0d[a] ^ au8Mul09[b] ^ au8Mul0e[c] ^ au8Mul0b[d];
+            au8State[i + 3] = au8Mul0b[a] ^ au8Mul0d[b] ^ au8Mul09[c] ^ au8Mul0e[d];
         }
     }
 }
 
-
+/****************************************************************************
+ *
+ * NAME: vECB_Decrypt
+ *
+ * DESCRIPTION:
+ * Decrypts one 16 byte block with a 128 bit key, using a context on the
+ * stack. Callers decrypting several blocks with one key should keep a context
+ * and use vECB_DecryptInit and vECB_DecryptBlock instead.
+ *
+ * PARAMETERS:  Name            Usage
+ *              au8Key          16 byte key
+ *              au8InData       16 byte cipher text
+ *              au8OutData      16 byte plain text
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
 PUBLIC void vECB_Decrypt(uint8* au8Key,
                          uint8* au8InData,
-                         uint8* au8OutData) {
-
-
-    int i;
-    // Copy the Key and CipherText
-    for(i=0;i<Nk*4;i++)
-    {
-        Key[i]=au8Key[i];
-        in[i]=au8InData[i];
-    }
-
-    KeyExpansion();
-
-    // The next function call decrypts the CipherText with the Key using AES algorithm.
-    InvCipher();
-
-    for(i=0;i<Nb*4;i++)
-    {
-        au8OutData[i] = out[i];
-    }
+                         uint8* au8OutData)
+{
+    tsECB_DecryptContext sContext;
 
+    vECB_DecryptInit(&sContext, au8Key);
+    vECB_DecryptBlock(&sContext, au8InData, au8OutData);
 }
 #endif
 
-
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
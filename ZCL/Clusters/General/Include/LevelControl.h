@@ -73,6 +73,12 @@
 /* Enable the optional Attribute StartUpCurrentLevel  for ZLO extension*/
 //#define CLD_LEVELCONTROL_ATTR_STARTUP_CURRENT_LEVEL
 
+/* Evaluate transitions from the time elapsed since they started rather than
+ * adding a fixed step per 100ms update. The application may then call
+ * eCLD_LevelControlUpdateElapsed() at any rate, using
+ * eCLD_LevelControlGetNextChangeTime() to decide when the next call is due */
+//#define CLD_LEVELCONTROL_TIMED_TRANSITIONS
+
 #ifndef CLD_LEVELCONTROL_MIN_LEVEL
 #define CLD_LEVELCONTROL_MIN_LEVEL                  (1)
 #endif
@@ -96,6 +102,12 @@
 #define LEVELCONTROL_EXECUTE_IF_OFF_BIT              (1<<0)
 #define LEVELCONTROL_COUPLE_COLOUR_TEMP_TO_LEVEL_BIT (1<<1)
 
+/* Time represented by one call to eCLD_LevelControlUpdate() */
+#define CLD_LEVELCONTROL_UPDATE_PERIOD_MS           (100)
+
+/* Returned by eCLD_LevelControlGetNextChangeTime() when nothing is moving */
+#define CLD_LEVELCONTROL_NO_CHANGE_PENDING          (0xffffffff)
+
 #define LEVELCONTROL_OO_BIT (1 << 0)
 #define LEVELCONTROL_LT_BIT (1 << 1)
 #define LEVELCONTROL_FQ_BIT (1 << 2)
@@ -312,6 +324,12 @@ typedef struct
     #ifdef CLD_LEVELCONTROL_ATTR_CURRENT_FREQUENCY
     uint16                          u16TargetFrequency;
     #endif    
+    #ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+    int                             iStartLevel;
+    int                             iEndLevel;
+    uint32                          u32DurationMs;
+    uint32                          u32ElapsedMs;
+    #endif
 } tsCLD_LevelControl_Transition;
 
 
@@ -340,6 +358,16 @@ PUBLIC teZCL_Status eCLD_LevelControlCreateLevelControl(
 PUBLIC teZCL_Status eCLD_LevelControlUpdate(
                     uint8                   u8SourceEndPointId);
 
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+PUBLIC teZCL_Status eCLD_LevelControlUpdateElapsed(
+                    uint8                   u8SourceEndPointId,
+                    uint32                  u32ElapsedMs);
+
+PUBLIC teZCL_Status eCLD_LevelControlGetNextChangeTime(
+                    uint8                   u8SourceEndPointId,
+                    uint32                  *pu32TimeMs);
+#endif
+
 PUBLIC teZCL_Status eCLD_LevelControlSetLevel(
                     uint8                   u8SourceEndPointId,
                     uint8                   u8Level,
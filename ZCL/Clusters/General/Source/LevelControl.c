@@ -84,6 +84,23 @@ PRIVATE teZCL_Status eCLD_LevelControlSceneEventHandler(
                         teZCL_SceneEvent            eEvent,
                         tsZCL_EndPointDefinition   *psEndPointDefinition,
                         tsZCL_ClusterInstance      *psClusterInstance);
+
+PRIVATE bool_t bCLD_LevelControlAdvanceTransition(
+                        tsCLD_LevelControl_Transition *psTransition);
+
+PRIVATE int iCLD_LevelControlMoveLevel(
+                        tsCLD_LevelControl_Transition *psTransition);
+
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+PRIVATE void vCLD_LevelControlChainTimedTransition(
+                        tsCLD_LevelControl_Transition *psTransition);
+
+PRIVATE uint32 u32CLD_LevelControlNextStepTime(
+                        int                         iStartLevel,
+                        int                         iDelta,
+                        uint32                      u32DurationMs,
+                        uint32                      u32ElapsedMs);
+#endif
 #endif
 /****************************************************************************/
 /***        Exported Variables                                            ***/
@@ -277,6 +294,12 @@ PUBLIC  teZCL_Status eCLD_LevelControlCreateLevelControl(
 
     psCustomDataStructure->sTransition.iStepSize        = 0;
     psCustomDataStructure->sTransition.u32Time          = 0;
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+    psCustomDataStructure->sTransition.iStartLevel      = CLD_LEVELCONTROL_MIN_LEVEL * 100;
+    psCustomDataStructure->sTransition.iEndLevel        = CLD_LEVELCONTROL_MIN_LEVEL * 100;
+    psCustomDataStructure->sTransition.u32DurationMs    = 0;
+    psCustomDataStructure->sTransition.u32ElapsedMs     = 0;
+#endif
 
     /* Set attribute default values */
     if(pvEndPointSharedStructPtr != NULL)
@@ -375,6 +398,44 @@ PUBLIC  teZCL_Status eCLD_LevelControlCreateLevelControl(
 }
 
 #ifdef LEVEL_CONTROL_SERVER
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+/****************************************************************************
+ **
+ ** NAME:       eCLD_LevelControlUpdate
+ **
+ ** DESCRIPTION:
+ ** Updates the the state of a level control cluster by one 100ms tick
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          Source EP Id
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
+{
+    return eCLD_LevelControlUpdateElapsed(u8SourceEndPointId, CLD_LEVELCONTROL_UPDATE_PERIOD_MS);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       eCLD_LevelControlUpdateElapsed
+ **
+ ** DESCRIPTION:
+ ** Updates the the state of a level control cluster, evaluating any
+ ** transition at the time elapsed since it started
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          Source EP Id
+ ** uint32                      u32ElapsedMs                Time since last update
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PUBLIC  teZCL_Status eCLD_LevelControlUpdateElapsed(uint8 u8SourceEndPointId, uint32 u32ElapsedMs)
+#else
 /****************************************************************************
  **
  ** NAME:       eCLD_LevelControlUpdate
@@ -390,6 +451,7 @@ PUBLIC  teZCL_Status eCLD_LevelControlCreateLevelControl(
  **
  ****************************************************************************/
 PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
+#endif
 {
 
 	bool_t bGenerateEvent = FALSE;
@@ -424,6 +486,12 @@ PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
     if((psCommon->sTransition.iCurrentLevel / 100) != psSharedStruct->u8CurrentLevel)
     {
         psCommon->sTransition.iCurrentLevel = psSharedStruct->u8CurrentLevel * 100;
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+        /* Carry on from the new level over whatever time is left */
+        psCommon->sTransition.iStartLevel = psCommon->sTransition.iCurrentLevel;
+        psCommon->sTransition.u32DurationMs -= MIN(psCommon->sTransition.u32ElapsedMs, psCommon->sTransition.u32DurationMs);
+        psCommon->sTransition.u32ElapsedMs = 0;
+#endif
     }
 
 
@@ -442,7 +510,9 @@ PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
         eZCL_GetMutex(psEndPointDefinition);
     #endif
 
-
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+    psCommon->sTransition.u32ElapsedMs += MIN(u32ElapsedMs, 0xffffffff - psCommon->sTransition.u32ElapsedMs);
+#endif
 
     switch(psCommon->sTransition.eTransition)
     {
@@ -452,13 +522,10 @@ PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
         bGenerateEvent = TRUE;
         DBG_vPrintf(TRACE_LEVEL_CONTROL, "\nLC: Updating EP:%d Target=%i Cur=%i Step=%i Time=%i OnOff=%i", u8SourceEndPointId, psCommon->sTransition.iTargetLevel, psCommon->sTransition.iCurrentLevel, psCommon->sTransition.iStepSize, psCommon->sTransition.u32Time, bOnOff);
 
-        if(psCommon->sTransition.u32Time > 0)
+        if(bCLD_LevelControlAdvanceTransition(&psCommon->sTransition))
         {
-            psCommon->sTransition.iCurrentLevel += psCommon->sTransition.iStepSize;
-
             /* Ensure it stays within limits */
             psCommon->sTransition.iCurrentLevel = CLAMP(psCommon->sTransition.iCurrentLevel, CLD_LEVELCONTROL_MIN_LEVEL * 100, CLD_LEVELCONTROL_MAX_LEVEL * 100);
-            psCommon->sTransition.u32Time--;
         }
         else
         {
@@ -476,7 +543,7 @@ PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
         {
 
         case E_CLD_LEVELCONTROL_MOVE_MODE_UP:
-            psCommon->sTransition.iCurrentLevel = MIN(CLD_LEVELCONTROL_MAX_LEVEL * 100, psCommon->sTransition.iCurrentLevel + psCommon->sTransition.iStepSize);
+            psCommon->sTransition.iCurrentLevel = MIN(CLD_LEVELCONTROL_MAX_LEVEL * 100, iCLD_LevelControlMoveLevel(&psCommon->sTransition));
             if(psCommon->sTransition.iCurrentLevel == (CLD_LEVELCONTROL_MAX_LEVEL * 100))
             {
                 psCommon->sTransition.eTransition = E_CLD_LEVELCONTROL_CMD_NONE;
@@ -484,7 +551,7 @@ PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
             break;
 
         case E_CLD_LEVELCONTROL_MOVE_MODE_DOWN:
-            psCommon->sTransition.iCurrentLevel = MAX(CLD_LEVELCONTROL_MIN_LEVEL * 100, psCommon->sTransition.iCurrentLevel + psCommon->sTransition.iStepSize);
+            psCommon->sTransition.iCurrentLevel = MAX(CLD_LEVELCONTROL_MIN_LEVEL * 100, iCLD_LevelControlMoveLevel(&psCommon->sTransition));
             if(psCommon->sTransition.iCurrentLevel == (CLD_LEVELCONTROL_MIN_LEVEL * 100))
             {
                 psCommon->sTransition.eTransition = E_CLD_LEVELCONTROL_CMD_NONE;
@@ -505,13 +572,10 @@ PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
             #endif
         }
 
-        if(psCommon->sTransition.u32Time > 0)
+        if(bCLD_LevelControlAdvanceTransition(&psCommon->sTransition))
         {
-            psCommon->sTransition.iCurrentLevel += psCommon->sTransition.iStepSize;
             psCommon->sTransition.iCurrentLevel = MIN(CLD_LEVELCONTROL_MAX_LEVEL * 100, psCommon->sTransition.iCurrentLevel);
-
-            psCommon->sTransition.u32Time--;
-            }
+        }
         else
         {
             /* Ensure final value stays within limits */
@@ -524,13 +588,11 @@ PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
         bGenerateEvent = TRUE;
         DBG_vPrintf(TRACE_LEVEL_CONTROL, "\nLC: Updating EP:%d Target=%i Cur=%i Step=%i Time=%i OnOff=%i", u8SourceEndPointId, psCommon->sTransition.iTargetLevel, psCommon->sTransition.iCurrentLevel, psCommon->sTransition.iStepSize, psCommon->sTransition.u32Time, bOnOff);
 
-        if(psCommon->sTransition.u32Time > 0)
-            {
-            psCommon->sTransition.iCurrentLevel += psCommon->sTransition.iStepSize;
+        if(bCLD_LevelControlAdvanceTransition(&psCommon->sTransition))
+        {
             psCommon->sTransition.iCurrentLevel = MAX(CLD_LEVELCONTROL_MIN_LEVEL * 100, psCommon->sTransition.iCurrentLevel);
             //ToDo:RemoveThisLine:- psCommon->sTransition.iPreviousLevel = psCommon->sTransition.iCurrentLevel;
-            psCommon->sTransition.u32Time--;
-            }
+        }
         else
         {
             #if (defined CLD_ONOFF) && (defined ONOFF_SERVER)
@@ -551,17 +613,18 @@ PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
         bGenerateEvent = TRUE;
         DBG_vPrintf(TRACE_LEVEL_CONTROL, "\nLC: Updating EP:%d Target=%i Cur=%i Step=%i Time=%i OnOff=%i", u8SourceEndPointId, psCommon->sTransition.iTargetLevel, psCommon->sTransition.iCurrentLevel, psCommon->sTransition.iStepSize, psCommon->sTransition.u32Time, bOnOff);
 
-        if(psCommon->sTransition.u32Time > 0)
-            {
-            psCommon->sTransition.iCurrentLevel += psCommon->sTransition.iStepSize;
+        if(bCLD_LevelControlAdvanceTransition(&psCommon->sTransition))
+        {
             psCommon->sTransition.iCurrentLevel = MAX(CLD_LEVELCONTROL_MIN_LEVEL * 100, psCommon->sTransition.iCurrentLevel);
-            psCommon->sTransition.u32Time--;
-            }
+        }
         else
         {
             psCommon->sTransition.eTransition = E_CLD_LEVELCONTROL_TRANSITION_OFF;
             psCommon->sTransition.u32Time = 40;  // Instead of 12 seconds (120)
             psCommon->sTransition.iStepSize = (psCommon->sTransition.iTargetLevel - psCommon->sTransition.iCurrentLevel) / (int)psCommon->sTransition.u32Time;
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+            vCLD_LevelControlChainTimedTransition(&psCommon->sTransition);
+#endif
         }
         break;
 
@@ -569,17 +632,18 @@ PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
         bGenerateEvent = TRUE;
         DBG_vPrintf(TRACE_LEVEL_CONTROL, "\nLC: Updating EP:%d Target=%i Cur=%i Step=%i Time=%i OnOff=%i", u8SourceEndPointId, psCommon->sTransition.iTargetLevel, psCommon->sTransition.iCurrentLevel, psCommon->sTransition.iStepSize, psCommon->sTransition.u32Time, bOnOff);
 
-        if(psCommon->sTransition.u32Time > 0)
-            {
-            psCommon->sTransition.iCurrentLevel += psCommon->sTransition.iStepSize;
+        if(bCLD_LevelControlAdvanceTransition(&psCommon->sTransition))
+        {
             psCommon->sTransition.iCurrentLevel = MAX(CLD_LEVELCONTROL_MIN_LEVEL * 100, psCommon->sTransition.iCurrentLevel);
-            psCommon->sTransition.u32Time--;
-            }
+        }
         else
         {
             psCommon->sTransition.eTransition = E_CLD_LEVELCONTROL_TRANSITION_OFF;
             psCommon->sTransition.u32Time = 10;
             psCommon->sTransition.iStepSize = (psCommon->sTransition.iTargetLevel - psCommon->sTransition.iCurrentLevel) / (int)psCommon->sTransition.u32Time;
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+            vCLD_LevelControlChainTimedTransition(&psCommon->sTransition);
+#endif
         }
         break;
         
@@ -692,6 +756,136 @@ PUBLIC  teZCL_Status eCLD_LevelControlUpdate(uint8 u8SourceEndPointId)
     return(E_ZCL_SUCCESS);
 }
 
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+/****************************************************************************
+ **
+ ** NAME:       eCLD_LevelControlGetNextChangeTime
+ **
+ ** DESCRIPTION:
+ ** Works out how long until the current level attribute next changes, so
+ ** the application can schedule its next call to the update function
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          EndPoint Id
+ ** uint32*                     pu32TimeMs                  Time in ms, or
+ **                                                         CLD_LEVELCONTROL_NO_CHANGE_PENDING
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PUBLIC  teZCL_Status eCLD_LevelControlGetNextChangeTime(
+        uint8                   u8SourceEndPointId,
+        uint32                  *pu32TimeMs)
+{
+
+    teZCL_Status eStatus;
+    tsZCL_EndPointDefinition *psEndPointDefinition;
+    tsZCL_ClusterInstance *psClusterInstance;
+    tsCLD_LevelControlCustomDataStructure *psCommon;
+    tsCLD_LevelControl_Transition *psTransition;
+    uint32 u32NextMs;
+
+    if(pu32TimeMs == NULL)
+    {
+        return E_ZCL_ERR_PARAMETER_NULL;
+    }
+
+    /* Find pointers to cluster */
+    eStatus = eZCL_FindCluster(GENERAL_CLUSTER_ID_LEVEL_CONTROL, u8SourceEndPointId, TRUE, &psEndPointDefinition, &psClusterInstance, (void*)&psCommon);
+    if(eStatus != E_ZCL_SUCCESS)
+    {
+        DBG_vPrintf(TRACE_LEVEL_CONTROL, "\nLC: No cluster");
+        return eStatus;
+    }
+
+    psTransition = &psCommon->sTransition;
+
+    switch(psTransition->eTransition)
+    {
+
+    case E_CLD_LEVELCONTROL_TRANSITION_MOVE:
+        /* Rate moves are open ended, stopping only at a limit */
+        u32NextMs = u32CLD_LevelControlNextStepTime(psTransition->iStartLevel,
+                                                    psTransition->iStepSize,
+                                                    CLD_LEVELCONTROL_UPDATE_PERIOD_MS,
+                                                    psTransition->u32ElapsedMs);
+        break;
+
+    case E_CLD_LEVELCONTROL_TRANSITION_MOVE_TO_LEVEL:
+    case E_CLD_LEVELCONTROL_TRANSITION_STEP:
+    case E_CLD_LEVELCONTROL_TRANSITION_ON:
+    case E_CLD_LEVELCONTROL_TRANSITION_OFF:
+    case E_CLD_LEVELCONTROL_TRANSITION_OFF_WITH_EFFECT_DIM_DOWN_FADE_OFF:
+    case E_CLD_LEVELCONTROL_TRANSITION_OFF_WITH_EFFECT_DIM_UP_FADE_OFF:
+        /* The end of the transition is itself a change (final level, On/Off, next fade phase) */
+        u32NextMs = psTransition->u32DurationMs;
+        if((psTransition->u32Time > 0) && (psTransition->u32DurationMs > 0))
+        {
+            u32NextMs = MIN(u32NextMs, u32CLD_LevelControlNextStepTime(psTransition->iStartLevel,
+                                                                       psTransition->iEndLevel - psTransition->iStartLevel,
+                                                                       psTransition->u32DurationMs,
+                                                                       psTransition->u32ElapsedMs));
+        }
+        else
+        {
+            u32NextMs = 0;
+        }
+        break;
+
+    default:
+        *pu32TimeMs = CLD_LEVELCONTROL_NO_CHANGE_PENDING;
+        return E_ZCL_SUCCESS;
+
+    }
+
+    *pu32TimeMs = (u32NextMs > psTransition->u32ElapsedMs) ? (u32NextMs - psTransition->u32ElapsedMs) : 0;
+
+    return E_ZCL_SUCCESS;
+
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vCLD_LevelControlStartTimedTransition
+ **
+ ** DESCRIPTION:
+ ** Anchors a transition that has just been set up at the current level so
+ ** it can be evaluated from elapsed time rather than accumulated steps
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsCLD_LevelControl_Transition *psTransition             Transition
+ **
+ ** RETURN:
+ ** None
+ **
+ ****************************************************************************/
+PUBLIC  void vCLD_LevelControlStartTimedTransition(
+        tsCLD_LevelControl_Transition *psTransition)
+{
+
+    psTransition->iStartLevel   = psTransition->iCurrentLevel;
+    psTransition->u32DurationMs = psTransition->u32Time * CLD_LEVELCONTROL_UPDATE_PERIOD_MS;
+    psTransition->u32ElapsedMs  = 0;
+
+    switch(psTransition->eTransition)
+    {
+
+    /* Fade phases head for an intermediate level given by their step size */
+    case E_CLD_LEVELCONTROL_TRANSITION_OFF_WITH_EFFECT_DIM_DOWN_FADE_OFF:
+    case E_CLD_LEVELCONTROL_TRANSITION_OFF_WITH_EFFECT_DIM_UP_FADE_OFF:
+        psTransition->iEndLevel = psTransition->iCurrentLevel + (psTransition->iStepSize * (int)psTransition->u32Time);
+        break;
+
+    default:
+        psTransition->iEndLevel = psTransition->iTargetLevel;
+        break;
+
+    }
+
+}
+#endif
+
 /****************************************************************************/
 /***        Local Functions                                               ***/
 /****************************************************************************/
@@ -893,6 +1087,9 @@ PUBLIC  teZCL_Status eCLD_LevelControlSetOnOffState(
     {
         psCommon->sTransition.iStepSize = psCommon->sTransition.iTargetLevel - psCommon->sTransition.iCurrentLevel;
     }
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+    vCLD_LevelControlStartTimedTransition(&psCommon->sTransition);
+#endif
 
 
     DBG_vPrintf(TRACE_LEVEL_CONTROL, "\nLC: Prev:%d Curr:%d Target:%d Time%d Step:%i",
@@ -984,6 +1181,9 @@ PUBLIC  teZCL_Status eCLD_LevelControlSetLevel(
         psCommon->sTransition.iStepSize     = (psCommon->sTransition.iCurrentLevel - psCommon->sTransition.iTargetLevel);
     
     psCommon->sTransition.u32Time       = u16TransitionTime;
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+    vCLD_LevelControlStartTimedTransition(&psCommon->sTransition);
+#endif
 
     DBG_vPrintf(TRACE_LEVEL_CONTROL, " Level=%d Time=%d Step*100=%d", u8Level, u16TransitionTime, psCommon->sTransition.iStepSize);
 
@@ -1178,6 +1378,9 @@ PRIVATE  teZCL_Status eCLD_LevelControlSceneEventHandler(
 #else
         psCommon->sTransition.u32Time = 0;
 #endif
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+        vCLD_LevelControlStartTimedTransition(&psCommon->sTransition);
+#endif
 
 
         /* Inform the application that the cluster has just been updated */
@@ -1195,6 +1398,159 @@ PRIVATE  teZCL_Status eCLD_LevelControlSceneEventHandler(
 
     return E_ZCL_SUCCESS;
 }
+
+/****************************************************************************
+ **
+ ** NAME:       bCLD_LevelControlAdvanceTransition
+ **
+ ** DESCRIPTION:
+ ** Moves the current level of a bounded transition on to where it should be
+ ** now and updates the remaining time
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsCLD_LevelControl_Transition *psTransition             Transition
+ **
+ ** RETURN:
+ ** bool_t - FALSE once the transition has run its course
+ **
+ ****************************************************************************/
+PRIVATE  bool_t bCLD_LevelControlAdvanceTransition(
+                        tsCLD_LevelControl_Transition *psTransition)
+{
+
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+    if((psTransition->u32Time == 0) || (psTransition->u32ElapsedMs >= psTransition->u32DurationMs))
+    {
+        psTransition->u32Time = 0;
+        return FALSE;
+    }
+
+    /* Interpolate from the start level, remaining time rounds up to whole tenths */
+    psTransition->iCurrentLevel = psTransition->iStartLevel +
+        (int)(((int64)(psTransition->iEndLevel - psTransition->iStartLevel) * psTransition->u32ElapsedMs) / psTransition->u32DurationMs);
+    psTransition->u32Time = (psTransition->u32DurationMs - psTransition->u32ElapsedMs + CLD_LEVELCONTROL_UPDATE_PERIOD_MS - 1) / CLD_LEVELCONTROL_UPDATE_PERIOD_MS;
+#else
+    if(psTransition->u32Time == 0)
+    {
+        return FALSE;
+    }
+
+    psTransition->iCurrentLevel += psTransition->iStepSize;
+    psTransition->u32Time--;
+#endif
+
+    return TRUE;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       iCLD_LevelControlMoveLevel
+ **
+ ** DESCRIPTION:
+ ** Gives the unclamped level a rate move has now reached
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsCLD_LevelControl_Transition *psTransition             Transition
+ **
+ ** RETURN:
+ ** int
+ **
+ ****************************************************************************/
+PRIVATE  int iCLD_LevelControlMoveLevel(
+                        tsCLD_LevelControl_Transition *psTransition)
+{
+
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+    int64 i64Level;
+
+    /* Step size is per update period, keep well inside int before the caller clamps */
+    i64Level = psTransition->iStartLevel + (((int64)psTransition->iStepSize * psTransition->u32ElapsedMs) / CLD_LEVELCONTROL_UPDATE_PERIOD_MS);
+    return (int)CLAMP(i64Level, (CLD_LEVELCONTROL_MIN_LEVEL - 1) * 100, (CLD_LEVELCONTROL_MAX_LEVEL + 1) * 100);
+#else
+    return psTransition->iCurrentLevel + psTransition->iStepSize;
+#endif
+}
+
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+/****************************************************************************
+ **
+ ** NAME:       vCLD_LevelControlChainTimedTransition
+ **
+ ** DESCRIPTION:
+ ** Starts the next phase of a multi-phase transition from the moment the
+ ** previous phase ended, so time past its end in the last update counts
+ ** towards the new phase
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsCLD_LevelControl_Transition *psTransition             Transition
+ **
+ ** RETURN:
+ ** None
+ **
+ ****************************************************************************/
+PRIVATE  void vCLD_LevelControlChainTimedTransition(
+                        tsCLD_LevelControl_Transition *psTransition)
+{
+
+    uint32 u32OvershootMs;
+
+    u32OvershootMs = psTransition->u32ElapsedMs - MIN(psTransition->u32ElapsedMs, psTransition->u32DurationMs);
+    vCLD_LevelControlStartTimedTransition(psTransition);
+    psTransition->u32ElapsedMs = u32OvershootMs;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       u32CLD_LevelControlNextStepTime
+ **
+ ** DESCRIPTION:
+ ** Works out the elapsed time at which a level moving linearly from its
+ ** start next crosses a whole level
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** int                         iStartLevel                 Level (x100) at time 0
+ ** int                         iDelta                      Change over u32DurationMs
+ ** uint32                      u32DurationMs               Time for iDelta
+ ** uint32                      u32ElapsedMs                Time now
+ **
+ ** RETURN:
+ ** uint32 - elapsed time in ms
+ **
+ ****************************************************************************/
+PRIVATE  uint32 u32CLD_LevelControlNextStepTime(
+                        int                         iStartLevel,
+                        int                         iDelta,
+                        uint32                      u32DurationMs,
+                        uint32                      u32ElapsedMs)
+{
+
+    int iLevel;
+    uint32 u32Distance;
+    uint64 u64Time;
+
+    if(iDelta == 0)
+    {
+        return CLD_LEVELCONTROL_NO_CHANGE_PENDING;
+    }
+
+    iLevel = iStartLevel + (int)(((int64)iDelta * u32ElapsedMs) / u32DurationMs);
+
+    /* Distance from the start to the first value of the next whole level */
+    if(iDelta > 0)
+    {
+        u32Distance = (uint32)((((iLevel / 100) + 1) * 100) - iStartLevel);
+    }
+    else
+    {
+        u32Distance = (uint32)(iStartLevel - (((iLevel / 100) * 100) - 1));
+        iDelta = -iDelta;
+    }
+
+    u64Time = (((uint64)u32Distance * u32DurationMs) + (uint64)iDelta - 1) / (uint64)iDelta;
+
+    return (uint32)MIN(u64Time, (uint64)CLD_LEVELCONTROL_NO_CHANGE_PENDING);
+}
+#endif
 #endif
 #endif
 /****************************************************************************/
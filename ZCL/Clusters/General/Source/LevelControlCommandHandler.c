@@ -345,6 +345,9 @@ PRIVATE  teZCL_Status eCLD_LevelControlHandleMoveToLevelCommand(
     {
         psCommon->sTransition.iStepSize = psCommon->sTransition.iTargetLevel - psCommon->sTransition.iCurrentLevel;
     }
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+    vCLD_LevelControlStartTimedTransition(&psCommon->sTransition);
+#endif
 
     /* Is command "with On/Off" ? */
     if(u8CommandIdentifier == E_CLD_LEVELCONTROL_CMD_MOVE_TO_LEVEL_WITH_ON_OFF)
@@ -491,6 +494,9 @@ PRIVATE  teZCL_Status eCLD_LevelControlHandleMoveCommand(
         break;
 
     }
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+    vCLD_LevelControlStartTimedTransition(&psCommon->sTransition);
+#endif
 
     /* Is command "with On/Off" ? */
     if(u8CommandIdentifier == E_CLD_LEVELCONTROL_CMD_MOVE_WITH_ON_OFF)
@@ -656,6 +662,9 @@ PRIVATE  teZCL_Status eCLD_LevelControlHandleStepCommand(
     {
         psCommon->sTransition.iStepSize = psCommon->sTransition.iTargetLevel - psCommon->sTransition.iCurrentLevel;
     }
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+    vCLD_LevelControlStartTimedTransition(&psCommon->sTransition);
+#endif
 
     /* Message data for callback */
     psCommon->sCallBackMessage.uMessage.psStepCommandPayload = &sPayload;
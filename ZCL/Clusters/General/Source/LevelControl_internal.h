@@ -96,6 +96,11 @@ PUBLIC teZCL_Status eCLD_LevelControlSetOnOffState(
                     bool_t                        bOn,
                     teCLD_OnOff_OffWithEffect   eCLD_OnOff_OffWithEffect);
 
+#ifdef CLD_LEVELCONTROL_TIMED_TRANSITIONS
+PUBLIC void vCLD_LevelControlStartTimedTransition(
+                    tsCLD_LevelControl_Transition *psTransition);
+#endif
+
 
 PUBLIC  teZCL_Status eCLD_LevelControlCommandMoveToClosestFreqCommandReceive(
                     ZPS_tsAfEvent               *pZPSevent,
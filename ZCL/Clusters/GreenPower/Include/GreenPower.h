@@ -70,6 +70,22 @@ extern "C" {
 #define GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES                                 (5)
 #endif
 
+/* Hash index over the GPD identity of the Sink/Proxy table entries, so that
+ * received GPDFs do not scan the whole table (GP_PROXY_SINK_TABLE_HASH_INDEX) */
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+#ifndef GP_PROXY_SINK_TABLE_HASH_BUCKETS
+#define GP_PROXY_SINK_TABLE_HASH_BUCKETS                                (16)
+#endif
+
+#if ((GP_PROXY_SINK_TABLE_HASH_BUCKETS & (GP_PROXY_SINK_TABLE_HASH_BUCKETS - 1)) != 0)
+#error GP_PROXY_SINK_TABLE_HASH_BUCKETS should be a power of 2
+#endif
+
+#if (GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES > 254) || (GP_PROXY_SINK_TABLE_HASH_BUCKETS > 254)
+#error GP_PROXY_SINK_TABLE_HASH_INDEX supports up to 254 table entries and buckets
+#endif
+#endif
+
 
 #ifndef GP_MAX_SINK_GROUP_LIST
 #define GP_MAX_SINK_GROUP_LIST                                          (2)
@@ -149,6 +165,81 @@ extern "C" {
 #define GP_DELAY_GOTXQUEUE_RESPONSE_AT_GPD                              (30)
 #endif
 
+/* Received GPD commands are looked up in a dispatch map of the translation table,
+ * keyed by GPD id and GPD command id, instead of walking every translation entry
+ * (GP_TRANSLATION_TABLE_DISPATCH_MAP). The map is rebuilt on the first GPDF after
+ * the table changed, applications that edit the translation table outside of the
+ * GP callbacks must call eGP_TranslationTableChanged */
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+#ifndef GP_COMBO_BASIC_DEVICE
+#error GP_TRANSLATION_TABLE_DISPATCH_MAP requires GP_COMBO_BASIC_DEVICE
+#endif
+#ifndef GP_TRANSLATION_DISPATCH_MAP_ENTRIES
+#define GP_TRANSLATION_DISPATCH_MAP_ENTRIES                             (GP_NUMBER_OF_TRANSLATION_TABLE_ENTRIES * 4)
+#endif
+#ifndef GP_TRANSLATION_DISPATCH_MAP_BUCKETS
+#define GP_TRANSLATION_DISPATCH_MAP_BUCKETS                             (16)
+#endif
+#if (GP_TRANSLATION_DISPATCH_MAP_BUCKETS & (GP_TRANSLATION_DISPATCH_MAP_BUCKETS - 1)) != 0
+#error GP_TRANSLATION_DISPATCH_MAP_BUCKETS must be a power of 2
+#endif
+#if (GP_TRANSLATION_DISPATCH_MAP_ENTRIES > 254) || (GP_TRANSLATION_DISPATCH_MAP_BUCKETS > 254) || (GP_NUMBER_OF_TRANSLATION_TABLE_ENTRIES > 255)
+#error GP_TRANSLATION_TABLE_DISPATCH_MAP supports up to 254 map entries and buckets
+#endif
+#endif
+
+/* GPD security frame counters are persisted only when they pass a high-water mark
+ * GP_SEC_FRAME_COUNTER_RESERVATION_FRAMES ahead of the last persisted value, and
+ * vGP_RestorePersistedData advances restored counters by the same amount
+ * (GP_SEC_FRAME_COUNTER_RESERVATION).
+ *
+ * This trades availability for replay protection. After a reset a GPD's frames
+ * are rejected until its counter passes the reserved mark, so up to
+ * GP_SEC_FRAME_COUNTER_RESERVATION_FRAMES legitimate frames per GPD (e.g. switch
+ * presses) are dropped. A larger reservation saves flash writes but widens that
+ * window. GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES lets the first frames at or
+ * below the mark through once after a restore; each of them may be a replay of
+ * a frame accepted before the reset, so the default keeps the strict behaviour */
+#ifdef GP_SEC_FRAME_COUNTER_RESERVATION
+#ifndef GP_SEC_FRAME_COUNTER_RESERVATION_FRAMES
+#define GP_SEC_FRAME_COUNTER_RESERVATION_FRAMES                         (16)
+#endif
+#ifndef GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES
+#define GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES                       (0)
+#endif
+#if (GP_SEC_FRAME_COUNTER_RESERVATION_FRAMES < 1)
+#error GP_SEC_FRAME_COUNTER_RESERVATION_FRAMES must be at least 1
+#endif
+#if (GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES > 255) || (GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES > GP_SEC_FRAME_COUNTER_RESERVATION_FRAMES)
+#error GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES must be 0 to 255 and no more than the reservation
+#endif
+#endif
+
+/* Buffered GPDFs are kept in a deadline heap and the GP end point only asks for
+ * a ms timer (E_ZCL_CBET_ENABLE_MS_TIMER) up to the earliest deadline instead of
+ * a continuous 1 ms tick (GP_TX_QUEUE_DEADLINE_TIMER). The application must run
+ * the timer for the requested period and post E_ZCL_CBET_TIMER_MS when it expires.
+ * Deadlines are kept against a free-running 32 bit ms counter read through
+ * GP_TX_QUEUE_TIME_MS() (zbPlatGetTime() unless defined by the application),
+ * so E_ZCL_CBET_TIMER_MS events raised for other end points (e.g. OTA) never
+ * make a GPDF go out early */
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+#ifndef GP_TX_QUEUE_TIME_MS
+#define GP_TX_QUEUE_TIME_MS()                                           zbPlatGetTime()
+#endif
+#ifndef GP_TX_QUEUE_MAX_TIMER_PERIOD_MS
+#define GP_TX_QUEUE_MAX_TIMER_PERIOD_MS                                 (100)
+#endif
+#if (GP_TX_QUEUE_MAX_TIMER_PERIOD_MS < 20) || (GP_TX_QUEUE_MAX_TIMER_PERIOD_MS > 0xFFFF)
+#error GP_TX_QUEUE_MAX_TIMER_PERIOD_MS must be 20 to 65535 ms
+#endif
+#endif
+
+/* Sink and proxy table attribute reads and Sink/Proxy Table Request responses
+ * serialise table entries straight into the outgoing APDU, an entry at a time,
+ * instead of through a table sized string (GP_TABLE_STREAM_ENCODER). Responses
+ * carry the entries that fit in the APDU, the rest are read with a later index */
+
 #define GREENPOWER_CLUSTER_ID                                           (0x0021)
 
 #define GREENPOWER_PROFILE_ID                                           (0xA1E0)
@@ -729,6 +820,26 @@ struct tsGP_TranslationTableEntry
 
 };
 
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+/* One translation of a GPD command, chained per hash of application id, SrcID/IEEE
+ * address and GPD command id in ascending translation table order. Translations of
+ * wildcard addresses are chained in the last bucket (GP_TRANSLATION_DISPATCH_MAP_BUCKETS) */
+typedef struct
+{
+    uint8                               u8TableIndex;
+    uint8                               u8CmdIndex;
+    uint8                               u8Next;
+}tsGP_TranslationDispatchEntry;
+
+typedef struct
+{
+    bool_t                              bValid;
+    bool_t                              bOverflow;
+    uint8                               au8Bucket[GP_TRANSLATION_DISPATCH_MAP_BUCKETS + 1];
+    tsGP_TranslationDispatchEntry       asEntry[GP_TRANSLATION_DISPATCH_MAP_ENTRIES];
+}tsGP_TranslationDispatchMap;
+#endif
+
 /* structure for sink table response command */
 typedef struct tsGP_SinkTableResposneCmdPayload
 {
@@ -787,6 +898,18 @@ typedef struct
   //  tsGP_ZgpsSinkAddrList               sUnicastSinkAddr[GP_MAX_UNICAST_SINK];
 }tsGP_ZgppProxySinkTable;
 
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+/* Chained hash index of the Sink/Proxy table. Every slot is linked into the chain of
+ * its application id and SrcID/IEEE address, chains are kept in ascending slot order.
+ * Entries with a wildcard address are linked into the last chain (GP_PROXY_SINK_TABLE_HASH_BUCKETS) */
+typedef struct
+{
+    uint8                               au8ChainHead[GP_PROXY_SINK_TABLE_HASH_BUCKETS + 1];
+    uint8                               au8NextSlot[GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES];
+    uint8                               au8SlotChain[GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES];
+}tsGP_ProxySinkTableIndex;
+#endif
+
 
 /* structure for the ZGP command cluster table */
 typedef struct {
@@ -913,12 +1036,13 @@ typedef enum
 }teGP_GreenPowerBufferedCommands;
 
 
-/* Structure for ZGP Duplicate filter table */
+/* Structure for ZGP Duplicate filter table, an entry is free when u8TimeOut is 0 */
 typedef struct
 {
     uint8                               u3SecLevel  :1;
     uint8                               u3ApplicationID   :3;
-    uint16                              u16AgingTime;
+    uint8                               u8TimeOut;
+    uint32                              u32ArrivalTime;
     tuGP_ZgpdDeviceAddr                 uZgpdDeviceAddr;
     union {
         uint32 u32gpdCrc;
@@ -957,8 +1081,26 @@ typedef struct
 typedef struct {
     DNODE                               dllGpNode;
     tsGP_BufferedApduInfo               sBufferedApduInfo;
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+    uint32                              u32Deadline;
+    uint8                               u8HeapIndex;
+#endif
 }tsGP_ZgpBufferedApduRecord;
 
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+/* Min-heap of buffered records ordered by deadline, times in ms of GP_TX_QUEUE_TIME_MS() */
+typedef struct
+{
+    uint32                              u32TimeMs;
+    uint32                              u32TimerExpiryMs;
+    uint32                              u32TimeoutDueMs;
+    bool_t                              bTimerRunning;
+    bool_t                              bTimeoutRunning;
+    uint8                               u8Size;
+    tsGP_ZgpBufferedApduRecord          *apsRecord[GP_MAX_NUMBER_BUFFERED_RECORDS];
+}tsGP_TxQueue;
+#endif
+
 typedef struct {
     uint8                               u8PDUSize;
     uint8                               u8SeqNum;
@@ -999,17 +1141,31 @@ typedef struct
     uint16                              u16TransmitChannelTimeout;
 #ifdef GP_COMBO_BASIC_DEVICE
     tsGP_TranslationTableEntry          *psZgpsTranslationTableEntry;
+#endif
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+    tsGP_TranslationDispatchMap         sTranslationDispatchMap;
 #endif
     uint64                              u64CommissionSetAddress;
     bool_t	                            bCommissionUnicast;
     uint16	                            u16CommissionUnicastAddress;
     tsGP_ZgpDuplicateTable              asZgpDuplicateFilterTable[GP_MAX_DUPLICATE_TABLE_ENTIRES];
     tsGP_ZgppProxySinkTable             asZgpsSinkProxyTable[GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES];
-
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+    tsGP_ProxySinkTableIndex            sProxySinkTableIndex;
+#endif
+#ifdef GP_SEC_FRAME_COUNTER_RESERVATION
+    uint32                              au32SecFrameCounterHighWater[GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES];
+#if (GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES > 0)
+    uint8                               au8SecFrameCounterGrace[GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES];
+#endif
+#endif
 
     DLIST                               lGpAllocList;
     DLIST                               lGpDeAllocList;
     tsGP_ZgpBufferedApduRecord          asZgpBufferedApduRecord[GP_MAX_NUMBER_BUFFERED_RECORDS];
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+    tsGP_TxQueue                        sTxQueue;
+#endif
     tsGP_Common                         sGPCommon;
 }tsGP_GreenPowerCustomData;
 
@@ -1031,6 +1187,14 @@ PUBLIC teZCL_Status eGP_Update20mS(
                     uint8                                  u8GreenPowerEndPointId);
 PUBLIC teZCL_Status eGP_Update1mS(
                     uint8                                  u8GreenPowerEndPointId);
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+PUBLIC teZCL_Status eGP_UpdateTxQueueTimer(
+                    uint8                                  u8GreenPowerEndPointId);
+#endif
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+PUBLIC teZCL_Status eGP_TranslationTableChanged(
+                    uint8                                  u8GreenPowerEndPointId);
+#endif
 
 PUBLIC void vZCL_HandleZgpDataIndication(
                     ZPS_tsAfEvent                          *pZPSevent,
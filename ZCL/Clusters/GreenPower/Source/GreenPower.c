@@ -49,6 +49,13 @@
 #define ALIAS_NWK_SEQ_NUM_ADDRESS_CONFLICT                0x30
 #define ZPS_NWK_CMD_ADDR_CONFLICT                          0xD
 #define GP_INVALID_CLUSTER_ID                            (0xFFFF)
+
+/* number of duplicate table entries a GPDF can be stored in */
+#if (GP_MAX_DUPLICATE_TABLE_ENTIRES > 1)
+#define GP_DUPLICATE_FILTER_WAYS                         (2)
+#else
+#define GP_DUPLICATE_FILTER_WAYS                         (1)
+#endif
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
@@ -57,6 +64,13 @@
 /***        Local Function Prototypes                                     ***/
 /****************************************************************************/
 PRIVATE void vCLD_GPTimerClickCallback(tsZCL_CallBackEvent *psCallBackEvent);
+PRIVATE uint8 u8GP_GetDuplicateFilterSlot(
+                    uint8                                  u8ApplicationID,
+                    tuGP_ZgpdDeviceAddr                    *puZgpdDeviceAddr,
+                    uint32                                 u32Key);
+PRIVATE bool_t bGP_IsDuplicateEntryLive(
+                    tsGP_ZgpDuplicateTable                 *psZgpDuplicateTable,
+                    uint32                                 u32Time);
  teZCL_Status eCLD_GPRegisterTimeServer(void);
 /****************************************************************************/
 /***        Exported Variables                                            ***/
@@ -268,11 +282,28 @@ PUBLIC teZCL_Status eGP_CreateGreenPower(
     for(u8Count=0; u8Count < GP_MAX_NUMBER_BUFFERED_RECORDS; u8Count++)
     {
         vDLISTaddToTail(&psCustomDataStructure->lGpDeAllocList, (DNODE *)&psCustomDataStructure->asZgpBufferedApduRecord[u8Count]);
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+        psCustomDataStructure->asZgpBufferedApduRecord[u8Count].u8HeapIndex = GP_TX_QUEUE_NOT_QUEUED;
+#endif
     }
-    //initialize the aging time of duplicate table
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+    memset(&psCustomDataStructure->sTxQueue, 0, sizeof(tsGP_TxQueue));
+#endif
+#ifdef GP_SEC_FRAME_COUNTER_RESERVATION
+    /* persist on the first accepted frame until the table has been restored */
+    memset(psCustomDataStructure->au32SecFrameCounterHighWater, 0, sizeof(psCustomDataStructure->au32SecFrameCounterHighWater));
+#if (GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES > 0)
+    memset(psCustomDataStructure->au8SecFrameCounterGrace, 0, sizeof(psCustomDataStructure->au8SecFrameCounterGrace));
+#endif
+#endif
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+    /* built on the first GPDF, the application sets up the translation table after create */
+    psCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+#endif
+    //initialize the duplicate table entries as free
     for(u8Count = 0; u8Count < GP_MAX_DUPLICATE_TABLE_ENTIRES; u8Count++)
     {
-        psCustomDataStructure->asZgpDuplicateFilterTable[u8Count].u16AgingTime = 0;
+        psCustomDataStructure->asZgpDuplicateFilterTable[u8Count].u8TimeOut = 0;
     }
 
     psCustomDataStructure->u8GPDataReqHandle = ZPS_NWK_GP_BASE_HANDLE + 1;
@@ -298,6 +329,9 @@ PUBLIC teZCL_Status eGP_CreateGreenPower(
     }
 #endif
     psCustomDataStructure->u16TransmitChannelTimeout = 0;
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+    vGP_RebuildProxySinkTableIndex(psCustomDataStructure);
+#endif
     eCLD_GPRegisterTimeServer();
     return E_ZCL_SUCCESS;
 }
@@ -351,6 +385,13 @@ PUBLIC teZCL_Status eCLD_GPRegisterTimeServer(void)
  ****************************************************************************/
 PRIVATE void vCLD_GPTimerClickCallback(tsZCL_CallBackEvent *psCallBackEvent)
 {
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+	/* the GP end point requests its own ms timer periods, ignore the 1 sec tick */
+	if(psCallBackEvent->eEventType == E_ZCL_CBET_TIMER_MS)
+	{
+		eGP_UpdateTxQueueTimer(psZCL_Common->u8GreenPowerMappedEpId);
+	}
+#else
 	static uint16 u16OneMSCounterValue = 0;
 
 	eGP_Update1mS(psZCL_Common->u8GreenPowerMappedEpId);
@@ -363,6 +404,71 @@ PRIVATE void vCLD_GPTimerClickCallback(tsZCL_CallBackEvent *psCallBackEvent)
 		eGP_Update20mS(psZCL_Common->u8GreenPowerMappedEpId);
 		u16OneMSCounterValue = 0;
 	}
+#endif
+}
+
+/****************************************************************************
+ **
+ ** NAME:       u8GP_GetDuplicateFilterSlot
+ **
+ ** DESCRIPTION:
+ ** Hashes GPD id and frame counter (or CRC) to the first duplicate table
+ ** entry the GPDF can be stored in
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8ApplicationID             Application ID
+ ** tuGP_ZgpdDeviceAddr         *puZgpdDeviceAddr           GPD address
+ ** uint32                      u32Key                      Frame counter or CRC
+ **
+ ** RETURN:
+ ** uint8 duplicate table index
+ **
+ ****************************************************************************/
+PRIVATE uint8 u8GP_GetDuplicateFilterSlot(
+                    uint8                                  u8ApplicationID,
+                    tuGP_ZgpdDeviceAddr                    *puZgpdDeviceAddr,
+                    uint32                                 u32Key)
+{
+    uint32 u32Hash = u32Key ^ u8ApplicationID;
+
+    if(u8ApplicationID == GP_APPL_ID_8_BYTE)
+    {
+        u32Hash ^= (uint32)puZgpdDeviceAddr->sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr ^
+                   (uint32)(puZgpdDeviceAddr->sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr >> 32);
+    }
+    else
+    {
+        u32Hash ^= puZgpdDeviceAddr->u32ZgpdSrcId;
+    }
+    u32Hash ^= u32Hash >> 16;
+    u32Hash ^= u32Hash >> 8;
+
+    return (uint8)(u32Hash % GP_MAX_DUPLICATE_TABLE_ENTIRES);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       bGP_IsDuplicateEntryLive
+ **
+ ** DESCRIPTION:
+ ** Checks if a duplicate table entry is used and its timeout has not passed.
+ ** The time has a resolution of one second so an entry lives between its
+ ** timeout and one second more, a time that went backwards expires it
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsGP_ZgpDuplicateTable      *psZgpDuplicateTable        Duplicate table entry
+ ** uint32                      u32Time                     Current ZCL time
+ **
+ ** RETURN:
+ ** TRUE if live, FALSE otherwise
+ **
+ ****************************************************************************/
+PRIVATE bool_t bGP_IsDuplicateEntryLive(
+                    tsGP_ZgpDuplicateTable                 *psZgpDuplicateTable,
+                    uint32                                 u32Time)
+{
+    return ((psZgpDuplicateTable->u8TimeOut != 0) &&
+            ((u32Time - psZgpDuplicateTable->u32ArrivalTime) <= psZgpDuplicateTable->u8TimeOut));
 }
 
 /****************************************************************************
@@ -618,7 +724,9 @@ PUBLIC bool_t bGP_IsDuplicatePkt(
 {
 
     uint8 i, u8TempData[12], u8Index = 0;
-    uint32 u32CRC = 0;
+    uint8 u8Slot, u8Free;
+    uint32 u32CRC = 0, u32Time;
+    tsGP_ZgpDuplicateTable *psZgpDuplicateTable;
 
     /* If packet rxed with no security, calculate CRC over device address, counter, GP command id */
     if(u8SecLevel == 0)
@@ -648,60 +756,70 @@ PUBLIC bool_t bGP_IsDuplicatePkt(
 
     }
 
-    /* traverse through duplicate table to check entry is existed or not. If entry existed
-     * returns TRUE otherwise FALSE */
-    for(i = 0; i< GP_MAX_DUPLICATE_TABLE_ENTIRES; i++)
+    /* the GPDF can only be stored in the entries following its hash slot, entries are
+     * aged against their arrival time when looked at */
+    u32Time = u32ZCL_GetUTCTime();
+    u8Slot = u8GP_GetDuplicateFilterSlot(u8ApplicationID,
+                                         &uZgpdDeviceAddr,
+                                         (u8SecLevel) ? u32SeqNoOrCounter : u32CRC);
+    u8Free = u8Slot;
+    for(i = 0; i < GP_DUPLICATE_FILTER_WAYS; i++)
     {
-        if(psGpCustomDataStructure->asZgpDuplicateFilterTable[i].u16AgingTime != 0)
-        {
+        psZgpDuplicateTable = &psGpCustomDataStructure->asZgpDuplicateFilterTable[(u8Slot + i) % GP_MAX_DUPLICATE_TABLE_ENTIRES];
 
-        	if((psGpCustomDataStructure->asZgpDuplicateFilterTable[i].u3ApplicationID ==u8ApplicationID) &&
-        			((psGpCustomDataStructure->asZgpDuplicateFilterTable[i].uZgpdDeviceAddr.u32ZgpdSrcId == uZgpdDeviceAddr.u32ZgpdSrcId)||
-        			(psGpCustomDataStructure->asZgpDuplicateFilterTable[i].uZgpdDeviceAddr.sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr  == uZgpdDeviceAddr.sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr)))
+        if(bGP_IsDuplicateEntryLive(psZgpDuplicateTable, u32Time) == FALSE)
+        {
+            psZgpDuplicateTable->u8TimeOut = 0;
+            u8Free = (u8Slot + i) % GP_MAX_DUPLICATE_TABLE_ENTIRES;
+            continue;
+        }
 
-        	{
-                if(psGpCustomDataStructure->asZgpDuplicateFilterTable[i].u3SecLevel)
+        if((psZgpDuplicateTable->u3ApplicationID ==u8ApplicationID) &&
+                ((psZgpDuplicateTable->uZgpdDeviceAddr.u32ZgpdSrcId == uZgpdDeviceAddr.u32ZgpdSrcId)||
+                (psZgpDuplicateTable->uZgpdDeviceAddr.sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr  == uZgpdDeviceAddr.sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr)))
+        {
+            if(psZgpDuplicateTable->u3SecLevel)
+            {
+                 /* compare */
+                if(psZgpDuplicateTable->uData.u32SecFrameCounter == u32SeqNoOrCounter)
                 {
-                     /* compare */
-                    if(psGpCustomDataStructure->asZgpDuplicateFilterTable[i].uData.u32SecFrameCounter == u32SeqNoOrCounter)
-                    {
-                        return TRUE;
-                    }
+                    return TRUE;
                 }
-                else
-                {   /* compare */
-                    if(u32CRC == psGpCustomDataStructure->asZgpDuplicateFilterTable[i].uData.u32gpdCrc)
-                    {
-                        return TRUE;
-                    }
+            }
+            else
+            {   /* compare */
+                if(u32CRC == psZgpDuplicateTable->uData.u32gpdCrc)
+                {
+                    return TRUE;
                 }
             }
         }
+        /* otherwise replace the oldest entry */
+        if((psGpCustomDataStructure->asZgpDuplicateFilterTable[u8Free].u8TimeOut != 0) &&
+           ((u32Time - psZgpDuplicateTable->u32ArrivalTime) >
+            (u32Time - psGpCustomDataStructure->asZgpDuplicateFilterTable[u8Free].u32ArrivalTime)))
+        {
+            u8Free = (u8Slot + i) % GP_MAX_DUPLICATE_TABLE_ENTIRES;
+        }
     }
     /* packet is not duplicate so add this entry in duplicate filter */
     if(u8TimeOutInSec)
-	{
-		for(i = 0; i< GP_MAX_DUPLICATE_TABLE_ENTIRES; i++)
-		 {
-			/* find a free duplicate table entry */
-			if(psGpCustomDataStructure->asZgpDuplicateFilterTable[i].u16AgingTime == 0)
-			{
-				psGpCustomDataStructure->asZgpDuplicateFilterTable[i].u16AgingTime = (u8TimeOutInSec * 50);
-				psGpCustomDataStructure->asZgpDuplicateFilterTable[i].u3ApplicationID = u8ApplicationID;
-				psGpCustomDataStructure->asZgpDuplicateFilterTable[i].uZgpdDeviceAddr = uZgpdDeviceAddr;
-				psGpCustomDataStructure->asZgpDuplicateFilterTable[i].u3SecLevel = u8SecLevel;
-				if(u8SecLevel)
-				{
-					psGpCustomDataStructure->asZgpDuplicateFilterTable[i].uData.u32SecFrameCounter = u32SeqNoOrCounter;
-				}
-				else
-				{
-					psGpCustomDataStructure->asZgpDuplicateFilterTable[i].uData.u32gpdCrc = u32CRC;
-				}
-				break;
-			}
-		 }
-	}
+    {
+        psZgpDuplicateTable = &psGpCustomDataStructure->asZgpDuplicateFilterTable[u8Free];
+        psZgpDuplicateTable->u8TimeOut = u8TimeOutInSec;
+        psZgpDuplicateTable->u32ArrivalTime = u32Time;
+        psZgpDuplicateTable->u3ApplicationID = u8ApplicationID;
+        psZgpDuplicateTable->uZgpdDeviceAddr = uZgpdDeviceAddr;
+        psZgpDuplicateTable->u3SecLevel = u8SecLevel;
+        if(u8SecLevel)
+        {
+            psZgpDuplicateTable->uData.u32SecFrameCounter = u32SeqNoOrCounter;
+        }
+        else
+        {
+            psZgpDuplicateTable->uData.u32gpdCrc = u32CRC;
+        }
+    }
 
     return FALSE;
 }
@@ -751,6 +869,21 @@ PUBLIC teZCL_Status u16GP_APduInstanceReadWriteLongString(
             {
                 // get APDU size
                 uint16 u16APduSize = PDUM_u16APduGetSize(PDUM_thAPduInstanceGetApdu(hAPduInst));
+#ifdef GP_TABLE_STREAM_ENCODER
+                if(u16Pos < u16APduSize)
+                {
+                    /* serialise entries straight into the APDU */
+                    *pu16NoOfBytes = u16GP_StreamTableString(u8EndPoint,
+                                                             TRUE,
+                                                             (uint8 *)(PDUM_pvAPduInstanceGetPayload(hAPduInst)) + u16Pos,
+                                                             u16APduSize - u16Pos);
+                    if(*pu16NoOfBytes != 0)
+                    {
+                        return E_ZCL_SUCCESS;
+                    }
+                }
+                return E_ZCL_ERR_INSUFFICIENT_SPACE;
+#else
 
                 // get string size
                 u16stringSize = u16GP_GetStringSizeOfSinkTable(u8EndPoint, &u8NoOfTableEntries, NULL);
@@ -771,6 +904,7 @@ PUBLIC teZCL_Status u16GP_APduInstanceReadWriteLongString(
                 	DBG_vPrintf(TRACE_GP_DEBUG, "E_ZCL_ERR_INSUFFICIENT_SPACE ASinkTable size = %d  u16stringSize = %d \n",*pu16NoOfBytes, u16stringSize);
                 	return E_ZCL_ERR_INSUFFICIENT_SPACE;
                 }
+#endif
             }
         }
 
@@ -786,6 +920,21 @@ PUBLIC teZCL_Status u16GP_APduInstanceReadWriteLongString(
             	/* write into APDU */
                 // get APDU size
                 u16APduSize = PDUM_u16APduGetSize(PDUM_thAPduInstanceGetApdu(hAPduInst));
+#ifdef GP_TABLE_STREAM_ENCODER
+                if(u16Pos < u16APduSize)
+                {
+                    /* serialise entries straight into the APDU */
+                    *pu16NoOfBytes = u16GP_StreamTableString(u8EndPoint,
+                                                             FALSE,
+                                                             (uint8 *)(PDUM_pvAPduInstanceGetPayload(hAPduInst)) + u16Pos,
+                                                             u16APduSize - u16Pos);
+                    if(*pu16NoOfBytes != 0)
+                    {
+                        return E_ZCL_SUCCESS;
+                    }
+                }
+                return E_ZCL_ERR_INSUFFICIENT_SPACE;
+#else
 
                 // get string size
                 u16stringSize = u16GP_GetStringSizeOfProxyTable(u8EndPoint, &u8NoOfTableEntries, NULL);
@@ -806,6 +955,7 @@ PUBLIC teZCL_Status u16GP_APduInstanceReadWriteLongString(
                 {
                 	return E_ZCL_ERR_INSUFFICIENT_SPACE;
                 }
+#endif
             }
             /* Proxy and Sink table are read only, no need to suppot write functionality*/
 
@@ -1077,6 +1227,9 @@ PUBLIC void vGP_CallbackForPersistData(void)
                              &psGpCustomDataStructure) == E_ZCL_SUCCESS)
         {
 
+#ifdef GP_SEC_FRAME_COUNTER_RESERVATION
+            vGP_ReserveSecFrameCounters(psGpCustomDataStructure);
+#endif
             psGpCustomDataStructure->sGPCommon.sGreenPowerCallBackMessage.eEventType = E_GP_PERSIST_SINK_PROXY_TABLE;
 
             psGpCustomDataStructure->sGPCommon.sGreenPowerCallBackMessage.uMessage.psZgpsProxySinkTable =
@@ -1233,6 +1386,17 @@ PUBLIC void vGP_RestorePersistedData( tsGP_ZgppProxySinkTable
 #endif
 #endif
 			}
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+			/* table may have been reset or loaded by the application */
+			vGP_RebuildProxySinkTableIndex(psGpCustomDataStructure);
+#endif
+#ifdef GP_SEC_FRAME_COUNTER_RESERVATION
+			/* never accept a frame counter that may have been seen before the reset */
+			vGP_AdvanceSecFrameCounters(psGpCustomDataStructure);
+#endif
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+			psGpCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+#endif
 			// release mutex
 			#ifndef COOPERATIVE
 				eZCL_ReleaseMutex(psEndPointDefinition);
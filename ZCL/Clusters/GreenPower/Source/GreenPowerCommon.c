@@ -60,6 +60,21 @@
 #define D_MAX                           100
 #define E_GP_ALL_ENPOINTS               0xFF
 #define E_GP_EP_INDEPENDENT				0x00
+
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+#define GP_PROXY_SINK_TABLE_INDEX_END           (0xFF)
+#define GP_PROXY_SINK_TABLE_WILDCARD_CHAIN      (GP_PROXY_SINK_TABLE_HASH_BUCKETS)
+
+/* which entries an index lookup accepts */
+#define GP_TABLE_ENTRY_ANY                      (0)
+#define GP_TABLE_ENTRY_PROXY                    (1)
+#define GP_TABLE_ENTRY_SINK                     (2)
+#endif
+
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+#define GP_TRANSLATION_DISPATCH_MAP_END         (0xFF)
+#define GP_TRANSLATION_DISPATCH_WILDCARD_BUCKET (GP_TRANSLATION_DISPATCH_MAP_BUCKETS)
+#endif
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
@@ -126,6 +141,45 @@ bool_t bGP_FillCommInd(
 		          tsZCL_EndPointDefinition    							*psEndPointDefinition,
 		          tsGP_GreenPowerCustomData                              *psGpCustomDataStructure);
 
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+PRIVATE uint8 u8GP_GetProxySinkTableChain(
+                    uint8                                  u8ApplicationId,
+                    tuGP_ZgpdDeviceAddr                    *puZgpdAddress);
+
+PRIVATE void vGP_LinkProxySinkTableSlot(
+                    tsGP_ProxySinkTableIndex               *psIndex,
+                    uint8                                  u8Slot,
+                    uint8                                  u8Chain);
+
+PRIVATE bool_t bGP_IsProxySinkTableEntryMatch(
+                    tsGP_ZgppProxySinkTable                *psProxySinkTableEntry,
+                    uint8                                  u8EntryFilter,
+                    uint8                                  u8ApplicationId,
+                    tuGP_ZgpdDeviceAddr                    *puZgpdAddress);
+
+PRIVATE bool_t bGP_FindIndexedGPD(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure,
+                    uint8                                  u8EntryFilter,
+                    uint8                                  u8ApplicationId,
+                    tuGP_ZgpdDeviceAddr                    *puZgpdAddress,
+                    tsGP_ZgppProxySinkTable                **psProxySinkTableEntry);
+#endif
+
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+PRIVATE void vGP_BuildTranslationDispatchMap(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure);
+
+PRIVATE uint8 u8GP_GetTranslationDispatchBucket(
+                    uint8                                  u8ApplicationId,
+                    tuGP_ZgpdDeviceAddr                    *puZgpdAddress,
+                    teGP_ZgpdCommandId                     eZgpdCommandId);
+
+PRIVATE uint8 u8GP_NextTranslationDispatchEntry(
+                    tsGP_TranslationDispatchMap            *psMap,
+                    uint8                                  *pu8Entry,
+                    uint8                                  *pu8WildcardEntry);
+#endif
+
 /****************************************************************************/
 /***        Exported Variables                                            ***/
 /****************************************************************************/
@@ -168,7 +222,9 @@ PUBLIC bool_t bGP_IsSinkTableEntryPresent(
     tsZCL_ClusterInstance                   *psClusterInstance;
     tsGP_GreenPowerCustomData               *psGpCustomDataStructure;
     uint8                   				u8Status;
+#ifndef GP_PROXY_SINK_TABLE_HASH_INDEX
     uint8                                   i;
+#endif
     bool_t                                  bZgpIdMatch = FALSE;
 
     /* Check pointers */
@@ -203,6 +259,13 @@ PUBLIC bool_t bGP_IsSinkTableEntryPresent(
 		   E_CLD_GP_ATTR_ZGPS_COMMUNICATION_MODE,
 		   &eCommunicationMode);
 	}
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+    bZgpIdMatch = bGP_FindIndexedGPD(psGpCustomDataStructure,
+                                     GP_TABLE_ENTRY_SINK,
+                                     u8ApplicationId,
+                                     puZgpdAddress,
+                                     psSinkTableEntry);
+#else
     for(i = 0; i< GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES; i++)
     {
 
@@ -228,6 +291,7 @@ PUBLIC bool_t bGP_IsSinkTableEntryPresent(
 
         }
     }
+#endif
 
     // release mutex
     #ifndef COOPERATIVE
@@ -269,7 +333,9 @@ PUBLIC bool_t bGP_IsProxyTableEntryPresent(
     tsZCL_ClusterInstance                   *psClusterInstance;
     tsGP_GreenPowerCustomData               *psGpCustomDataStructure;
     uint8                   				u8Status;
+#ifndef GP_PROXY_SINK_TABLE_HASH_INDEX
     uint8                                   i;
+#endif
     bool_t                                  bZgpIdMatch = FALSE;
 
 
@@ -296,7 +362,13 @@ PUBLIC bool_t bGP_IsProxyTableEntryPresent(
         eZCL_GetMutex(psEndPointDefinition);
    #endif
 
-
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+    bZgpIdMatch = bGP_FindIndexedGPD(psGpCustomDataStructure,
+                                     GP_TABLE_ENTRY_PROXY,
+                                     u8ApplicationId,
+                                     puZgpdAddress,
+                                     psProxySinkTableEntry);
+#else
     for(i = 0; i< GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES; i++)
     {   /* check if sink table entry is not empty */
 
@@ -316,6 +388,7 @@ PUBLIC bool_t bGP_IsProxyTableEntryPresent(
 		}
 
 	}
+#endif
 
     // release mutex
     #ifndef COOPERATIVE
@@ -612,6 +685,10 @@ bool_t bGP_CheckGroupTable(uint16 u16GrpId )
 
 		/* Give Application Callback  */
 		psEndPointDefinition->pCallBackFunctions(&psGpCustomDataStructure->sGPCommon.sGPCustomCallBackEvent);
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+		/* the application may have changed the translation table */
+		psGpCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+#endif
 		return TRUE;
 	}
 	else if(psZgpDataIndication->u8CommandId == E_GP_COMMISSIONING)
@@ -647,6 +724,10 @@ bool_t bGP_CheckGroupTable(uint16 u16GrpId )
 
 	/* Give Application Callback for functionality matching */
 	psEndPointDefinition->pCallBackFunctions(&psGpCustomDataStructure->sGPCommon.sGPCustomCallBackEvent);
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+	/* the application may have changed the translation table */
+	psGpCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+#endif
 	if((psGpCustomDataStructure->sGPCommon.sGreenPowerCallBackMessage.uMessage.bIsActAsTempMaster) ||
 			(psZgpDataIndication->bRxAfterTx == FALSE))
 	{
@@ -828,6 +909,66 @@ PUBLIC teZCL_Status eGP_GPDFHandler(
         }
     #endif
 
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+    if(!psGpCustomDataStructure->sTranslationDispatchMap.bValid)
+    {
+        vGP_BuildTranslationDispatchMap(psGpCustomDataStructure);
+    }
+    /* Wildcard GPD addresses match any table address and hash to the wildcard
+     * bucket itself, only the table walk handles them */
+    if((!psGpCustomDataStructure->sTranslationDispatchMap.bOverflow) &&
+       (((u8ApplicationId == GP_APPL_ID_4_BYTE) &&
+         (puZgpdAddress->u32ZgpdSrcId != 0xFFFFFFFF)) ||
+        ((u8ApplicationId != GP_APPL_ID_4_BYTE) &&
+         (puZgpdAddress->sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr != 0xFFFFFFFFFFFFFFFFULL))))
+    {
+        tsGP_TranslationDispatchMap *psMap = &psGpCustomDataStructure->sTranslationDispatchMap;
+        tsGP_TranslationDispatchEntry *psEntry;
+        uint8 u8Entry, u8WildcardEntry, u8Found;
+
+        u8Entry = psMap->au8Bucket[u8GP_GetTranslationDispatchBucket(u8ApplicationId, puZgpdAddress, eZgpdCommandId)];
+        u8WildcardEntry = psMap->au8Bucket[GP_TRANSLATION_DISPATCH_WILDCARD_BUCKET];
+
+        /* visit candidate translations in table order, as the table walk does */
+        while((u8Found = u8GP_NextTranslationDispatchEntry(psMap, &u8Entry, &u8WildcardEntry)) != GP_TRANSLATION_DISPATCH_MAP_END)
+        {
+            psEntry = &psMap->asEntry[u8Found];
+            i = psEntry->u8TableIndex;
+            if((psGpCustomDataStructure->psZgpsTranslationTableEntry[i].psGpToZclCmdInfo[psEntry->u8CmdIndex].eZgpdCommandId != eZgpdCommandId) ||
+               (!bGP_CheckGPDAddressMatch(
+                       (psGpCustomDataStructure->psZgpsTranslationTableEntry[i].b8Options & (uint8)GP_APPLICATION_ID_MASK),
+                       u8ApplicationId,
+                       &psGpCustomDataStructure->psZgpsTranslationTableEntry[i].uZgpdDeviceAddr,
+                       puZgpdAddress)))
+            {
+                continue;
+            }
+            if(bMatchSuccess)
+            {
+                /* the loop back walk continues from this entry */
+                eGP_BufferLoopBackPacket(
+                        psEndPointDefinition,
+                        psGpCustomDataStructure,
+                        i,
+                        u8ApplicationId,
+                        puZgpdAddress,
+                        eZgpdCommandId,
+                        u8GpdCommandPayloadLength,
+                        pu8GpdCommandPayload);
+                break;
+            }
+            bMatchSuccess = TRUE;
+            eGP_TranslateCommandIntoZcl(
+                    psEndPointDefinition->u8EndPointNumber,
+                    i,
+                    psEntry->u8CmdIndex,
+                    psGpCustomDataStructure,
+                    u8GpdCommandPayloadLength,
+                    pu8GpdCommandPayload);
+        }
+    }
+    else
+#endif
     /* Traverse translation table */
     for(i = 0; i < GP_NUMBER_OF_TRANSLATION_TABLE_ENTRIES; i++)
     {
@@ -1101,6 +1242,11 @@ void vGP_RemoveGPDFromProxySinkTable( uint8                                u8End
 	 ZPS_tuAfZgpGreenPowerId uGreenPowerId;
 	 ZPS_tsAfZgpGpstEntry *psAfZgpGpstEntry;
 	 tsGP_ZgppProxySinkTable                              *psSinkProxyTableEntry;
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+	 tsZCL_EndPointDefinition                             *psEndPointDefinition;
+	 tsZCL_ClusterInstance                                *psClusterInstance;
+	 tsGP_GreenPowerCustomData                            *psGpCustomDataStructure;
+#endif
 	 for(i=0; i < GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES; i++)
 	 {
 			if(bGP_IsProxyTableEntryPresent(
@@ -1130,6 +1276,21 @@ void vGP_RemoveGPDFromProxySinkTable( uint8                                u8End
 				psSinkProxyTableEntry->b16Options &= ~GP_APPLICATION_ID_MASK ;
 				psSinkProxyTableEntry->u16ZgpdAssignedAlias =0;
 				memset(&psSinkProxyTableEntry->sZgpdKey,0,sizeof(psSinkProxyTableEntry->sZgpdKey));
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+				/* application id is cleared, move the entry to the chain of its new identity */
+				if(eGP_FindGpCluster(u8EndPointNumber,
+		#ifdef GP_COMBO_BASIC_DEVICE
+						TRUE,
+		#else
+						FALSE,
+		#endif
+						&psEndPointDefinition,
+						&psClusterInstance,
+						&psGpCustomDataStructure) == E_ZCL_SUCCESS)
+				{
+					vGP_UpdateProxySinkTableIndex(psGpCustomDataStructure, psSinkProxyTableEntry);
+				}
+#endif
 		    }
 	 }
 	 /* remove the security details in stack also*/
@@ -1201,6 +1362,9 @@ PUBLIC bool_t bGP_GetFreeProxySinkTableEntry(
             #endif
              memset(&psGpCustomDataStructure->asZgpsSinkProxyTable[i],0,sizeof(tsGP_ZgppProxySinkTable));
              psGpCustomDataStructure->asZgpsSinkProxyTable[i].bProxyTableEntryOccupied = TRUE;
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+             vGP_UpdateProxySinkTableIndex(psGpCustomDataStructure, &psGpCustomDataStructure->asZgpsSinkProxyTable[i]);
+#endif
             return TRUE;
         }
     }
@@ -1409,7 +1573,6 @@ PUBLIC bool_t bGP_IsFreshPkt(
 					uint8                                  u8SecurityLevel )
 {
 
-
     /* If the GPD command used SecurityLevel 0b10 or 0b11, then the filtering of duplicate messages is performed based on the
      * GPD security  frame counter, stored in the Proxy/Sink Table entry for this GPD */
 
@@ -1433,13 +1596,40 @@ PUBLIC bool_t bGP_IsFreshPkt(
     	  ( ( u8SecurityLevel & 0x3 ) != 0 ) )
     {
 	    psTableEntry->u32ZgpdSecFrameCounter = u32SeqNoOrCounter;
+#ifdef GP_SEC_FRAME_COUNTER_RESERVATION
+	    if((psTableEntry >= &psGpCustomDataStructure->asZgpsSinkProxyTable[0]) &&
+	       (psTableEntry < &psGpCustomDataStructure->asZgpsSinkProxyTable[GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES]))
+	    {
+	        uint8 u8Index = (uint8)(psTableEntry - psGpCustomDataStructure->asZgpsSinkProxyTable);
+
+	        /* counters up to the high-water mark are covered by the last persisted value */
+	        if(u32SeqNoOrCounter <= psGpCustomDataStructure->au32SecFrameCounterHighWater[u8Index])
+	        {
+#if (GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES > 0)
+	            /* restore window, once the grace frames are used up reject the rest of it */
+	            if((psGpCustomDataStructure->au8SecFrameCounterGrace[u8Index]) &&
+	               (--psGpCustomDataStructure->au8SecFrameCounterGrace[u8Index] == 0))
+	            {
+	                psTableEntry->u32ZgpdSecFrameCounter = psGpCustomDataStructure->au32SecFrameCounterHighWater[u8Index];
+	            }
+#endif
+	            return TRUE;
+	        }
+#if (GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES > 0)
+	        psGpCustomDataStructure->au8SecFrameCounterGrace[u8Index] = 0;
+#endif
+	    }
+#endif
 	    vGP_CallbackForPersistData();
     }
     else if ( ( (psTableEntry->b16Options & GP_PROXY_TABLE_SECURITY_USE_MASK) == 0) &&
     		( ( u8SecurityLevel & 0x3 ) == 0 ) )
     {
     	 psTableEntry->u32ZgpdSecFrameCounter = u32SeqNoOrCounter;
+#ifndef GP_SEC_FRAME_COUNTER_RESERVATION
+    	 /* unsecured entries only hold the MAC sequence number, not worth a write per GPDF */
     	 vGP_CallbackForPersistData();
+#endif
     }
 
     return TRUE;
@@ -1555,6 +1745,10 @@ PUBLIC teZCL_Status eGp_BufferTransmissionPacket(
         /* Add to the Alloc list as tail */
         vDLISTaddToTail(&psGreenPowerCustomData->lGpAllocList,
                             (DNODE *)psZgpBufferedApduRecord);
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+        vGP_TxQueueSchedule(psGreenPowerCustomData, psZgpBufferedApduRecord);
+        vGP_TxQueueArmTimer(psGreenPowerCustomData);
+#endif
         DBG_vPrintf(TRACE_GP_DEBUG, "eGp_BufferTransmissionPacket delay = %d\n",
                 psZgpBufferedApduRecord->sBufferedApduInfo.u16Delay);
     }
@@ -1847,9 +2041,22 @@ PUBLIC void vGp_TransmissionTimerCallback(
     /* Get Head Pointer of Alloc List */
     psZgpBufferedApduRecord = (tsGP_ZgpBufferedApduRecord *)psDLISTgetHead(&psGpCustomDataStructure->lGpAllocList);
 
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+    /* Nothing to do until the earliest deadline */
+    if((psGpCustomDataStructure->sTxQueue.u8Size == 0) ||
+       (!bGP_IsTxQueueRecordDue(psGpCustomDataStructure, psGpCustomDataStructure->sTxQueue.apsRecord[0])))
+    {
+        return;
+    }
+#endif
+
     /* Check Pointer */
     while(psZgpBufferedApduRecord)
     {
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+        /* Transmit packet once its deadline is reached */
+        if(bGP_IsTxQueueRecordDue(psGpCustomDataStructure, psZgpBufferedApduRecord))
+#else
         /* Decrement delay, transmit packet if delay reached zero */
         if(psZgpBufferedApduRecord->sBufferedApduInfo.u16Delay)
         {
@@ -1857,6 +2064,7 @@ PUBLIC void vGp_TransmissionTimerCallback(
         }
 
         if(psZgpBufferedApduRecord->sBufferedApduInfo.u16Delay == 0x00)
+#endif
         {
 
 #ifdef GP_COMBO_BASIC_DEVICE
@@ -1952,6 +2160,9 @@ PUBLIC void vGp_TransmissionTimerCallback(
 				/* Before Transmission delete from alloc list and add to the dealloc list */
 				psDLISTremove(&psGpCustomDataStructure->lGpAllocList,
 						(DNODE *)psZgpBufferedApduRecord);
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+				vGP_TxQueueRemove(psGpCustomDataStructure, psZgpBufferedApduRecord);
+#endif
 
 				// add to free list
 				vDLISTaddToTail(&psGpCustomDataStructure->lGpDeAllocList,
@@ -3136,6 +3347,9 @@ PRIVATE void vGP_TxLoopBackCmds(
 		if(bMatchSuccess)
 		{
 			psZgpBufferedApduRecord->sBufferedApduInfo.u16Delay = 3;
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+			vGP_TxQueueSchedule(psGpCustomDataStructure, psZgpBufferedApduRecord);
+#endif
 			break;
 		}
 	}
@@ -3279,6 +3493,9 @@ PUBLIC  bool_t bGP_AddOrUpdateProxySinkTableEntries   (
 	  psZgppProxySinkTable->uZgpdDeviceAddr.sZgpdDeviceAddrAppId2.u8EndPoint =
 			  psZgpDataIndication->uZgpdDeviceAddr.sZgpdDeviceAddrAppId2.u8EndPoint;
    }
+#endif
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+   vGP_UpdateProxySinkTableIndex(psGpCustomDataStructure, psZgppProxySinkTable);
 #endif
 	if(psZgpDataIndication->bTunneledPkt == FALSE)
 	{
@@ -4681,7 +4898,9 @@ PRIVATE bool_t bGP_IsGPDPresent(
     tsZCL_ClusterInstance                   *psClusterInstance;
     tsGP_GreenPowerCustomData               *psGpCustomDataStructure;
     uint8                   				u8Status;
+#ifndef GP_PROXY_SINK_TABLE_HASH_INDEX
     uint8                                   i;
+#endif
     bool_t                                  bZgpIdMatch = FALSE;
 
 
@@ -4708,7 +4927,13 @@ PRIVATE bool_t bGP_IsGPDPresent(
         eZCL_GetMutex(psEndPointDefinition);
    #endif
 
-
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+    bZgpIdMatch = bGP_FindIndexedGPD(psGpCustomDataStructure,
+                                     GP_TABLE_ENTRY_ANY,
+                                     u8ApplicationId,
+                                     puZgpdAddress,
+                                     psProxySinkTableEntry);
+#else
     for(i = 0; i< GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES; i++)
     {   /* check if sink table entry is not empty */
     	DBG_vPrintf(TRACE_GP_DEBUG, " bGP_IsGPDPresent appId1 =%d appid 2 = %d Address = 0x%08x, Address 2 = 0x%08x \n",
@@ -4728,6 +4953,7 @@ PRIVATE bool_t bGP_IsGPDPresent(
 			break;
 		}
 	}
+#endif
 
     // release mutex
     #ifndef COOPERATIVE
@@ -4737,6 +4963,761 @@ PRIVATE bool_t bGP_IsGPDPresent(
     return bZgpIdMatch;
 }
 #endif
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+/****************************************************************************
+ **
+ ** NAME:       vGP_RebuildProxySinkTableIndex
+ **
+ ** DESCRIPTION:
+ ** Rebuilds the GPD hash index from the contents of the Sink/Proxy table,
+ ** used when the whole table has been initialised or restored
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** tsGP_GreenPowerCustomData     *psGpCustomDataStructure       Custom data
+ **
+ ** RETURN:
+ ** None
+ **
+ ****************************************************************************/
+PUBLIC void vGP_RebuildProxySinkTableIndex(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure)
+{
+    tsGP_ProxySinkTableIndex                *psIndex = &psGpCustomDataStructure->sProxySinkTableIndex;
+    tsGP_ZgppProxySinkTable                 *psEntry;
+    uint8                                   i;
+
+    memset(psIndex->au8ChainHead, GP_PROXY_SINK_TABLE_INDEX_END, sizeof(psIndex->au8ChainHead));
+
+    /* link from the last slot so that every insertion is at the head of its chain */
+    for(i = GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES; i > 0; i--)
+    {
+        psEntry = &psGpCustomDataStructure->asZgpsSinkProxyTable[i - 1];
+        vGP_LinkProxySinkTableSlot(psIndex,
+                                   i - 1,
+                                   u8GP_GetProxySinkTableChain((uint8)(psEntry->b16Options & GP_APPLICATION_ID_MASK),
+                                                               &psEntry->uZgpdDeviceAddr));
+    }
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vGP_UpdateProxySinkTableIndex
+ **
+ ** DESCRIPTION:
+ ** Moves a Sink/Proxy table entry to the hash chain of its current application
+ ** id and address, to be called whenever either of them has been written
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** tsGP_GreenPowerCustomData     *psGpCustomDataStructure       Custom data
+ ** tsGP_ZgppProxySinkTable       *psProxySinkTableEntry         Updated entry
+ **
+ ** RETURN:
+ ** None
+ **
+ ****************************************************************************/
+PUBLIC void vGP_UpdateProxySinkTableIndex(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure,
+                    tsGP_ZgppProxySinkTable                *psProxySinkTableEntry)
+{
+    tsGP_ProxySinkTableIndex                *psIndex = &psGpCustomDataStructure->sProxySinkTableIndex;
+    uint8                                   u8Slot;
+    uint8                                   *pu8Link;
+
+    u8Slot = (uint8)(psProxySinkTableEntry - psGpCustomDataStructure->asZgpsSinkProxyTable);
+    if(u8Slot >= GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES)
+    {
+        return;
+    }
+
+    /* unlink from the chain of the previous identity */
+    pu8Link = &psIndex->au8ChainHead[psIndex->au8SlotChain[u8Slot]];
+    while((*pu8Link != u8Slot) && (*pu8Link != GP_PROXY_SINK_TABLE_INDEX_END))
+    {
+        pu8Link = &psIndex->au8NextSlot[*pu8Link];
+    }
+    if(*pu8Link == u8Slot)
+    {
+        *pu8Link = psIndex->au8NextSlot[u8Slot];
+    }
+
+    vGP_LinkProxySinkTableSlot(psIndex,
+                               u8Slot,
+                               u8GP_GetProxySinkTableChain((uint8)(psProxySinkTableEntry->b16Options & GP_APPLICATION_ID_MASK),
+                                                           &psProxySinkTableEntry->uZgpdDeviceAddr));
+}
+
+/****************************************************************************
+ **
+ ** NAME:       u8GP_GetProxySinkTableChain
+ **
+ ** DESCRIPTION:
+ ** Hashes application id and SrcID/IEEE address of a GPD to its index chain.
+ ** The endpoint is not hashed as bGP_CheckGPDAddressMatch treats 0x00 and 0xFF
+ ** as wildcards, wildcard addresses map to GP_PROXY_SINK_TABLE_WILDCARD_CHAIN
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** uint8                         u8ApplicationId                Application ID
+ ** tuGP_ZgpdDeviceAddr           *puZgpdAddress                 ZGP device address
+ **
+ ** RETURN:
+ ** uint8 chain index
+ **
+ ****************************************************************************/
+PRIVATE uint8 u8GP_GetProxySinkTableChain(
+                    uint8                                  u8ApplicationId,
+                    tuGP_ZgpdDeviceAddr                    *puZgpdAddress)
+{
+    uint32                                  u32Hash;
+
+    if(u8ApplicationId == GP_APPL_ID_4_BYTE)
+    {
+        if(puZgpdAddress->u32ZgpdSrcId == 0xFFFFFFFF)
+        {
+            return GP_PROXY_SINK_TABLE_WILDCARD_CHAIN;
+        }
+        u32Hash = puZgpdAddress->u32ZgpdSrcId;
+    }
+    else
+    {
+        if(puZgpdAddress->sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr == 0xFFFFFFFFFFFFFFFFULL)
+        {
+            return GP_PROXY_SINK_TABLE_WILDCARD_CHAIN;
+        }
+        u32Hash = (uint32)puZgpdAddress->sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr ^
+                  (uint32)(puZgpdAddress->sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr >> 32);
+    }
+
+    u32Hash ^= u32Hash >> 16;
+    u32Hash ^= u32Hash >> 8;
+    u32Hash += u8ApplicationId;
+
+    return (uint8)(u32Hash & (GP_PROXY_SINK_TABLE_HASH_BUCKETS - 1));
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vGP_LinkProxySinkTableSlot
+ **
+ ** DESCRIPTION:
+ ** Inserts a slot into an index chain, keeping the chain in ascending slot
+ ** order so that lookups return the same entry as a linear table scan
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** tsGP_ProxySinkTableIndex      *psIndex                       Hash index
+ ** uint8                         u8Slot                         Table slot
+ ** uint8                         u8Chain                        Chain to link into
+ **
+ ** RETURN:
+ ** None
+ **
+ ****************************************************************************/
+PRIVATE void vGP_LinkProxySinkTableSlot(
+                    tsGP_ProxySinkTableIndex               *psIndex,
+                    uint8                                  u8Slot,
+                    uint8                                  u8Chain)
+{
+    uint8                                   *pu8Link = &psIndex->au8ChainHead[u8Chain];
+
+    /* chain end marker is larger than any slot */
+    while(*pu8Link < u8Slot)
+    {
+        pu8Link = &psIndex->au8NextSlot[*pu8Link];
+    }
+    psIndex->au8NextSlot[u8Slot] = *pu8Link;
+    psIndex->au8SlotChain[u8Slot] = u8Chain;
+    *pu8Link = u8Slot;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       bGP_IsProxySinkTableEntryMatch
+ **
+ ** DESCRIPTION:
+ ** Checks if a table entry is in use and belongs to the given GPD
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** tsGP_ZgppProxySinkTable       *psProxySinkTableEntry         Table entry
+ ** uint8                         u8EntryFilter                  GP_TABLE_ENTRY_ANY/PROXY/SINK
+ ** uint8                         u8ApplicationId                Application ID
+ ** tuGP_ZgpdDeviceAddr           *puZgpdAddress                 ZGP device address
+ **
+ ** RETURN:
+ ** TRUE if matches, FALSE otherwise
+ **
+ ****************************************************************************/
+PRIVATE bool_t bGP_IsProxySinkTableEntryMatch(
+                    tsGP_ZgppProxySinkTable                *psProxySinkTableEntry,
+                    uint8                                  u8EntryFilter,
+                    uint8                                  u8ApplicationId,
+                    tuGP_ZgpdDeviceAddr                    *puZgpdAddress)
+{
+    if((u8EntryFilter == GP_TABLE_ENTRY_PROXY) && (psProxySinkTableEntry->bProxyTableEntryOccupied != TRUE))
+    {
+        return FALSE;
+    }
+#ifdef GP_COMBO_BASIC_DEVICE
+    if((u8EntryFilter == GP_TABLE_ENTRY_SINK) && (psProxySinkTableEntry->eGreenPowerSinkTablePriority == 0))
+    {
+        return FALSE;
+    }
+#endif
+
+    return bGP_CheckGPDAddressMatch((uint8)(psProxySinkTableEntry->b16Options & GP_APPLICATION_ID_MASK),
+                                    u8ApplicationId,
+                                    &psProxySinkTableEntry->uZgpdDeviceAddr,
+                                    puZgpdAddress);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       bGP_FindIndexedGPD
+ **
+ ** DESCRIPTION:
+ ** Finds the first Sink/Proxy table entry of a GPD through the hash index,
+ ** only the GPD chain and the wildcard chain are visited
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** tsGP_GreenPowerCustomData     *psGpCustomDataStructure       Custom data
+ ** uint8                         u8EntryFilter                  GP_TABLE_ENTRY_ANY/PROXY/SINK
+ ** uint8                         u8ApplicationId                Application ID
+ ** tuGP_ZgpdDeviceAddr           *puZgpdAddress                 ZGP device address
+ ** tsGP_ZgppProxySinkTable       **psProxySinkTableEntry        Found entry
+ **
+ ** RETURN:
+ ** TRUE if present, FALSE otherwise
+ **
+ ****************************************************************************/
+PRIVATE bool_t bGP_FindIndexedGPD(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure,
+                    uint8                                  u8EntryFilter,
+                    uint8                                  u8ApplicationId,
+                    tuGP_ZgpdDeviceAddr                    *puZgpdAddress,
+                    tsGP_ZgppProxySinkTable                **psProxySinkTableEntry)
+{
+    tsGP_ProxySinkTableIndex                *psIndex = &psGpCustomDataStructure->sProxySinkTableIndex;
+    uint8                                   au8Chain[2];
+    uint8                                   u8Match = GP_PROXY_SINK_TABLE_INDEX_END;
+    uint8                                   u8Slot, i;
+
+    au8Chain[0] = u8GP_GetProxySinkTableChain(u8ApplicationId, puZgpdAddress);
+    au8Chain[1] = GP_PROXY_SINK_TABLE_WILDCARD_CHAIN;
+
+    if(au8Chain[0] == GP_PROXY_SINK_TABLE_WILDCARD_CHAIN)
+    {
+        /* a wildcard address can match an entry in any chain */
+        for(i = 0; i < GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES; i++)
+        {
+            if(bGP_IsProxySinkTableEntryMatch(&psGpCustomDataStructure->asZgpsSinkProxyTable[i],
+                                              u8EntryFilter,
+                                              u8ApplicationId,
+                                              puZgpdAddress))
+            {
+                u8Match = i;
+                break;
+            }
+        }
+    }
+    else
+    {
+        /* chains are in ascending slot order, keep the lowest match of both */
+        for(i = 0; i < 2; i++)
+        {
+            for(u8Slot = psIndex->au8ChainHead[au8Chain[i]];
+                u8Slot < u8Match;
+                u8Slot = psIndex->au8NextSlot[u8Slot])
+            {
+                if(bGP_IsProxySinkTableEntryMatch(&psGpCustomDataStructure->asZgpsSinkProxyTable[u8Slot],
+                                                  u8EntryFilter,
+                                                  u8ApplicationId,
+                                                  puZgpdAddress))
+                {
+                    u8Match = u8Slot;
+                    break;
+                }
+            }
+        }
+    }
+
+    if(u8Match == GP_PROXY_SINK_TABLE_INDEX_END)
+    {
+        return FALSE;
+    }
+
+    *psProxySinkTableEntry = &psGpCustomDataStructure->asZgpsSinkProxyTable[u8Match];
+    return TRUE;
+}
+#endif
+#ifdef GP_SEC_FRAME_COUNTER_RESERVATION
+/****************************************************************************
+ **
+ ** NAME:       vGP_ReserveSecFrameCounters
+ **
+ ** DESCRIPTION:
+ ** Sets the high-water mark of every Sink/Proxy table entry the reserved number
+ ** of frames ahead of its security frame counter, called when the table is
+ ** persisted
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** tsGP_GreenPowerCustomData   *psGpCustomDataStructure      custom data structure
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PUBLIC void vGP_ReserveSecFrameCounters(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure)
+{
+    uint32                                      u32Counter;
+    uint8                                       i;
+
+    for(i = 0; i < GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES; i++)
+    {
+        u32Counter = psGpCustomDataStructure->asZgpsSinkProxyTable[i].u32ZgpdSecFrameCounter;
+        if(u32Counter > (0xFFFFFFFFUL - GP_SEC_FRAME_COUNTER_RESERVATION_FRAMES))
+        {
+            u32Counter = 0xFFFFFFFFUL;
+        }
+        else
+        {
+            u32Counter += GP_SEC_FRAME_COUNTER_RESERVATION_FRAMES;
+        }
+        psGpCustomDataStructure->au32SecFrameCounterHighWater[i] = u32Counter;
+    }
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vGP_AdvanceSecFrameCounters
+ **
+ ** DESCRIPTION:
+ ** Advances restored security frame counters by the reserved number of frames,
+ ** the GPD may have sent that many accepted frames since the table was last
+ ** persisted. The high-water marks are set to the advanced counters so the next
+ ** accepted frame persists the table again. With restore grace frames the
+ ** counters are left at the persisted value and bGP_IsFreshPkt advances them
+ ** once the grace frames are used up
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** tsGP_GreenPowerCustomData   *psGpCustomDataStructure      custom data structure
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PUBLIC void vGP_AdvanceSecFrameCounters(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure)
+{
+    tsGP_ZgppProxySinkTable                     *psTableEntry;
+    uint8                                       i;
+
+    vGP_ReserveSecFrameCounters(psGpCustomDataStructure);
+    for(i = 0; i < GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES; i++)
+    {
+        psTableEntry = &psGpCustomDataStructure->asZgpsSinkProxyTable[i];
+        if(psTableEntry->b16Options & GP_PROXY_TABLE_SECURITY_USE_MASK)
+        {
+#if (GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES > 0)
+            psGpCustomDataStructure->au8SecFrameCounterGrace[i] = GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES;
+            continue;
+#else
+            psTableEntry->u32ZgpdSecFrameCounter = psGpCustomDataStructure->au32SecFrameCounterHighWater[i];
+#endif
+        }
+#if (GP_SEC_FRAME_COUNTER_RESTORE_GRACE_FRAMES > 0)
+        psGpCustomDataStructure->au8SecFrameCounterGrace[i] = 0;
+#endif
+        psGpCustomDataStructure->au32SecFrameCounterHighWater[i] = psTableEntry->u32ZgpdSecFrameCounter;
+    }
+}
+#endif
+
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+/****************************************************************************
+ **
+ ** NAME:       eGP_TranslationTableChanged
+ **
+ ** DESCRIPTION:
+ ** Tells the GP cluster that the application changed the translation table,
+ ** the dispatch map is rebuilt on the next received GPDF
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** uint8                         u8GreenPowerEndPointId         GP end point
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PUBLIC teZCL_Status eGP_TranslationTableChanged(
+                    uint8                                  u8GreenPowerEndPointId)
+{
+    tsZCL_EndPointDefinition                *psEndPointDefinition;
+    tsZCL_ClusterInstance                   *psClusterInstance;
+    tsGP_GreenPowerCustomData               *psGpCustomDataStructure;
+    teZCL_Status                            eStatus;
+
+    if((eStatus = eGP_FindGpCluster(u8GreenPowerEndPointId,
+                                    TRUE,
+                                    &psEndPointDefinition,
+                                    &psClusterInstance,
+                                    &psGpCustomDataStructure)) != E_ZCL_SUCCESS)
+    {
+        return eStatus;
+    }
+    psGpCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+
+    return E_ZCL_SUCCESS;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vGP_BuildTranslationDispatchMap
+ **
+ ** DESCRIPTION:
+ ** Builds the dispatch map from the translation table. Only the first command
+ ** info of an entry matching a GPD command id is mapped, as bIsCommandMapped
+ ** does. If the map is too small the table walk is used instead
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** tsGP_GreenPowerCustomData     *psGpCustomDataStructure       Custom data
+ **
+ ** RETURN:
+ ** None
+ **
+ ****************************************************************************/
+PRIVATE void vGP_BuildTranslationDispatchMap(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure)
+{
+    tsGP_TranslationDispatchMap             *psMap = &psGpCustomDataStructure->sTranslationDispatchMap;
+    tsGP_TranslationTableEntry              *psTableEntry;
+    tsGP_GpToZclCommandInfo                 *psCmdInfo;
+    uint8                                   u8Bucket, u8Used = 0;
+    uint8                                   i, j, k;
+
+    memset(psMap->au8Bucket, GP_TRANSLATION_DISPATCH_MAP_END, sizeof(psMap->au8Bucket));
+    psMap->bOverflow = FALSE;
+    psMap->bValid = TRUE;
+
+    if(psGpCustomDataStructure->psZgpsTranslationTableEntry == NULL)
+    {
+        return;
+    }
+
+    /* pushing to the chain heads in reverse table order leaves chains in table order */
+    for(i = GP_NUMBER_OF_TRANSLATION_TABLE_ENTRIES; i-- > 0; )
+    {
+        psTableEntry = &psGpCustomDataStructure->psZgpsTranslationTableEntry[i];
+        if(psTableEntry->psGpToZclCmdInfo == NULL)
+        {
+            continue;
+        }
+        for(j = 0; j < psTableEntry->u8NoOfCmdInfo; j++)
+        {
+            psCmdInfo = &psTableEntry->psGpToZclCmdInfo[j];
+            if(psCmdInfo->u8EndpointId == 0xFD)
+            {
+                continue;
+            }
+            for(k = 0; k < j; k++)
+            {
+                if((psTableEntry->psGpToZclCmdInfo[k].eZgpdCommandId == psCmdInfo->eZgpdCommandId) &&
+                   (psTableEntry->psGpToZclCmdInfo[k].u8EndpointId != 0xFD))
+                {
+                    break;
+                }
+            }
+            if(k < j)
+            {
+                continue;
+            }
+            if(u8Used == GP_TRANSLATION_DISPATCH_MAP_ENTRIES)
+            {
+                DBG_vPrintf(TRACE_GP_DEBUG, "vGP_BuildTranslationDispatchMap: map full, walking table\n");
+                psMap->bOverflow = TRUE;
+                return;
+            }
+            u8Bucket = u8GP_GetTranslationDispatchBucket((uint8)(psTableEntry->b8Options & GP_APPLICATION_ID_MASK),
+                                                         &psTableEntry->uZgpdDeviceAddr,
+                                                         psCmdInfo->eZgpdCommandId);
+            psMap->asEntry[u8Used].u8TableIndex = i;
+            psMap->asEntry[u8Used].u8CmdIndex = j;
+            psMap->asEntry[u8Used].u8Next = psMap->au8Bucket[u8Bucket];
+            psMap->au8Bucket[u8Bucket] = u8Used;
+            u8Used++;
+        }
+    }
+}
+
+/****************************************************************************
+ **
+ ** NAME:       u8GP_GetTranslationDispatchBucket
+ **
+ ** DESCRIPTION:
+ ** Hashes application id, SrcID/IEEE address and GPD command id to a dispatch
+ ** map bucket. The endpoint is not hashed as bGP_CheckGPDAddressMatch treats
+ ** 0x00 and 0xFF as wildcards, wildcard addresses map to the wildcard bucket
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** uint8                         u8ApplicationId                Application ID
+ ** tuGP_ZgpdDeviceAddr           *puZgpdAddress                 ZGP device address
+ ** teGP_ZgpdCommandId            eZgpdCommandId                 command id
+ **
+ ** RETURN:
+ ** uint8 bucket index
+ **
+ ****************************************************************************/
+PRIVATE uint8 u8GP_GetTranslationDispatchBucket(
+                    uint8                                  u8ApplicationId,
+                    tuGP_ZgpdDeviceAddr                    *puZgpdAddress,
+                    teGP_ZgpdCommandId                     eZgpdCommandId)
+{
+    uint32                                  u32Hash;
+
+    if(u8ApplicationId == GP_APPL_ID_4_BYTE)
+    {
+        if(puZgpdAddress->u32ZgpdSrcId == 0xFFFFFFFF)
+        {
+            return GP_TRANSLATION_DISPATCH_WILDCARD_BUCKET;
+        }
+        u32Hash = puZgpdAddress->u32ZgpdSrcId;
+    }
+    else
+    {
+        if(puZgpdAddress->sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr == 0xFFFFFFFFFFFFFFFFULL)
+        {
+            return GP_TRANSLATION_DISPATCH_WILDCARD_BUCKET;
+        }
+        u32Hash = (uint32)puZgpdAddress->sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr ^
+                  (uint32)(puZgpdAddress->sZgpdDeviceAddrAppId2.u64ZgpdIEEEAddr >> 32);
+    }
+
+    u32Hash ^= u32Hash >> 16;
+    u32Hash ^= u32Hash >> 8;
+    u32Hash += u8ApplicationId + ((uint32)eZgpdCommandId * 31);
+
+    return (uint8)(u32Hash & (GP_TRANSLATION_DISPATCH_MAP_BUCKETS - 1));
+}
+
+/****************************************************************************
+ **
+ ** NAME:       u8GP_NextTranslationDispatchEntry
+ **
+ ** DESCRIPTION:
+ ** Merges the GPD bucket chain and the wildcard chain, returning the entry
+ ** with the lower translation table index and advancing its chain
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** tsGP_TranslationDispatchMap   *psMap                         dispatch map
+ ** uint8                         *pu8Entry                      next entry of the GPD chain
+ ** uint8                         *pu8WildcardEntry              next entry of the wildcard chain
+ **
+ ** RETURN:
+ ** uint8 map entry, GP_TRANSLATION_DISPATCH_MAP_END when both chains are done
+ **
+ ****************************************************************************/
+PRIVATE uint8 u8GP_NextTranslationDispatchEntry(
+                    tsGP_TranslationDispatchMap            *psMap,
+                    uint8                                  *pu8Entry,
+                    uint8                                  *pu8WildcardEntry)
+{
+    uint8                                   u8Entry;
+
+    if((*pu8WildcardEntry == GP_TRANSLATION_DISPATCH_MAP_END) ||
+       ((*pu8Entry != GP_TRANSLATION_DISPATCH_MAP_END) &&
+        (psMap->asEntry[*pu8Entry].u8TableIndex <= psMap->asEntry[*pu8WildcardEntry].u8TableIndex)))
+    {
+        u8Entry = *pu8Entry;
+        if(u8Entry != GP_TRANSLATION_DISPATCH_MAP_END)
+        {
+            *pu8Entry = psMap->asEntry[u8Entry].u8Next;
+        }
+    }
+    else
+    {
+        u8Entry = *pu8WildcardEntry;
+        *pu8WildcardEntry = psMap->asEntry[u8Entry].u8Next;
+    }
+    return u8Entry;
+}
+#endif
+
+#ifdef GP_TABLE_STREAM_ENCODER
+#ifdef GP_COMBO_BASIC_DEVICE
+/****************************************************************************
+ **
+ ** NAME:       u16GetSinkTableEntrySize
+ **
+ ** DESCRIPTION:
+ ** Get number of bytes u16GetSinkTableString writes for an entry
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** tsGP_ZgppProxySinkTable       *psZgppProxySinkTable          sink table entry
+ **
+ ** RETURN:
+ ** Length of entry string
+ ****************************************************************************/
+uint16 u16GetSinkTableEntrySize(tsGP_ZgppProxySinkTable  *psZgppProxySinkTable)
+{
+	uint16                                  u16BytesToWrite = 0;
+
+	u16BytesToWrite += 2; //2 byte options field
+	if((psZgppProxySinkTable->b16Options & GP_APPLICATION_ID_MASK) == GP_APPL_ID_4_BYTE)
+	{
+		u16BytesToWrite += 4; //4 byte GPD ID
+	}
+#ifdef GP_IEEE_ADDR_SUPPORT
+	else
+	{
+		u16BytesToWrite += 9; //8 byte GPD ID + 1 byte endpoint
+	}
+#endif
+	u16BytesToWrite += 1; //1 byte Device ID
+	if((psZgppProxySinkTable->b8SinkOptions & GP_SINK_TABLE_COMM_MODE_MASK) == E_GP_GROUP_FORWARD_ZGP_NOTIFICATION_TO_PRE_COMMISSION_GROUP_ID)
+	{
+		/* group list length, sink group and alias for each group */
+		u16BytesToWrite += 1 + (psZgppProxySinkTable->u8SinkGroupListEntries * 4);
+	}
+	if(psZgppProxySinkTable->b16Options & GP_PROXY_TABLE_ASSIGNED_ALIAS_MASK)
+	{
+		u16BytesToWrite += 2; //2 byte GPD Assigned Alias
+	}
+	u16BytesToWrite += 1; //1 byte Radius
+	if(psZgppProxySinkTable->b16Options & GP_PROXY_TABLE_SECURITY_USE_MASK)
+	{
+		u16BytesToWrite += 1; //1 byte security options
+	}
+	if((psZgppProxySinkTable->b16Options & GP_PROXY_TABLE_SEQ_NUM_CAP_MASK)||
+				(psZgppProxySinkTable->b16Options & GP_PROXY_TABLE_SECURITY_USE_MASK))
+	{
+		u16BytesToWrite += 4; //4 byte security frame counter
+	}
+	if(psZgppProxySinkTable->b16Options & GP_PROXY_TABLE_SECURITY_USE_MASK)
+	{
+		teGP_GreenPowerSecLevel    eSecLevel;
+		teGP_GreenPowerSecKeyType  eSecKeyType;
+
+		eSecLevel = psZgppProxySinkTable->b8SecOptions & GP_SECURITY_LEVEL_MASK;
+		eSecKeyType = (psZgppProxySinkTable->b8SecOptions & GP_SECURITY_KEY_TYPE_MASK) >> 2;
+		if((eSecLevel != E_GP_NO_SECURITY)&&(eSecKeyType != E_GP_NO_KEY))
+		{
+			u16BytesToWrite += E_ZCL_KEY_128_SIZE; //16 byte security key
+		}
+	}
+	return u16BytesToWrite;
+}
+#endif
+
+/****************************************************************************
+ **
+ ** NAME:       u16GP_StreamTableEntry
+ **
+ ** DESCRIPTION:
+ ** Writes a sink or proxy table entry string if it fits in the space left
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** bool_t                        bIsSinkTable                   sink or proxy table entry
+ ** tsGP_ZgppProxySinkTable       *psZgppProxySinkTable          table entry
+ ** uint8                         *pu8Data                       data pointer to write
+ ** uint16                        u16MaxLength                   space left at pu8Data
+ **
+ ** RETURN:
+ ** Length of bytes written, 0 if the entry does not fit
+ ****************************************************************************/
+PUBLIC uint16 u16GP_StreamTableEntry(
+                    bool_t                                 bIsSinkTable,
+                    tsGP_ZgppProxySinkTable                *psZgppProxySinkTable,
+                    uint8                                  *pu8Data,
+                    uint16                                 u16MaxLength)
+{
+#ifdef GP_COMBO_BASIC_DEVICE
+    if(bIsSinkTable)
+    {
+        if(u16GetSinkTableEntrySize(psZgppProxySinkTable) > u16MaxLength)
+        {
+            return 0;
+        }
+        return u16GetSinkTableString(pu8Data, psZgppProxySinkTable);
+    }
+#endif
+    if(u16GetProxyTableEntrySize(psZgppProxySinkTable) > u16MaxLength)
+    {
+        return 0;
+    }
+    return u16GetProxyTableString(pu8Data, psZgppProxySinkTable);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       u16GP_StreamTableString
+ **
+ ** DESCRIPTION:
+ ** Writes sink or proxy table attribute as long octet string into passed data
+ ** pointer, entry by entry. The string length is filled in once all entries
+ ** have been written
+ **
+ ** PARAMETERS:                    Name                           Usage
+ ** uint8                         u8GreenPowerEndPointId         Green Power Endpoint id
+ ** bool_t                        bIsSinkTable                   sink or proxy table
+ ** uint8                         *pu8Data                       data pointer to write
+ ** uint16                        u16MaxLength                   space at pu8Data
+ **
+ ** RETURN:
+ ** Length of bytes written, 0 if the table does not fit
+ ****************************************************************************/
+PUBLIC uint16 u16GP_StreamTableString(
+                    uint8                                  u8GreenPowerEndPointId,
+                    bool_t                                 bIsSinkTable,
+                    uint8                                  *pu8Data,
+                    uint16                                 u16MaxLength)
+{
+    tsZCL_EndPointDefinition                *psEndPointDefinition;
+    tsZCL_ClusterInstance                   *psClusterInstance;
+    tsGP_GreenPowerCustomData               *psGpCustomDataStructure;
+    tsGP_ZgppProxySinkTable                 *psTableEntry;
+    uint16                                  u16Len = 2, u16EntryLen;
+    uint8                                   i;
+
+    if((u16MaxLength < 2) ||
+       (eGP_FindGpCluster(u8GreenPowerEndPointId,
+                          bIsSinkTable,
+                          &psEndPointDefinition,
+                          &psClusterInstance,
+                          &psGpCustomDataStructure) != E_ZCL_SUCCESS))
+    {
+        return 0;
+    }
+
+    for(i = 0; i < GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES; i++)
+    {
+        psTableEntry = &psGpCustomDataStructure->asZgpsSinkProxyTable[i];
+#ifdef GP_COMBO_BASIC_DEVICE
+        if(bIsSinkTable)
+        {
+            if((psTableEntry->eGreenPowerSinkTablePriority == 0) || (psTableEntry->u8GPDPaired != E_GP_PAIRED))
+            {
+                continue;
+            }
+        }
+        else
+#endif
+        if(psTableEntry->bProxyTableEntryOccupied != TRUE)
+        {
+            continue;
+        }
+        u16EntryLen = u16GP_StreamTableEntry(bIsSinkTable, psTableEntry, pu8Data + u16Len, u16MaxLength - u16Len);
+        if(u16EntryLen == 0)
+        {
+            DBG_vPrintf(TRACE_GP_DEBUG, "u16GP_StreamTableString: entry %d does not fit\n", i);
+            return 0;
+        }
+        u16Len += u16EntryLen;
+    }
+
+    /* first 2 bytes are the string length */
+    pu8Data[0] = (uint8)(u16Len - 2);
+    pu8Data[1] = (uint8)((u16Len - 2) >> 8);
+
+    return u16Len;
+}
+#endif
+
 /****************************************************************************/
 /***        END OF FILE                                                   ***/
 /****************************************************************************/
@@ -128,6 +128,16 @@ void bGP_RemoveDuplicateGPResponse(
 		tsGP_GreenPowerCustomData                   *psGpCustomDataStructure,
 		tsGP_ZgpResponseCmdPayload                  *psZgpResponseCmdPayload );
 #endif
+#ifdef GP_TABLE_STREAM_ENCODER
+PRIVATE teZCL_Status eGP_SendTableResponseStream(
+		tsZCL_EndPointDefinition                    *psEndPointDefinition,
+		tsGP_GreenPowerCustomData                   *psGpCustomDataStructure,
+		bool_t                                      bIsSinkTable,
+		tsZCL_Address                               *psDestinationAddress,
+		zbmap8                                      b8Options,
+		tuGP_ZgpdDeviceAddr                         *puZgpdDeviceAddr,
+		uint8                                       u8Index);
+#endif
 /****************************************************************************/
 /***        Exported Variables                                            ***/
 /****************************************************************************/
@@ -163,18 +173,24 @@ PUBLIC teZCL_Status  eGP_HandleSinkTableRequest(
         tsZCL_ClusterInstance          *psClusterInstance,
         uint16                         u16Offset)
 {
+#ifndef GP_TABLE_STREAM_ENCODER
 	uint8 i,u8Index = 0;
 	bool_t bIsRequestByAddr;
+#endif
 	tsGP_GreenPowerCustomData                   *psGPCustomDataStructure;
 	tsGP_ZgpSinkTableRequestCmdPayload           sSinkTableRequestCmdPayload;
 	teZCL_Status                                eStatus = E_ZCL_SUCCESS;
 	tsZCL_Address                               sDestAddress = {E_ZCL_AM_SHORT,  {pZPSevent->uEvent.sApsDataIndEvent.uSrcAddress.u16Addr}};
+#ifndef GP_TABLE_STREAM_ENCODER
 	tsGP_SinkTableRespCmdPayload                sSinkTableRespCmdPayload = {0, 0, 0xff, 0,0 } ;
 	uint8 u8SinkTableEntries[MAX_SINK_TABLE_ENTRIES_LENGTH];
+#endif
 
 	// initialise pointer
 	psGPCustomDataStructure = (tsGP_GreenPowerCustomData *)psClusterInstance->pvEndPointCustomStructPtr;
+#ifndef GP_TABLE_STREAM_ENCODER
 	sSinkTableRespCmdPayload.puSinkTableEntries = u8SinkTableEntries;
+#endif
 	// get EP mutex
 	#ifndef COOPERATIVE
 		eZCL_GetMutex(psEndPointDefinition);
@@ -198,6 +214,16 @@ PUBLIC teZCL_Status  eGP_HandleSinkTableRequest(
 
 		return eStatus;
 	}
+#ifdef GP_TABLE_STREAM_ENCODER
+	return eGP_SendTableResponseStream(
+			psEndPointDefinition,
+			psGPCustomDataStructure,
+			TRUE,
+			&sDestAddress,
+			sSinkTableRequestCmdPayload.b8Options,
+			&sSinkTableRequestCmdPayload.uZgpdDeviceAddr,
+			sSinkTableRequestCmdPayload.u8Index);
+#else
 	bIsRequestByAddr = (sSinkTableRequestCmdPayload.b8Options & BIT_MAP_REQUEST_TYPE)? 0:1;
 	if(bIsRequestByAddr)
 	{
@@ -263,6 +289,7 @@ PUBLIC teZCL_Status  eGP_HandleSinkTableRequest(
 
 
 	return eStatus;
+#endif
 }
 #endif
 /****************************************************************************
@@ -350,18 +377,24 @@ PUBLIC teZCL_Status  eGP_HandleProxyTableRequest(
         tsZCL_ClusterInstance          *psClusterInstance,
         uint16                         u16Offset)
 {
+#ifndef GP_TABLE_STREAM_ENCODER
 	uint8 i,  u8Index=0;
 	bool_t bIsRequestByAddr;
+#endif
 	tsGP_GreenPowerCustomData                   *psGPCustomDataStructure;
 	tsGP_ZgpProxyTableRequestCmdPayload           sProxyTableRequestCmdPayload;
 	teZCL_Status                                eStatus = E_ZCL_SUCCESS;
 	tsZCL_Address                               sDestAddress = {E_ZCL_AM_SHORT,  {pZPSevent->uEvent.sApsDataIndEvent.uSrcAddress.u16Addr}};
+#ifndef GP_TABLE_STREAM_ENCODER
 	tsGP_ProxyTableRespCmdPayload                sProxyTableRespCmdPayload = {0, 0, 0xff, 0,0 } ;
 	uint8 u8ProxyTableEntries[MAX_SINK_TABLE_ENTRIES_LENGTH];
     uint16 u16SizeFits = MAX_SINK_TABLE_ENTRIES_LENGTH;
+#endif
     // initialise pointer
 	psGPCustomDataStructure = (tsGP_GreenPowerCustomData *)psClusterInstance->pvEndPointCustomStructPtr;
+#ifndef GP_TABLE_STREAM_ENCODER
 	sProxyTableRespCmdPayload.puProxyTableEntries = u8ProxyTableEntries;
+#endif
 	// get EP mutex
 	#ifndef COOPERATIVE
 		eZCL_GetMutex(psEndPointDefinition);
@@ -385,6 +418,16 @@ PUBLIC teZCL_Status  eGP_HandleProxyTableRequest(
 
 		return eStatus;
 	}
+#ifdef GP_TABLE_STREAM_ENCODER
+	return eGP_SendTableResponseStream(
+			psEndPointDefinition,
+			psGPCustomDataStructure,
+			FALSE,
+			&sDestAddress,
+			sProxyTableRequestCmdPayload.b8Options,
+			&sProxyTableRequestCmdPayload.uZgpdDeviceAddr,
+			sProxyTableRequestCmdPayload.u8Index);
+#else
 	bIsRequestByAddr = (sProxyTableRequestCmdPayload.b8Options & BIT_MAP_REQUEST_TYPE)? 0:1;
 	if(bIsRequestByAddr)
 	{
@@ -463,6 +506,7 @@ PUBLIC teZCL_Status  eGP_HandleProxyTableRequest(
 
 
 	return eStatus;
+#endif
 }
 
 /****************************************************************************
@@ -637,6 +681,9 @@ PUBLIC teZCL_Status eGP_HandleProxyCommissioningMode(
         {
             psGPCustomDataStructure->u16CommissionWindow =
                     (sZgpProxyCommissioningModeCmdPayload.u16CommissioningWindow * 50);
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+            vGP_TxQueueArmTimer(psGPCustomDataStructure);
+#endif
         }
         psGPCustomDataStructure->bCommissionExitModeOnFirstPairSuccess = FALSE;
         psGPCustomDataStructure->bCommissionExitModeOnCommissionModeExitCmd = FALSE;
@@ -1353,6 +1400,10 @@ PUBLIC teZCL_Status eGP_HandleZgpPairing(
     psGpCustomDataStructure->sGPCommon.sGreenPowerCallBackMessage.uMessage.psZgpPairingCmdPayload =
 		&sZgpPairingCmdPayload;
     psEndPointDefinition->pCallBackFunctions(&psGpCustomDataStructure->sGPCommon.sGPCustomCallBackEvent);
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+    /* the application may have changed the translation table */
+    psGpCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+#endif
 
     if(bGP_IsPairingCmdValid(&sZgpPairingCmdPayload) == FALSE)
     {
@@ -1414,6 +1465,9 @@ PUBLIC teZCL_Status eGP_HandleZgpPairing(
 				      sZgpPairingCmdPayload.uZgpdDeviceAddr.sZgpdDeviceAddrAppId2.u8EndPoint;
 		    }
     	 #endif
+    	 #ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+    	    vGP_UpdateProxySinkTableIndex(psGpCustomDataStructure, psZgppProxySinkTable);
+    	 #endif
     	}
 
     }
@@ -2006,6 +2060,10 @@ PUBLIC teZCL_Status eGP_HandleZgpTranslationTableUpdate(
 
             /* Give Application Callback to pass received Translation table response */
             psEndPointDefinition->pCallBackFunctions(&psGpCustomDataStructure->sGPCommon.sGPCustomCallBackEvent);
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+            /* the application may have changed the translation table */
+            psGpCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+#endif
 
             if(psGpCustomDataStructure->sGPCommon.sGreenPowerCallBackMessage.uMessage.psTransationTableUpdate->eStatus == E_GP_TRANSLATION_UPDATE_FAIL)
             {
@@ -2564,6 +2622,10 @@ PUBLIC teZCL_Status eGP_HandleZgpPairingConfig(
     psGpCustomDataStructure->sGPCommon.sGreenPowerCallBackMessage.uMessage.psZgpPairingConfigCmdPayload =
 		&sZgpPairingConfigPayload;
     psEndPointDefinition->pCallBackFunctions(&psGpCustomDataStructure->sGPCommon.sGPCustomCallBackEvent);
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+    /* the application may have changed the translation table */
+    psGpCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+#endif
 
     ePairingConfigAction = sZgpPairingConfigPayload.u8Actions & GP_PAIRING_CONFIG_ACTION_MASK;
 
@@ -2775,6 +2837,9 @@ PUBLIC teZCL_Status eGP_HandleZgpPairingConfig(
             psSinkTableEntry->uZgpdDeviceAddr.sZgpdDeviceAddrAppId2.u8EndPoint =
             		sZgpPairingConfigPayload.uZgpdDeviceAddr.sZgpdDeviceAddrAppId2.u8EndPoint;
         }
+#endif
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+        vGP_UpdateProxySinkTableIndex(psGpCustomDataStructure, psSinkTableEntry);
 #endif
         //psSinkTableEntry->uZgpdDeviceAddr = sZgpPairingConfigPayload.uZgpdDeviceAddr;
         psSinkTableEntry->eZgpdDeviceId = sZgpPairingConfigPayload.eZgpdDeviceId;
@@ -2811,6 +2876,10 @@ PUBLIC teZCL_Status eGP_HandleZgpPairingConfig(
 
         /* Give Application Callback for sink table update */
         psEndPointDefinition->pCallBackFunctions(&psGpCustomDataStructure->sGPCommon.sGPCustomCallBackEvent);
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+        /* the application may have changed the translation table */
+        psGpCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+#endif
         vSendpairing(psEndPointDefinition->u8EndPointNumber, TRUE, &sZgpPairingConfigPayload, psSinkTableEntry);
 
 
@@ -2903,6 +2972,9 @@ bool_t bGP_CheckIfCmdToBeBuffered(
 				/* Delete Node */
 				psDLISTremove(&psGpCustomDataStructure->lGpAllocList,
 						(DNODE *)psZgpBufferedApduRecord);
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+				vGP_TxQueueRemove(psGpCustomDataStructure, psZgpBufferedApduRecord);
+#endif
 
 				// add to free list
 				vDLISTaddToTail(&psGpCustomDataStructure->lGpDeAllocList,
@@ -3038,6 +3110,9 @@ bool_t bGP_CheckIfCmdToBeNotified(
 				/* Delete Node */
 				psDLISTremove(&psGpCustomDataStructure->lGpAllocList,
 						(DNODE *)psZgpBufferedApduRecord);
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+				vGP_TxQueueRemove(psGpCustomDataStructure, psZgpBufferedApduRecord);
+#endif
 
 				// add to free list
 				vDLISTaddToTail(&psGpCustomDataStructure->lGpDeAllocList,
@@ -3109,6 +3184,9 @@ void bGP_RemoveDuplicateGPResponse(
 			/* Before Transmission delete from alloc list and add to the dealloc list */
 			psDLISTremove(&psGpCustomDataStructure->lGpAllocList,
 					(DNODE *)psZgpBufferedApduRecord);
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+			vGP_TxQueueRemove(psGpCustomDataStructure, psZgpBufferedApduRecord);
+#endif
 
 			// add to free list
 			vDLISTaddToTail(&psGpCustomDataStructure->lGpDeAllocList,
@@ -3735,6 +3813,10 @@ void vGiveIndicationForTranslationTableUpdate(
 	/* Give Application Callback  */
 	psGpCustomDataStructure->sGPCommon.sGreenPowerCallBackMessage.uMessage.psPairingConfigCmdRcvd = &sZgpsPairingConfigCmdRcvd;
 	psEndPointDefinition->pCallBackFunctions(&psGpCustomDataStructure->sGPCommon.sGPCustomCallBackEvent);
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+	/* the application may have changed the translation table */
+	psGpCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+#endif
 }
 /****************************************************************************
  **
@@ -4289,6 +4371,141 @@ bool_t bDecryptGPDFData(
 	return bValid;
 }
 #endif
+#ifdef GP_TABLE_STREAM_ENCODER
+/****************************************************************************
+ **
+ ** NAME:       eGP_SendTableResponseStream
+ **
+ ** DESCRIPTION:
+ ** Sends Sink or Proxy Table response, serialising the requested entries
+ ** straight into the response APDU. Entries from the first one that does not
+ ** fit onwards are left for a later request by index
+ **
+ ** PARAMETERS:               Name                      Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition      EP structure
+ ** tsGP_GreenPowerCustomData *psGpCustomDataStructure  GP custom data
+ ** bool_t                    bIsSinkTable              sink or proxy table
+ ** tsZCL_Address            *psDestinationAddress      requester address
+ ** zbmap8                    b8Options                 request options
+ ** tuGP_ZgpdDeviceAddr      *puZgpdDeviceAddr          requested GPD
+ ** uint8                     u8Index                   requested index
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PRIVATE teZCL_Status eGP_SendTableResponseStream(
+		tsZCL_EndPointDefinition                    *psEndPointDefinition,
+		tsGP_GreenPowerCustomData                   *psGpCustomDataStructure,
+		bool_t                                      bIsSinkTable,
+		tsZCL_Address                               *psDestinationAddress,
+		zbmap8                                      b8Options,
+		tuGP_ZgpdDeviceAddr                         *puZgpdDeviceAddr,
+		uint8                                       u8Index)
+{
+	PDUM_thAPduInstance                         hAPduInst;
+	tsGP_ZgppProxySinkTable                     *psTableEntry;
+	bool_t                                      bIsRequestByAddr;
+	uint8                                       *pu8Payload;
+	uint16                                      u16HeaderSize, u16Offset, u16APduSize, u16EntryLen;
+	uint8                                       u8Status = E_ZCL_CMDS_NOT_FOUND;
+	uint8                                       u8TotalNoOfEntries = 0, u8StartIndex, u8EntriesCount = 0;
+	uint8                                       i;
+
+	bIsRequestByAddr = (b8Options & BIT_MAP_REQUEST_TYPE)? FALSE:TRUE;
+	u8StartIndex = bIsRequestByAddr ? 0xFF : u8Index;
+	i = bIsRequestByAddr ? 0 : u8Index;
+
+#ifdef GP_COMBO_BASIC_DEVICE
+	if(bIsSinkTable)
+	{
+		u16GP_GetStringSizeOfSinkTable(psEndPointDefinition->u8EndPointNumber, &u8TotalNoOfEntries, psGpCustomDataStructure);
+	}
+	else
+#endif
+	{
+		u16GP_GetStringSizeOfProxyTable(psEndPointDefinition->u8EndPointNumber, &u8TotalNoOfEntries, psGpCustomDataStructure);
+	}
+
+	hAPduInst = hZCL_AllocateAPduInstance();
+	if(hAPduInst == PDUM_INVALID_HANDLE)
+	{
+		return E_ZCL_ERR_ZBUFFER_FAIL;
+	}
+	u16HeaderSize = u16ZCL_WriteCommandHeader(hAPduInst,
+			eFRAME_TYPE_COMMAND_IS_SPECIFIC_TO_A_CLUSTER,
+			FALSE,
+			0,
+			TRUE,
+			TRUE,
+			u8GetTransactionSequenceNumber(),
+			bIsSinkTable ? E_GP_ZGP_SINK_TABLE_RESPONSE : E_GP_ZGP_PROXY_TABLE_RESPONSE);
+	/* status, total number of entries, start index and entries count precede the entries */
+	u16Offset = u16HeaderSize + 4;
+	u16APduSize = PDUM_u16APduGetSize(hZCL_GetBufferPoolHandle());
+	pu8Payload = (uint8 *)PDUM_pvAPduInstanceGetPayload(hAPduInst);
+
+	for( ; (i < GP_NUMBER_OF_PROXY_SINK_TABLE_ENTRIES) && (u16Offset < u16APduSize); i++)
+	{
+		psTableEntry = &psGpCustomDataStructure->asZgpsSinkProxyTable[i];
+#ifdef GP_COMBO_BASIC_DEVICE
+		if(bIsSinkTable)
+		{
+			if(psTableEntry->eGreenPowerSinkTablePriority == 0)
+			{
+				continue;
+			}
+		}
+		else
+#endif
+		if(!psTableEntry->bProxyTableEntryOccupied)
+		{
+			continue;
+		}
+		if(bIsRequestByAddr)
+		{
+			/* the requested address may be a wildcard, check both ways */
+			if((bGP_CheckGPDAddressMatch((psTableEntry->b16Options & GP_APPLICATION_ID_MASK),
+					(b8Options & GP_APPLICATION_ID_MASK),
+					&psTableEntry->uZgpdDeviceAddr,
+					puZgpdDeviceAddr) == FALSE) &&
+			   (bGP_CheckGPDAddressMatch((b8Options & GP_APPLICATION_ID_MASK),
+					(psTableEntry->b16Options & GP_APPLICATION_ID_MASK),
+					puZgpdDeviceAddr,
+					&psTableEntry->uZgpdDeviceAddr) == FALSE))
+			{
+				continue;
+			}
+		}
+		u8Status = E_ZCL_SUCCESS;
+		u16EntryLen = u16GP_StreamTableEntry(bIsSinkTable, psTableEntry, pu8Payload + u16Offset, u16APduSize - u16Offset);
+		if(u16EntryLen == 0)
+		{
+			break;
+		}
+		u16Offset += u16EntryLen;
+		u8EntriesCount++;
+	}
+
+	u16HeaderSize += u16ZCL_APduInstanceWriteNBO(hAPduInst, u16HeaderSize, E_ZCL_ENUM8, &u8Status);
+	u16HeaderSize += u16ZCL_APduInstanceWriteNBO(hAPduInst, u16HeaderSize, E_ZCL_UINT8, &u8TotalNoOfEntries);
+	u16HeaderSize += u16ZCL_APduInstanceWriteNBO(hAPduInst, u16HeaderSize, E_ZCL_UINT8, &u8StartIndex);
+	u16ZCL_APduInstanceWriteNBO(hAPduInst, u16HeaderSize, E_ZCL_UINT8, &u8EntriesCount);
+	DBG_vPrintf(TRACE_GP_DEBUG, "\n eGP_SendTableResponseStream u8Status=%d, u8TotalNoOfEntries = %d, u8EntriesCount = %d, size = %d\n",
+			u8Status, u8TotalNoOfEntries, u8EntriesCount, u16Offset);
+
+	if(eZCL_TransmitDataRequest(hAPduInst,
+			u16Offset,
+			psEndPointDefinition->u8EndPointNumber,
+			ZCL_GP_PROXY_ENDPOINT_ID,
+			GREENPOWER_CLUSTER_ID,
+			psDestinationAddress) != E_ZCL_SUCCESS)
+	{
+		return E_ZCL_ERR_ZTRANSMIT_FAIL;
+	}
+	return E_ZCL_SUCCESS;
+}
+#endif
 /****************************************************************************/
 /***        END OF FILE                                                   ***/
 /****************************************************************************/
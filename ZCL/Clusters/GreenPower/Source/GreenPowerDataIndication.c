@@ -286,6 +286,10 @@ void vAddRemoveBufferedTxQMsg(ZPS_tsAfEvent *pZPSevent,
 			{
 				DBG_vPrintf(TRACE_GP_DEBUG, "Set Delay to 0pZPSevent->uEvent.sApsZgpDataConfirmEvent.u8Status = %d \r\n", pZPSevent->uEvent.sApsZgpDataConfirmEvent.u8Status);
 				psZgpBufferedApduRecord->sBufferedApduInfo.u16Delay = 1;
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+				vGP_TxQueueSchedule(psGpCustomDataStructure, psZgpBufferedApduRecord);
+				vGP_TxQueueArmTimer(psGpCustomDataStructure);
+#endif
 				psZgpBufferedApduRecord->sBufferedApduInfo.u8Status = E_ZCL_SUCCESS;
 	        	/*if (psGpCustomDataStructure->u16TransmitChannelTimeout)
 	        	{
@@ -309,6 +313,9 @@ void vAddRemoveBufferedTxQMsg(ZPS_tsAfEvent *pZPSevent,
 				/* Before Transmission delete from alloc list and add to the dealloc list */
 				psDLISTremove(&psGpCustomDataStructure->lGpAllocList,
 						(DNODE *)psZgpBufferedApduRecord);
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+				vGP_TxQueueRemove(psGpCustomDataStructure, psZgpBufferedApduRecord);
+#endif
 
 				// add to free list
 				vDLISTaddToTail(&psGpCustomDataStructure->lGpDeAllocList,
@@ -156,6 +156,9 @@ PUBLIC teZCL_Status eGP_ProxyCommissioningMode(
             {
                 /* Set Commission Window Timeout value in custom data struct */
                 psGpCustomDataStructure->u16CommissionWindow = u16CommissionWindow * 50;
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+                vGP_TxQueueArmTimer(psGpCustomDataStructure);
+#endif
             }
         }
 
@@ -226,6 +229,9 @@ PUBLIC teZCL_Status eGP_ProxyCommissioningMode(
 
                 /* Set Commission Window Timeout value in custom data struct */
                 psGpCustomDataStructure->u16CommissionWindow = u16CommissionWindow * 50;
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+                vGP_TxQueueArmTimer(psGpCustomDataStructure);
+#endif
             }
         }
     }
@@ -805,6 +805,9 @@ PRIVATE void vGP_TxGPResponse(
 		 {
 			 ZPS_vNwkNibSetChannel( ZPS_pvAplZdoGetNwkHandle(), (sZgpResponseCmdPayload.b8TempMasterTxChannel & 0x0F) + 11);
 			 psGpCustomDataStructure->u16TransmitChannelTimeout = 250;
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+			 vGP_TxQueueArmTimer(psGpCustomDataStructure);
+#endif
 		 }
 		 DBG_vPrintf(TRACE_GP_DEBUG, "\n vGP_TxGPResponse: psGpCustomDataStructure->u16TransmitChannelTimeout == 250 , set channel to %d u8OperationalChannel %d\n",
 				 ((sZgpResponseCmdPayload.b8TempMasterTxChannel & 0x0F) + 11),
@@ -1251,6 +1254,10 @@ PRIVATE void vGP_TxGPResponse(
 		psGpCustomDataStructure->sGPCommon.sGreenPowerCallBackMessage.eEventType = E_GP_SINK_PROXY_TABLE_ENTRY_ADDED;
 		psGpCustomDataStructure->sGPCommon.sGreenPowerCallBackMessage.uMessage.psZgpsProxySinkTable = psSinkProxyTableEntry;
 		psEndPointDefinition->pCallBackFunctions(&psGpCustomDataStructure->sGPCommon.sGPCustomCallBackEvent);
+#ifdef GP_TRANSLATION_TABLE_DISPATCH_MAP
+		/* the application may have changed the translation table */
+		psGpCustomDataStructure->sTranslationDispatchMap.bValid = FALSE;
+#endif
 		/*  add check if group exits for precommissioned mode */
 		 if((psSinkProxyTableEntry->b8SinkOptions & GP_SINK_TABLE_COMM_MODE_MASK) == E_GP_GROUP_FORWARD_ZGP_NOTIFICATION_TO_PRE_COMMISSION_GROUP_ID)
 		 {
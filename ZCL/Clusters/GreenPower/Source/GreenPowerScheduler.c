@@ -34,9 +34,14 @@
 #include <string.h>
 #include "dlist.h"
 #include "zcl.h"
+#include "zcl_common.h"
+#include "zcl_customcommand.h"
 #include "GreenPower.h"
 #include "GreenPower_internal.h"
 #include "dbg.h"
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+#include <zb_platform.h>
+#endif
 /****************************************************************************/
 /***        Macro Definitions                                             ***/
 /****************************************************************************/
@@ -44,6 +49,8 @@
 #define TRACE_GP_DEBUG FALSE
 #endif
 
+#define GP_TIMEOUT_TICK_MS                      (20)
+
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
@@ -51,6 +58,24 @@
 /****************************************************************************/
 /***        Local Function Prototypes                                     ***/
 /****************************************************************************/
+PRIVATE void vGP_HandleTimeouts(
+                    tsZCL_EndPointDefinition               *psEndPointDefinition,
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure);
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+PRIVATE bool_t bGP_IsTxQueueEarlier(
+                    tsGP_ZgpBufferedApduRecord             *psFirst,
+                    tsGP_ZgpBufferedApduRecord             *psSecond);
+PRIVATE void vGP_TxQueueSwap(
+                    tsGP_TxQueue                           *psTxQueue,
+                    uint8                                  u8First,
+                    uint8                                  u8Second);
+PRIVATE void vGP_TxQueueSiftUp(
+                    tsGP_TxQueue                           *psTxQueue,
+                    uint8                                  u8Index);
+PRIVATE void vGP_TxQueueSiftDown(
+                    tsGP_TxQueue                           *psTxQueue,
+                    uint8                                  u8Index);
+#endif
 
 /****************************************************************************/
 /***        Exported Variables                                            ***/
@@ -84,8 +109,6 @@ PUBLIC teZCL_Status eGP_Update20mS(uint8 u8GreenPowerEndPointId) {
 	tsZCL_EndPointDefinition *psEndPointDefinition;
 	tsZCL_ClusterInstance *psClusterInstance;
 	tsGP_GreenPowerCustomData *psGpCustomDataStructure;
-	uint8 u8Loop;
-	tsGP_ZgpDuplicateTable *psZgpDuplicateTable;
 
 	if ((etatus = eGP_FindGpCluster(u8GreenPowerEndPointId, bIsServer,
 			&psEndPointDefinition, &psClusterInstance, &psGpCustomDataStructure))
@@ -99,43 +122,18 @@ PUBLIC teZCL_Status eGP_Update20mS(uint8 u8GreenPowerEndPointId) {
 		}
 	}
 
+	/* Duplicate filter entries are aged on lookup, nothing to do without a running timeout */
+	if ((psGpCustomDataStructure->u16CommissionWindow == 0)
+			&& (psGpCustomDataStructure->u16TransmitChannelTimeout == 0)) {
+		return etatus;
+	}
+
 	// get EP mutex
 #ifndef COOPERATIVE
 	eZCL_GetMutex(psEndPointDefinition);
 #endif
 
-	/* Handling Proxy Commission Mode Timeout */
-	if (psGpCustomDataStructure->u16CommissionWindow) {
-		/* Decrement and if value is zero exit commission mode */
-		if ((--psGpCustomDataStructure->u16CommissionWindow == 0x00)
-				&& (psGpCustomDataStructure->eGreenPowerDeviceMode
-						!= E_GP_OPERATING_MODE)) {
-			vGP_ExitCommMode(psEndPointDefinition,
-					psGpCustomDataStructure);
-		}
-	}
-	/* Handling transmit channel Timeout */
-	if (psGpCustomDataStructure->u16TransmitChannelTimeout) {
-		/* Decrement and if value is zero change channel to operational */
-		if (--psGpCustomDataStructure->u16TransmitChannelTimeout == 0x00) {
-            DBG_vPrintf(TRACE_GP_DEBUG, "\n eGP_Update20mS: setting channel to back to operating = %d  \n", psGpCustomDataStructure->u8OperationalChannel);
-#ifndef PC_PLATFORM_BUILD
-			ZPS_vNwkNibSetChannel(ZPS_pvAplZdoGetNwkHandle(),
-					psGpCustomDataStructure->u8OperationalChannel);
-#endif
-		}
-	}
-	/* initialize duplicate filter table pointer */
-		psZgpDuplicateTable = psGpCustomDataStructure->asZgpDuplicateFilterTable;
-
-	/* Handling Duplicate Filter Timeout Table */
-	for (u8Loop = 0; u8Loop < GP_MAX_DUPLICATE_TABLE_ENTIRES; u8Loop++) {
-		/* Decrement only if aging time is non zero value */
-		if (psZgpDuplicateTable[u8Loop].u16AgingTime) {
-			psZgpDuplicateTable[u8Loop].u16AgingTime--;
-			break;
-		}
-	}
+	vGP_HandleTimeouts(psEndPointDefinition, psGpCustomDataStructure);
 	/*vGp_TransmissionTimerCallback(u8GreenPowerEndPointId, psEndPointDefinition,
 			psGpCustomDataStructure);*/
 
@@ -198,6 +196,444 @@ PUBLIC teZCL_Status eGP_Update1mS(uint8 u8GreenPowerEndPointId) {
 	return etatus;
 
 }
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+/****************************************************************************
+ *
+ * NAME: eGP_UpdateTxQueueTimer
+ *
+ * DESCRIPTION:
+ * Replaces eGP_Update1mS/eGP_Update20mS when the buffered GPDFs are kept in
+ * the deadline queue. Called on every E_ZCL_CBET_TIMER_MS event, which is also
+ * raised for ms timers of other end points, so the GP clock is read from
+ * GP_TX_QUEUE_TIME_MS() rather than advanced by the requested period. Transmits
+ * the due GPDFs, runs the 20 ms timeouts that are due and requests the next
+ * expiry
+ *
+ * PARAMETERS:  Name                            Usage
+ * uint8        u8GreenPowerEndPointId          Local Green Power End Point Id
+ *
+ * RETURNS:
+ * teZCL_Status
+ *
+ ****************************************************************************/
+PUBLIC teZCL_Status eGP_UpdateTxQueueTimer(uint8 u8GreenPowerEndPointId) {
+	teZCL_Status etatus = E_ZCL_SUCCESS;
+	bool_t bIsServer = TRUE;
+	tsZCL_EndPointDefinition *psEndPointDefinition;
+	tsZCL_ClusterInstance *psClusterInstance;
+	tsGP_GreenPowerCustomData *psGpCustomDataStructure;
+	tsGP_TxQueue *psTxQueue;
+
+	if ((etatus = eGP_FindGpCluster(u8GreenPowerEndPointId, bIsServer,
+			&psEndPointDefinition, &psClusterInstance, &psGpCustomDataStructure))
+			!= E_ZCL_SUCCESS) {
+		bIsServer = FALSE;
+
+		if ((etatus = eGP_FindGpCluster(u8GreenPowerEndPointId, bIsServer,
+				&psEndPointDefinition, &psClusterInstance,
+				&psGpCustomDataStructure)) != E_ZCL_SUCCESS) {
+			return etatus;
+		}
+	}
+
+	// get EP mutex
+#ifndef COOPERATIVE
+	eZCL_GetMutex(psEndPointDefinition);
+#endif
+
+	psTxQueue = &psGpCustomDataStructure->sTxQueue;
+	psTxQueue->u32TimeMs = GP_TX_QUEUE_TIME_MS();
+
+	if ((psTxQueue->bTimerRunning)
+			&& ((int32)(psTxQueue->u32TimeMs - psTxQueue->u32TimerExpiryMs) >= 0)) {
+		psTxQueue->bTimerRunning = FALSE;
+	}
+
+	/* run every 20 ms step that fell due, a late event catches up */
+	while ((psTxQueue->bTimeoutRunning)
+			&& ((int32)(psTxQueue->u32TimeMs - psTxQueue->u32TimeoutDueMs) >= 0)) {
+		if ((psGpCustomDataStructure->u16CommissionWindow == 0)
+				&& (psGpCustomDataStructure->u16TransmitChannelTimeout == 0)) {
+			psTxQueue->bTimeoutRunning = FALSE;
+			break;
+		}
+		psTxQueue->u32TimeoutDueMs += GP_TIMEOUT_TICK_MS;
+		vGP_HandleTimeouts(psEndPointDefinition, psGpCustomDataStructure);
+	}
+
+	vGp_TransmissionTimerCallback(u8GreenPowerEndPointId,
+			psEndPointDefinition, psGpCustomDataStructure);
+
+	vGP_TxQueueArmTimer(psGpCustomDataStructure);
+
+	// release mutex
+#ifndef COOPERATIVE
+	eZCL_ReleaseMutex(psEndPointDefinition);
+#endif
+
+	return etatus;
+}
+
+/****************************************************************************
+ *
+ * NAME: vGP_TxQueueSchedule
+ *
+ * DESCRIPTION:
+ * Sets the deadline of a buffered record to u16Delay ms from now, adding it
+ * to the deadline queue if it is not queued yet
+ *
+ * PARAMETERS:  Name                            Usage
+ * tsGP_GreenPowerCustomData  *psGpCustomDataStructure  Custom Data Structure
+ * tsGP_ZgpBufferedApduRecord *psZgpBufferedApduRecord  Buffered record
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PUBLIC void vGP_TxQueueSchedule(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure,
+                    tsGP_ZgpBufferedApduRecord             *psZgpBufferedApduRecord)
+{
+    tsGP_TxQueue *psTxQueue = &psGpCustomDataStructure->sTxQueue;
+    uint8 u8Index = psZgpBufferedApduRecord->u8HeapIndex;
+
+    psZgpBufferedApduRecord->u32Deadline = GP_TX_QUEUE_TIME_MS() +
+            psZgpBufferedApduRecord->sBufferedApduInfo.u16Delay;
+
+    if (u8Index == GP_TX_QUEUE_NOT_QUEUED)
+    {
+        if (psTxQueue->u8Size >= GP_MAX_NUMBER_BUFFERED_RECORDS)
+        {
+            return;
+        }
+        u8Index = psTxQueue->u8Size++;
+        psTxQueue->apsRecord[u8Index] = psZgpBufferedApduRecord;
+        psZgpBufferedApduRecord->u8HeapIndex = u8Index;
+    }
+    vGP_TxQueueSiftUp(psTxQueue, u8Index);
+    vGP_TxQueueSiftDown(psTxQueue, psZgpBufferedApduRecord->u8HeapIndex);
+}
+
+/****************************************************************************
+ *
+ * NAME: vGP_TxQueueRemove
+ *
+ * DESCRIPTION:
+ * Removes a buffered record from the deadline queue
+ *
+ * PARAMETERS:  Name                            Usage
+ * tsGP_GreenPowerCustomData  *psGpCustomDataStructure  Custom Data Structure
+ * tsGP_ZgpBufferedApduRecord *psZgpBufferedApduRecord  Buffered record
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PUBLIC void vGP_TxQueueRemove(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure,
+                    tsGP_ZgpBufferedApduRecord             *psZgpBufferedApduRecord)
+{
+    tsGP_TxQueue *psTxQueue = &psGpCustomDataStructure->sTxQueue;
+    uint8 u8Index = psZgpBufferedApduRecord->u8HeapIndex;
+    uint8 u8Last;
+
+    if (u8Index == GP_TX_QUEUE_NOT_QUEUED)
+    {
+        return;
+    }
+    psZgpBufferedApduRecord->u8HeapIndex = GP_TX_QUEUE_NOT_QUEUED;
+
+    u8Last = --psTxQueue->u8Size;
+    if (u8Index != u8Last)
+    {
+        /* move the last record into the hole and restore the heap order */
+        psTxQueue->apsRecord[u8Index] = psTxQueue->apsRecord[u8Last];
+        psTxQueue->apsRecord[u8Index]->u8HeapIndex = u8Index;
+        vGP_TxQueueSiftUp(psTxQueue, u8Index);
+        vGP_TxQueueSiftDown(psTxQueue, psTxQueue->apsRecord[u8Index]->u8HeapIndex);
+    }
+}
+
+/****************************************************************************
+ *
+ * NAME: bGP_IsTxQueueRecordDue
+ *
+ * DESCRIPTION:
+ * Checks if the deadline of a queued record has been reached
+ *
+ * PARAMETERS:  Name                            Usage
+ * tsGP_GreenPowerCustomData  *psGpCustomDataStructure  Custom Data Structure
+ * tsGP_ZgpBufferedApduRecord *psZgpBufferedApduRecord  Buffered record
+ *
+ * RETURNS:
+ * TRUE if the record should be transmitted
+ *
+ ****************************************************************************/
+PUBLIC bool_t bGP_IsTxQueueRecordDue(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure,
+                    tsGP_ZgpBufferedApduRecord             *psZgpBufferedApduRecord)
+{
+    return ((psZgpBufferedApduRecord->u8HeapIndex != GP_TX_QUEUE_NOT_QUEUED) &&
+            ((int32)(psGpCustomDataStructure->sTxQueue.u32TimeMs - psZgpBufferedApduRecord->u32Deadline) >= 0));
+}
+
+/****************************************************************************
+ *
+ * NAME: vGP_TxQueueArmTimer
+ *
+ * DESCRIPTION:
+ * Requests the ms timer of the GP end point for the earliest deadline, or for
+ * the next 20 ms step while the commission window or transmit channel timeout
+ * is running, and stops it when nothing is pending. A running timer is only
+ * restarted when it would expire too late
+ *
+ * PARAMETERS:  Name                            Usage
+ * tsGP_GreenPowerCustomData  *psGpCustomDataStructure  Custom Data Structure
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PUBLIC void vGP_TxQueueArmTimer(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure)
+{
+    tsGP_TxQueue *psTxQueue = &psGpCustomDataStructure->sTxQueue;
+    tsZCL_EndPointDefinition *psEndPointDefinition;
+    uint32 u32NowMs = GP_TX_QUEUE_TIME_MS();
+    uint32 u32PeriodMs = 0;
+    int32 i32RemainingMs;
+
+    if (psTxQueue->u8Size)
+    {
+        i32RemainingMs = (int32)(psTxQueue->apsRecord[0]->u32Deadline - u32NowMs);
+        u32PeriodMs = (i32RemainingMs > 0) ? (uint32)i32RemainingMs : 1;
+        if (u32PeriodMs > GP_TX_QUEUE_MAX_TIMER_PERIOD_MS)
+        {
+            u32PeriodMs = GP_TX_QUEUE_MAX_TIMER_PERIOD_MS;
+        }
+    }
+    if ((psGpCustomDataStructure->u16CommissionWindow)
+            || (psGpCustomDataStructure->u16TransmitChannelTimeout))
+    {
+        if (!psTxQueue->bTimeoutRunning)
+        {
+            psTxQueue->bTimeoutRunning = TRUE;
+            psTxQueue->u32TimeoutDueMs = u32NowMs + GP_TIMEOUT_TICK_MS;
+        }
+        i32RemainingMs = (int32)(psTxQueue->u32TimeoutDueMs - u32NowMs);
+        if (i32RemainingMs <= 0)
+        {
+            i32RemainingMs = 1;
+        }
+        if ((u32PeriodMs == 0) || ((uint32)i32RemainingMs < u32PeriodMs))
+        {
+            u32PeriodMs = (uint32)i32RemainingMs;
+        }
+    }
+    else
+    {
+        psTxQueue->bTimeoutRunning = FALSE;
+    }
+
+    if (u32PeriodMs == 0)
+    {
+        if (!psTxQueue->bTimerRunning)
+        {
+            return;
+        }
+    }
+    else if ((psTxQueue->bTimerRunning)
+            && ((int32)(psTxQueue->u32TimerExpiryMs - (u32NowMs + u32PeriodMs)) <= 0))
+    {
+        /* running timer expires early enough */
+        return;
+    }
+
+    if (eZCL_SearchForEPentry(psZCL_Common->u8GreenPowerMappedEpId, &psEndPointDefinition) != E_ZCL_SUCCESS)
+    {
+        return;
+    }
+    DBG_vPrintf(TRACE_GP_DEBUG, "vGP_TxQueueArmTimer: period %d ms\n", u32PeriodMs);
+    psTxQueue->bTimerRunning = (u32PeriodMs != 0);
+    psTxQueue->u32TimerExpiryMs = u32NowMs + u32PeriodMs;
+    eZCL_UpdateMsTimer(psEndPointDefinition, (u32PeriodMs != 0), u32PeriodMs);
+}
+#endif
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+/****************************************************************************
+ *
+ * NAME: vGP_HandleTimeouts
+ *
+ * DESCRIPTION:
+ * Runs one 20 ms step of the commission window and transmit channel timeouts
+ *
+ * PARAMETERS:  Name                            Usage
+ * tsZCL_EndPointDefinition   *psEndPointDefinition     End Point defintion
+ * tsGP_GreenPowerCustomData  *psGpCustomDataStructure  Custom Data Structure
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PRIVATE void vGP_HandleTimeouts(
+                    tsZCL_EndPointDefinition               *psEndPointDefinition,
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure)
+{
+	/* Handling Proxy Commission Mode Timeout */
+	if (psGpCustomDataStructure->u16CommissionWindow) {
+		/* Decrement and if value is zero exit commission mode */
+		if ((--psGpCustomDataStructure->u16CommissionWindow == 0x00)
+				&& (psGpCustomDataStructure->eGreenPowerDeviceMode
+						!= E_GP_OPERATING_MODE)) {
+			vGP_ExitCommMode(psEndPointDefinition,
+					psGpCustomDataStructure);
+		}
+	}
+	/* Handling transmit channel Timeout */
+	if (psGpCustomDataStructure->u16TransmitChannelTimeout) {
+		/* Decrement and if value is zero change channel to operational */
+		if (--psGpCustomDataStructure->u16TransmitChannelTimeout == 0x00) {
+            DBG_vPrintf(TRACE_GP_DEBUG, "\n eGP_Update20mS: setting channel to back to operating = %d  \n", psGpCustomDataStructure->u8OperationalChannel);
+#ifndef PC_PLATFORM_BUILD
+			ZPS_vNwkNibSetChannel(ZPS_pvAplZdoGetNwkHandle(),
+					psGpCustomDataStructure->u8OperationalChannel);
+#endif
+		}
+	}
+}
+
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+/****************************************************************************
+ *
+ * NAME: bGP_IsTxQueueEarlier
+ *
+ * DESCRIPTION:
+ * Compares the deadlines of two buffered records
+ *
+ * PARAMETERS:  Name                            Usage
+ * tsGP_ZgpBufferedApduRecord *psFirst          Buffered record
+ * tsGP_ZgpBufferedApduRecord *psSecond         Buffered record
+ *
+ * RETURNS:
+ * TRUE if psFirst is due before psSecond
+ *
+ ****************************************************************************/
+PRIVATE bool_t bGP_IsTxQueueEarlier(
+                    tsGP_ZgpBufferedApduRecord             *psFirst,
+                    tsGP_ZgpBufferedApduRecord             *psSecond)
+{
+    return ((int32)(psFirst->u32Deadline - psSecond->u32Deadline) < 0);
+}
+
+/****************************************************************************
+ *
+ * NAME: vGP_TxQueueSwap
+ *
+ * DESCRIPTION:
+ * Swaps two heap positions and updates the records' heap indexes
+ *
+ * PARAMETERS:  Name                            Usage
+ * tsGP_TxQueue               *psTxQueue        Deadline queue
+ * uint8                      u8First           Heap index
+ * uint8                      u8Second          Heap index
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PRIVATE void vGP_TxQueueSwap(
+                    tsGP_TxQueue                           *psTxQueue,
+                    uint8                                  u8First,
+                    uint8                                  u8Second)
+{
+    tsGP_ZgpBufferedApduRecord *psRecord = psTxQueue->apsRecord[u8First];
+
+    psTxQueue->apsRecord[u8First] = psTxQueue->apsRecord[u8Second];
+    psTxQueue->apsRecord[u8Second] = psRecord;
+    psTxQueue->apsRecord[u8First]->u8HeapIndex = u8First;
+    psTxQueue->apsRecord[u8Second]->u8HeapIndex = u8Second;
+}
+
+/****************************************************************************
+ *
+ * NAME: vGP_TxQueueSiftUp
+ *
+ * DESCRIPTION:
+ * Moves a record towards the heap root while it is due before its parent
+ *
+ * PARAMETERS:  Name                            Usage
+ * tsGP_TxQueue               *psTxQueue        Deadline queue
+ * uint8                      u8Index           Heap index
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PRIVATE void vGP_TxQueueSiftUp(
+                    tsGP_TxQueue                           *psTxQueue,
+                    uint8                                  u8Index)
+{
+    uint8 u8Parent;
+
+    while (u8Index > 0)
+    {
+        u8Parent = (u8Index - 1) / 2;
+        if (!bGP_IsTxQueueEarlier(psTxQueue->apsRecord[u8Index], psTxQueue->apsRecord[u8Parent]))
+        {
+            break;
+        }
+        vGP_TxQueueSwap(psTxQueue, u8Index, u8Parent);
+        u8Index = u8Parent;
+    }
+}
+
+/****************************************************************************
+ *
+ * NAME: vGP_TxQueueSiftDown
+ *
+ * DESCRIPTION:
+ * Moves a record away from the heap root while a child is due before it
+ *
+ * PARAMETERS:  Name                            Usage
+ * tsGP_TxQueue               *psTxQueue        Deadline queue
+ * uint8                      u8Index           Heap index
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+PRIVATE void vGP_TxQueueSiftDown(
+                    tsGP_TxQueue                           *psTxQueue,
+                    uint8                                  u8Index)
+{
+    uint8 u8Child;
+
+    for (;;)
+    {
+        u8Child = 2 * u8Index + 1;
+        if (u8Child >= psTxQueue->u8Size)
+        {
+            break;
+        }
+        if ((u8Child + 1 < psTxQueue->u8Size) &&
+                bGP_IsTxQueueEarlier(psTxQueue->apsRecord[u8Child + 1], psTxQueue->apsRecord[u8Child]))
+        {
+            u8Child++;
+        }
+        if (!bGP_IsTxQueueEarlier(psTxQueue->apsRecord[u8Child], psTxQueue->apsRecord[u8Index]))
+        {
+            break;
+        }
+        vGP_TxQueueSwap(psTxQueue, u8Index, u8Child);
+        u8Index = u8Child;
+    }
+}
+#endif
+
 /****************************************************************************/
 /***        END OF FILE                                                   ***/
 /****************************************************************************/
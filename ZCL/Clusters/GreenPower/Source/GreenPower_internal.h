@@ -46,6 +46,8 @@ extern "C" {
 /****************************************************************************/
 #define GP_GENERAL_CLUSTER_ID_IDENTIFY                                  (0x0003)
 
+#define GP_TX_QUEUE_NOT_QUEUED                                          (0xFF)
+
 #define GP_GENERAL_CLUSTER_ID_ONOFF                                     (0x0006)
 
 #define GP_GENERAL_CLUSTER_ID_LEVEL_CONTROL                             (0x0008)
@@ -607,6 +609,59 @@ bool_t bGP_CheckGPDAddressMatch(
 		tuGP_ZgpdDeviceAddr          *sAddrDst
 		);
 
+#ifdef GP_PROXY_SINK_TABLE_HASH_INDEX
+PUBLIC void vGP_RebuildProxySinkTableIndex(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure);
+
+PUBLIC void vGP_UpdateProxySinkTableIndex(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure,
+                    tsGP_ZgppProxySinkTable                *psProxySinkTableEntry);
+#endif
+
+#ifdef GP_SEC_FRAME_COUNTER_RESERVATION
+PUBLIC void vGP_ReserveSecFrameCounters(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure);
+
+PUBLIC void vGP_AdvanceSecFrameCounters(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure);
+#endif
+
+#ifdef GP_TABLE_STREAM_ENCODER
+#ifdef GP_COMBO_BASIC_DEVICE
+uint16 u16GetSinkTableEntrySize(
+		tsGP_ZgppProxySinkTable                              *psZgppProxySinkTable);
+#endif
+
+PUBLIC uint16 u16GP_StreamTableEntry(
+                    bool_t                                 bIsSinkTable,
+                    tsGP_ZgppProxySinkTable                *psZgppProxySinkTable,
+                    uint8                                  *pu8Data,
+                    uint16                                 u16MaxLength);
+
+PUBLIC uint16 u16GP_StreamTableString(
+                    uint8                                  u8GreenPowerEndPointId,
+                    bool_t                                 bIsSinkTable,
+                    uint8                                  *pu8Data,
+                    uint16                                 u16MaxLength);
+#endif
+
+#ifdef GP_TX_QUEUE_DEADLINE_TIMER
+PUBLIC void vGP_TxQueueSchedule(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure,
+                    tsGP_ZgpBufferedApduRecord             *psZgpBufferedApduRecord);
+
+PUBLIC void vGP_TxQueueRemove(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure,
+                    tsGP_ZgpBufferedApduRecord             *psZgpBufferedApduRecord);
+
+PUBLIC bool_t bGP_IsTxQueueRecordDue(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure,
+                    tsGP_ZgpBufferedApduRecord             *psZgpBufferedApduRecord);
+
+PUBLIC void vGP_TxQueueArmTimer(
+                    tsGP_GreenPowerCustomData              *psGpCustomDataStructure);
+#endif
+
 PUBLIC teZCL_Status eGP_HandleSinkTableResponse(
                     ZPS_tsAfEvent                  *pZPSevent,
                     tsZCL_EndPointDefinition       *psEndPointDefinition,
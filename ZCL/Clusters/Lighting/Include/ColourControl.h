@@ -191,6 +191,27 @@
 #define CLD_COLOURCONTROL_WHITE_Y   (1.0 / 3.0)
 #endif
 
+/* Define CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS to do the HSV, xyY, CCT and
+ * gamut conversions run on every transition step in Q16 fixed point instead of
+ * software float. The XYZ<->RGB matrices are still derived from the primaries
+ * in float, once, when they are set. The error against the float conversions
+ * is listed in ColourControlConversionsFixedPoint.c.
+ */
+//#define CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
+
+/* Define CLD_COLOURCONTROL_TIMED_TRANSITIONS to evaluate transitions from the
+ * time elapsed since they started instead of adding a step per 100ms update.
+ * eCLD_ColourControlUpdateElapsed() can then be called at any rate, and
+ * eCLD_ColourControlGetNextChangeTime() says when the next call is worthwhile.
+ */
+//#define CLD_COLOURCONTROL_TIMED_TRANSITIONS
+
+/* Time represented by one call to eCLD_ColourControlUpdate() */
+#define CLD_COLOURCONTROL_UPDATE_PERIOD_MS              (100)
+
+/* Returned by eCLD_ColourControlGetNextChangeTime() when nothing is moving */
+#define CLD_COLOURCONTROL_NO_CHANGE_PENDING             (0xffffffff)
+
 
 /* Define min & max colour temperature */
 #ifndef CLD_COLOURCONTROL_COLOUR_TEMPERATURE_PHY_MIN
@@ -1029,6 +1050,11 @@ typedef struct
     tsCLD_ColourControl_Attributes                                  sTarget;
     tsCLD_ColourControl_Attributes                                  sStep;
     tsCLD_ColourControl_Attributes                                  sPrevious;
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+    tsCLD_ColourControl_Attributes                                  sDelta;
+    uint32                                                          u32DurationMs;
+    uint32                                                          u32ElapsedMs;
+#endif
 } tsCLD_ColourControl_Transition;
 
 
@@ -1040,8 +1066,13 @@ typedef struct
     tsCLD_ColourControl_Transition                                  sTransition;
 
     /* Matrices for XYZ <> RGB conversions */
+#ifdef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
+    int32                                                           ai32XYZ2RGB[3][3];
+    int32                                                           ai32RGB2XYZ[3][3];
+#else
     float                                                           afXYZ2RGB[3][3];
     float                                                           afRGB2XYZ[3][3];
+#endif
 
     tsZCL_ReceiveEventAddress                                         sReceiveEventAddress;
     tsZCL_CallBackEvent                                             sCustomCallBackEvent;
@@ -1222,6 +1253,16 @@ PUBLIC void vCLD_ColourControl_CCT2xyY(
 
 PUBLIC teZCL_Status eCLD_ColourControlUpdate(
         uint8                       u8SourceEndPointId);
+
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+PUBLIC teZCL_Status eCLD_ColourControlUpdateElapsed(
+        uint8                       u8SourceEndPointId,
+        uint32                      u32ElapsedMs);
+
+PUBLIC teZCL_Status eCLD_ColourControlGetNextChangeTime(
+        uint8                       u8SourceEndPointId,
+        uint32                      *pu32TimeMs);
+#endif
         
 PUBLIC teZCL_Status eCLD_ColourControlStopTransition(
         uint8                       u8SourceEndPointId);
@@ -79,6 +79,9 @@
                      : \
                      ((X) >= (Z) ? (X) : (Z)))
 
+/* Span of the 16 bit hue scale (x100) that hue moves wrap around */
+#define CLD_COLOURCONTROL_HUE_RANGE     ((CLD_COLOURCONTROL_HUE_MAX_VALUE << 8) * 100)
+
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
@@ -181,6 +184,27 @@ PRIVATE  teZCL_Status eCLD_ColourControlSceneEventHandler(
         teZCL_SceneEvent                        eEvent,
         tsZCL_EndPointDefinition                *psEndPointDefinition,
         tsZCL_ClusterInstance                   *psClusterInstance);
+
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+PRIVATE  int iCLD_ColourControlInterpolate(
+         tsCLD_ColourControl_Transition         *psTransition,
+         int                                    iStart,
+         int                                    iDelta);
+
+PRIVATE  int iCLD_ColourControlRateValue(
+         tsCLD_ColourControl_Transition         *psTransition,
+         int                                    iStart,
+         int                                    iStep);
+
+PRIVATE  int iCLD_ColourControlHueRateValue(
+         tsCLD_ColourControl_Transition         *psTransition);
+
+PRIVATE  uint32 u32CLD_ColourControlNextStepTime(
+         int                                    iStart,
+         int                                    iDelta,
+         uint32                                 u32DurationMs,
+         uint32                                 u32ElapsedMs);
+#endif
 #endif
 
 /****************************************************************************/
@@ -544,6 +568,10 @@ PUBLIC  teZCL_Status eCLD_ColourControlCreateColourControl(
     
     /* Last received command (for update function) */
     psCustomDataStructure->sTransition.eCommand = E_CLD_COLOURCONTROL_CMD_NONE;
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+    psCustomDataStructure->sTransition.u32DurationMs = 0;
+    psCustomDataStructure->sTransition.u32ElapsedMs = 0;
+#endif
 
     /* Set master colour mode value. Shared struct value is just a copy of this */
     psCustomDataStructure->eColourMode = E_CLD_COLOURCONTROL_COLOURMODE_CURRENT_X_AND_CURRENT_Y;
@@ -819,6 +847,44 @@ PUBLIC  teZCL_Status eCLD_ColourControlSetPrimaries(
 /****************************************************************************/
 /***        Local Functions                                               ***/
 /****************************************************************************/
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+/****************************************************************************
+ **
+ ** NAME:       eCLD_ColourControlUpdate
+ **
+ ** DESCRIPTION:
+ ** Updates the the state of a colour control cluster by one 100ms tick
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          Source EP Id
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PUBLIC  teZCL_Status eCLD_ColourControlUpdate(uint8 u8SourceEndPointId)
+{
+    return eCLD_ColourControlUpdateElapsed(u8SourceEndPointId, CLD_COLOURCONTROL_UPDATE_PERIOD_MS);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       eCLD_ColourControlUpdateElapsed
+ **
+ ** DESCRIPTION:
+ ** Updates the the state of a colour control cluster, evaluating any
+ ** transition at the time elapsed since it started
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          Source EP Id
+ ** uint32                      u32ElapsedMs                Time since last update
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PUBLIC  teZCL_Status eCLD_ColourControlUpdateElapsed(uint8 u8SourceEndPointId, uint32 u32ElapsedMs)
+#else
 /****************************************************************************
  **
  ** NAME:       eCLD_ColourControlUpdate
@@ -834,6 +900,7 @@ PUBLIC  teZCL_Status eCLD_ColourControlSetPrimaries(
  **
  ****************************************************************************/
 PUBLIC  teZCL_Status eCLD_ColourControlUpdate(uint8 u8SourceEndPointId)
+#endif
 {
 
     teZCL_Status eStatus;
@@ -862,7 +929,22 @@ PUBLIC  teZCL_Status eCLD_ColourControlUpdate(uint8 u8SourceEndPointId)
         eZCL_GetMutex(psEndPointDefinition);
     #endif
 
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+    psCommon->sTransition.u32ElapsedMs += MIN(u32ElapsedMs, 0xffffffff - psCommon->sTransition.u32ElapsedMs);
 
+    /* Remaining time follows the clock, so a bounded transition ends when it reaches 0 */
+    if(psCommon->sTransition.u16Time > 0)
+    {
+        if(psCommon->sTransition.u32ElapsedMs >= psCommon->sTransition.u32DurationMs)
+        {
+            psCommon->sTransition.u16Time = 0;
+        }
+        else
+        {
+            psCommon->sTransition.u16Time = (uint16)((psCommon->sTransition.u32DurationMs - psCommon->sTransition.u32ElapsedMs + CLD_COLOURCONTROL_UPDATE_PERIOD_MS - 1) / CLD_COLOURCONTROL_UPDATE_PERIOD_MS);
+        }
+    }
+#endif
 
     /* If we're in a transition, save previous values in case there is a conversion error later */
     if(psCommon->sTransition.eCommand != E_CLD_COLOURCONTROL_CMD_NONE)
@@ -1209,6 +1291,215 @@ PUBLIC  teZCL_Status eCLD_ColourControlStopTransition(uint8 u8SourceEndPointId)
     return eStatus;
 }
 
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+/****************************************************************************
+ **
+ ** NAME:       eCLD_ColourControlGetNextChangeTime
+ **
+ ** DESCRIPTION:
+ ** Works out how long until a transition next changes the colour attributes,
+ ** so the application can schedule its next call to the update function
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          Source EP Id
+ ** uint32                      *pu32TimeMs                 Time in ms, or
+ **                                                         CLD_COLOURCONTROL_NO_CHANGE_PENDING
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PUBLIC  teZCL_Status eCLD_ColourControlGetNextChangeTime(
+        uint8                       u8SourceEndPointId,
+        uint32                      *pu32TimeMs)
+{
+
+    teZCL_Status eStatus;
+    tsCLD_ColourControlCustomDataStructure *psCommon;
+    tsZCL_EndPointDefinition *psEndPointDefinition;
+    tsZCL_ClusterInstance *psClusterInstance;
+    tsCLD_ColourControl_Transition *psTransition;
+    tsCLD_ColourControl_Attributes *psChange;
+    uint32 u32NextMs;
+    uint32 u32PeriodMs;
+
+    if(pu32TimeMs == NULL)
+    {
+        return E_ZCL_ERR_PARAMETER_NULL;
+    }
+
+    /* Find pointers to cluster */
+    eStatus = eZCL_FindCluster(LIGHTING_CLUSTER_ID_COLOUR_CONTROL, u8SourceEndPointId, TRUE, &psEndPointDefinition, &psClusterInstance, (void*)&psCommon);
+    if(eStatus != E_ZCL_SUCCESS)
+    {
+        return eStatus;
+    }
+
+    psTransition = &psCommon->sTransition;
+
+    switch(psTransition->eCommand)
+    {
+
+    case E_CLD_COLOURCONTROL_CMD_NONE:
+        *pu32TimeMs = CLD_COLOURCONTROL_NO_CHANGE_PENDING;
+        return E_ZCL_SUCCESS;
+
+    case E_CLD_COLOURCONTROL_CMD_SCENE_TRANSITION:
+        *pu32TimeMs = 0;
+        return E_ZCL_SUCCESS;
+
+    /* Open ended moves run at their step per update period */
+    case E_CLD_COLOURCONTROL_CMD_MOVE_HUE:
+    case E_CLD_COLOURCONTROL_CMD_ENHANCED_MOVE_HUE:
+    case E_CLD_COLOURCONTROL_CMD_COLOUR_LOOP_SET:
+    case E_CLD_COLOURCONTROL_CMD_MOVE_SATURATION:
+    case E_CLD_COLOURCONTROL_CMD_MOVE_COLOUR:
+    case E_CLD_COLOURCONTROL_CMD_MOVE_COLOUR_TEMPERATURE:
+        psChange = &psTransition->sStep;
+        u32PeriodMs = CLD_COLOURCONTROL_UPDATE_PERIOD_MS;
+        u32NextMs = CLD_COLOURCONTROL_NO_CHANGE_PENDING;
+        break;
+
+    /* Bounded transitions also change when they end */
+    default:
+        if(psTransition->u16Time == 0)
+        {
+            *pu32TimeMs = 0;
+            return E_ZCL_SUCCESS;
+        }
+        psChange = &psTransition->sDelta;
+        u32PeriodMs = psTransition->u32DurationMs;
+        u32NextMs = psTransition->u32DurationMs;
+        break;
+
+    }
+
+    switch(psTransition->eCommand)
+    {
+
+    case E_CLD_COLOURCONTROL_CMD_MOVE_HUE:
+    case E_CLD_COLOURCONTROL_CMD_ENHANCED_MOVE_HUE:
+    case E_CLD_COLOURCONTROL_CMD_COLOUR_LOOP_SET:
+        u32NextMs = u32CLD_ColourControlNextStepTime(psTransition->sStart.iHue, psChange->iHue, u32PeriodMs, psTransition->u32ElapsedMs);
+        break;
+
+    case E_CLD_COLOURCONTROL_CMD_MOVE_SATURATION:
+        u32NextMs = u32CLD_ColourControlNextStepTime(psTransition->sStart.iSaturation, psChange->iSaturation, u32PeriodMs, psTransition->u32ElapsedMs);
+        break;
+
+    case E_CLD_COLOURCONTROL_CMD_MOVE_COLOUR_TEMPERATURE:
+        u32NextMs = u32CLD_ColourControlNextStepTime(psTransition->sStart.iCCT, psChange->iCCT, u32PeriodMs, psTransition->u32ElapsedMs);
+        break;
+
+    case E_CLD_COLOURCONTROL_CMD_MOVE_COLOUR:
+        if((psChange->iX == 0) && (psChange->iY == 0))
+        {
+            /* The next update ends it */
+            u32NextMs = 0;
+            break;
+        }
+        u32NextMs = MIN(u32CLD_ColourControlNextStepTime(psTransition->sStart.iX, psChange->iX, u32PeriodMs, psTransition->u32ElapsedMs),
+                        u32CLD_ColourControlNextStepTime(psTransition->sStart.iY, psChange->iY, u32PeriodMs, psTransition->u32ElapsedMs));
+        break;
+
+    default:
+        /* Fields a bounded transition does not move have a zero delta */
+        u32NextMs = MIN(u32NextMs, u32CLD_ColourControlNextStepTime(psTransition->sStart.iHue, psChange->iHue, u32PeriodMs, psTransition->u32ElapsedMs));
+        u32NextMs = MIN(u32NextMs, u32CLD_ColourControlNextStepTime(psTransition->sStart.iSaturation, psChange->iSaturation, u32PeriodMs, psTransition->u32ElapsedMs));
+        u32NextMs = MIN(u32NextMs, u32CLD_ColourControlNextStepTime(psTransition->sStart.iX, psChange->iX, u32PeriodMs, psTransition->u32ElapsedMs));
+        u32NextMs = MIN(u32NextMs, u32CLD_ColourControlNextStepTime(psTransition->sStart.iY, psChange->iY, u32PeriodMs, psTransition->u32ElapsedMs));
+        u32NextMs = MIN(u32NextMs, u32CLD_ColourControlNextStepTime(psTransition->sStart.iCCT, psChange->iCCT, u32PeriodMs, psTransition->u32ElapsedMs));
+        break;
+
+    }
+
+    if(u32NextMs == CLD_COLOURCONTROL_NO_CHANGE_PENDING)
+    {
+        *pu32TimeMs = CLD_COLOURCONTROL_NO_CHANGE_PENDING;
+    }
+    else
+    {
+        *pu32TimeMs = (u32NextMs > psTransition->u32ElapsedMs) ? (u32NextMs - psTransition->u32ElapsedMs) : 0;
+    }
+
+    return E_ZCL_SUCCESS;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vCLD_ColourControlStartTimedTransition
+ **
+ ** DESCRIPTION:
+ ** Anchors a transition that has just been set up at the current values so
+ ** it can be evaluated from elapsed time rather than accumulated steps
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsCLD_ColourControl_Transition *psTransition            Transition
+ **
+ ** RETURN:
+ ** None
+ **
+ ****************************************************************************/
+PUBLIC  void vCLD_ColourControlStartTimedTransition(
+        tsCLD_ColourControl_Transition *psTransition)
+{
+
+    int64 i64Path;
+
+    memcpy(&psTransition->sStart, &psTransition->sCurrent, sizeof(tsCLD_ColourControl_Attributes));
+    memset(&psTransition->sDelta, 0, sizeof(tsCLD_ColourControl_Attributes));
+    psTransition->u32DurationMs = (uint32)psTransition->u16Time * CLD_COLOURCONTROL_UPDATE_PERIOD_MS;
+    psTransition->u32ElapsedMs = 0;
+
+    /* Only bounded transitions have a delta, and only for the values they move */
+    switch(psTransition->eCommand)
+    {
+
+    case E_CLD_COLOURCONTROL_CMD_MOVE_TO_HUE_AND_SATURATION:
+    case E_CLD_COLOURCONTROL_CMD_ENHANCED_MOVE_TO_HUE_AND_SATURATION:
+        psTransition->sDelta.iSaturation = psTransition->sTarget.iSaturation - psTransition->sStart.iSaturation;
+        /* Fall through */
+    case E_CLD_COLOURCONTROL_CMD_MOVE_TO_HUE:
+    case E_CLD_COLOURCONTROL_CMD_ENHANCED_MOVE_TO_HUE:
+    case E_CLD_COLOURCONTROL_CMD_STEP_HUE:
+    case E_CLD_COLOURCONTROL_CMD_ENHANCED_STEP_HUE:
+        /* Hue can go either way round, take the difference that follows the steps */
+        i64Path = (int64)psTransition->sStep.iHue * psTransition->u16Time;
+        psTransition->sDelta.iHue = psTransition->sTarget.iHue - psTransition->sStart.iHue;
+        while((psTransition->sDelta.iHue - i64Path) > (CLD_COLOURCONTROL_HUE_RANGE / 2))
+        {
+            psTransition->sDelta.iHue -= CLD_COLOURCONTROL_HUE_RANGE;
+        }
+        while((i64Path - psTransition->sDelta.iHue) > (CLD_COLOURCONTROL_HUE_RANGE / 2))
+        {
+            psTransition->sDelta.iHue += CLD_COLOURCONTROL_HUE_RANGE;
+        }
+        break;
+
+    case E_CLD_COLOURCONTROL_CMD_MOVE_TO_SATURATION:
+    case E_CLD_COLOURCONTROL_CMD_STEP_SATURATION:
+        psTransition->sDelta.iSaturation = psTransition->sTarget.iSaturation - psTransition->sStart.iSaturation;
+        break;
+
+    case E_CLD_COLOURCONTROL_CMD_MOVE_TO_COLOUR:
+    case E_CLD_COLOURCONTROL_CMD_STEP_COLOUR:
+        psTransition->sDelta.iX = psTransition->sTarget.iX - psTransition->sStart.iX;
+        psTransition->sDelta.iY = psTransition->sTarget.iY - psTransition->sStart.iY;
+        break;
+
+    case E_CLD_COLOURCONTROL_CMD_MOVE_TO_COLOUR_TEMPERATURE:
+    case E_CLD_COLOURCONTROL_CMD_STEP_COLOUR_TEMPERATURE:
+        psTransition->sDelta.iCCT = psTransition->sTarget.iCCT - psTransition->sStart.iCCT;
+        break;
+
+    default:
+        break;
+
+    }
+
+}
+#endif
+
 
 #if (CLD_COLOURCONTROL_COLOUR_CAPABILITIES & COLOUR_CAPABILITY_HUE_SATURATION_SUPPORTED)
 /****************************************************************************
@@ -1246,11 +1537,16 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleMoveToHueTransition(
     }
     else
     {
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+        /* Interpolate from the start values */
+        psCommon->sTransition.sCurrent.iHue = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iHue, psCommon->sTransition.sDelta.iHue);
+#else
         /* Decrement transition timer */
         psCommon->sTransition.u16Time--;
 
         /* Add step to current values */
         psCommon->sTransition.sCurrent.iHue += psCommon->sTransition.sStep.iHue;
+#endif
     }
 
     DBG_vPrintf(TRACE_COLOUR_CONTROL_UPDATES, " Now=%d Time=%d",
@@ -1289,8 +1585,13 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleMoveHueTransition(
                                       psCommon->sTransition.sCurrent.iHue,
                                       psCommon->sTransition.sStep.iHue);
 
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+    /* Work out where the move has got to */
+    psCommon->sTransition.sCurrent.iHue = iCLD_ColourControlHueRateValue(&psCommon->sTransition);
+#else
     /* Add step to current values */
     psCommon->sTransition.sCurrent.iHue += psCommon->sTransition.sStep.iHue;
+#endif
 
     /* Set upper limit */
     if(psCommon->sTransition.sCurrent.iHue > (CLD_COLOURCONTROL_HUE_MAX_VALUE << 8) * 100)
@@ -1348,11 +1649,16 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleStepHueTransition(
     }
     else
     {
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+        /* Interpolate from the start values */
+        psCommon->sTransition.sCurrent.iHue = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iHue, psCommon->sTransition.sDelta.iHue);
+#else
         /* Decrement transition timer */
         psCommon->sTransition.u16Time--;
 
         /* Add step to current values */
         psCommon->sTransition.sCurrent.iHue += psCommon->sTransition.sStep.iHue;
+#endif
     }
 
     DBG_vPrintf(TRACE_COLOUR_CONTROL_UPDATES, " Now=%d Time=%d",
@@ -1399,11 +1705,16 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleMoveToSaturationTransition(
     }
     else
     {
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+        /* Interpolate from the start values */
+        psCommon->sTransition.sCurrent.iSaturation = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iSaturation, psCommon->sTransition.sDelta.iSaturation);
+#else
         /* Decrement transition timer */
         psCommon->sTransition.u16Time--;
 
         /* Add step to current values */
         psCommon->sTransition.sCurrent.iSaturation += psCommon->sTransition.sStep.iSaturation;
+#endif
     }
 
     DBG_vPrintf(TRACE_COLOUR_CONTROL_UPDATES, " Now=%d Time=%d",
@@ -1441,8 +1752,13 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleMoveSaturationTransition(
                                       psCommon->sTransition.sCurrent.iSaturation,
                                       psCommon->sTransition.sStep.iSaturation);
 
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+    /* Work out where the move has got to */
+    psCommon->sTransition.sCurrent.iSaturation = iCLD_ColourControlRateValue(&psCommon->sTransition, psCommon->sTransition.sStart.iSaturation, psCommon->sTransition.sStep.iSaturation);
+#else
     /* Add step to current values */
     psCommon->sTransition.sCurrent.iSaturation += psCommon->sTransition.sStep.iSaturation;
+#endif
 
     /* Set upper limit */
     if(psCommon->sTransition.sCurrent.iSaturation > CLD_COLOURCONTROL_SATURATION_MAX_VALUE * 100)
@@ -1502,11 +1818,16 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleStepSaturationTransition(
     }
     else
     {
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+        /* Interpolate from the start values */
+        psCommon->sTransition.sCurrent.iSaturation = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iSaturation, psCommon->sTransition.sDelta.iSaturation);
+#else
         /* Decrement transition timer */
         psCommon->sTransition.u16Time--;
 
         /* Add step to current values */
         psCommon->sTransition.sCurrent.iSaturation += psCommon->sTransition.sStep.iSaturation;
+#endif
     }
 
     DBG_vPrintf(TRACE_COLOUR_CONTROL_UPDATES, " Now=%d Time=%d",
@@ -1556,12 +1877,18 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleMoveToHueAndSaturationTransition(
     }
     else
     {
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+        /* Interpolate from the start values */
+        psCommon->sTransition.sCurrent.iHue = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iHue, psCommon->sTransition.sDelta.iHue);
+        psCommon->sTransition.sCurrent.iSaturation = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iSaturation, psCommon->sTransition.sDelta.iSaturation);
+#else
         /* Decrement transition timer */
         psCommon->sTransition.u16Time--;
 
         /* Add step to current values */
         psCommon->sTransition.sCurrent.iHue += psCommon->sTransition.sStep.iHue;
         psCommon->sTransition.sCurrent.iSaturation += psCommon->sTransition.sStep.iSaturation;
+#endif
     }
 
     DBG_vPrintf(TRACE_COLOUR_CONTROL_UPDATES, " NowH=%d NowS=%d Time=%d",
@@ -1613,12 +1940,18 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleMoveToColourTransition(
     }
     else
     {
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+        /* Interpolate from the start values */
+        psCommon->sTransition.sCurrent.iX = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iX, psCommon->sTransition.sDelta.iX);
+        psCommon->sTransition.sCurrent.iY = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iY, psCommon->sTransition.sDelta.iY);
+#else
         /* Decrement transition timer */
         psCommon->sTransition.u16Time--;
 
         /* Add step to current values */
         psCommon->sTransition.sCurrent.iX += psCommon->sTransition.sStep.iX;
         psCommon->sTransition.sCurrent.iY += psCommon->sTransition.sStep.iY;
+#endif
     }
 
     DBG_vPrintf(TRACE_COLOUR_CONTROL_UPDATES, " NowX=%d NowY=%d Time=%d",
@@ -1666,9 +1999,15 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleMoveColourTransition(
     }
     else
     {
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+        /* Work out where the move has got to */
+        psCommon->sTransition.sCurrent.iX = iCLD_ColourControlRateValue(&psCommon->sTransition, psCommon->sTransition.sStart.iX, psCommon->sTransition.sStep.iX);
+        psCommon->sTransition.sCurrent.iY = iCLD_ColourControlRateValue(&psCommon->sTransition, psCommon->sTransition.sStart.iY, psCommon->sTransition.sStep.iY);
+#else
         /* Add step to current values */
         psCommon->sTransition.sCurrent.iX += psCommon->sTransition.sStep.iX;
         psCommon->sTransition.sCurrent.iY += psCommon->sTransition.sStep.iY;
+#endif
 
         /* Set upper limit */
         if(psCommon->sTransition.sCurrent.iX > CLD_COLOURCONTROL_X_MAX_VALUE * 100)
@@ -1742,12 +2081,18 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleStepColourTransition(
     }
     else
     {
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+        /* Interpolate from the start values */
+        psCommon->sTransition.sCurrent.iX = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iX, psCommon->sTransition.sDelta.iX);
+        psCommon->sTransition.sCurrent.iY = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iY, psCommon->sTransition.sDelta.iY);
+#else
         /* Decrement transition timer */
         psCommon->sTransition.u16Time--;
 
         /* Add step to current values */
         psCommon->sTransition.sCurrent.iX += psCommon->sTransition.sStep.iX;
         psCommon->sTransition.sCurrent.iY += psCommon->sTransition.sStep.iY;
+#endif
     }
 
     DBG_vPrintf(TRACE_COLOUR_CONTROL_UPDATES, " NowX=%d NowY=%d Time=%d",
@@ -1797,11 +2142,16 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleMoveToColourTemperatureTransition(
     }
     else
     {
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+        /* Interpolate from the start values */
+        psCommon->sTransition.sCurrent.iCCT = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iCCT, psCommon->sTransition.sDelta.iCCT);
+#else
         /* Decrement transition timer */
         psCommon->sTransition.u16Time--;
 
         /* Add step to current values */
         psCommon->sTransition.sCurrent.iCCT += psCommon->sTransition.sStep.iCCT;
+#endif
     }
 
     DBG_vPrintf(TRACE_COLOUR_CONTROL_UPDATES, " Now=%d Time=%d",
@@ -1854,8 +2204,13 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleColourLoopTransition(
         return E_ZCL_SUCCESS;
     }
 
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+    /* Work out where the move has got to */
+    psCommon->sTransition.sCurrent.iHue = iCLD_ColourControlHueRateValue(&psCommon->sTransition);
+#else
     /* Add step to current values */
     psCommon->sTransition.sCurrent.iHue += psCommon->sTransition.sStep.iHue;
+#endif
 
     /* Set upper limit */
     if(psCommon->sTransition.sCurrent.iHue > (CLD_COLOURCONTROL_HUE_MAX_VALUE<<8) * 100)
@@ -1902,8 +2257,13 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleMoveColourTemperatureTransition(
                                       psCommon->sTransition.sCurrent.iCCT,
                                       psCommon->sTransition.sStep.iCCT);
 
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+    /* Work out where the move has got to */
+    psCommon->sTransition.sCurrent.iCCT = iCLD_ColourControlRateValue(&psCommon->sTransition, psCommon->sTransition.sStart.iCCT, psCommon->sTransition.sStep.iCCT);
+#else
     /* Add step to current values */
     psCommon->sTransition.sCurrent.iCCT += psCommon->sTransition.sStep.iCCT;
+#endif
 
     /* If its a move UP, Set upper limit */
     if((psCommon->sTransition.sStep.iCCT > 0) && (psCommon->sTransition.sCurrent.iCCT > psCommon->sTransition.sTarget.iCCT))
@@ -1964,11 +2324,16 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleStepColourTemperatureTransition(
     }
     else
     {
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+        /* Interpolate from the start values */
+        psCommon->sTransition.sCurrent.iCCT = iCLD_ColourControlInterpolate(&psCommon->sTransition, psCommon->sTransition.sStart.iCCT, psCommon->sTransition.sDelta.iCCT);
+#else
         /* Decrement transition timer */
         psCommon->sTransition.u16Time--;
 
         /* Add step to current values */
         psCommon->sTransition.sCurrent.iCCT += psCommon->sTransition.sStep.iCCT;
+#endif
 
         /* If its a step UP, Set upper limit */
         if((psCommon->sTransition.sStep.iCCT > 0) && (psCommon->sTransition.sCurrent.iCCT > psCommon->sTransition.sTarget.iCCT))
@@ -2054,6 +2419,15 @@ PRIVATE  teZCL_Status eCLD_ColourControlHandleSceneTransition(
                     psCommon->sTransition.sStep.iHue = (-65535 * 100);
                 }
             }
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+            {
+                /* The loop starts when the scene transition ended, keep the time past that */
+                uint32 u32OvershootMs = psCommon->sTransition.u32ElapsedMs -
+                                        MIN(psCommon->sTransition.u32ElapsedMs, psCommon->sTransition.u32DurationMs);
+                vCLD_ColourControlStartTimedTransition(&psCommon->sTransition);
+                psCommon->sTransition.u32ElapsedMs = u32OvershootMs;
+            }
+#endif
         }
     #endif
 
@@ -2124,6 +2498,172 @@ PRIVATE  teZCL_Status eCLD_ColourControlSceneEventHandler(
 
     return E_ZCL_SUCCESS;
 }
+
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+/****************************************************************************
+ **
+ ** NAME:       iCLD_ColourControlInterpolate
+ **
+ ** DESCRIPTION:
+ ** Gives the value a bounded transition has reached
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsCLD_ColourControl_Transition *psTransition            Transition
+ ** int                         iStart                      Value at the start
+ ** int                         iDelta                      Change over the transition
+ **
+ ** RETURN:
+ ** int
+ **
+ ****************************************************************************/
+PRIVATE  int iCLD_ColourControlInterpolate(
+         tsCLD_ColourControl_Transition         *psTransition,
+         int                                    iStart,
+         int                                    iDelta)
+{
+
+    if(psTransition->u32ElapsedMs >= psTransition->u32DurationMs)
+    {
+        return iStart + iDelta;
+    }
+
+    return iStart + (int)(((int64)iDelta * psTransition->u32ElapsedMs) / psTransition->u32DurationMs);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       iCLD_ColourControlRateValue
+ **
+ ** DESCRIPTION:
+ ** Gives the unclamped value an open ended move has reached
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsCLD_ColourControl_Transition *psTransition            Transition
+ ** int                         iStart                      Value at the start
+ ** int                         iStep                       Change per update period
+ **
+ ** RETURN:
+ ** int
+ **
+ ****************************************************************************/
+PRIVATE  int iCLD_ColourControlRateValue(
+         tsCLD_ColourControl_Transition         *psTransition,
+         int                                    iStart,
+         int                                    iStep)
+{
+
+    int64 i64Value;
+
+    i64Value = iStart + (((int64)iStep * psTransition->u32ElapsedMs) / CLD_COLOURCONTROL_UPDATE_PERIOD_MS);
+
+    /* Keep it well inside an int, callers apply their own limits */
+    if(i64Value > 0x3fffffff)
+    {
+        i64Value = 0x3fffffff;
+    }
+    if(i64Value < -0x3fffffff)
+    {
+        i64Value = -0x3fffffff;
+    }
+
+    return (int)i64Value;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       iCLD_ColourControlHueRateValue
+ **
+ ** DESCRIPTION:
+ ** Gives the hue a wrapping hue move or colour loop has reached. Whole
+ ** update periods are folded into the start hue so the move can run for
+ ** ever without the elapsed time growing
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsCLD_ColourControl_Transition *psTransition            Transition
+ **
+ ** RETURN:
+ ** int
+ **
+ ****************************************************************************/
+PRIVATE  int iCLD_ColourControlHueRateValue(
+         tsCLD_ColourControl_Transition         *psTransition)
+{
+
+    int64 i64Hue;
+
+    i64Hue = psTransition->sStart.iHue + ((int64)psTransition->sStep.iHue * (psTransition->u32ElapsedMs / CLD_COLOURCONTROL_UPDATE_PERIOD_MS));
+    i64Hue %= CLD_COLOURCONTROL_HUE_RANGE;
+    if(i64Hue < 0)
+    {
+        i64Hue += CLD_COLOURCONTROL_HUE_RANGE;
+    }
+
+    psTransition->sStart.iHue = (int)i64Hue;
+    psTransition->u32ElapsedMs %= CLD_COLOURCONTROL_UPDATE_PERIOD_MS;
+
+    return iCLD_ColourControlRateValue(psTransition, psTransition->sStart.iHue, psTransition->sStep.iHue);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       u32CLD_ColourControlNextStepTime
+ **
+ ** DESCRIPTION:
+ ** Works out the elapsed time at which a value moving linearly from its
+ ** start next crosses a whole attribute unit
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** int                         iStart                      Value (x100) at time 0
+ ** int                         iDelta                      Change over u32DurationMs
+ ** uint32                      u32DurationMs               Time for iDelta
+ ** uint32                      u32ElapsedMs                Time now
+ **
+ ** RETURN:
+ ** uint32 - elapsed time in ms
+ **
+ ****************************************************************************/
+PRIVATE  uint32 u32CLD_ColourControlNextStepTime(
+         int                                    iStart,
+         int                                    iDelta,
+         uint32                                 u32DurationMs,
+         uint32                                 u32ElapsedMs)
+{
+
+    int64 i64Value;
+    int64 i64Unit;
+    uint64 u64Distance;
+    uint64 u64Time;
+
+    if((iDelta == 0) || (u32DurationMs == 0))
+    {
+        return CLD_COLOURCONTROL_NO_CHANGE_PENDING;
+    }
+
+    i64Value = iStart + (((int64)iDelta * u32ElapsedMs) / u32DurationMs);
+
+    /* Whole unit the value is in now, rounding towards minus infinity */
+    i64Unit = i64Value / 100;
+    if((i64Value % 100) < 0)
+    {
+        i64Unit--;
+    }
+
+    /* Distance from the start to the first value of the next unit */
+    if(iDelta > 0)
+    {
+        u64Distance = (uint64)(((i64Unit + 1) * 100) - iStart);
+    }
+    else
+    {
+        u64Distance = (uint64)(iStart - ((i64Unit * 100) - 1));
+        iDelta = -iDelta;
+    }
+
+    u64Time = ((u64Distance * u32DurationMs) + (uint64)iDelta - 1) / (uint64)iDelta;
+
+    return (uint32)MIN(u64Time, (uint64)CLD_COLOURCONTROL_NO_CHANGE_PENDING);
+}
+#endif
 #endif
 
 #endif          // ifdef CLD_COLOUR_CONTROL
@@ -364,6 +364,14 @@ PUBLIC  teZCL_Status eCLD_ColourControlCommandHandler(
 
     }
     
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+    /* Whatever transition the command set up is timed from here */
+    if(eStatus == E_ZCL_SUCCESS)
+    {
+        vCLD_ColourControlStartTimedTransition(&psCommon->sTransition);
+    }
+#endif
+
     /* Added the check to make sure the default reponse with status success is centralized */
     if((eStatus == E_ZCL_SUCCESS) && !(sZCL_HeaderParams.bDisableDefaultResponse))
         eZCL_SendDefaultResponse(pZPSevent, E_ZCL_CMDS_SUCCESS);
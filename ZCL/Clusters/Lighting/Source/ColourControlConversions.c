@@ -82,6 +82,7 @@ y                   = CurrentY / 65536
 Colour Temperature  = 1000000 / ColourTemperature
 */
 
+#ifndef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
 typedef struct
 {
     uint16      u16Temperature;
@@ -94,11 +95,13 @@ typedef struct
     float x;
     float y;
 } CS_tsPoint;
+#endif
 
 /****************************************************************************/
 /***        Local Function Prototypes                                     ***/
 /****************************************************************************/
 
+#ifndef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
 PRIVATE void vCLD_ColourControl_HSV2RGB(
         float                       fHue,
         float                       fSaturation,
@@ -161,6 +164,13 @@ PRIVATE bool_t CS_bDoLinesIntersect(float x1, float y1,
                                     float x4, float y4,
                                     float *x, float *y);
 #endif
+#endif
+
+#ifdef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
+PRIVATE void vCLD_ColourControl_MatrixToQ16(
+        float                       afMatrix[3][3],
+        int32                       ai32Matrix[3][3]);
+#endif
 
 /****************************************************************************/
 /***        Exported Variables                                            ***/
@@ -170,6 +180,7 @@ PRIVATE bool_t CS_bDoLinesIntersect(float x1, float y1,
 /***        Local Variables                                               ***/
 /****************************************************************************/
 
+#ifndef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
 /* Colour temperature vs CIE xyY coordinates */
 tsCLD_ColourControlCCT asCLD_ColourControlCCTlist[] = {
 
@@ -202,11 +213,13 @@ tsCLD_ColourControlCCT asCLD_ColourControlCCTlist[] = {
     {40000,     (float)0.2487,     (float)0.2438},
     {65535,     (float)0.244151,   (float)0.236667}
 };
+#endif
 
 
 /****************************************************************************/
 /***        Exported Functions                                            ***/
 /****************************************************************************/
+#ifndef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
 /****************************************************************************
  **
  ** NAME:       eCLD_ColourControl_GetRGB
@@ -563,6 +576,7 @@ PUBLIC  void vCLD_ColourControl_xyY2CCT(
 
 
 }
+#endif
 
 /****************************************************************************
  **
@@ -639,8 +653,13 @@ PUBLIC  teZCL_Status eCLD_ColourControlCalculateConversionMatrices(
     Cxr[2][2] =  (Crx[0][0] * Crx[1][1] - Crx[1][0] * Crx[0][1]) / Determinant;
 
     /* Save resulting matrices */
+#ifdef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
+    vCLD_ColourControl_MatrixToQ16(Crx, psCustomDataStructure->ai32RGB2XYZ);
+    vCLD_ColourControl_MatrixToQ16(Cxr, psCustomDataStructure->ai32XYZ2RGB);
+#else
     memcpy(&psCustomDataStructure->afRGB2XYZ, Crx, sizeof(Crx));
     memcpy(&psCustomDataStructure->afXYZ2RGB, Cxr, sizeof(Cxr));
+#endif
 
     return E_ZCL_SUCCESS;
 
@@ -649,6 +668,7 @@ PUBLIC  teZCL_Status eCLD_ColourControlCalculateConversionMatrices(
 /****************************************************************************/
 /***        Local Functions                                               ***/
 /****************************************************************************/
+#ifndef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
 /****************************************************************************
  **
  ** NAME:       vCLD_ColourControl_HSV2RGB
@@ -1245,6 +1265,48 @@ PRIVATE bool_t CS_bDoLinesIntersect(float x1, float y1,
     return TRUE;
 }
 #endif
+#endif
+
+#ifdef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
+/****************************************************************************
+ **
+ ** NAME:       vCLD_ColourControl_MatrixToQ16
+ **
+ ** DESCRIPTION:
+ ** Converts a floating point conversion matrix to Q16 fixed point (1.0 = 65536)
+ ** for use by the fixed point conversion functions
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** float                       afMatrix[3][3]              Floating point matrix
+ ** int32                       ai32Matrix[3][3]            Result Q16 matrix
+ **
+ ** RETURN:
+ ** void
+ **
+ ****************************************************************************/
+PRIVATE  void vCLD_ColourControl_MatrixToQ16(
+        float                       afMatrix[3][3],
+        int32                       ai32Matrix[3][3])
+{
+    int i, j;
+
+    for(i = 0; i < 3; i++)
+    {
+        for(j = 0; j < 3; j++)
+        {
+            /* Round to nearest */
+            if(afMatrix[i][j] < 0)
+            {
+                ai32Matrix[i][j] = (int32)(afMatrix[i][j] * 65536.0 - 0.5);
+            }
+            else
+            {
+                ai32Matrix[i][j] = (int32)(afMatrix[i][j] * 65536.0 + 0.5);
+            }
+        }
+    }
+}
+#endif
 
 #endif /* COLOUR_CONTROL_SERVER */
 /****************************************************************************/
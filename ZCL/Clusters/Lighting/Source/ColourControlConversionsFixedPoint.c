@@ -0,0 +1,1199 @@
+/****************************************************************************
+ *
+ * Copyright 2020 NXP.
+ *
+ * NXP Confidential.
+ *
+ * This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms.
+ * By expressly accepting such terms or by downloading, installing, activating
+ * and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms.
+ * If you do not agree to be bound by the applicable license terms,
+ * then you may not retain, install, activate or otherwise use the software.
+ *
+ *
+ ****************************************************************************/
+
+
+/*****************************************************************************
+ *
+ * MODULE:             Colour Control Cluster
+ *
+ * COMPONENT:          ColourControlConversionsFixedPoint.c
+ *
+ * DESCRIPTION:        Colour Control colour space conversion functions using
+ *                     Q16 fixed point arithmetic
+ *
+ *                     Against the floating point conversions, with the
+ *                     default primaries, results differ by at most:
+ *                       HSV2xyY   x, y 5/65536, Y 1
+ *                       xyY2HSV   hue 2 + 256 / saturation (1/65536 of a
+ *                                 turn), saturation 1, value 1
+ *                       CCT2xyY   x, y 2/65536
+ *                       xyY2CCT   1 mired down to 1000K, 1% below it
+ *                       GetRGB    1 + 640 / CurrentY per component
+ *                       CS_bTransitionIsValid  2/65536 on the clipped point
+ *                     tests/host/ColourControlConversionsTest.c checks these.
+ *
+ *****************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include <jendefs.h>
+
+#include "zps_apl.h"
+#include "zps_apl_aib.h"
+
+#include "zcl.h"
+#include "zcl_customcommand.h"
+#include "zcl_options.h"
+#include "string.h"
+#include "ColourControl.h"
+#include "ColourControl_internal.h"
+
+
+#include "dbg.h"
+
+#ifdef DEBUG_CLD_COLOUR_CONTROL_CONVERSIONS
+#define TRACE_COLOUR_CONTROL_CONVERSIONS    TRUE
+#else
+#define TRACE_COLOUR_CONTROL_CONVERSIONS    FALSE
+#endif
+
+#ifdef DEBUG_CLD_COLOUR_CONTROL
+#define TRACE_COLOUR_CONTROL   TRUE
+#else
+#define TRACE_COLOUR_CONTROL   FALSE
+#endif
+
+#if (defined COLOUR_CONTROL_SERVER) && (defined CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS)
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* 3 way MAX and MIN macro's */
+#define MIN3(X,Y,Z)     ((Y) <= (Z) ? ((X) <= (Y) ? (X) : (Y)) : ((X) <= (Z) ? (X) : (Z)))
+
+#define MAX3(X,Y,Z)     ((Y) >= (Z) ? ((X) >= (Y) ? (X) : (Y)) : ((X) >= (Z) ? (X) : (Z)))
+
+/* Q16 fixed point: 1.0 is represented by 65536 */
+#define Q16_ONE                         (65536L)
+
+/* Converts a floating point constant to Q16, resolved at compile time */
+#define Q16_FROM_CONST(f)               ((int32)((f) * 65536.0 + 0.5))
+
+/* Multiplies two Q16 values */
+#define Q16_MUL(a, b)                   ((int32)(((int64)(a) * (int64)(b)) >> 16))
+
+/* Converts an 8 bit attribute value (0 - 255) to Q16 (0 - 1.0) */
+#define Q16_FROM_U8(u8)                 ((int32)(u8) * 257 + ((u8) >> 7))
+
+/* Number of entries in the colour temperature lookup table */
+#define CCT_TABLE_SIZE                  ((int)(sizeof(asCLD_ColourControlCCTlist) / sizeof(tsCLD_ColourControlCCT)))
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/*
+ * All intermediate values are Q16 fixed point held in int32, so that
+ * x = CurrentX / 65536, Saturation = CurrentSaturation / 255 etc. as for the
+ * floating point conversions. Hue is held in sectors of 60 degrees (0 - 6.0).
+ */
+
+typedef struct
+{
+    uint16      u16Temperature;
+    uint16      u16x;
+    uint16      u16y;
+} tsCLD_ColourControlCCT;
+
+typedef struct
+{
+    int32 x;
+    int32 y;
+} CS_tsPoint;
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+PRIVATE void vCLD_ColourControl_HSV2RGB(
+        uint16                      u16Hue,
+        int32                       i32Saturation,
+        int32                       i32Value,
+        int32                       *pi32Red,
+        int32                       *pi32Green,
+        int32                       *pi32Blue);
+
+PRIVATE void vCLD_ColourControl_RGB2HSV(
+        int32                       i32Red,
+        int32                       i32Green,
+        int32                       i32Blue,
+        int32                       *pi32Hue,
+        int32                       *pi32Saturation,
+        int32                       *pi32Value);
+
+PRIVATE void vCLD_ColourControl_MatrixMultiply(
+        int32                       ai32Matrix[3][3],
+        int32                       i32A,
+        int32                       i32B,
+        int32                       i32C,
+        int32                       *pi32A,
+        int32                       *pi32B,
+        int32                       *pi32C);
+
+PRIVATE void vCLD_ColourControl_XYZ2RGB(
+        int32                       ai32Matrix[3][3],
+        int32                       i32X,
+        int32                       i32Y,
+        int32                       i32Z,
+        int32                       *pi32Red,
+        int32                       *pi32Green,
+        int32                       *pi32Blue);
+
+PRIVATE teZCL_Status eCLD_ColourControl_XYZ2xyY(
+        int32                       i32X,
+        int32                       i32Y,
+        int32                       i32Z,
+        int32                       *pi32x,
+        int32                       *pi32y,
+        int32                       *pi32Y);
+
+PRIVATE teZCL_Status eCLD_ColourControl_xyY2XYZ(
+        int32                       i32x,
+        int32                       i32y,
+        int32                       i32Y,
+        int32                       *pi32X,
+        int32                       *pi32Y,
+        int32                       *pi32Z);
+
+PRIVATE uint8 u8CLD_ColourControl_Q16ToU8(
+        int32                       i32Value);
+
+PRIVATE uint16 u16CLD_ColourControl_Q16ToU16(
+        int32                       i32Value);
+
+#if (CLD_COLOURCONTROL_COLOUR_CAPABILITIES & COLOUR_CAPABILITY_XY_SUPPORTED)
+PRIVATE bool_t CS_bIsInGamut(int32 x, int32 y);
+
+PRIVATE bool_t CS_bDoLinesIntersect(int32 x1, int32 y1,
+                                    int32 x2, int32 y2,
+                                    int32 x3, int32 y3,
+                                    int32 x4, int32 y4,
+                                    int32 *x, int32 *y);
+#endif
+
+/****************************************************************************/
+/***        Exported Variables                                            ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+/* Colour temperature vs CIE xyY coordinates, x and y scaled by 65535 */
+PRIVATE const tsCLD_ColourControlCCT asCLD_ColourControlCCTlist[] = {
+
+    /*  CCT     x          y */
+    {0,         45874,     19660},
+    {1000,      42591,     22767},
+    {1500,      38279,     25965},
+    {2000,      34517,     27348},
+    {2500,      31339,     27433},
+    {3000,      28757,     26837},
+    {4000,      25080,     25034},
+    {5000,      22760,     23337},
+    {6000,      21246,     21987},
+    {6600,      20578,     21325},
+    {6700,      20480,     21220},
+    {7000,      20204,     20938},
+    {8000,      19464,     20126},
+    {9000,      18920,     19497},
+    {10000,     18507,     18992},
+    {11000,     18179,     18586},
+    {12000,     17917,     18251},
+    {13000,     17708,     17970},
+    {14000,     17531,     17740},
+    {15000,     17386,     17537},
+    {16000,     17262,     17367},
+    {20000,     16908,     16869},
+    {25000,     16652,     16495},
+    {30000,     16489,     16259},
+    {35000,     16384,     16095},
+    {40000,     16299,     15977},
+    {65535,     16000,     15510}
+};
+
+#if (CLD_COLOURCONTROL_COLOUR_CAPABILITIES & COLOUR_CAPABILITY_XY_SUPPORTED)
+/* Gamut triangle and white point in Q16 */
+PRIVATE const CS_tsPoint sCS_Red   = {Q16_FROM_CONST(CLD_COLOURCONTROL_RED_X),   Q16_FROM_CONST(CLD_COLOURCONTROL_RED_Y)};
+PRIVATE const CS_tsPoint sCS_Green = {Q16_FROM_CONST(CLD_COLOURCONTROL_GREEN_X), Q16_FROM_CONST(CLD_COLOURCONTROL_GREEN_Y)};
+PRIVATE const CS_tsPoint sCS_Blue  = {Q16_FROM_CONST(CLD_COLOURCONTROL_BLUE_X),  Q16_FROM_CONST(CLD_COLOURCONTROL_BLUE_Y)};
+PRIVATE const CS_tsPoint sCS_White = {Q16_FROM_CONST(CLD_COLOURCONTROL_WHITE_X), Q16_FROM_CONST(CLD_COLOURCONTROL_WHITE_Y)};
+#endif
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+/****************************************************************************
+ **
+ ** NAME:       eCLD_ColourControl_GetRGB
+ **
+ ** DESCRIPTION:
+ ** Converts from xyY to RGB taking the path xyY->XYZ->RGB
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          End point ID
+ ** uint8                       *pu8Red                     Red value
+ ** uint8                       *pu8Green                   Green value
+ ** uint8                       *pu8Blue                    Blue value
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PUBLIC  teZCL_Status eCLD_ColourControl_GetRGB(
+        uint8                       u8SourceEndPointId,
+        uint8                       *pu8Red,
+        uint8                       *pu8Green,
+        uint8                       *pu8Blue)
+{
+
+    teZCL_Status eStatus;
+    tsCLD_ColourControlCustomDataStructure *psCommon;
+    tsZCL_EndPointDefinition *psEndPointDefinition;
+    tsZCL_ClusterInstance *psClusterInstance;
+    tsCLD_ColourControl *psColourControl;
+
+    int32 X, Y, Z;
+    int32 R, G, B;
+
+    /* Find pointers to cluster */
+    eStatus = eZCL_FindCluster(LIGHTING_CLUSTER_ID_COLOUR_CONTROL, u8SourceEndPointId, TRUE, &psEndPointDefinition, &psClusterInstance, (void*)&psCommon);
+    if(eStatus != E_ZCL_SUCCESS)
+    {
+        DBG_vPrintf(TRACE_COLOUR_CONTROL_CONVERSIONS, " No Endpoint");
+        return eStatus;
+    }
+
+    psColourControl = (tsCLD_ColourControl*)psClusterInstance->pvEndPointSharedStructPtr;
+
+    /* Convert xyY to XYZ colour space */
+    if(eCLD_ColourControl_xyY2XYZ(psColourControl->u16CurrentX, psColourControl->u16CurrentY, Q16_ONE, &X, &Y, &Z) != E_ZCL_SUCCESS)
+    {
+        return E_ZCL_ERR_PARAMETER_RANGE;
+    }
+
+    /* Convert XYZ to RGB colour space */
+    vCLD_ColourControl_XYZ2RGB(psCommon->ai32XYZ2RGB, X, Y, Z, &R, &G, &B);
+
+    *pu8Red     = u8CLD_ColourControl_Q16ToU8(R);
+    *pu8Green   = u8CLD_ColourControl_Q16ToU8(G);
+    *pu8Blue    = u8CLD_ColourControl_Q16ToU8(B);
+
+    return(E_ZCL_SUCCESS);
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       eCLD_ColourControl_HSV2xyY
+ **
+ ** DESCRIPTION:
+ ** Converts from HSV to xyY taking the path HSV->RGB->XYZ->xyY
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          End point ID
+ ** uint16                      u16Hue                      Hue
+ ** uint8                       u8Saturation                Saturation
+ ** uint8                       u8Value                     Value
+ ** uint16                      *pu16x                      x
+ ** uint16                      *pu16y                      y
+ ** uint8                       *pu8Y                       Y
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PUBLIC  teZCL_Status eCLD_ColourControl_HSV2xyY(
+        uint8                       u8SourceEndPointId,
+        uint16                      u16Hue,
+        uint8                       u8Saturation,
+        uint8                       u8Value,
+        uint16                      *pu16x,
+        uint16                      *pu16y,
+        uint8                       *pu8Y)
+{
+
+    int32 R, G, B;
+    int32 X, Y, Z;
+    int32 x, y, BigY;
+
+    tsCLD_ColourControlCustomDataStructure *psCustomDataStructPtr;
+    tsZCL_EndPointDefinition *psEndPointDefinition;
+    tsZCL_ClusterInstance *psClusterInstance;
+    teZCL_Status eStatus;
+    /* Find pointers to cluster */
+    eStatus = eZCL_FindCluster(LIGHTING_CLUSTER_ID_COLOUR_CONTROL,
+                               u8SourceEndPointId,
+                               TRUE,
+                               &psEndPointDefinition,
+                               &psClusterInstance,
+                               (void*)&psCustomDataStructPtr);
+    if(eStatus != E_ZCL_SUCCESS)
+    {
+        return eStatus;
+    }
+
+    /* Black has no chromaticity */
+    if(u8Value == 0)
+    {
+        return E_ZCL_ERR_PARAMETER_RANGE;
+    }
+
+    /* First we need to convert from HSV to RGB colour space. Chromaticity does
+     * not depend on value, so convert at full value to keep precision for dim
+     * colours and scale the luminance afterwards */
+    vCLD_ColourControl_HSV2RGB(u16Hue, Q16_FROM_U8(u8Saturation), Q16_ONE, &R, &G, &B);
+
+    /* Now convert RGB to XYZ */
+    vCLD_ColourControl_MatrixMultiply(psCustomDataStructPtr->ai32RGB2XYZ, R, G, B, &X, &Y, &Z);
+
+    /* Finally we can convert from XYZ to xyY chromaticity coordinates and luminocity */
+    if(eCLD_ColourControl_XYZ2xyY(X, Y, Z, &x, &y, &BigY) != E_ZCL_SUCCESS)
+    {
+        return E_ZCL_ERR_PARAMETER_RANGE;
+    }
+
+    /* Convert results to attribute values */
+    *pu16x = u16CLD_ColourControl_Q16ToU16(x);
+    *pu16y = u16CLD_ColourControl_Q16ToU16(y);
+    *pu8Y  = u8CLD_ColourControl_Q16ToU8(Q16_MUL(BigY, Q16_FROM_U8(u8Value)));
+
+    return E_ZCL_SUCCESS;
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       vCLD_ColourControl_CCT2xyY
+ **
+ ** DESCRIPTION:
+ ** Converts from Colour Temperature to xyY using interpolated data from a
+ ** lookup table.
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint16                      u16ColourTemperatureMired   Colour Temperature
+ ** uint16                      *pu16x                      x
+ ** uint16                      *pu16y                      y
+ ** uint8                       *pu8Y                       Y
+ **
+ ** RETURN:
+ ** void
+ **
+ ****************************************************************************/
+PUBLIC  void vCLD_ColourControl_CCT2xyY(
+        uint16                      u16ColourTemperatureMired,
+        uint16                      *pu16x,
+        uint16                      *pu16y,
+        uint8                       *pu8Y)
+{
+
+    uint32 u32CCT;
+    int32 i32Range;
+    int32 i32Steps;
+    int n;
+
+    const tsCLD_ColourControlCCT *psPrev = &asCLD_ColourControlCCTlist[0];
+    const tsCLD_ColourControlCCT *psNext = &asCLD_ColourControlCCTlist[0];
+
+    if(u16ColourTemperatureMired == 0) u16ColourTemperatureMired = 1;
+
+    /* Convert Colour temperature none scaled inverse value */
+    u32CCT = 1000000 / u16ColourTemperatureMired;
+
+    /* Limit maximum colour temperature to last value in the table */
+    if(u32CCT > asCLD_ColourControlCCTlist[CCT_TABLE_SIZE - 1].u16Temperature)
+    {
+        u32CCT = asCLD_ColourControlCCTlist[CCT_TABLE_SIZE - 1].u16Temperature;
+    }
+
+    /* Find 2 closest values in the table */
+    for(n = 0; n < CCT_TABLE_SIZE; n++)
+    {
+        psNext = &asCLD_ColourControlCCTlist[n];
+
+        if(psNext->u16Temperature >= u32CCT)
+        {
+            break;
+        }
+
+        psPrev = psNext;
+    }
+
+    /* Linear interpolation between the points on the curve */
+    i32Range = (int32)psNext->u16Temperature - (int32)psPrev->u16Temperature;
+    i32Steps = (int32)u32CCT - (int32)psPrev->u16Temperature;
+
+    if(i32Range == 0)
+    {
+        *pu16x = psPrev->u16x;
+        *pu16y = psPrev->u16y;
+    }
+    else
+    {
+        *pu16x = (uint16)(psPrev->u16x + (((int32)psNext->u16x - (int32)psPrev->u16x) * i32Steps) / i32Range);
+        *pu16y = (uint16)(psPrev->u16y + (((int32)psNext->u16y - (int32)psPrev->u16y) * i32Steps) / i32Range);
+    }
+    *pu8Y  = 255;
+
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       eCLD_ColourControl_xyY2HSV
+ **
+ ** DESCRIPTION:
+ ** Converts from xyY to HSV taking the path xyY->XYZ->RGB->HSV
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsCLD_ColourControlCustomDataStructure *psCustomDataStructPtr   Pointer to custom data structure
+ ** uint16                      u16x                        x
+ ** uint16                      u16y                        y
+ ** uint8                       u8Y                         Y
+ ** uint16                      *pu16Hue                    Hue
+ ** uint8                       *pu8Saturation              Saturation
+ ** uint8                       *pu8Value                   Value
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PUBLIC  teZCL_Status eCLD_ColourControl_xyY2HSV(
+        tsCLD_ColourControlCustomDataStructure  *psCustomDataStructPtr,
+        uint16                      u16x,
+        uint16                      u16y,
+        uint8                       u8Y,
+        uint16                      *pu16Hue,
+        uint8                       *pu8Saturation,
+        uint8                       *pu8Value)
+{
+
+    int32 H, S, V;
+    int32 R, G, B;
+    int32 X, Y, Z;
+    int64 i64Hue;
+
+    /* Black has no chromaticity */
+    if(u8Y == 0)
+    {
+        return E_ZCL_ERR_PARAMETER_RANGE;
+    }
+
+    /* Convert xyY to XYZ colour space. Hue and saturation do not depend on
+     * luminance, so convert at full luminance to keep precision for dim
+     * colours and scale the value afterwards */
+    if(eCLD_ColourControl_xyY2XYZ(u16x, u16y, Q16_ONE, &X, &Y, &Z) != E_ZCL_SUCCESS)
+    {
+        return E_ZCL_ERR_PARAMETER_RANGE;
+    }
+
+    /* Convert XYZ to RGB colour space, clamping out of gamut components. The
+     * normalisation done by XYZ2RGB is applied to the value below instead */
+    vCLD_ColourControl_MatrixMultiply(psCustomDataStructPtr->ai32XYZ2RGB, X, Y, Z, &R, &G, &B);
+    if(R < 0) R = 0;
+    if(G < 0) G = 0;
+    if(B < 0) B = 0;
+
+    /* Finally, convert from RGB to HSV colour space */
+    vCLD_ColourControl_RGB2HSV(R, G, B, &H, &S, &V);
+    V = Q16_MUL(V, Q16_FROM_U8(u8Y));
+
+    /* Convert results back to attribute values, hue from 6 sectors to 0 - 65535 */
+    i64Hue = ((int64)H * 65535) / (6 * Q16_ONE);
+    if(i64Hue > 65535)
+    {
+        i64Hue = 65535;
+    }
+    *pu16Hue       = (uint16)i64Hue;
+    *pu8Saturation = u8CLD_ColourControl_Q16ToU8(S);
+    *pu8Value      = u8CLD_ColourControl_Q16ToU8(V);
+
+    return E_ZCL_SUCCESS;
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       vCLD_ColourControl_xyY2CCT
+ **
+ ** DESCRIPTION:
+ ** Converts from xyY colour to Colour Temperature using interpolated data from
+ ** a lookup table. Points beyond either end of the table are clamped to it.
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint16                      u16x                        x
+ ** uint16                      u16y                        y
+ ** uint8                       u8Y                         Y
+ ** uint16                      *pu16ColourTemperature      Colour Temperature
+ **
+ ** RETURN:
+ ** void
+ **
+ ****************************************************************************/
+PUBLIC  void vCLD_ColourControl_xyY2CCT(
+        uint16                      u16x,
+        uint16                      u16y,
+        uint8                       u8Y,
+        uint16                      *pu16ColourTemperature)
+{
+    int n;
+    uint32 u32XRange;
+    uint32 u32Divisor;
+    uint64 u64Mired;
+
+    const tsCLD_ColourControlCCT *psPrev;
+    const tsCLD_ColourControlCCT *psNext;
+
+    /* Redder than the start of the curve */
+    if(u16x >= asCLD_ColourControlCCTlist[0].u16x)
+    {
+        *pu16ColourTemperature = 0xffff;
+        return;
+    }
+
+    /* Bluer than the end of the curve */
+    if(u16x <= asCLD_ColourControlCCTlist[CCT_TABLE_SIZE - 1].u16x)
+    {
+        *pu16ColourTemperature = (uint16)(1000000 / asCLD_ColourControlCCTlist[CCT_TABLE_SIZE - 1].u16Temperature);
+        return;
+    }
+
+    /* Find a point on the curve where x values fit, x decreases along the table */
+    for(n = 1; n < CCT_TABLE_SIZE - 1; n++)
+    {
+        if(u16x >= asCLD_ColourControlCCTlist[n].u16x)
+        {
+            break;
+        }
+    }
+    psPrev = &asCLD_ColourControlCCTlist[n - 1];
+    psNext = &asCLD_ColourControlCCTlist[n];
+
+    /* Interpolate CCT, scaled by the x range of the segment so the mired
+     * value can be found with a single division */
+    u32XRange  = (uint32)(psPrev->u16x - psNext->u16x);
+    u32Divisor = (uint32)psNext->u16Temperature * u32XRange -
+                 (uint32)(u16x - psNext->u16x) * (uint32)(psNext->u16Temperature - psPrev->u16Temperature);
+
+    u64Mired = (u32Divisor == 0) ? 0xffff : ((uint64)1000000 * u32XRange) / u32Divisor;
+    if(u64Mired > 0xffff)
+    {
+        u64Mired = 0xffff;
+    }
+
+    *pu16ColourTemperature = (uint16)u64Mired;
+
+}
+
+#if (CLD_COLOURCONTROL_COLOUR_CAPABILITIES & COLOUR_CAPABILITY_XY_SUPPORTED)
+/****************************************************************************
+ **
+ ** NAME:       CS_bTransitionIsValid
+ **
+ ** DESCRIPTION:
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** u16X1                       Current X position
+ ** u16Y1                       Current Y position
+ ** u16X2                       Target X position for the transition
+ ** u16Y2                       Target Y position for the transition
+ ** *pu16X                      New X target if transition is outside of gamut
+ ** *pu16Y                      New Y target if transition is outside of gamut
+ **
+ ** RETURN:
+ ** bool_t                      TRUE if transition was inside of gamut, FALSE otherwise
+ **
+ ****************************************************************************/
+PUBLIC bool_t CS_bTransitionIsValid(uint16 u16X1,  uint16 u16Y1,
+                                    uint16 u16X2,  uint16 u16Y2,
+                                    uint16 *pu16X, uint16 *pu16Y)
+{
+
+    int32 x1, y1;
+    int32 x2, y2;
+    int32 x, y;
+
+    x1 = sCS_White.x;
+    y1 = sCS_White.y;
+    x2 = u16X2;
+    y2 = u16Y2;
+
+    x = x2;
+    y = y2;
+
+    DBG_vPrintf(TRACE_COLOUR_CONTROL, "Checking transition from %d,%d to %d,%d\n", u16X1, u16Y1, u16X2, u16Y2);
+
+    /* If the destination coordinates lie outside the available colour gamut, check where the path intersects the triangle edge */
+    if(CS_bIsInGamut(x2, y2) == FALSE)
+    {
+
+        if((CS_bDoLinesIntersect(x1, y1, x2, y2, sCS_Blue.x,  sCS_Blue.y,  sCS_Red.x,   sCS_Red.y,   &x, &y) == TRUE) ||
+           (CS_bDoLinesIntersect(x1, y1, x2, y2, sCS_Red.x,   sCS_Red.y,   sCS_Green.x, sCS_Green.y, &x, &y) == TRUE) ||
+           (CS_bDoLinesIntersect(x1, y1, x2, y2, sCS_Green.x, sCS_Green.y, sCS_Blue.x,  sCS_Blue.y,  &x, &y) == TRUE))
+        {
+            *pu16X = u16CLD_ColourControl_Q16ToU16(x);
+            *pu16Y = u16CLD_ColourControl_Q16ToU16(y);
+
+            DBG_vPrintf(TRACE_COLOUR_CONTROL, "Transition invalid, intersection at (%d,%d)\n", *pu16X, *pu16Y);
+
+            return FALSE;
+        }
+
+    }
+
+    return TRUE;
+
+}
+#endif
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+/****************************************************************************
+ **
+ ** NAME:       vCLD_ColourControl_HSV2RGB
+ **
+ ** DESCRIPTION:
+ ** Converts from HSV colour to RGB
+ **
+ ** See Wikipedia: http://en.wikipedia.org/wiki/HSL_and_HSV
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint16                      u16Hue                      Hue         (0 - 65535)
+ ** int32                       i32Saturation               Saturation  (Q16 0 - 1)
+ ** int32                       i32Value                    Value       (Q16 0 - 1)
+ ** int32                       *pi32Red                    Result Red
+ ** int32                       *pi32Green                  Result Green
+ ** int32                       *pi32Blue                   Result Blue
+ **
+ ** RETURN:
+ ** void
+ **
+ ****************************************************************************/
+PRIVATE  void vCLD_ColourControl_HSV2RGB(
+        uint16                      u16Hue,
+        int32                       i32Saturation,
+        int32                       i32Value,
+        int32                       *pi32Red,
+        int32                       *pi32Green,
+        int32                       *pi32Blue)
+{
+
+    int32 R, G, B;
+    uint32 u32Sectors = (uint32)u16Hue * 6;
+    int32 i32Fraction = (int32)(u32Sectors & 0xffff);
+    int32 C = Q16_MUL(i32Saturation, i32Value);
+    int32 Min = i32Value - C;
+    int32 X;
+
+    /* Distance from the nearest primary rises in even sectors and falls in odd ones */
+    if(u32Sectors & 0x10000)
+    {
+        X = Q16_MUL(C, Q16_ONE - i32Fraction);
+    }
+    else
+    {
+        X = Q16_MUL(C, i32Fraction);
+    }
+
+    switch(u32Sectors >> 16)
+    {
+
+    case 0:
+        R = Min + C;
+        G = Min + X;
+        B = Min;
+        break;
+
+    case 1:
+        R = Min + X;
+        G = Min + C;
+        B = Min;
+        break;
+
+    case 2:
+        R = Min;
+        G = Min + C;
+        B = Min + X;
+        break;
+
+    case 3:
+        R = Min;
+        G = Min + X;
+        B = Min + C;
+        break;
+
+    case 4:
+        R = Min + X;
+        G = Min;
+        B = Min + C;
+        break;
+
+    case 5:
+        R = Min + C;
+        G = Min;
+        B = Min + X;
+        break;
+
+    default:
+        R = G = B = 0;
+        break;
+
+    }
+
+    *pi32Red    = R;
+    *pi32Green  = G;
+    *pi32Blue   = B;
+
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       vCLD_ColourControl_RGB2HSV
+ **
+ ** DESCRIPTION:
+ ** Converts from RGB colour to HSV
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** int32                       i32Red                      Red         (Q16 0 - 1)
+ ** int32                       i32Green                    Green       (Q16 0 - 1)
+ ** int32                       i32Blue                     Blue        (Q16 0 - 1)
+ ** int32                       *pi32Hue                    Result Hue  (Q16 0 - 6 sectors)
+ ** int32                       *pi32Saturation             Result Saturation
+ ** int32                       *pi32Value                  Result Value
+ **
+ ** RETURN:
+ ** void
+ **
+ ****************************************************************************/
+PRIVATE  void vCLD_ColourControl_RGB2HSV(
+        int32                       i32Red,
+        int32                       i32Green,
+        int32                       i32Blue,
+        int32                       *pi32Hue,
+        int32                       *pi32Saturation,
+        int32                       *pi32Value)
+{
+
+    int32 H = 0;
+    int32 Min = MIN3(i32Red, i32Green, i32Blue);
+    int32 Max = MAX3(i32Red, i32Green, i32Blue);
+    int32 C = Max - Min;
+
+    if(C > 0)
+    {
+        if(Max == i32Red)
+        {
+            H = (int32)(((int64)(i32Green - i32Blue) << 16) / C);
+            if(H < 0)
+            {
+                H += 6 * Q16_ONE;
+            }
+        }
+        else if(Max == i32Green)
+        {
+            H = (2 * Q16_ONE) + (int32)(((int64)(i32Blue - i32Red) << 16) / C);
+        }
+        else
+        {
+            H = (4 * Q16_ONE) + (int32)(((int64)(i32Red - i32Green) << 16) / C);
+        }
+    }
+
+    *pi32Hue        = H;
+    *pi32Saturation = (Max > 0) ? (int32)(((int64)C << 16) / Max) : 0;
+    *pi32Value      = Max;
+
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       vCLD_ColourControl_MatrixMultiply
+ **
+ ** DESCRIPTION:
+ ** Multiplies a vector by a Q16 conversion matrix, used for RGB->XYZ and as
+ ** the first stage of XYZ->RGB
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** int32                       ai32Matrix[3][3]            Conversion matrix
+ ** int32                       i32A                        Input 1
+ ** int32                       i32B                        Input 2
+ ** int32                       i32C                        Input 3
+ ** int32                       *pi32A                      Result 1
+ ** int32                       *pi32B                      Result 2
+ ** int32                       *pi32C                      Result 3
+ **
+ ** RETURN:
+ ** void
+ **
+ ****************************************************************************/
+PRIVATE  void vCLD_ColourControl_MatrixMultiply(
+        int32                       ai32Matrix[3][3],
+        int32                       i32A,
+        int32                       i32B,
+        int32                       i32C,
+        int32                       *pi32A,
+        int32                       *pi32B,
+        int32                       *pi32C)
+{
+    *pi32A = (int32)(((int64)ai32Matrix[0][0] * i32A + (int64)ai32Matrix[0][1] * i32B + (int64)ai32Matrix[0][2] * i32C) >> 16);
+    *pi32B = (int32)(((int64)ai32Matrix[1][0] * i32A + (int64)ai32Matrix[1][1] * i32B + (int64)ai32Matrix[1][2] * i32C) >> 16);
+    *pi32C = (int32)(((int64)ai32Matrix[2][0] * i32A + (int64)ai32Matrix[2][1] * i32B + (int64)ai32Matrix[2][2] * i32C) >> 16);
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       vCLD_ColourControl_XYZ2RGB
+ **
+ ** DESCRIPTION:
+ ** Converts from XYZ colour space to RGB, normalised so that no component
+ ** exceeds 1.0 and out of gamut components are clamped to 0
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** int32                       ai32Matrix[3][3]            Conversion matrix
+ ** int32                       i32X                        X
+ ** int32                       i32Y                        Y
+ ** int32                       i32Z                        Z
+ ** int32                       *pi32Red                    Result Red
+ ** int32                       *pi32Green                  Result Green
+ ** int32                       *pi32Blue                   Result Blue
+ **
+ ** RETURN:
+ ** void
+ **
+ ****************************************************************************/
+PRIVATE  void vCLD_ColourControl_XYZ2RGB(
+        int32                       ai32Matrix[3][3],
+        int32                       i32X,
+        int32                       i32Y,
+        int32                       i32Z,
+        int32                       *pi32Red,
+        int32                       *pi32Green,
+        int32                       *pi32Blue)
+{
+
+    int32 R, G, B;
+    int32 Max;
+    int64 i64Scale;
+
+    vCLD_ColourControl_MatrixMultiply(ai32Matrix, i32X, i32Y, i32Z, &R, &G, &B);
+
+    if(R < 0) R = 0;
+    if(G < 0) G = 0;
+    if(B < 0) B = 0;
+
+    /* Normalise using a single reciprocal */
+    Max = MAX3(R, G, B);
+    if(Max > Q16_ONE)
+    {
+        i64Scale = ((int64)1 << 32) / Max;
+        R = (int32)(((int64)R * i64Scale) >> 16);
+        G = (int32)(((int64)G * i64Scale) >> 16);
+        B = (int32)(((int64)B * i64Scale) >> 16);
+    }
+
+    *pi32Red    = R;
+    *pi32Green  = G;
+    *pi32Blue   = B;
+
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       eCLD_ColourControl_XYZ2xyY
+ **
+ ** DESCRIPTION:
+ ** Converts from XYZ colour space to xyY
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** int32                       i32X                        X
+ ** int32                       i32Y                        Y
+ ** int32                       i32Z                        Z
+ ** int32                       *pi32x                      Result x
+ ** int32                       *pi32y                      Result y
+ ** int32                       *pi32Y                      Result Y
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PRIVATE  teZCL_Status eCLD_ColourControl_XYZ2xyY(
+        int32                       i32X,
+        int32                       i32Y,
+        int32                       i32Z,
+        int32                       *pi32x,
+        int32                       *pi32y,
+        int32                       *pi32Y)
+{
+
+    int32 i32Sum = i32X + i32Y + i32Z;
+
+    if(i32Sum <= 0)
+    {
+        DBG_vPrintf(TRACE_COLOUR_CONTROL_CONVERSIONS, "XYZ2xyY: No chromaticity\n");
+        return E_ZCL_FAIL;
+    }
+
+    *pi32x = (int32)(((int64)i32X << 16) / i32Sum);
+    *pi32y = (int32)(((int64)i32Y << 16) / i32Sum);
+    *pi32Y = i32Y;
+
+    return E_ZCL_SUCCESS;
+
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       eCLD_ColourControl_xyY2XYZ
+ **
+ ** DESCRIPTION:
+ ** Converts from xyY colour space to XYZ
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** int32                       i32x                        x
+ ** int32                       i32y                        y
+ ** int32                       i32Y                        Y
+ ** int32                       *pi32X                      Result X
+ ** int32                       *pi32Y                      Result Y
+ ** int32                       *pi32Z                      Result Z
+ **
+ ** RETURN:
+ ** teZCL_Status
+ **
+ ****************************************************************************/
+PRIVATE  teZCL_Status eCLD_ColourControl_xyY2XYZ(
+        int32                       i32x,
+        int32                       i32y,
+        int32                       i32Y,
+        int32                       *pi32X,
+        int32                       *pi32Y,
+        int32                       *pi32Z)
+{
+
+    int64 i64X, i64Z;
+
+    if((i32y <= 0) || (i32Y <= 0))
+    {
+        DBG_vPrintf(TRACE_COLOUR_CONTROL_CONVERSIONS, "xyY2XYZ: Invalid y %d Y %d\n", i32y, i32Y);
+        return E_ZCL_FAIL;
+    }
+
+    i64X = ((int64)i32x * i32Y) / i32y;
+    i64Z = ((int64)(Q16_ONE - i32x - i32y) * i32Y) / i32y;
+
+    /* Reject anything the following stages cannot represent */
+    if((i64X > 0x7fffffffL) || (i64Z > 0x7fffffffL) || (i64Z < -0x7fffffffL))
+    {
+        DBG_vPrintf(TRACE_COLOUR_CONTROL_CONVERSIONS, "xyY2XYZ: Out of range\n");
+        return E_ZCL_FAIL;
+    }
+
+    *pi32X = (int32)i64X;
+    *pi32Y = i32Y;
+    *pi32Z = (int32)i64Z;
+
+    return E_ZCL_SUCCESS;
+
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       u8CLD_ColourControl_Q16ToU8
+ **
+ ** DESCRIPTION:
+ ** Converts a Q16 value to an 8 bit attribute value, clamped to 0 - 255
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** int32                       i32Value                    Q16 value
+ **
+ ** RETURN:
+ ** uint8
+ **
+ ****************************************************************************/
+PRIVATE  uint8 u8CLD_ColourControl_Q16ToU8(
+        int32                       i32Value)
+{
+    if(i32Value <= 0)
+    {
+        return 0;
+    }
+    if(i32Value >= Q16_ONE)
+    {
+        return 255;
+    }
+    return (uint8)((i32Value * 255) >> 16);
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       u16CLD_ColourControl_Q16ToU16
+ **
+ ** DESCRIPTION:
+ ** Converts a Q16 value to a 16 bit attribute value, clamped to 0 - 65535
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** int32                       i32Value                    Q16 value
+ **
+ ** RETURN:
+ ** uint16
+ **
+ ****************************************************************************/
+PRIVATE  uint16 u16CLD_ColourControl_Q16ToU16(
+        int32                       i32Value)
+{
+    if(i32Value <= 0)
+    {
+        return 0;
+    }
+    if(i32Value > 0xffff)
+    {
+        return 0xffff;
+    }
+    return (uint16)i32Value;
+}
+
+#if (CLD_COLOURCONTROL_COLOUR_CAPABILITIES & COLOUR_CAPABILITY_XY_SUPPORTED)
+/****************************************************************************
+ **
+ ** NAME:       CS_bIsInGamut
+ **
+ ** DESCRIPTION:
+ ** Checks if the specified coordinates lie inside the available colour gamut
+ ** by testing which side of each triangle edge the point lies on
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** int32                       x                           Q16 x coordinate
+ ** int32                       y                           Q16 y coordinate
+ **
+ ** RETURN:
+ ** bool_t
+ **
+ ****************************************************************************/
+PRIVATE bool_t CS_bIsInGamut(int32 x, int32 y)
+{
+
+    int64 d1, d2, d3;
+    bool_t bNegative, bPositive;
+
+    d1 = (int64)(sCS_Green.x - sCS_Red.x)   * (y - sCS_Red.y)   - (int64)(sCS_Green.y - sCS_Red.y)   * (x - sCS_Red.x);
+    d2 = (int64)(sCS_Blue.x  - sCS_Green.x) * (y - sCS_Green.y) - (int64)(sCS_Blue.y  - sCS_Green.y) * (x - sCS_Green.x);
+    d3 = (int64)(sCS_Red.x   - sCS_Blue.x)  * (y - sCS_Blue.y)  - (int64)(sCS_Red.y   - sCS_Blue.y)  * (x - sCS_Blue.x);
+
+    bNegative = (d1 < 0) || (d2 < 0) || (d3 < 0);
+    bPositive = (d1 > 0) || (d2 > 0) || (d3 > 0);
+
+    /* Inside (or on an edge) if the point is on the same side of every edge */
+    if(!(bNegative && bPositive))
+    {
+        DBG_vPrintf(TRACE_COLOUR_CONTROL, "Coordinates %d,%d valid\n", x, y);
+        return TRUE;
+    }
+
+    DBG_vPrintf(TRACE_COLOUR_CONTROL, "Coordinates %d,%d invalid\n", x, y);
+
+    return FALSE;
+}
+
+
+/****************************************************************************
+ **
+ ** NAME:       CS_bDoLinesIntersect
+ **
+ ** DESCRIPTION:
+ ** Checks if the 2 lines specified intersect
+ **
+ ** PARAMETERS:                 Name                        Usage
+ **
+ ** RETURN:
+ ** bool_t
+ **
+ ****************************************************************************/
+PRIVATE bool_t CS_bDoLinesIntersect(int32 x1, int32 y1,
+                                    int32 x2, int32 y2,
+                                    int32 x3, int32 y3,
+                                    int32 x4, int32 y4,
+                                    int32 *x, int32 *y)
+{
+    int64 denom, numera, numerb;
+
+    denom  = (int64)(y4-y3) * (x2-x1) - (int64)(x4-x3) * (y2-y1);
+    numera = (int64)(x4-x3) * (y1-y3) - (int64)(y4-y3) * (x1-x3);
+    numerb = (int64)(x2-x1) * (y1-y3) - (int64)(y2-y1) * (x1-x3);
+
+    /* Are the line coincident? (do they lie on top of each other) */
+    if((numera == 0) && (numerb == 0) && (denom == 0))
+    {
+        *x = (x1 + x2) / 2;
+        *y = (y1 + y2) / 2;
+
+        DBG_vPrintf(TRACE_COLOUR_CONTROL, "Lines are coincident\n");
+        return TRUE;
+    }
+
+    /* Are the line parallel */
+    if(denom == 0)
+    {
+        *x = 0;
+        *y = 0;
+
+        DBG_vPrintf(TRACE_COLOUR_CONTROL, "Lines are parallel\n");
+
+        return FALSE;
+    }
+
+    /* Is the intersection along the the segments, i.e. 0 <= numer / denom <= 1 */
+    if(denom < 0)
+    {
+        denom  = -denom;
+        numera = -numera;
+        numerb = -numerb;
+    }
+    if(numera < 0 || numera > denom || numerb < 0 || numerb > denom)
+    {
+        *x = 0;
+        *y = 0;
+
+        DBG_vPrintf(TRACE_COLOUR_CONTROL, "No intersection\n");
+
+        return FALSE;
+    }
+
+    *x = x1 + (int32)((numera * (x2 - x1)) / denom);
+    *y = y1 + (int32)((numera * (y2 - y1)) / denom);
+
+    DBG_vPrintf(TRACE_COLOUR_CONTROL, "Intersection at %d,%d\n", *x, *y);
+
+    return TRUE;
+}
+#endif
+
+#endif /* COLOUR_CONTROL_SERVER && CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS */
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
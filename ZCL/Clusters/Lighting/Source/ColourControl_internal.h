@@ -166,6 +166,11 @@ PUBLIC teZCL_Status eCLD_ColourControlCommandStepColourTemperatureCommandReceive
 
 PUBLIC teZCL_Status eCLD_ColourControlUpdate(uint8 u8SourceEndPointId);
 
+#ifdef CLD_COLOURCONTROL_TIMED_TRANSITIONS
+PUBLIC void vCLD_ColourControlStartTimedTransition(
+                    tsCLD_ColourControl_Transition *psTransition);
+#endif
+
 
 PUBLIC teZCL_Status eCLD_ColourControl_HSV2xyY(
         uint8                       u8SourceEndPointId,
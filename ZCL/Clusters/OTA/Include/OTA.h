@@ -91,6 +91,25 @@ extern "C" {
        #endif
 #endif
 
+/* Decoded (delta or decompressed) images are written to flash as they are
+ * rebuilt, which needs a plain image with no bytes stripped or encrypted */
+#if (defined KSDK2) && !(defined APP0) && !(defined INTERNAL_ENCRYPTED)
+#define OTA_DECODE_TO_FLASH_SUPPORTED
+#endif
+
+/* Multicast blocks are only written ahead of the current download position
+ * where the image slot is fully erased before the download starts. Other
+ * storage drivers may define it if they accept non-sequential writes */
+#if (defined OTA_MULTICAST_SUPPORT) && ((defined JENNIC_CHIP_FAMILY_JN516x) || (defined JENNIC_CHIP_FAMILY_JN517x))
+#ifndef OTA_MULTICAST_OUT_OF_ORDER_WRITES
+#define OTA_MULTICAST_OUT_OF_ORDER_WRITES
+#endif
+#endif
+
+#if (defined OTA_DELTA_IMAGE_SUPPORT) && !(defined OTA_DECODE_TO_FLASH_SUPPORTED)
+#error OTA_DELTA_IMAGE_SUPPORT requires an unencrypted internal flash image without selective OTA
+#endif
+
 #ifndef OTA_MAX_IMAGES_PER_ENDPOINT
 #define OTA_MAX_IMAGES_PER_ENDPOINT 1
 #endif
@@ -155,6 +174,8 @@ extern "C" {
 #define OTA_TAG_ID_EDCA_SIGNATURE                 (uint16)0x0001
 #define OTA_TAG_ID_EDCA_CERT                      (uint16)0x0002
 #define OTA_TAG_ID_OVERLAYS                       (uint16)0xF01A
+#define OTA_TAG_ID_DELTA_IMAGE                    (uint16)0xF0D0
+#define OTA_TAG_ID_COMPRESSED_IMAGE               (uint16)0xF0C0
 #define OTA_SIGNING_CERT_SIZE                     (uint8)48
 #define OTA_SIGNITURE_SIZE                        (uint8)42
 #define OTA_MAC_ADDRESS_SIZE                      (uint8)8
@@ -171,6 +192,78 @@ extern "C" {
 
 #define OTA_AES_BLOCK_SIZE                        (uint8)16
 
+#ifdef OTA_DELTA_IMAGE_SUPPORT
+/* Delta sub-element: 16 byte header followed by control records */
+#define OTA_DELTA_IMAGE_MAGIC                     (uint32)0x544C445A  /* "ZDLT" */
+#define OTA_DELTA_IMAGE_HEADER_SIZE               (uint8)16
+#define OTA_DELTA_IMAGE_CONTROL_SIZE              (uint8)12
+#ifndef OTA_DELTA_CRC_FOLD_SIZE
+#define OTA_DELTA_CRC_FOLD_SIZE                   (uint32)8192 /* running image bytes checked per block response */
+#endif
+#endif
+
+#ifdef OTA_COMPRESSED_IMAGE_SUPPORT
+/* Compressed sub-element: 12 byte header followed by an LZSS bit stream */
+#define OTA_COMPRESSED_IMAGE_MAGIC                (uint32)0x535A4C5A  /* "ZLZS" */
+#define OTA_COMPRESSED_IMAGE_HEADER_SIZE          (uint8)12
+#ifndef OTA_DECOMPRESS_WINDOW_BITS
+#define OTA_DECOMPRESS_WINDOW_BITS                8
+#endif
+#if (OTA_DECOMPRESS_WINDOW_BITS < 4) || (OTA_DECOMPRESS_WINDOW_BITS > 12)
+#error OTA_DECOMPRESS_WINDOW_BITS must be between 4 and 12
+#endif
+#endif
+
+/* The patch engine and decompressor state is not part of tsOTA_PersistedData,
+ * eOTA_RestoreClientData drops a download that was interrupted inside a delta
+ * or compressed sub-element, so it starts again from offset 0 with the next
+ * Query Next Image */
+#if (defined OTA_DELTA_IMAGE_SUPPORT) || (defined OTA_COMPRESSED_IMAGE_SUPPORT)
+#ifndef OTA_IMAGE_DECODE_WINDOW_SIZE
+#define OTA_IMAGE_DECODE_WINDOW_SIZE              64
+#endif
+#if ((OTA_IMAGE_DECODE_WINDOW_SIZE % 16) != 0)
+#error OTA_IMAGE_DECODE_WINDOW_SIZE must be a multiple of 16
+#endif
+#if (OTA_IMAGE_DECODE_WINDOW_SIZE < 16) || (OTA_IMAGE_DECODE_WINDOW_SIZE > 240)
+#error OTA_IMAGE_DECODE_WINDOW_SIZE must be 16 to 240, the window fill count is a uint8
+#endif
+#endif
+
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+#ifndef OTA_ADAPTIVE_MIN_BLOCK_SIZE
+#define OTA_ADAPTIVE_MIN_BLOCK_SIZE               16
+#endif
+#ifndef OTA_ADAPTIVE_BLOCK_SIZE_STEP
+#define OTA_ADAPTIVE_BLOCK_SIZE_STEP              16
+#endif
+#ifndef OTA_ADAPTIVE_SUCCESS_THRESHOLD
+#define OTA_ADAPTIVE_SUCCESS_THRESHOLD            (uint8)4   /* responses in a row before speeding up */
+#endif
+#ifndef OTA_ADAPTIVE_MAX_DELAY_MS
+#define OTA_ADAPTIVE_MAX_DELAY_MS                 (uint16)2000
+#endif
+#if ((OTA_ADAPTIVE_MIN_BLOCK_SIZE % 16) != 0) || ((OTA_ADAPTIVE_BLOCK_SIZE_STEP % 16) != 0)
+#error OTA_ADAPTIVE_MIN_BLOCK_SIZE and OTA_ADAPTIVE_BLOCK_SIZE_STEP must be multiples of 16
+#endif
+#endif
+
+#ifdef OTA_MULTICAST_SUPPORT
+/* Largest image and smallest multicast block size the client received-block
+ * bitmap has to cover */
+#ifndef OTA_MULTICAST_MAX_IMAGE_SIZE
+#define OTA_MULTICAST_MAX_IMAGE_SIZE              (512UL * 1024)
+#endif
+#ifndef OTA_MULTICAST_MIN_BLOCK_SIZE
+#define OTA_MULTICAST_MIN_BLOCK_SIZE              64
+#endif
+#ifndef OTA_MULTICAST_BITMAP_SIZE
+#define OTA_MULTICAST_BITMAP_SIZE                 (((OTA_MULTICAST_MAX_IMAGE_SIZE + OTA_MULTICAST_MIN_BLOCK_SIZE - 1) / OTA_MULTICAST_MIN_BLOCK_SIZE + 7) / 8) /* bytes, one bit per multicast block */
+#endif
+#if ((OTA_MULTICAST_BITMAP_SIZE * 8UL * OTA_MULTICAST_MIN_BLOCK_SIZE) < OTA_MULTICAST_MAX_IMAGE_SIZE)
+#error OTA_MULTICAST_BITMAP_SIZE cannot track an OTA_MULTICAST_MAX_IMAGE_SIZE image in OTA_MULTICAST_MIN_BLOCK_SIZE blocks
+#endif
+#endif
 
 #define OTA_ENC_OFFSET                            (uint8)32
 
@@ -632,8 +725,84 @@ typedef struct
     teZCL_Status eUpgradeDowngradeStatus;
 }tsOTA_UpgradeDowngradeVerify;
 
+#ifdef OTA_COMPRESSED_IMAGE_SUPPORT
+typedef enum
+{
+    E_OTA_DECOMPRESS_STATE_FILE_HEADER,
+    E_OTA_DECOMPRESS_STATE_PASSTHROUGH,
+    E_OTA_DECOMPRESS_STATE_HEADER,
+    E_OTA_DECOMPRESS_STATE_TAG_BIT,
+    E_OTA_DECOMPRESS_STATE_LITERAL,
+    E_OTA_DECOMPRESS_STATE_INDEX,
+    E_OTA_DECOMPRESS_STATE_COUNT,
+    E_OTA_DECOMPRESS_STATE_COMPLETE,
+    E_OTA_DECOMPRESS_STATE_ERROR
+}teOTA_DecompressState;
+
+typedef struct
+{
+    bool_t bActive;
+    bool_t bToFlash;
+    bool_t bDecoded;
+    teOTA_DecompressState eState;
+    teOTA_UpgradeClusterEvents eEventId;
+    uint8  u8WindowBits;
+    uint8  u8LookaheadBits;
+    uint8  u8BitCount;
+    uint8  u8FieldLength;
+    uint8  au8Field[OTA_COMPRESSED_IMAGE_HEADER_SIZE];
+    uint16 u16FileHeaderLength;
+    uint16 u16Index;
+    uint16 u16HistoryPos;
+    uint32 u32BitBuffer;
+    uint32 u32RawOffset;
+    uint32 u32TagRemaining;             /* over the air bytes left in the sub-element */
+    uint32 u32DecodedSize;
+    uint32 u32Decoded;
+    uint32 u32OutputOffset;             /* where the next decompressed byte is written */
+    uint32 u32OutputLimit;              /* end of the flash slot */
+    uint8  u8WindowFill;
+    uint8  au8Window[OTA_IMAGE_DECODE_WINDOW_SIZE];
+    uint8  au8History[1 << OTA_DECOMPRESS_WINDOW_BITS];
+    tsOTA_SuccessBlockResponsePayload sBlockTemplate;
+}tsOTA_DecompressContext;
+#endif
+
 #ifdef OTA_CLIENT
 
+#ifdef OTA_DELTA_IMAGE_SUPPORT
+typedef enum
+{
+    E_OTA_DELTA_STATE_HEADER,
+    E_OTA_DELTA_STATE_CONTROL,
+    E_OTA_DELTA_STATE_DIFF,
+    E_OTA_DELTA_STATE_EXTRA,
+    E_OTA_DELTA_STATE_COMPLETE,
+    E_OTA_DELTA_STATE_ERROR
+}teOTA_DeltaState;
+
+typedef struct
+{
+    bool_t bActive;
+    teOTA_DeltaState eState;
+    uint8  u8FieldLength;
+    uint8  au8Field[OTA_DELTA_IMAGE_HEADER_SIZE];
+    bool_t bOldImageVerified;
+    uint32 u32OldImageSize;
+    uint32 u32OldImageCrc;
+    uint32 u32OldCrcRunning;
+    uint32 u32OldCrcPos;
+    uint32 u32NewImageSize;
+    uint32 u32OldPos;
+    uint32 u32NewPos;
+    uint32 u32DiffRemaining;
+    uint32 u32ExtraRemaining;
+    int32  i32Seek;
+    uint8  u8WindowFill;
+    uint8  au8Window[OTA_IMAGE_DECODE_WINDOW_SIZE];
+}tsOTA_DeltaContext;
+#endif
+
 #ifdef OTA_PAGE_REQUEST_SUPPORT
 typedef struct
 {
@@ -688,6 +857,10 @@ typedef struct
     uint16_t blobId;
 #endif
 
+#if (defined OTA_DELTA_IMAGE_SUPPORT) || (defined OTA_COMPRESSED_IMAGE_SUPPORT)
+    uint32 u32DecodedImageSize;         /* bytes in the slot, header sizes are over the air */
+#endif
+
 }tsOTA_PersistedData;
 
 #endif
@@ -703,6 +876,45 @@ typedef struct
 }tsOTA_PageReqServerParams;
 #endif
 
+#if (defined OTA_SERVER && defined OTA_MULTICAST_SUPPORT)
+typedef struct
+{
+    bool_t                     bActive;
+    uint8                      u8SrcEndpoint;
+    uint8                      u8DstEndpoint;
+    uint8                      u8ImageIndex;
+    uint8                      u8BlockSize;
+    uint8                      u8TransactionNumber;
+    uint16                     u16GroupAddress;
+    uint16                     u16BlockSpacingMs;
+    uint32                     u32DataStart;
+    uint32                     u32NextOffset;
+    uint32                     u32EndTime;
+}tsOTA_MulticastServerParams;
+#endif
+
+#if (defined OTA_CLIENT && defined OTA_ADAPTIVE_BLOCK_REQUESTS)
+typedef struct
+{
+    bool_t bDelayPending;
+    bool_t bDelayElapsed;
+    uint8  u8BlockSize;
+    uint8  u8MaxBlockSize;
+    uint8  u8RequestedSize;
+    uint8  u8Successes;
+    uint16 u16DelayMs;
+}tsOTA_BlockRateContext;
+#endif
+
+#if (defined OTA_CLIENT && defined OTA_MULTICAST_SUPPORT)
+typedef struct
+{
+    uint8  u8BlockSize;
+    uint32 u32BlockBase;
+    uint8  au8Received[OTA_MULTICAST_BITMAP_SIZE];
+}tsOTA_MulticastClientContext;
+#endif
+
 typedef struct
 {
     /* this function gets called after a cold or warm start */
@@ -741,6 +953,15 @@ typedef struct
     tsOTA_PersistedData sPersistedData;
     uint8 au8ReadOTAData[OTA_MAX_BLOCK_SIZE];
     uint8 u8NextFreeImageLocation;
+#ifdef OTA_DELTA_IMAGE_SUPPORT
+    tsOTA_DeltaContext sDeltaContext;
+#endif
+#ifdef OTA_MULTICAST_SUPPORT
+    tsOTA_MulticastClientContext sMulticastContext;
+#endif
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+    tsOTA_BlockRateContext sBlockRateContext;
+#endif
 #endif
 #ifdef OTA_SERVER
     tsCLD_PR_Ota aServerPrams[OTA_MAX_IMAGES_PER_ENDPOINT+OTA_MAX_CO_PROCESSOR_IMAGES];
@@ -751,6 +972,12 @@ typedef struct
 #ifdef OTA_PAGE_REQUEST_SUPPORT
     tsOTA_PageReqServerParams  sPageReqServerParams;
 #endif
+#ifdef OTA_MULTICAST_SUPPORT
+    tsOTA_MulticastServerParams  sMulticastServerParams;
+#endif
+#endif
+#ifdef OTA_COMPRESSED_IMAGE_SUPPORT
+    tsOTA_DecompressContext sDecompressContext;
 #endif
     uint8  u8ImageStartSector[OTA_MAX_IMAGES_PER_ENDPOINT];
     uint8 au8CAPublicKey[22];
@@ -920,6 +1147,20 @@ PUBLIC teZCL_Status eOTA_SetWaitForDataParams(
                     uint8                       u8Endpoint,
                     uint16                      u16ClientAddress,
                     tsOTA_WaitForData          *sWaitForDataParams);
+
+#ifdef OTA_MULTICAST_SUPPORT
+PUBLIC teZCL_Status eOTA_ServerMulticastStart(
+                    uint8                       u8SourceEndpoint,
+                    uint8                       u8DestinationEndpoint,
+                    uint16                      u16GroupAddress,
+                    uint8                       u8ImageIndex,
+                    uint8                       u8BlockSize,
+                    uint16                      u16BlockSpacingMs,
+                    uint16                      u16StartDelay);
+
+PUBLIC teZCL_Status eOTA_ServerMulticastStop(
+                    uint8                       u8SourceEndpoint);
+#endif
 #endif
 
 #ifdef OTA_CLIENT
@@ -742,6 +742,20 @@ PUBLIC  teZCL_Status eOTA_RestoreClientData(
             {
                 psCustomData->sOTACallBackMessage.sPersistedData.sAttributes.u8ImageUpgradeStatus = E_CLD_OTA_STATUS_RESET;
             }
+#endif
+#if (defined OTA_DELTA_IMAGE_SUPPORT) || (defined OTA_COMPRESSED_IMAGE_SUPPORT)
+            if(psCustomData->sOTACallBackMessage.sPersistedData.sAttributes.u8ImageUpgradeStatus == E_CLD_OTA_STATUS_DL_IN_PROGRESS)
+            {
+                uint16 u16TagId;
+                uint32 u32TagLength;
+
+                /* the decoder state was lost with the reset, start the download again */
+                vOTA_GetTagIdandLengh(&u16TagId, &u32TagLength, &psCustomData->sOTACallBackMessage.sPersistedData.u8ActiveTag[0]);
+                if((u16TagId == OTA_TAG_ID_DELTA_IMAGE) || (u16TagId == OTA_TAG_ID_COMPRESSED_IMAGE))
+                {
+                    psCustomData->sOTACallBackMessage.sPersistedData.sAttributes.u8ImageUpgradeStatus = E_CLD_OTA_STATUS_NORMAL;
+                }
+            }
 #endif
             vOtaClientUpgMgrMapStates(  psCustomData->sOTACallBackMessage.sPersistedData.sAttributes.u8ImageUpgradeStatus, //teOTA_ImageUpgradeStatus  eStatus,
                                         psEndPointDefinition,                                                              //tsZCL_EndPointDefinition *psEndPointDefinition,
@@ -1084,7 +1098,7 @@ PUBLIC  teZCL_Status eOtaTimeUpdate(
 {
     teZCL_Status eStatus = E_ZCL_SUCCESS;
 
-#if defined(OTA_CLIENT) || (defined(OTA_SERVER) && defined(OTA_PAGE_REQUEST_SUPPORT))
+#if defined(OTA_CLIENT) || (defined(OTA_SERVER) && (defined(OTA_PAGE_REQUEST_SUPPORT) || defined(OTA_MULTICAST_SUPPORT)))
     tsZCL_ClusterInstance *psClusterInstance;
     tsZCL_EndPointDefinition *psEndPointDefinition;
     tsOTA_Common *psCustomData;
@@ -1111,6 +1125,20 @@ PUBLIC  teZCL_Status eOtaTimeUpdate(
                            FALSE))
                            == E_ZCL_SUCCESS)
         {
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+            if((psCustomData->sOTACallBackMessage.sBlockRateContext.bDelayPending == TRUE)&&
+                    (E_ZCL_CBET_TIMER_MS == psCallBackEvent->eEventType))
+            {
+                /* request delay over, send the deferred block request */
+                eZCL_UpdateMsTimer(psEndPointDefinition, FALSE, 0);
+                psCustomData->sOTACallBackMessage.sBlockRateContext.bDelayPending = FALSE;
+                psCustomData->sOTACallBackMessage.sBlockRateContext.bDelayElapsed = TRUE;
+                psCustomData->sOTACallBackMessage.eEventId = E_CLD_OTA_INTERNAL_COMMAND_TIMER_EXPIRED;
+                psCustomData->sOTACustomCallBackEvent.psClusterInstance = psClusterInstance;
+                ((pFuncptr)(psCustomData->sOTACallBackMessage.sPersistedData.u32FunctionPointer))(psCustomData, psEndPointDefinition);
+                return E_ZCL_SUCCESS;
+            }
+#endif
 #ifdef OTA_CLD_ATTR_REQUEST_DELAY
             if((psCustomData->sOTACallBackMessage.sPersistedData.bWaitForBlockReq == TRUE)&&
                     (E_ZCL_CBET_TIMER_MS == psCallBackEvent->eEventType))
@@ -1140,7 +1168,7 @@ PUBLIC  teZCL_Status eOtaTimeUpdate(
 #endif
 
     }
-#if (defined OTA_SERVER && defined OTA_PAGE_REQUEST_SUPPORT)
+#if (defined OTA_SERVER) && ((defined OTA_PAGE_REQUEST_SUPPORT) || (defined OTA_MULTICAST_SUPPORT))
     else
     {
         if((eStatus = eOtaFindCluster(u8SourceEndPointId,
@@ -1150,12 +1178,21 @@ PUBLIC  teZCL_Status eOtaTimeUpdate(
                     TRUE))
                     == E_ZCL_SUCCESS)
         {
+#ifdef OTA_PAGE_REQUEST_SUPPORT
             if((psCustomData->sOTACallBackMessage.sPageReqServerParams.bPageReqRespSpacing == TRUE)&&
                (E_ZCL_CBET_TIMER_MS == psCallBackEvent->eEventType))
             {
                 psCustomData->sOTACallBackMessage.sPageReqServerParams.bPageReqRespSpacing = FALSE;
                 vOtaHandleTimedPageRequest(u8SourceEndPointId);
             }
+#endif
+#ifdef OTA_MULTICAST_SUPPORT
+            if((psCustomData->sOTACallBackMessage.sMulticastServerParams.bActive)&&
+               (E_ZCL_CBET_TIMER_MS == psCallBackEvent->eEventType))
+            {
+                vOtaHandleTimedMulticastBlock(u8SourceEndPointId);
+            }
+#endif
         }
     }
 #endif
@@ -1526,6 +1563,31 @@ PUBLIC  teZCL_Status eOTA_FlashWriteNewImageBlock(
                                     sNvmDefsStruct.u32SectorSize) * OTA_SECTOR_CONVERTION;
 #else
                             u32FlashOffset = 0;
+#endif
+#if (defined OTA_COMPRESSED_IMAGE_SUPPORT) && (defined OTA_DECODE_TO_FLASH_SUPPORTED)
+                            {
+                                uint16 u16TagId;
+                                uint32 u32TagLength;
+                                vOTA_GetTagIdandLengh(&u16TagId, &u32TagLength,
+                                        &psCustomData->sOTACallBackMessage.au8ServerOTAHeader[u16OTAHeaderLength]);
+                                if(u16TagId == OTA_TAG_ID_COMPRESSED_IMAGE)
+                                {
+                                    /* own image is stored decompressed, ready to run */
+                                    vOtaDecompressInit(&psCustomData->sOTACallBackMessage.sDecompressContext, u32TagLength, u32FlashOffset,
+                                                       psCustomData->sOTACallBackMessage.u8MaxNumberOfSectors * sNvmDefsStruct.u32SectorSize);
+                                }
+                                else
+                                {
+                                    psCustomData->sOTACallBackMessage.sDecompressContext.bActive = FALSE;
+                                }
+                            }
+                            if(psCustomData->sOTACallBackMessage.sDecompressContext.bActive)
+                            {
+                                eStatus = eOtaDecompressProcess(psEndPointDefinition, psCustomData,
+                                            (pu8UpgradeBlockData+u8ServerOTAHeaderRemBytesWrite),
+                                            (u8UpgradeBlockDataLength-u8ServerOTAHeaderRemBytesWrite));
+                            }
+                            else
 #endif
                             /* Now start writing into flash */
                             vOtaFlashLockWrite(psEndPointDefinition, psCustomData,u32FlashOffset,
@@ -1548,6 +1610,13 @@ PUBLIC  teZCL_Status eOTA_FlashWriteNewImageBlock(
                 /* Get OTA header length */
                 vReverseMemcpy((uint8*)&u16OTAHeaderLength,&psCustomData->sOTACallBackMessage.au8ServerOTAHeader[6],sizeof(uint16));
                 u8ServerOTAHeaderOffset = u16OTAHeaderLength + OTA_TAG_HEADER_SIZE;
+#if (defined OTA_COMPRESSED_IMAGE_SUPPORT) && (defined OTA_DECODE_TO_FLASH_SUPPORTED)
+                if(psCustomData->sOTACallBackMessage.sDecompressContext.bActive)
+                {
+                    return eOtaDecompressProcess(psEndPointDefinition, psCustomData,
+                                                 pu8UpgradeBlockData, u8UpgradeBlockDataLength);
+                }
+#endif
             }
         }
 
@@ -3210,6 +3279,59 @@ PUBLIC void vOTA_GetTagIdandLengh(uint16 *pu16TagId,uint32 *pu32TagLength,uint8
     vReverseMemcpy((uint8*)pu32TagLength,&pu8Tag[2],sizeof(uint32));
 }
 
+/****************************************************************************
+ **
+ ** NAME:       bOTA_IsUpgradeImageTag
+ **
+ ** DESCRIPTION:
+ ** Returns TRUE for the sub-elements that carry this node's upgrade image
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** uint16                    u16TagId                       sub-element tag
+ **
+ ** RETURN:
+ ** bool_t
+ ****************************************************************************/
+PUBLIC bool_t bOTA_IsUpgradeImageTag(uint16 u16TagId)
+{
+    if(u16TagId == OTA_TAG_ID_UPGRADE_IMAGE)
+    {
+        return TRUE;
+    }
+    return bOTA_IsDecodedImageTag(u16TagId);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       bOTA_IsDecodedImageTag
+ **
+ ** DESCRIPTION:
+ ** Returns TRUE for the sub-elements that are decoded before being written,
+ ** whose size in flash therefore differs from the tag length
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** uint16                    u16TagId                       sub-element tag
+ **
+ ** RETURN:
+ ** bool_t
+ ****************************************************************************/
+PUBLIC bool_t bOTA_IsDecodedImageTag(uint16 u16TagId)
+{
+#ifdef OTA_DELTA_IMAGE_SUPPORT
+    if(u16TagId == OTA_TAG_ID_DELTA_IMAGE)
+    {
+        return TRUE;
+    }
+#endif
+#if (defined OTA_COMPRESSED_IMAGE_SUPPORT) && (defined OTA_DECODE_TO_FLASH_SUPPORTED)
+    if(u16TagId == OTA_TAG_ID_COMPRESSED_IMAGE)
+    {
+        return TRUE;
+    }
+#endif
+    return FALSE;
+}
+
 PUBLIC void vOTA_EncodeString(tsReg128 *psKey, uint8 *pu8Iv,uint8 * pu8DataOut)
 {
     tsReg128 sIv,sDataOut;
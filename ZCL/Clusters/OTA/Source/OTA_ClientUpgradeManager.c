@@ -185,6 +185,22 @@ PRIVATE bool_t bOtaVerifyString( tsOTA_Common *psOTA_Common,
                                              uint8 * pu8ExpectedStr);
 #endif
 
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+PRIVATE bool_t bOtaBlockRateDeferRequest(
+                                 tsOTA_Common                *psOTA_Common,
+                                 tsZCL_EndPointDefinition    *psEndPointDefinition);
+PRIVATE void vOtaBlockRateSuccess(
+                                 tsOTA_Common                *psOTA_Common,
+                                 uint8                        u8DataSize);
+PRIVATE void vOtaBlockRateBackOff(tsOTA_Common *psOTA_Common);
+#endif
+#ifdef OTA_MULTICAST_SUPPORT
+PRIVATE void vOtaMulticastSkipReceived(tsOTA_Common *psOTA_Common);
+PRIVATE uint8 u8OtaMulticastMaxRequestSize(
+                                 tsOTA_Common                *psOTA_Common,
+                                 uint8                        u8MaxDataSize);
+#endif
+
 /****************************************************************************/
 /***        Exported Variables                                            ***/
 /****************************************************************************/
@@ -263,6 +279,18 @@ PUBLIC  void vOtaClientUpgMgrMapStates(
             psCustomData->sOTACallBackMessage.sPersistedData.u32Step = 0;
             psCustomData->sOTACallBackMessage.sPersistedData.bIsSpecificFile = FALSE;
             psCustomData->sOTACallBackMessage.sPersistedData.bIsNullImage = FALSE;
+#ifdef OTA_DELTA_IMAGE_SUPPORT
+            psCustomData->sOTACallBackMessage.sDeltaContext.bActive = FALSE;
+#endif
+#ifdef OTA_COMPRESSED_IMAGE_SUPPORT
+            psCustomData->sOTACallBackMessage.sDecompressContext.bActive = FALSE;
+#endif
+#ifdef OTA_MULTICAST_SUPPORT
+            memset(&psCustomData->sOTACallBackMessage.sMulticastContext, 0, sizeof(tsOTA_MulticastClientContext));
+#endif
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+            memset(&psCustomData->sOTACallBackMessage.sBlockRateContext, 0, sizeof(tsOTA_BlockRateContext));
+#endif
 #ifdef OTA_CLD_ATTR_REQUEST_DELAY
             psCustomData->sOTACallBackMessage.sPersistedData.sAttributes.u16MinBlockRequestDelay = OTA_BLOCK_REQUEST_DELAY_DEF_VALUE;
             eZCL_UpdateMsTimer(psEndPointDefinition, FALSE,0);
@@ -323,6 +351,149 @@ PUBLIC  void vOtaClientUpgMgrMapStates(
 
 }
 
+#ifdef OTA_MULTICAST_SUPPORT
+/****************************************************************************
+ **
+ ** NAME:       vOtaHandleMulticastBlockResponse
+ **
+ ** DESCRIPTION:
+ ** Stores a block received from a multicast session. The block goes to the
+ ** place it would have been written to by the block request sequence and is
+ ** recorded in the received bitmap, so that block requests skip over it.
+ ** Blocks that cannot be placed are dropped and requested later on.
+ ** PARAMETERS:                           Name                           Usage
+ ** tsOTA_Common                       *psOTA_Common                   OTA custom data
+ ** tsZCL_EndPointDefinition           *psEndPointDefinition           Endpoint definition
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PUBLIC  void vOtaHandleMulticastBlockResponse(
+                                       tsOTA_Common             *psOTA_Common,
+                                       tsZCL_EndPointDefinition *psEndPointDefinition)
+{
+    tsOTA_PersistedData *psPersist = &psOTA_Common->sOTACallBackMessage.sPersistedData;
+    tsOTA_MulticastClientContext *psMulticast = &psOTA_Common->sOTACallBackMessage.sMulticastContext;
+    tsOTA_SuccessBlockResponsePayload *psBlock =
+        &psOTA_Common->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.uMessage.sBlockPayloadSuccess;
+    uint16 u16TagId, u16ManufacturerCode, u16ImageType;
+    uint32 u32TagLength, u32TotalSize, u32FileVersion;
+    uint32 u32FileOffset, u32BlockEnd, u32Skip, u32Block;
+#if (defined OTA_INTERNAL_STORAGE) || (defined KSDK2)
+    uint32 u32Distance;
+#endif
+    uint8 u8DataSize = psBlock->u8DataSize;
+
+    /* only a plain upgrade image past its bootloader specific bytes can take
+     * blocks in any order, everything else keeps to the unicast sequence */
+    if ( (psPersist->sAttributes.u8ImageUpgradeStatus != E_CLD_OTA_STATUS_DL_IN_PROGRESS) ||
+         (psPersist->bIsCoProcessorImage) ||
+         (psPersist->bIsSpecificFile) ||
+         (psPersist->u32TagDataWritten <= OTA_FLS_MAGIC_NUMBER_LENGTH) )
+    {
+        return;
+    }
+
+    vOTA_GetTagIdandLengh(&u16TagId, &u32TagLength, &psPersist->u8ActiveTag[0]);
+    vReverseMemcpy((uint8*)&u16ManufacturerCode, &psPersist->au8Header[10], sizeof(uint16));
+    vReverseMemcpy((uint8*)&u16ImageType, &psPersist->au8Header[12], sizeof(uint16));
+    vReverseMemcpy((uint8*)&u32FileVersion, &psPersist->au8Header[14], sizeof(uint32));
+    vReverseMemcpy((uint8*)&u32TotalSize, &psPersist->au8Header[52], sizeof(uint32));
+
+    if ( (u16TagId != OTA_TAG_ID_UPGRADE_IMAGE) ||
+         (psBlock->u16ManufacturerCode != u16ManufacturerCode) ||
+         (psBlock->u16ImageType != u16ImageType) ||
+         (psBlock->u32FileVersion != u32FileVersion) ||
+         (u8DataSize == 0) || (u8DataSize > OTA_MAX_BLOCK_SIZE) )
+    {
+        return;
+    }
+
+    u32FileOffset = psPersist->sAttributes.u32FileOffset;
+    u32BlockEnd = psBlock->u32FileOffset + u8DataSize;
+
+    /* the last block completes the download and is left to the block request
+     * sequence, blocks before the current offset are already in flash */
+    if ( (u32BlockEnd >= u32TotalSize) || (u32BlockEnd <= u32FileOffset) )
+    {
+        return;
+    }
+
+    if (psMulticast->u8BlockSize == 0)
+    {
+        psMulticast->u8BlockSize = u8DataSize;
+        psMulticast->u32BlockBase = psBlock->u32FileOffset % u8DataSize;
+    }
+    else if ( (u8DataSize != psMulticast->u8BlockSize) ||
+              ((psBlock->u32FileOffset % u8DataSize) != psMulticast->u32BlockBase) )
+    {
+        return;
+    }
+
+    u32Block = (psBlock->u32FileOffset - psMulticast->u32BlockBase) / u8DataSize;
+    if ( (u32Block >= ((uint32)OTA_MULTICAST_BITMAP_SIZE * 8)) ||
+         (psMulticast->au8Received[u32Block / 8] & (1 << (u32Block % 8))) )
+    {
+        return;
+    }
+
+#if (defined OTA_INTERNAL_STORAGE) || (defined KSDK2)
+    /* writes must stay 16 byte aligned to the block request sequence */
+    u32Distance = (psBlock->u32FileOffset > u32FileOffset) ? (psBlock->u32FileOffset - u32FileOffset) :
+                                                             (u32FileOffset - psBlock->u32FileOffset);
+    if ( ((u8DataSize % 16) != 0) || ((u32Distance % 16) != 0) )
+    {
+        return;
+    }
+#endif
+#ifndef OTA_MULTICAST_OUT_OF_ORDER_WRITES
+    if (psBlock->u32FileOffset > u32FileOffset)
+    {
+        /* the storage is written in sequence, no gaps allowed */
+        return;
+    }
+#endif
+
+    u32Skip = 0;
+    if (psBlock->u32FileOffset < u32FileOffset)
+    {
+        u32Skip = u32FileOffset - psBlock->u32FileOffset;
+    }
+
+    {
+        uint32 u32FlashOffset = psPersist->u32CurrentFlashOffset + (psBlock->u32FileOffset + u32Skip - u32FileOffset);
+#ifdef INTERNAL_ENCRYPTED
+        uint32 u32StartLocation = 0;
+#if (defined JENNIC_CHIP_FAMILY_JN516x) || (defined JENNIC_CHIP_FAMILY_JN517x) || (defined APP0)
+        #ifdef APP0 /* Building with selective OTA */
+            if(psPersist->bStackDownloadActive)
+            {
+                u32StartLocation = OTA_APP1_SHADOW_FLASH_OFFSET;
+            }
+            else
+        #endif
+            {
+                u32StartLocation = psOTA_Common->sOTACallBackMessage.u8ImageStartSector[psOTA_Common->sOTACallBackMessage.u8NextFreeImageLocation]
+                                                      * sNvmDefsStruct.u32SectorSize* OTA_SECTOR_CONVERTION;
+            }
+#endif
+        vOtaProcessInternalEncryption( psBlock->pu8Data + u32Skip,
+                                       u32FlashOffset,
+                                       (uint32)u8DataSize - u32Skip,
+                                       u32StartLocation);
+#endif
+        DBG_vPrintf(TRACE_INT_FLASH, "MCAST -> block %d offset %08x flash %08x\n",
+                    u32Block, psBlock->u32FileOffset, u32FlashOffset);
+        vOtaFlashLockWrite( psEndPointDefinition, psOTA_Common,
+                            u32FlashOffset,
+                            (uint16)(u8DataSize - u32Skip),
+                            psBlock->pu8Data + u32Skip);
+    }
+
+    psMulticast->au8Received[u32Block / 8] |= (1 << (u32Block % 8));
+    vOtaMulticastSkipReceived(psOTA_Common);
+}
+#endif
+
 /****************************************************************************/
 /***        Local Functions                                               ***/
 /****************************************************************************/
@@ -979,6 +1150,13 @@ PRIVATE  void vOtaRequestNextBlock(
     DBG_vPrintf(TRACE_BLOCKS, "BLOCK REQ -> %08x\n", psBlock->u32FileOffset);
     eStatus = eOTA_ClientImageBlockRequest(u8SrcEndpoint,u8DstEndpoint,psZCL_Address,psBlock);
     DBG_vPrintf(TRACE_OTA_DEBUG, "OTA 50 ..%x\n",eStatus);
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+    if(eStatus != E_ZCL_SUCCESS)
+    {
+        /* request could not be sent (no buffers, fragmentation), slow down */
+        vOtaBlockRateBackOff(psOTA_Common);
+    }
+#endif
 
 }
 /****************************************************************************
@@ -1052,6 +1230,12 @@ PRIVATE  void vOtaHandleTimedBlockRequest(
 #endif
     if(psOTA_Common->sOTACallBackMessage.sPersistedData.u8Retry <=CLD_OTA_MAX_BLOCK_PAGE_REQ_RETRIES)
     {
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+        if(bOtaBlockRateDeferRequest(psOTA_Common, psEndPointDefinition))
+        {
+            return;
+        }
+#endif
         DBG_vPrintf(TRACE_OTA_DEBUG, "OTA 113 .. %d\n" , psOTA_Common->sOTACallBackMessage.sPersistedData.u8Retry);
         psOTA_Common->sOTACallBackMessage.sPersistedData.u8Retry++;
 #ifdef OTA_PAGE_REQUEST_SUPPORT
@@ -1059,6 +1243,9 @@ PRIVATE  void vOtaHandleTimedBlockRequest(
         {
             psOTA_Common->sOTACallBackMessage.sPersistedData.sPageReqParams.u8PageReqRetry++;
         }
+#endif
+#ifdef OTA_MULTICAST_SUPPORT
+        vOtaMulticastSkipReceived(psOTA_Common);
 #endif
         sBlock.u32FileOffset = psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset;
         if(psOTA_Common->sOTACallBackMessage.sPersistedData.bIsSpecificFile)
@@ -1077,6 +1264,15 @@ PRIVATE  void vOtaHandleTimedBlockRequest(
             sBlock.u16ImageType = psOTACurrentHeader->u16ImageType;
         }
         sBlock.u8MaxDataSize = OTA_MAX_BLOCK_SIZE;
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+        sBlock.u8MaxDataSize = psOTA_Common->sOTACallBackMessage.sBlockRateContext.u8BlockSize;
+#endif
+#ifdef OTA_MULTICAST_SUPPORT
+        sBlock.u8MaxDataSize = u8OtaMulticastMaxRequestSize(psOTA_Common, sBlock.u8MaxDataSize);
+#endif
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+        psOTA_Common->sOTACallBackMessage.sBlockRateContext.u8RequestedSize = sBlock.u8MaxDataSize;
+#endif
         sBlock.u32FileVersion = psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32DownloadedFileVersion;
 
 #ifndef OTA_TIME_INTERVAL_BETWEEN_REQUESTS
@@ -1246,6 +1442,9 @@ PRIVATE  void vOtaHandleWaitForDataStatus(
             eZCL_UpdateMsTimer(psEndPointDefinition, TRUE,(u32MinBlockRequestDelay*1000));
         }        
     }
+#endif
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+    vOtaBlockRateBackOff(psOTA_Common);
 #endif
     psOTA_Common->sOTACallBackMessage.sPersistedData.u32RequestBlockRequestTime = 0;
     if(psBlockResponse->uMessage.sWaitForData.u32CurrentTime == 0)
@@ -2128,7 +2327,7 @@ PRIVATE bool_t bOtaHandleBlockResponseIdle( tsOTA_Common *psOTA_Common,
                             return FALSE;
                         }
 
-                        if(u16TagId == OTA_TAG_ID_UPGRADE_IMAGE)
+                        if(bOTA_IsUpgradeImageTag(u16TagId))
                         {
                             uint32 u32WriteValue=0;
                             int i;
@@ -2187,6 +2386,42 @@ PRIVATE bool_t bOtaHandleBlockResponseIdle( tsOTA_Common *psOTA_Common,
 #if APP0
                             g_bOtaFirstImagePage = TRUE;
 #endif
+#endif
+#ifdef OTA_DELTA_IMAGE_SUPPORT
+                            if(u16TagId == OTA_TAG_ID_DELTA_IMAGE)
+                            {
+                                /* the patch engine writes the rebuilt image from the start of the slot */
+                                psOTA_Common->sOTACallBackMessage.sPersistedData.u32CurrentFlashOffset = u32StartLocation;
+                                vOtaDeltaInit(&psOTA_Common->sOTACallBackMessage.sDeltaContext);
+                                if(eOtaDeltaProcess(psEndPointDefinition, psOTA_Common,
+                                                    sBlockResponse.uMessage.sBlockPayloadSuccess.pu8Data + (u32TagIdOverflow + u32FileOverflow),
+                                                    u32DataOverflow, &u32DataOverflow) != E_ZCL_SUCCESS)
+                                {
+                                    vOtaAbortDownload(psOTA_Common, psEndPointDefinition);
+                                    return FALSE;
+                                }
+                                /* bytes held back while the running image is verified are requested again */
+                                psOTA_Common->sOTACallBackMessage.sPersistedData.u32TagDataWritten = u32DataOverflow;
+                            }
+                            else
+#endif
+#if (defined OTA_COMPRESSED_IMAGE_SUPPORT) && (defined OTA_DECODE_TO_FLASH_SUPPORTED)
+                            if(u16TagId == OTA_TAG_ID_COMPRESSED_IMAGE)
+                            {
+                                /* the decompressor writes the image from the start of the slot */
+                                psOTA_Common->sOTACallBackMessage.sPersistedData.u32CurrentFlashOffset = u32StartLocation;
+                                psOTA_Common->sOTACallBackMessage.sPersistedData.u32TagDataWritten = u32DataOverflow;
+                                vOtaDecompressInit(&psOTA_Common->sOTACallBackMessage.sDecompressContext, u32TagLength, u32StartLocation,
+                                                   sNvmDefsStruct.u32SectorSize * psOTA_Common->sOTACallBackMessage.u8MaxNumberOfSectors * OTA_SECTOR_CONVERTION);
+                                if(eOtaDecompressProcess(psEndPointDefinition, psOTA_Common,
+                                                         sBlockResponse.uMessage.sBlockPayloadSuccess.pu8Data + (u32TagIdOverflow + u32FileOverflow),
+                                                         u32DataOverflow) != E_ZCL_SUCCESS)
+                                {
+                                    vOtaAbortDownload(psOTA_Common, psEndPointDefinition);
+                                    return FALSE;
+                                }
+                            }
+                            else
 #endif
                             if( !psOTA_Common->sOTACallBackMessage.sPersistedData.bIsNullImage)
                             {  /* if image is for own device copy from  OTA_FLS_MAGIC_NUMBER_LENGTH onwards */
@@ -2609,6 +2844,15 @@ PRIVATE bool_t bOtaHandleBlockResponseInProgress( tsOTA_Common *psOTA_Common,
     DBG_vPrintf(TRACE_BLOCKS, "BLOCK actv -> Flash Offset %08x\n",
                         psOTA_Common->sOTACallBackMessage.sPersistedData.u32CurrentFlashOffset);
 
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+    if ( ( sResponse.u8Status == OTA_STATUS_SUCCESS ) &&
+         ( sResponse.uMessage.sBlockPayloadSuccess.u32FileOffset ==
+           psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset ) )
+    {
+        vOtaBlockRateSuccess(psOTA_Common, sResponse.uMessage.sBlockPayloadSuccess.u8DataSize);
+    }
+#endif
+
     if ( ( sResponse.u8Status == OTA_STATUS_SUCCESS ) &&
         ( !psOTA_Common->sOTACallBackMessage.sPersistedData.bIsCoProcessorImage) &&
         ( !psOTA_Common->sOTACallBackMessage.sPersistedData.bIsSpecificFile) )
@@ -2915,6 +3159,41 @@ PRIVATE bool_t bOtaHandleBlockResponseStandardImage( tsOTA_Common *psOTA_Common,
                         }
                     }
                 }  /* End of u16TagId == OTA_TAG_ID_UPGRADE_IMAGE */
+#ifdef OTA_DELTA_IMAGE_SUPPORT
+                else if ( u16TagId == OTA_TAG_ID_DELTA_IMAGE )
+                {
+                    /* The patch engine state is not persisted, eOTA_RestoreClientData
+                     * restarts a delta download interrupted by a reset */
+                    uint32 u32Consumed;
+
+                    if ( eOtaDeltaProcess( psEndPointDefinition, psOTA_Common,
+                                           psResponse->uMessage.sBlockPayloadSuccess.pu8Data,
+                                           u8DataSize, &u32Consumed) != E_ZCL_SUCCESS )
+                    {
+                        vOtaAbortDownload(psOTA_Common, psEndPointDefinition);
+                        return FALSE;
+                    }
+                    /* bytes held back while the running image is verified are requested again */
+                    psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset += u32Consumed;
+                    psOTA_Common->sOTACallBackMessage.sPersistedData.u32TagDataWritten += u32Consumed;
+                }
+#endif
+#if (defined OTA_COMPRESSED_IMAGE_SUPPORT) && (defined OTA_DECODE_TO_FLASH_SUPPORTED)
+                else if ( u16TagId == OTA_TAG_ID_COMPRESSED_IMAGE )
+                {
+                    /* As for delta images, the decompressor state is not persisted
+                     * and an interrupted download is restarted */
+                    if ( eOtaDecompressProcess( psEndPointDefinition, psOTA_Common,
+                                                psResponse->uMessage.sBlockPayloadSuccess.pu8Data,
+                                                u8DataSize) != E_ZCL_SUCCESS )
+                    {
+                        vOtaAbortDownload(psOTA_Common, psEndPointDefinition);
+                        return FALSE;
+                    }
+                    psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset += u8DataSize;
+                    psOTA_Common->sOTACallBackMessage.sPersistedData.u32TagDataWritten += u8DataSize;
+                }
+#endif
                 else
                 {
                     /* u16TagId != OTA_TAG_ID_UPGRADE_IMAGE */
@@ -2982,6 +3261,23 @@ PRIVATE bool_t bOtaHandleBlockResponseStandardImage( tsOTA_Common *psOTA_Common,
             {
                 /* sAttributes.u32FileOffset == u32TotalSize */
                 DBG_vPrintf(TRACE_INT_FLASH, "u32FileOffset == u32TotalSize\n");
+#ifdef OTA_DELTA_IMAGE_SUPPORT
+                if ( ( u16TagId == OTA_TAG_ID_DELTA_IMAGE ) &&
+                     ( eOtaDeltaFinish(psEndPointDefinition, psOTA_Common) != E_ZCL_SUCCESS ) )
+                {
+                    vOtaAbortDownload(psOTA_Common, psEndPointDefinition);
+                    return FALSE;
+                }
+#endif
+#if (defined OTA_COMPRESSED_IMAGE_SUPPORT) && (defined OTA_DECODE_TO_FLASH_SUPPORTED)
+                if ( ( u16TagId == OTA_TAG_ID_COMPRESSED_IMAGE ) &&
+                     ( eOtaDecompressFinish(&psOTA_Common->sOTACallBackMessage.sDecompressContext,
+                                            &psOTA_Common->sOTACallBackMessage.sPersistedData.u32DecodedImageSize) != E_ZCL_SUCCESS ) )
+                {
+                    vOtaAbortDownload(psOTA_Common, psEndPointDefinition);
+                    return FALSE;
+                }
+#endif
                 if ( psOTA_Common->sOTACallBackMessage.sPersistedData.bIsNullImage )
                 {
                     /* Null image */
@@ -3168,17 +3464,39 @@ PRIVATE bool_t bOtaHandleBlockResponseCoProcessorImage( tsOTA_Common *psOTA_Comm
         else if(psResponse->uMessage.sBlockPayloadSuccess.u32FileOffset ==
             psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset)
         {
+#ifdef OTA_COMPRESSED_IMAGE_SUPPORT
+            uint8 u8DataSize = psResponse->uMessage.sBlockPayloadSuccess.u8DataSize;
+            /* a compressed sub-element reaches the application decompressed */
+            if(eOtaDecompressFileBlock(psEndPointDefinition, psOTA_Common,
+                                       E_CLD_OTA_INTERNAL_COMMAND_CO_PROCESSOR_BLOCK_RESPONSE,
+                                       &psResponse->uMessage.sBlockPayloadSuccess) != E_ZCL_SUCCESS)
+            {
+                vOtaAbortDownload(psOTA_Common, psEndPointDefinition);
+                eOtaSetEventTypeAndGiveCallBack(psOTA_Common, E_CLD_OTA_INTERNAL_COMMAND_CO_PROCESSOR_DL_ABORT,psEndPointDefinition);
+                return FALSE;
+            }
+            psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset += u8DataSize;
+#else
             psOTA_Common->sOTACallBackMessage.eEventId = E_CLD_OTA_INTERNAL_COMMAND_CO_PROCESSOR_BLOCK_RESPONSE;
             psOTA_Common->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.uMessage.sBlockPayloadSuccess = psResponse->uMessage.sBlockPayloadSuccess;
             psOTA_Common->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.u8Status = OTA_STATUS_SUCCESS;
             psEndPointDefinition->pCallBackFunctions(&psOTA_Common->sOTACustomCallBackEvent);
             psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset += psResponse->uMessage.sBlockPayloadSuccess.u8DataSize;
+#endif
             DBG_vPrintf(TRACE_INT_FLASH, "OFFSET11 -> %08x, added %d\n",
                     psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset,
                                                    psResponse->uMessage.sBlockPayloadSuccess.u8DataSize);
             /* check if download complete */
             if(psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset == psOTA_Common->sOTACallBackMessage.sPersistedData.u32CoProcessorImageSize)
             {
+#ifdef OTA_COMPRESSED_IMAGE_SUPPORT
+                if(eOtaDecompressFinish(&psOTA_Common->sOTACallBackMessage.sDecompressContext, NULL) != E_ZCL_SUCCESS)
+                {
+                    vOtaAbortDownload(psOTA_Common, psEndPointDefinition);
+                    eOtaSetEventTypeAndGiveCallBack(psOTA_Common, E_CLD_OTA_INTERNAL_COMMAND_CO_PROCESSOR_DL_ABORT,psEndPointDefinition);
+                    return FALSE;
+                }
+#endif
                 /* send a call back event if download is complete */
                 eOtaSetEventTypeAndGiveCallBack(psOTA_Common, E_CLD_OTA_INTERNAL_COMMAND_CO_PROCESSOR_IMAGE_DL_COMPLETE,psEndPointDefinition);
                 psOTA_Common->sOTACallBackMessage.sPersistedData.u32RequestBlockRequestTime = 0;
@@ -3248,17 +3566,39 @@ PRIVATE bool_t bOtaHandleBlockResponseFileSpecificImage( tsOTA_Common *psOTA_Com
         else if(psResponse->uMessage.sBlockPayloadSuccess.u32FileOffset ==
             psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset)
         {
+#ifdef OTA_COMPRESSED_IMAGE_SUPPORT
+            uint8 u8DataSize = psResponse->uMessage.sBlockPayloadSuccess.u8DataSize;
+            /* a compressed sub-element reaches the application decompressed */
+            if(eOtaDecompressFileBlock(psEndPointDefinition, psOTA_Common,
+                                       E_CLD_OTA_INTERNAL_COMMAND_SPECIFIC_FILE_BLOCK_RESPONSE,
+                                       &psResponse->uMessage.sBlockPayloadSuccess) != E_ZCL_SUCCESS)
+            {
+                vOtaAbortDownload(psOTA_Common, psEndPointDefinition);
+                eOtaSetEventTypeAndGiveCallBack(psOTA_Common, E_CLD_OTA_INTERNAL_COMMAND_SPECIFIC_FILE_DL_ABORT,psEndPointDefinition);
+                return FALSE;
+            }
+            psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset += u8DataSize;
+#else
             psOTA_Common->sOTACallBackMessage.eEventId = E_CLD_OTA_INTERNAL_COMMAND_SPECIFIC_FILE_BLOCK_RESPONSE;
             psOTA_Common->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.uMessage.sBlockPayloadSuccess = psResponse->uMessage.sBlockPayloadSuccess;
             psOTA_Common->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.u8Status = OTA_STATUS_SUCCESS;
             psEndPointDefinition->pCallBackFunctions(&psOTA_Common->sOTACustomCallBackEvent);
             psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset += psResponse->uMessage.sBlockPayloadSuccess.u8DataSize;
+#endif
             DBG_vPrintf(TRACE_INT_FLASH, "OFFSET12 -> %08x, added %d\n",
                     psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset,
                                     psResponse->uMessage.sBlockPayloadSuccess.u8DataSize);
             /* check if download complete */
             if(psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset == psOTA_Common->sOTACallBackMessage.sPersistedData.u32SpecificFileSize)
             {
+#ifdef OTA_COMPRESSED_IMAGE_SUPPORT
+                if(eOtaDecompressFinish(&psOTA_Common->sOTACallBackMessage.sDecompressContext, NULL) != E_ZCL_SUCCESS)
+                {
+                    vOtaAbortDownload(psOTA_Common, psEndPointDefinition);
+                    eOtaSetEventTypeAndGiveCallBack(psOTA_Common, E_CLD_OTA_INTERNAL_COMMAND_SPECIFIC_FILE_DL_ABORT,psEndPointDefinition);
+                    return FALSE;
+                }
+#endif
                 /* send a call back event if download is complete */
                 eOtaSetEventTypeAndGiveCallBack(psOTA_Common, E_CLD_OTA_INTERNAL_COMMAND_SPECIFIC_FILE_DL_COMPLETE,psEndPointDefinition);
                 psOTA_Common->sOTACallBackMessage.sPersistedData.u32RequestBlockRequestTime = 0;
@@ -3286,6 +3626,241 @@ PRIVATE bool_t bOtaHandleBlockResponseFileSpecificImage( tsOTA_Common *psOTA_Com
     return bPollRequired;
 }
 
+#ifdef OTA_ADAPTIVE_BLOCK_REQUESTS
+/****************************************************************************
+ **
+ ** NAME:       bOtaBlockRateDeferRequest
+ **
+ ** DESCRIPTION:
+ ** Decides whether the next block request goes now or after the current
+ ** request delay, backing off first if the previous request timed out
+ ** PARAMETERS:                           Name                           Usage
+ ** tsOTA_Common                       *psOTA_Common                   OTA custom data
+ ** tsZCL_EndPointDefinition           *psEndPointDefinition           Endpoint definition
+ ** RETURN:
+ ** TRUE if the request has been deferred
+ ****************************************************************************/
+PRIVATE bool_t bOtaBlockRateDeferRequest(
+                                 tsOTA_Common                *psOTA_Common,
+                                 tsZCL_EndPointDefinition    *psEndPointDefinition)
+{
+    tsOTA_BlockRateContext *psRate = &psOTA_Common->sOTACallBackMessage.sBlockRateContext;
+
+    if (psRate->u8BlockSize == 0)
+    {
+        /* start from the largest block, a download on a good link runs as before */
+        psRate->u8MaxBlockSize = OTA_MAX_BLOCK_SIZE;
+        psRate->u8BlockSize = OTA_MAX_BLOCK_SIZE;
+    }
+
+    if (psRate->bDelayElapsed)
+    {
+        psRate->bDelayElapsed = FALSE;
+        return FALSE;
+    }
+
+    if (psOTA_Common->sOTACallBackMessage.sPersistedData.u8Retry != 0)
+    {
+        /* no response to the last request */
+        vOtaBlockRateBackOff(psOTA_Common);
+        return FALSE;
+    }
+
+    if (psRate->u16DelayMs != 0)
+    {
+        psRate->bDelayPending = TRUE;
+        eZCL_UpdateMsTimer(psEndPointDefinition, TRUE, psRate->u16DelayMs);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaBlockRateSuccess
+ **
+ ** DESCRIPTION:
+ ** Additive increase: after a run of good responses the block size grows by
+ ** a step and the request delay shrinks by one timer tick. A response shorter
+ ** than requested gives the most the server will send.
+ ** PARAMETERS:                           Name                           Usage
+ ** tsOTA_Common                       *psOTA_Common                   OTA custom data
+ ** uint8                               u8DataSize                     Size received
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaBlockRateSuccess(
+                                 tsOTA_Common                *psOTA_Common,
+                                 uint8                        u8DataSize)
+{
+    tsOTA_BlockRateContext *psRate = &psOTA_Common->sOTACallBackMessage.sBlockRateContext;
+
+    if (psRate->u8BlockSize == 0)
+    {
+        return;
+    }
+
+    if ( (u8DataSize < psRate->u8RequestedSize) && (u8DataSize >= OTA_ADAPTIVE_MIN_BLOCK_SIZE) )
+    {
+        psRate->u8MaxBlockSize = u8DataSize;
+        if (psRate->u8BlockSize > u8DataSize)
+        {
+            psRate->u8BlockSize = u8DataSize;
+        }
+    }
+
+    if (++psRate->u8Successes >= OTA_ADAPTIVE_SUCCESS_THRESHOLD)
+    {
+        psRate->u8Successes = 0;
+        if ((psRate->u8BlockSize + OTA_ADAPTIVE_BLOCK_SIZE_STEP) < psRate->u8MaxBlockSize)
+        {
+            psRate->u8BlockSize += OTA_ADAPTIVE_BLOCK_SIZE_STEP;
+        }
+        else
+        {
+            psRate->u8BlockSize = psRate->u8MaxBlockSize;
+        }
+        if (psRate->u16DelayMs > OTA_MIN_TIMER_MS_RESOLUTION)
+        {
+            psRate->u16DelayMs -= OTA_MIN_TIMER_MS_RESOLUTION;
+        }
+        else
+        {
+            psRate->u16DelayMs = 0;
+        }
+    }
+    DBG_vPrintf(TRACE_OTA_DEBUG, "OTA rate up %d %dms\n", psRate->u8BlockSize, psRate->u16DelayMs);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaBlockRateBackOff
+ **
+ ** DESCRIPTION:
+ ** Multiplicative decrease: halves the block size and doubles the request
+ ** delay after a timeout, a failed send or a Wait For Data response
+ ** PARAMETERS:                           Name                           Usage
+ ** tsOTA_Common                       *psOTA_Common                   OTA custom data
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaBlockRateBackOff(tsOTA_Common *psOTA_Common)
+{
+    tsOTA_BlockRateContext *psRate = &psOTA_Common->sOTACallBackMessage.sBlockRateContext;
+
+    if (psRate->u8BlockSize == 0)
+    {
+        return;
+    }
+
+    psRate->u8Successes = 0;
+    psRate->u8BlockSize = (uint8)((psRate->u8BlockSize / 2) & ~0x0F);
+    if (psRate->u8BlockSize < OTA_ADAPTIVE_MIN_BLOCK_SIZE)
+    {
+        psRate->u8BlockSize = OTA_ADAPTIVE_MIN_BLOCK_SIZE;
+    }
+
+    if (psRate->u16DelayMs == 0)
+    {
+        psRate->u16DelayMs = OTA_MIN_TIMER_MS_RESOLUTION;
+    }
+    else if (psRate->u16DelayMs < (OTA_ADAPTIVE_MAX_DELAY_MS / 2))
+    {
+        psRate->u16DelayMs *= 2;
+    }
+    else
+    {
+        psRate->u16DelayMs = OTA_ADAPTIVE_MAX_DELAY_MS;
+    }
+    DBG_vPrintf(TRACE_OTA_DEBUG, "OTA rate down %d %dms\n", psRate->u8BlockSize, psRate->u16DelayMs);
+}
+#endif
+
+#ifdef OTA_MULTICAST_SUPPORT
+/****************************************************************************
+ **
+ ** NAME:       vOtaMulticastSkipReceived
+ **
+ ** DESCRIPTION:
+ ** Moves the download offsets past multicast blocks already in flash
+ ** PARAMETERS:                           Name                           Usage
+ ** tsOTA_Common                       *psOTA_Common                   OTA custom data
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaMulticastSkipReceived(tsOTA_Common *psOTA_Common)
+{
+    tsOTA_PersistedData *psPersist = &psOTA_Common->sOTACallBackMessage.sPersistedData;
+    tsOTA_MulticastClientContext *psMulticast = &psOTA_Common->sOTACallBackMessage.sMulticastContext;
+    uint32 u32Block, u32Skip;
+
+    if (psMulticast->u8BlockSize == 0)
+    {
+        return;
+    }
+
+    while (psPersist->sAttributes.u32FileOffset >= psMulticast->u32BlockBase)
+    {
+        u32Block = (psPersist->sAttributes.u32FileOffset - psMulticast->u32BlockBase) / psMulticast->u8BlockSize;
+        if ( (u32Block >= ((uint32)OTA_MULTICAST_BITMAP_SIZE * 8)) ||
+             !(psMulticast->au8Received[u32Block / 8] & (1 << (u32Block % 8))) )
+        {
+            break;
+        }
+        u32Skip = psMulticast->u32BlockBase + ((u32Block + 1) * psMulticast->u8BlockSize) -
+                  psPersist->sAttributes.u32FileOffset;
+        psPersist->sAttributes.u32FileOffset += u32Skip;
+        psPersist->u32CurrentFlashOffset += u32Skip;
+        psPersist->u32TagDataWritten += u32Skip;
+    }
+}
+
+/****************************************************************************
+ **
+ ** NAME:       u8OtaMulticastMaxRequestSize
+ **
+ ** DESCRIPTION:
+ ** Limits a block request so it ends where the next multicast block received
+ ** starts
+ ** PARAMETERS:                           Name                           Usage
+ ** tsOTA_Common                       *psOTA_Common                   OTA custom data
+ ** uint8                               u8MaxDataSize                  Requested size
+ ** RETURN:
+ ** Size to request
+ ****************************************************************************/
+PRIVATE uint8 u8OtaMulticastMaxRequestSize(
+                                 tsOTA_Common                *psOTA_Common,
+                                 uint8                        u8MaxDataSize)
+{
+    tsOTA_MulticastClientContext *psMulticast = &psOTA_Common->sOTACallBackMessage.sMulticastContext;
+    uint32 u32FileOffset = psOTA_Common->sOTACallBackMessage.sPersistedData.sAttributes.u32FileOffset;
+    uint32 u32Block = 0, u32BlockStart;
+
+    if (psMulticast->u8BlockSize == 0)
+    {
+        return u8MaxDataSize;
+    }
+
+    if (u32FileOffset >= psMulticast->u32BlockBase)
+    {
+        u32Block = ((u32FileOffset - psMulticast->u32BlockBase) / psMulticast->u8BlockSize) + 1;
+    }
+
+    for ( ; u32Block < ((uint32)OTA_MULTICAST_BITMAP_SIZE * 8); u32Block++)
+    {
+        u32BlockStart = psMulticast->u32BlockBase + (u32Block * psMulticast->u8BlockSize);
+        if (u32BlockStart >= (u32FileOffset + u8MaxDataSize))
+        {
+            break;
+        }
+        if (psMulticast->au8Received[u32Block / 8] & (1 << (u32Block % 8)))
+        {
+            return (uint8)(u32BlockStart - u32FileOffset);
+        }
+    }
+    return u8MaxDataSize;
+}
+#endif
 
 #endif /* #ifdef OTA_CLIENT */
 /****************************************************************************/
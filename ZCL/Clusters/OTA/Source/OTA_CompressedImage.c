@@ -0,0 +1,717 @@
+/****************************************************************************
+ *
+ * Copyright 2020 NXP.
+ *
+ * NXP Confidential.
+ *
+ * This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms.
+ * By expressly accepting such terms or by downloading, installing, activating
+ * and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms.
+ * If you do not agree to be bound by the applicable license terms,
+ * then you may not retain, install, activate or otherwise use the software.
+ *
+ *
+ ****************************************************************************/
+
+
+/*****************************************************************************
+ *
+ * MODULE:             Over The Air Upgrade
+ *
+ * COMPONENT:          OTA_CompressedImage.c
+ *
+ * DESCRIPTION:        Streaming decompression of compressed upgrade images.
+ *
+ * The compressed sub-element (OTA_TAG_ID_COMPRESSED_IMAGE) starts with a
+ * 12 byte little endian header:
+ *
+ *   u32 magic "ZLZS", u32 decompressed size, u8 window bits,
+ *   u8 lookahead bits, u16 reserved
+ *
+ * followed by an LZSS bit stream, most significant bit first. A 1 bit is
+ * followed by an 8 bit literal; a 0 bit is followed by (distance - 1) in
+ * window bits and (count - 1) in lookahead bits. The history never exceeds
+ * 2^OTA_DECOMPRESS_WINDOW_BITS bytes, so blocks are decompressed as they
+ * arrive without buffering the image.
+ *
+ * examples/zigbee_ota_build/ota_compress.py produces this format.
+ *
+ *****************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+#include <jendefs.h>
+#include <string.h>
+#include "zcl_options.h"
+#include "zcl.h"
+#include "OTA.h"
+#include "OTA_private.h"
+#include "dbg.h"
+
+#ifndef TRACE_OTA_DECOMPRESS
+#define TRACE_OTA_DECOMPRESS FALSE
+#endif
+
+#ifdef OTA_COMPRESSED_IMAGE_SUPPORT
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+#define OTA_DECOMPRESS_IS_DECODING(STATE)    (((STATE) >= E_OTA_DECOMPRESS_STATE_HEADER) && \
+                                              ((STATE) <= E_OTA_DECOMPRESS_STATE_COUNT))
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+PRIVATE uint32 u32OtaDecompressGetLE(
+                    uint8                       *pu8Data);
+PRIVATE bool_t bOtaDecompressParseHeader(
+                    tsOTA_DecompressContext     *psDecompress);
+PRIVATE uint16 u16OtaDecompressTakeBits(
+                    tsOTA_DecompressContext     *psDecompress,
+                    uint8                        u8Bits);
+PRIVATE void vOtaDecompressDecodeBits(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData);
+PRIVATE void vOtaDecompressEmit(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    uint8                        u8Byte);
+PRIVATE void vOtaDecompressFlushWindow(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData);
+PRIVATE void vOtaDecompressEndOfTag(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData);
+PRIVATE void vOtaDecompressDeliver(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    uint8                       *pu8Data,
+                    uint8                        u8Length,
+                    uint32                       u32Offset);
+
+/****************************************************************************/
+/***        Exported Variables                                            ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+/****************************************************************************
+ **
+ ** NAME:       vOtaDecompressInit
+ **
+ ** DESCRIPTION:
+ ** Prepares the decompressor to write a compressed sub-element to flash.
+ ** Download progress stays in over the air bytes; only the flash sink works
+ ** in decompressed bytes.
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsOTA_DecompressContext  *psDecompress                   decompressor state
+ ** uint32                    u32TagLength                   sub-element length
+ ** uint32                    u32FlashOffset                 first flash location
+ ** uint32                    u32FlashSize                   size of the slot
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PUBLIC void vOtaDecompressInit(
+                    tsOTA_DecompressContext     *psDecompress,
+                    uint32                       u32TagLength,
+                    uint32                       u32FlashOffset,
+                    uint32                       u32FlashSize)
+{
+    memset(psDecompress, 0, sizeof(tsOTA_DecompressContext));
+    psDecompress->bActive = TRUE;
+    psDecompress->bToFlash = TRUE;
+    psDecompress->bDecoded = TRUE;
+    psDecompress->eState = E_OTA_DECOMPRESS_STATE_HEADER;
+    psDecompress->u32TagRemaining = u32TagLength;
+    psDecompress->u32OutputOffset = u32FlashOffset;
+    psDecompress->u32OutputLimit = u32FlashOffset + u32FlashSize;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       eOtaDecompressProcess
+ **
+ ** DESCRIPTION:
+ ** Feeds compressed sub-element bytes to the decompressor. Decompressed data
+ ** is written to flash or handed to the application a window at a time.
+ ** Bytes following the end of the sub-element are dropped by the flash sink
+ ** and passed on unchanged to the application.
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ ** uint8                    *pu8Data                        received bytes
+ ** uint32                    u32Length                      number of bytes
+ **
+ ** RETURN:
+ ** teZCL_Status
+ ****************************************************************************/
+PUBLIC teZCL_Status eOtaDecompressProcess(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    uint8                       *pu8Data,
+                    uint32                       u32Length)
+{
+    tsOTA_DecompressContext *psDecompress = &psCustomData->sOTACallBackMessage.sDecompressContext;
+
+    if(!psDecompress->bActive)
+    {
+        return E_ZCL_FAIL;
+    }
+
+    while((u32Length > 0) && (psDecompress->u32TagRemaining > 0) &&
+          (psDecompress->eState != E_OTA_DECOMPRESS_STATE_ERROR))
+    {
+        if(psDecompress->eState == E_OTA_DECOMPRESS_STATE_HEADER)
+        {
+            psDecompress->au8Field[psDecompress->u8FieldLength++] = *pu8Data;
+            if(psDecompress->u8FieldLength == OTA_COMPRESSED_IMAGE_HEADER_SIZE)
+            {
+                psDecompress->u8FieldLength = 0;
+                psDecompress->eState = bOtaDecompressParseHeader(psDecompress) ?
+                                       E_OTA_DECOMPRESS_STATE_TAG_BIT : E_OTA_DECOMPRESS_STATE_ERROR;
+                /* the slot was sized from the over the air length, check the padded
+                 * decompressed image still fits before anything is written */
+                if(psDecompress->bToFlash &&
+                   (((psDecompress->u32DecodedSize + OTA_AES_BLOCK_SIZE - 1) & ~(uint32)(OTA_AES_BLOCK_SIZE - 1)) >
+                    (psDecompress->u32OutputLimit - psDecompress->u32OutputOffset)))
+                {
+                    DBG_vPrintf(TRACE_OTA_DECOMPRESS, "LZS: %d bytes do not fit the slot\n", psDecompress->u32DecodedSize);
+                    psDecompress->eState = E_OTA_DECOMPRESS_STATE_ERROR;
+                }
+            }
+        }
+        else if(OTA_DECOMPRESS_IS_DECODING(psDecompress->eState))
+        {
+            psDecompress->u32BitBuffer = (psDecompress->u32BitBuffer << 8) | *pu8Data;
+            psDecompress->u8BitCount += 8;
+            vOtaDecompressDecodeBits(psEndPointDefinition, psCustomData);
+        }
+        else
+        {
+            /* stream continues after the image was complete */
+            psDecompress->eState = E_OTA_DECOMPRESS_STATE_ERROR;
+        }
+        pu8Data++;
+        u32Length--;
+
+        if(--psDecompress->u32TagRemaining == 0)
+        {
+            vOtaDecompressEndOfTag(psEndPointDefinition, psCustomData);
+        }
+    }
+
+    if(psDecompress->eState == E_OTA_DECOMPRESS_STATE_ERROR)
+    {
+        psDecompress->bActive = FALSE;
+        return E_ZCL_FAIL;
+    }
+
+    if(u32Length > 0)
+    {
+        if(psDecompress->bToFlash)
+        {
+            /* sub-elements following the image are not written to the slot */
+            return E_ZCL_SUCCESS;
+        }
+        /* further sub-elements are handed to the application unchanged */
+        psDecompress->eState = E_OTA_DECOMPRESS_STATE_PASSTHROUGH;
+        vOtaDecompressDeliver(psEndPointDefinition, psCustomData, pu8Data, (uint8)u32Length, psDecompress->u32OutputOffset);
+        psDecompress->u32OutputOffset += u32Length;
+    }
+    return E_ZCL_SUCCESS;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       eOtaDecompressFinish
+ **
+ ** DESCRIPTION:
+ ** Checks that the sub-element decompressed to its advertised size
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsOTA_DecompressContext  *psDecompress                   decompressor state
+ ** uint32                   *pu32DecodedSize                decompressed size
+ **
+ ** RETURN:
+ ** teZCL_Status
+ ****************************************************************************/
+PUBLIC teZCL_Status eOtaDecompressFinish(
+                    tsOTA_DecompressContext     *psDecompress,
+                    uint32                      *pu32DecodedSize)
+{
+    teZCL_Status eStatus = E_ZCL_SUCCESS;
+
+    if((psDecompress->eState == E_OTA_DECOMPRESS_STATE_ERROR) ||
+       OTA_DECOMPRESS_IS_DECODING(psDecompress->eState))
+    {
+        DBG_vPrintf(TRACE_OTA_DECOMPRESS, "LZS: incomplete stream state %d\n", psDecompress->eState);
+        eStatus = E_ZCL_FAIL;
+    }
+    if(pu32DecodedSize != NULL)
+    {
+        *pu32DecodedSize = psDecompress->u32Decoded;
+    }
+    psDecompress->bActive = FALSE;
+    return eStatus;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       eOtaDecompressFileBlock
+ **
+ ** DESCRIPTION:
+ ** Handles a block of a co-processor or file specific image. The OTA file
+ ** header and tag are tracked so that a compressed sub-element is handed to
+ ** the application decompressed; anything else is passed on unchanged.
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ ** teOTA_UpgradeClusterEvents eEventId                      event for the application
+ ** tsOTA_SuccessBlockResponsePayload *psBlock               received block
+ **
+ ** RETURN:
+ ** teZCL_Status
+ ****************************************************************************/
+PUBLIC teZCL_Status eOtaDecompressFileBlock(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    teOTA_UpgradeClusterEvents   eEventId,
+                    tsOTA_SuccessBlockResponsePayload *psBlock)
+{
+    tsOTA_DecompressContext *psDecompress = &psCustomData->sOTACallBackMessage.sDecompressContext;
+    /* psBlock may be the callback message itself, which delivery overwrites */
+    uint8 *pu8Data = psBlock->pu8Data;
+    uint8 u8DataSize = psBlock->u8DataSize;
+    uint32 u32FileOffset = psBlock->u32FileOffset;
+    uint32 u32Raw = 0;
+    uint32 u32TagStart;
+    uint16 u16TagId;
+    uint32 u32TagLength;
+
+    if(u32FileOffset == 0)
+    {
+        memset(psDecompress, 0, sizeof(tsOTA_DecompressContext));
+        psDecompress->bActive = TRUE;
+        psDecompress->eState = E_OTA_DECOMPRESS_STATE_FILE_HEADER;
+    }
+
+    if(!psDecompress->bActive)
+    {
+        /* tracking lost (reset during the download), start again */
+        return E_ZCL_FAIL;
+    }
+    psDecompress->eEventId = eEventId;
+    psDecompress->sBlockTemplate = *psBlock;
+
+    if(psDecompress->eState == E_OTA_DECOMPRESS_STATE_FILE_HEADER)
+    {
+        while((u32Raw < u8DataSize) && (psDecompress->eState == E_OTA_DECOMPRESS_STATE_FILE_HEADER))
+        {
+            uint32 u32Offset = psDecompress->u32RawOffset++;
+
+            if((u32Offset == 6) || (u32Offset == 7))
+            {
+                psDecompress->au8Field[u32Offset - 6] = pu8Data[u32Raw];
+                if(u32Offset == 7)
+                {
+                    vReverseMemcpy((uint8*)&psDecompress->u16FileHeaderLength, psDecompress->au8Field, sizeof(uint16));
+                    if((psDecompress->u16FileHeaderLength < OTA_MIN_HEADER_SIZE) ||
+                       (psDecompress->u16FileHeaderLength > OTA_MAX_HEADER_SIZE))
+                    {
+                        /* not an OTA file, hand it over untouched */
+                        psDecompress->eState = E_OTA_DECOMPRESS_STATE_PASSTHROUGH;
+                    }
+                }
+            }
+            else if(psDecompress->u16FileHeaderLength != 0)
+            {
+                u32TagStart = psDecompress->u16FileHeaderLength;
+                if((u32Offset >= u32TagStart) && (u32Offset < (u32TagStart + OTA_TAG_HEADER_SIZE)))
+                {
+                    psDecompress->au8Field[u32Offset - u32TagStart] = pu8Data[u32Raw];
+                    if(u32Offset == (u32TagStart + OTA_TAG_HEADER_SIZE - 1))
+                    {
+                        vOTA_GetTagIdandLengh(&u16TagId, &u32TagLength, psDecompress->au8Field);
+                        if(u16TagId == OTA_TAG_ID_COMPRESSED_IMAGE)
+                        {
+                            psDecompress->eState = E_OTA_DECOMPRESS_STATE_HEADER;
+                            psDecompress->bDecoded = TRUE;
+                            psDecompress->u32TagRemaining = u32TagLength;
+                            psDecompress->u32OutputOffset = u32Offset + 1;
+                        }
+                        else
+                        {
+                            psDecompress->eState = E_OTA_DECOMPRESS_STATE_PASSTHROUGH;
+                        }
+                    }
+                }
+            }
+            u32Raw++;
+        }
+
+        if(psDecompress->eState != E_OTA_DECOMPRESS_STATE_HEADER)
+        {
+            /* header, tag and anything that is not compressed go through as received */
+            vOtaDecompressDeliver(psEndPointDefinition, psCustomData, pu8Data, u8DataSize, u32FileOffset);
+            return E_ZCL_SUCCESS;
+        }
+        vOtaDecompressDeliver(psEndPointDefinition, psCustomData, pu8Data, (uint8)u32Raw, u32FileOffset);
+    }
+    else if(psDecompress->eState == E_OTA_DECOMPRESS_STATE_PASSTHROUGH)
+    {
+        vOtaDecompressDeliver(psEndPointDefinition, psCustomData, pu8Data, u8DataSize,
+                              psDecompress->bDecoded ? psDecompress->u32OutputOffset : u32FileOffset);
+        psDecompress->u32OutputOffset += u8DataSize;
+        return E_ZCL_SUCCESS;
+    }
+
+    if(u32Raw < u8DataSize)
+    {
+        return eOtaDecompressProcess(psEndPointDefinition, psCustomData, pu8Data + u32Raw, u8DataSize - u32Raw);
+    }
+    return E_ZCL_SUCCESS;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+/****************************************************************************
+ **
+ ** NAME:       u32OtaDecompressGetLE
+ **
+ ** DESCRIPTION:
+ ** Reads a little endian 32 bit field
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** uint8                    *pu8Data                        field bytes
+ **
+ ** RETURN:
+ ** uint32
+ ****************************************************************************/
+PRIVATE uint32 u32OtaDecompressGetLE(uint8 *pu8Data)
+{
+    return ((uint32)pu8Data[0])       |
+           ((uint32)pu8Data[1] << 8)  |
+           ((uint32)pu8Data[2] << 16) |
+           ((uint32)pu8Data[3] << 24);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       bOtaDecompressParseHeader
+ **
+ ** DESCRIPTION:
+ ** Validates the compressed sub-element header against the build limits
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsOTA_DecompressContext  *psDecompress                   decompressor state
+ **
+ ** RETURN:
+ ** TRUE if the stream can be decompressed
+ ****************************************************************************/
+PRIVATE bool_t bOtaDecompressParseHeader(tsOTA_DecompressContext *psDecompress)
+{
+    if(u32OtaDecompressGetLE(&psDecompress->au8Field[0]) != OTA_COMPRESSED_IMAGE_MAGIC)
+    {
+        DBG_vPrintf(TRACE_OTA_DECOMPRESS, "LZS: bad magic\n");
+        return FALSE;
+    }
+
+    psDecompress->u32DecodedSize  = u32OtaDecompressGetLE(&psDecompress->au8Field[4]);
+    psDecompress->u8WindowBits    = psDecompress->au8Field[8];
+    psDecompress->u8LookaheadBits = psDecompress->au8Field[9];
+
+    if((psDecompress->u32DecodedSize == 0) ||
+       (psDecompress->u8WindowBits < 4) ||
+       (psDecompress->u8WindowBits > OTA_DECOMPRESS_WINDOW_BITS) ||
+       (psDecompress->u8LookaheadBits < 2) ||
+       (psDecompress->u8LookaheadBits >= psDecompress->u8WindowBits))
+    {
+        DBG_vPrintf(TRACE_OTA_DECOMPRESS, "LZS: unsupported stream W%d L%d\n",
+                    psDecompress->u8WindowBits, psDecompress->u8LookaheadBits);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       u16OtaDecompressTakeBits
+ **
+ ** DESCRIPTION:
+ ** Removes the oldest bits from the bit buffer
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsOTA_DecompressContext  *psDecompress                   decompressor state
+ ** uint8                     u8Bits                         number of bits
+ **
+ ** RETURN:
+ ** bit field value
+ ****************************************************************************/
+PRIVATE uint16 u16OtaDecompressTakeBits(
+                    tsOTA_DecompressContext     *psDecompress,
+                    uint8                        u8Bits)
+{
+    psDecompress->u8BitCount -= u8Bits;
+    return (uint16)((psDecompress->u32BitBuffer >> psDecompress->u8BitCount) & ((1UL << u8Bits) - 1));
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaDecompressDecodeBits
+ **
+ ** DESCRIPTION:
+ ** Decodes as many literals and back references as the bit buffer holds
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaDecompressDecodeBits(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData)
+{
+    tsOTA_DecompressContext *psDecompress = &psCustomData->sOTACallBackMessage.sDecompressContext;
+    uint16 u16Mask = (uint16)((1 << psDecompress->u8WindowBits) - 1);
+    uint16 u16Count;
+
+    for(;;)
+    {
+        switch(psDecompress->eState)
+        {
+            case E_OTA_DECOMPRESS_STATE_TAG_BIT:
+                if(psDecompress->u8BitCount < 1)
+                {
+                    return;
+                }
+                psDecompress->eState = u16OtaDecompressTakeBits(psDecompress, 1) ?
+                                       E_OTA_DECOMPRESS_STATE_LITERAL : E_OTA_DECOMPRESS_STATE_INDEX;
+            break;
+
+            case E_OTA_DECOMPRESS_STATE_LITERAL:
+                if(psDecompress->u8BitCount < 8)
+                {
+                    return;
+                }
+                vOtaDecompressEmit(psEndPointDefinition, psCustomData, (uint8)u16OtaDecompressTakeBits(psDecompress, 8));
+                psDecompress->eState = E_OTA_DECOMPRESS_STATE_TAG_BIT;
+            break;
+
+            case E_OTA_DECOMPRESS_STATE_INDEX:
+                if(psDecompress->u8BitCount < psDecompress->u8WindowBits)
+                {
+                    return;
+                }
+                psDecompress->u16Index = u16OtaDecompressTakeBits(psDecompress, psDecompress->u8WindowBits) + 1;
+                psDecompress->eState = E_OTA_DECOMPRESS_STATE_COUNT;
+            break;
+
+            case E_OTA_DECOMPRESS_STATE_COUNT:
+                if(psDecompress->u8BitCount < psDecompress->u8LookaheadBits)
+                {
+                    return;
+                }
+                u16Count = u16OtaDecompressTakeBits(psDecompress, psDecompress->u8LookaheadBits) + 1;
+                if((psDecompress->u16Index > psDecompress->u32Decoded) ||
+                   (u16Count > (psDecompress->u32DecodedSize - psDecompress->u32Decoded)))
+                {
+                    DBG_vPrintf(TRACE_OTA_DECOMPRESS, "LZS: bad reference %d/%d\n", psDecompress->u16Index, u16Count);
+                    psDecompress->eState = E_OTA_DECOMPRESS_STATE_ERROR;
+                    return;
+                }
+                while(u16Count--)
+                {
+                    vOtaDecompressEmit(psEndPointDefinition, psCustomData,
+                                       psDecompress->au8History[(psDecompress->u16HistoryPos - psDecompress->u16Index) & u16Mask]);
+                }
+                psDecompress->eState = E_OTA_DECOMPRESS_STATE_TAG_BIT;
+            break;
+
+            default:
+                return;
+        }
+
+        if(psDecompress->u32Decoded == psDecompress->u32DecodedSize)
+        {
+            /* the rest of the last byte is padding */
+            psDecompress->eState = E_OTA_DECOMPRESS_STATE_COMPLETE;
+            psDecompress->u8BitCount = 0;
+            return;
+        }
+    }
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaDecompressEmit
+ **
+ ** DESCRIPTION:
+ ** Adds one decompressed byte to the history and the output window
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ ** uint8                     u8Byte                         image byte
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaDecompressEmit(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    uint8                        u8Byte)
+{
+    tsOTA_DecompressContext *psDecompress = &psCustomData->sOTACallBackMessage.sDecompressContext;
+
+    psDecompress->au8History[psDecompress->u16HistoryPos & ((1 << psDecompress->u8WindowBits) - 1)] = u8Byte;
+    psDecompress->u16HistoryPos++;
+    psDecompress->u32Decoded++;
+
+    psDecompress->au8Window[psDecompress->u8WindowFill++] = u8Byte;
+    if(psDecompress->u8WindowFill == OTA_IMAGE_DECODE_WINDOW_SIZE)
+    {
+        vOtaDecompressFlushWindow(psEndPointDefinition, psCustomData);
+    }
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaDecompressFlushWindow
+ **
+ ** DESCRIPTION:
+ ** Writes the output window to flash or hands it to the application
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaDecompressFlushWindow(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData)
+{
+    tsOTA_DecompressContext *psDecompress = &psCustomData->sOTACallBackMessage.sDecompressContext;
+
+    if(psDecompress->bToFlash)
+    {
+        vOtaFlashLockWrite(psEndPointDefinition, psCustomData,
+                           psDecompress->u32OutputOffset,
+                           psDecompress->u8WindowFill,
+                           psDecompress->au8Window);
+    }
+    else
+    {
+        vOtaDecompressDeliver(psEndPointDefinition, psCustomData,
+                              psDecompress->au8Window,
+                              psDecompress->u8WindowFill,
+                              psDecompress->u32OutputOffset);
+    }
+    psDecompress->u32OutputOffset += psDecompress->u8WindowFill;
+    psDecompress->u8WindowFill = 0;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaDecompressEndOfTag
+ **
+ ** DESCRIPTION:
+ ** Called on the last byte of the sub-element, flushes the output window
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaDecompressEndOfTag(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData)
+{
+    tsOTA_DecompressContext *psDecompress = &psCustomData->sOTACallBackMessage.sDecompressContext;
+
+    if(psDecompress->eState != E_OTA_DECOMPRESS_STATE_COMPLETE)
+    {
+        DBG_vPrintf(TRACE_OTA_DECOMPRESS, "LZS: %d of %d bytes at end of tag\n",
+                    psDecompress->u32Decoded, psDecompress->u32DecodedSize);
+        psDecompress->eState = E_OTA_DECOMPRESS_STATE_ERROR;
+        return;
+    }
+
+    if(psDecompress->u8WindowFill > 0)
+    {
+        if(psDecompress->bToFlash)
+        {
+            /* pad the tail up to the flash write granularity */
+            while((psDecompress->u8WindowFill % OTA_AES_BLOCK_SIZE) != 0)
+            {
+                psDecompress->au8Window[psDecompress->u8WindowFill++] = 0xFF;
+            }
+        }
+        vOtaDecompressFlushWindow(psEndPointDefinition, psCustomData);
+    }
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaDecompressDeliver
+ **
+ ** DESCRIPTION:
+ ** Gives the application a block response event for decompressed data
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ ** uint8                    *pu8Data                        data
+ ** uint8                     u8Length                       data length
+ ** uint32                    u32Offset                      offset in the file
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaDecompressDeliver(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    uint8                       *pu8Data,
+                    uint8                        u8Length,
+                    uint32                       u32Offset)
+{
+    tsOTA_DecompressContext *psDecompress = &psCustomData->sOTACallBackMessage.sDecompressContext;
+
+    if(u8Length == 0)
+    {
+        return;
+    }
+    psCustomData->sOTACallBackMessage.eEventId = psDecompress->eEventId;
+    psCustomData->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.u8Status = OTA_STATUS_SUCCESS;
+    psCustomData->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.uMessage.sBlockPayloadSuccess = psDecompress->sBlockTemplate;
+    psCustomData->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.uMessage.sBlockPayloadSuccess.pu8Data = pu8Data;
+    psCustomData->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.uMessage.sBlockPayloadSuccess.u8DataSize = u8Length;
+    psCustomData->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.uMessage.sBlockPayloadSuccess.u32FileOffset = u32Offset;
+    psEndPointDefinition->pCallBackFunctions(&psCustomData->sOTACustomCallBackEvent);
+}
+#endif /* OTA_COMPRESSED_IMAGE_SUPPORT */
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
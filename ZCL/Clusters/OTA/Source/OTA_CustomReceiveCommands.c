@@ -396,8 +396,20 @@ PUBLIC  teZCL_Status eOtaReceivedBlockResponse(
 
     psEndPointDefinition->pCallBackFunctions(&psOTA_Common->sOTACustomCallBackEvent);
 
-    //post the incoming request to the state machine
-    ((pFuncptr)(psOTA_Common->sOTACallBackMessage.sPersistedData.u32FunctionPointer))(psOTA_Common, psEndPointDefinition);
+#ifdef OTA_MULTICAST_SUPPORT
+    /* blocks sent to a group belong to a multicast session, they are stored
+     * aside from the block request/response sequence */
+    if((psOTA_Common->sOTACallBackMessage.uMessage.sImageBlockResponsePayload.u8Status == OTA_STATUS_SUCCESS)&&
+       (!OTA_IS_UNICAST(psOTA_Common->sReceiveEventAddress.u8DstAddrMode, psOTA_Common->sReceiveEventAddress.uDstAddress.u16Addr)))
+    {
+        vOtaHandleMulticastBlockResponse(psOTA_Common, psEndPointDefinition);
+    }
+    else
+#endif
+    {
+        //post the incoming request to the state machine
+        ((pFuncptr)(psOTA_Common->sOTACallBackMessage.sPersistedData.u32FunctionPointer))(psOTA_Common, psEndPointDefinition);
+    }
     // release mutex
     #ifndef COOPERATIVE
         eZCL_ReleaseMutex(psEndPointDefinition);
@@ -0,0 +1,532 @@
+/****************************************************************************
+ *
+ * Copyright 2020 NXP.
+ *
+ * NXP Confidential.
+ *
+ * This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms.
+ * By expressly accepting such terms or by downloading, installing, activating
+ * and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms.
+ * If you do not agree to be bound by the applicable license terms,
+ * then you may not retain, install, activate or otherwise use the software.
+ *
+ *
+ ****************************************************************************/
+
+
+/*****************************************************************************
+ *
+ * MODULE:             Over The Air Upgrade
+ *
+ * COMPONENT:          OTA_DeltaImage.c
+ *
+ * DESCRIPTION:        Streaming patch engine for delta upgrade images.
+ *
+ * The delta sub-element (OTA_TAG_ID_DELTA_IMAGE) reconstructs the upgrade
+ * image from the running image. All fields are little endian.
+ *
+ *   Header  : u32 magic "ZDLT", u32 old image size, u32 old image CRC32,
+ *             u32 new image size
+ *   Records : u32 diff length, u32 extra length, int32 old image seek,
+ *             followed by diff length bytes which are added to the running
+ *             image and extra length bytes which are copied as is.
+ *
+ * The reconstructed image is written to the download slot through the same
+ * flash interface a full image uses, one decode window at a time.
+ *
+ * The old image CRC is folded OTA_DELTA_CRC_FOLD_SIZE bytes per block
+ * response rather than in one pass. The engine stops short of the first
+ * diff byte until the running image is verified, the unconsumed bytes are
+ * then requested again.
+ *
+ *****************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+#include <jendefs.h>
+#include <string.h>
+#include "zcl_options.h"
+#include "zcl.h"
+#include "OTA.h"
+#include "OTA_private.h"
+#include "zps_apl_af.h"
+#include "dbg.h"
+
+#ifndef TRACE_OTA_DELTA
+#define TRACE_OTA_DELTA FALSE
+#endif
+
+#if (defined OTA_CLIENT) && (defined OTA_DELTA_IMAGE_SUPPORT)
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+#ifndef OTA_DELTA_RUNNING_IMAGE_BASE
+#define OTA_DELTA_RUNNING_IMAGE_BASE              ((uint8*)&_flash_start)
+#endif
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+PRIVATE uint32 u32OtaDeltaGetLE(
+                    uint8                       *pu8Data);
+PRIVATE bool_t bOtaDeltaParseHeader(
+                    tsOTA_DeltaContext          *psDelta);
+PRIVATE void vOtaDeltaFoldOldCrc(
+                    tsOTA_DeltaContext          *psDelta);
+PRIVATE bool_t bOtaDeltaParseControl(
+                    tsOTA_DeltaContext          *psDelta);
+PRIVATE void vOtaDeltaEndRecord(
+                    tsOTA_DeltaContext          *psDelta);
+PRIVATE void vOtaDeltaEmit(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    uint8                        u8Byte);
+PRIVATE void vOtaDeltaFlushWindow(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData);
+
+/****************************************************************************/
+/***        Exported Variables                                            ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+/****************************************************************************
+ **
+ ** NAME:       vOtaDeltaInit
+ **
+ ** DESCRIPTION:
+ ** Resets the patch engine ready for the first byte of a delta sub-element
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsOTA_DeltaContext       *psDelta                        patch engine state
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PUBLIC void vOtaDeltaInit(tsOTA_DeltaContext *psDelta)
+{
+    memset(psDelta, 0, sizeof(tsOTA_DeltaContext));
+    psDelta->eState = E_OTA_DELTA_STATE_HEADER;
+    psDelta->bActive = TRUE;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       eOtaDeltaProcess
+ **
+ ** DESCRIPTION:
+ ** Feeds received delta bytes to the patch engine, reconstructed image bytes
+ ** are written to the download slot as the decode window fills. Fewer than
+ ** u32Length bytes are consumed while the running image is still being
+ ** verified, the caller requests the rest again
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ ** uint8                    *pu8Data                        delta bytes
+ ** uint32                    u32Length                      number of bytes
+ ** uint32                   *pu32Consumed                   bytes consumed
+ **
+ ** RETURN:
+ ** teZCL_Status
+ ****************************************************************************/
+PUBLIC teZCL_Status eOtaDeltaProcess(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    uint8                       *pu8Data,
+                    uint32                       u32Length,
+                    uint32                      *pu32Consumed)
+{
+    tsOTA_DeltaContext *psDelta = &psCustomData->sOTACallBackMessage.sDeltaContext;
+    uint8 *pu8Old = OTA_DELTA_RUNNING_IMAGE_BASE;
+    uint32 u32Count;
+    uint32 u32Total = u32Length;
+    bool_t bFolded = FALSE;
+
+    *pu32Consumed = 0;
+    if(!psDelta->bActive)
+    {
+        return E_ZCL_FAIL;
+    }
+
+    while((u32Length > 0) && (psDelta->eState != E_OTA_DELTA_STATE_ERROR))
+    {
+        if((psDelta->eState == E_OTA_DELTA_STATE_DIFF) && (!psDelta->bOldImageVerified))
+        {
+            /* diff bytes are added to the running image, which must match the patch base */
+            if(!bFolded)
+            {
+                vOtaDeltaFoldOldCrc(psDelta);
+                bFolded = TRUE;
+                continue;
+            }
+            break;
+        }
+
+        switch(psDelta->eState)
+        {
+            case E_OTA_DELTA_STATE_HEADER:
+                psDelta->au8Field[psDelta->u8FieldLength++] = *pu8Data++;
+                u32Length--;
+                if(psDelta->u8FieldLength == OTA_DELTA_IMAGE_HEADER_SIZE)
+                {
+                    psDelta->u8FieldLength = 0;
+                    psDelta->eState = bOtaDeltaParseHeader(psDelta) ?
+                                      E_OTA_DELTA_STATE_CONTROL : E_OTA_DELTA_STATE_ERROR;
+                }
+            break;
+
+            case E_OTA_DELTA_STATE_CONTROL:
+                psDelta->au8Field[psDelta->u8FieldLength++] = *pu8Data++;
+                u32Length--;
+                if(psDelta->u8FieldLength == OTA_DELTA_IMAGE_CONTROL_SIZE)
+                {
+                    psDelta->u8FieldLength = 0;
+                    if(!bOtaDeltaParseControl(psDelta))
+                    {
+                        psDelta->eState = E_OTA_DELTA_STATE_ERROR;
+                    }
+                    else if(psDelta->u32DiffRemaining > 0)
+                    {
+                        psDelta->eState = E_OTA_DELTA_STATE_DIFF;
+                    }
+                    else if(psDelta->u32ExtraRemaining > 0)
+                    {
+                        psDelta->eState = E_OTA_DELTA_STATE_EXTRA;
+                    }
+                    else
+                    {
+                        vOtaDeltaEndRecord(psDelta);
+                    }
+                }
+            break;
+
+            case E_OTA_DELTA_STATE_DIFF:
+                u32Count = (u32Length < psDelta->u32DiffRemaining) ? u32Length : psDelta->u32DiffRemaining;
+                psDelta->u32DiffRemaining -= u32Count;
+                u32Length -= u32Count;
+                while(u32Count--)
+                {
+                    vOtaDeltaEmit(psEndPointDefinition, psCustomData, (uint8)(pu8Old[psDelta->u32OldPos++] + *pu8Data++));
+                }
+                if(psDelta->u32DiffRemaining == 0)
+                {
+                    if(psDelta->u32ExtraRemaining > 0)
+                    {
+                        psDelta->eState = E_OTA_DELTA_STATE_EXTRA;
+                    }
+                    else
+                    {
+                        vOtaDeltaEndRecord(psDelta);
+                    }
+                }
+            break;
+
+            case E_OTA_DELTA_STATE_EXTRA:
+                u32Count = (u32Length < psDelta->u32ExtraRemaining) ? u32Length : psDelta->u32ExtraRemaining;
+                psDelta->u32ExtraRemaining -= u32Count;
+                u32Length -= u32Count;
+                while(u32Count--)
+                {
+                    vOtaDeltaEmit(psEndPointDefinition, psCustomData, *pu8Data++);
+                }
+                if(psDelta->u32ExtraRemaining == 0)
+                {
+                    vOtaDeltaEndRecord(psDelta);
+                }
+            break;
+
+            default:
+                /* data beyond the last record */
+                DBG_vPrintf(TRACE_OTA_DELTA, "DELTA: trailing data %d\n", u32Length);
+                psDelta->eState = E_OTA_DELTA_STATE_ERROR;
+            break;
+        }
+    }
+
+    if(psDelta->eState == E_OTA_DELTA_STATE_ERROR)
+    {
+        psDelta->bActive = FALSE;
+        return E_ZCL_FAIL;
+    }
+    *pu32Consumed = u32Total - u32Length;
+    return E_ZCL_SUCCESS;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       eOtaDeltaFinish
+ **
+ ** DESCRIPTION:
+ ** Called once the whole delta sub-element is received, writes the remaining
+ ** window bytes and records the reconstructed image size for verification
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ **
+ ** RETURN:
+ ** teZCL_Status
+ ****************************************************************************/
+PUBLIC teZCL_Status eOtaDeltaFinish(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData)
+{
+    tsOTA_DeltaContext *psDelta = &psCustomData->sOTACallBackMessage.sDeltaContext;
+
+    if((!psDelta->bActive) || (psDelta->eState != E_OTA_DELTA_STATE_COMPLETE))
+    {
+        DBG_vPrintf(TRACE_OTA_DELTA, "DELTA: incomplete patch state %d\n", psDelta->eState);
+        psDelta->bActive = FALSE;
+        return E_ZCL_FAIL;
+    }
+
+    if(psDelta->u8WindowFill > 0)
+    {
+        /* pad the tail up to the flash write granularity */
+        while((psDelta->u8WindowFill % OTA_AES_BLOCK_SIZE) != 0)
+        {
+            psDelta->au8Window[psDelta->u8WindowFill++] = 0xFF;
+        }
+        vOtaDeltaFlushWindow(psEndPointDefinition, psCustomData);
+    }
+
+    psCustomData->sOTACallBackMessage.sPersistedData.u32DecodedImageSize = psDelta->u32NewImageSize;
+    psDelta->bActive = FALSE;
+    DBG_vPrintf(TRACE_OTA_DELTA, "DELTA: rebuilt %d bytes\n", psDelta->u32NewImageSize);
+    return E_ZCL_SUCCESS;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+/****************************************************************************
+ **
+ ** NAME:       u32OtaDeltaGetLE
+ **
+ ** DESCRIPTION:
+ ** Reads a little endian 32 bit field
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** uint8                    *pu8Data                        field bytes
+ **
+ ** RETURN:
+ ** uint32
+ ****************************************************************************/
+PRIVATE uint32 u32OtaDeltaGetLE(uint8 *pu8Data)
+{
+    return ((uint32)pu8Data[0])       |
+           ((uint32)pu8Data[1] << 8)  |
+           ((uint32)pu8Data[2] << 16) |
+           ((uint32)pu8Data[3] << 24);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       bOtaDeltaParseHeader
+ **
+ ** DESCRIPTION:
+ ** Validates the delta header and starts the check that the patch was
+ ** generated against the image that is running on this device
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsOTA_DeltaContext       *psDelta                        patch engine state
+ **
+ ** RETURN:
+ ** TRUE if the patch can be applied
+ ****************************************************************************/
+PRIVATE bool_t bOtaDeltaParseHeader(tsOTA_DeltaContext *psDelta)
+{
+    if(u32OtaDeltaGetLE(&psDelta->au8Field[0]) != OTA_DELTA_IMAGE_MAGIC)
+    {
+        DBG_vPrintf(TRACE_OTA_DELTA, "DELTA: bad magic\n");
+        return FALSE;
+    }
+
+    psDelta->u32OldImageSize = u32OtaDeltaGetLE(&psDelta->au8Field[4]);
+    psDelta->u32OldImageCrc  = u32OtaDeltaGetLE(&psDelta->au8Field[8]);
+    psDelta->u32NewImageSize = u32OtaDeltaGetLE(&psDelta->au8Field[12]);
+
+    if((psDelta->u32OldImageSize == 0) || (psDelta->u32NewImageSize == 0))
+    {
+        return FALSE;
+    }
+
+    psDelta->u32OldCrcRunning = 0xFFFFFFFF;
+    psDelta->u32OldCrcPos = 0;
+    psDelta->bOldImageVerified = FALSE;
+    return TRUE;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaDeltaFoldOldCrc
+ **
+ ** DESCRIPTION:
+ ** Adds the next OTA_DELTA_CRC_FOLD_SIZE bytes of the running image to the
+ ** base image CRC and compares it with the header once all are covered
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsOTA_DeltaContext       *psDelta                        patch engine state
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaDeltaFoldOldCrc(tsOTA_DeltaContext *psDelta)
+{
+    uint8 *pu8Old = OTA_DELTA_RUNNING_IMAGE_BASE;
+    uint32 u32Count = psDelta->u32OldImageSize - psDelta->u32OldCrcPos;
+
+    if(u32Count > OTA_DELTA_CRC_FOLD_SIZE)
+    {
+        u32Count = OTA_DELTA_CRC_FOLD_SIZE;
+    }
+    while(u32Count--)
+    {
+        ZPS_vRunningCRC32(pu8Old[psDelta->u32OldCrcPos++], &psDelta->u32OldCrcRunning);
+    }
+
+    if(psDelta->u32OldCrcPos == psDelta->u32OldImageSize)
+    {
+        ZPS_vFinalCrc32(&psDelta->u32OldCrcRunning);
+        if(psDelta->u32OldCrcRunning != psDelta->u32OldImageCrc)
+        {
+            DBG_vPrintf(TRACE_OTA_DELTA, "DELTA: base image mismatch %08x %08x\n",
+                        psDelta->u32OldCrcRunning, psDelta->u32OldImageCrc);
+            psDelta->eState = E_OTA_DELTA_STATE_ERROR;
+            return;
+        }
+        psDelta->bOldImageVerified = TRUE;
+    }
+}
+
+/****************************************************************************
+ **
+ ** NAME:       bOtaDeltaParseControl
+ **
+ ** DESCRIPTION:
+ ** Decodes a control record and bounds checks it against both images
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsOTA_DeltaContext       *psDelta                        patch engine state
+ **
+ ** RETURN:
+ ** TRUE if the record is valid
+ ****************************************************************************/
+PRIVATE bool_t bOtaDeltaParseControl(tsOTA_DeltaContext *psDelta)
+{
+    psDelta->u32DiffRemaining  = u32OtaDeltaGetLE(&psDelta->au8Field[0]);
+    psDelta->u32ExtraRemaining = u32OtaDeltaGetLE(&psDelta->au8Field[4]);
+    psDelta->i32Seek           = (int32)u32OtaDeltaGetLE(&psDelta->au8Field[8]);
+
+    if((psDelta->u32DiffRemaining > (psDelta->u32OldImageSize - psDelta->u32OldPos)) ||
+       (psDelta->u32DiffRemaining > (psDelta->u32NewImageSize - psDelta->u32NewPos)) ||
+       (psDelta->u32ExtraRemaining > (psDelta->u32NewImageSize - psDelta->u32NewPos - psDelta->u32DiffRemaining)))
+    {
+        DBG_vPrintf(TRACE_OTA_DELTA, "DELTA: record out of range\n");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaDeltaEndRecord
+ **
+ ** DESCRIPTION:
+ ** Applies the seek of the current record and selects the next state
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsOTA_DeltaContext       *psDelta                        patch engine state
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaDeltaEndRecord(tsOTA_DeltaContext *psDelta)
+{
+    if(((psDelta->i32Seek < 0) && ((uint32)(-psDelta->i32Seek) > psDelta->u32OldPos)) ||
+       ((psDelta->i32Seek > 0) && ((uint32)psDelta->i32Seek > (psDelta->u32OldImageSize - psDelta->u32OldPos))))
+    {
+        psDelta->eState = E_OTA_DELTA_STATE_ERROR;
+        return;
+    }
+    psDelta->u32OldPos += (uint32)psDelta->i32Seek;
+
+    psDelta->eState = (psDelta->u32NewPos == psDelta->u32NewImageSize) ?
+                      E_OTA_DELTA_STATE_COMPLETE : E_OTA_DELTA_STATE_CONTROL;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaDeltaEmit
+ **
+ ** DESCRIPTION:
+ ** Adds one reconstructed byte to the decode window
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ ** uint8                     u8Byte                         image byte
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaDeltaEmit(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    uint8                        u8Byte)
+{
+    tsOTA_DeltaContext *psDelta = &psCustomData->sOTACallBackMessage.sDeltaContext;
+
+    psDelta->au8Window[psDelta->u8WindowFill++] = u8Byte;
+    psDelta->u32NewPos++;
+    if(psDelta->u8WindowFill == OTA_IMAGE_DECODE_WINDOW_SIZE)
+    {
+        vOtaDeltaFlushWindow(psEndPointDefinition, psCustomData);
+    }
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vOtaDeltaFlushWindow
+ **
+ ** DESCRIPTION:
+ ** Writes the decode window to the download slot
+ **
+ ** PARAMETERS:               Name                           Usage
+ ** tsZCL_EndPointDefinition *psEndPointDefinition           Endpoint definition
+ ** tsOTA_Common             *psCustomData                   OTA custom data
+ **
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PRIVATE void vOtaDeltaFlushWindow(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData)
+{
+    tsOTA_DeltaContext *psDelta = &psCustomData->sOTACallBackMessage.sDeltaContext;
+
+    vOtaFlashLockWrite(psEndPointDefinition, psCustomData,
+                       psCustomData->sOTACallBackMessage.sPersistedData.u32CurrentFlashOffset,
+                       psDelta->u8WindowFill,
+                       psDelta->au8Window);
+    psCustomData->sOTACallBackMessage.sPersistedData.u32CurrentFlashOffset += psDelta->u8WindowFill;
+    psDelta->u8WindowFill = 0;
+}
+#endif /* OTA_CLIENT && OTA_DELTA_IMAGE_SUPPORT */
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
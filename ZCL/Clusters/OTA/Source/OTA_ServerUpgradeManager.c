@@ -327,6 +327,37 @@ PUBLIC  void vOtaUpgManServerCommandHandler(
 
 
                         }
+#ifdef OTA_MULTICAST_SUPPORT
+                        else if((pZPSevent != NULL)&&
+                                (psOTA_Common->sOTACallBackMessage.sMulticastServerParams.bActive)&&
+                                (psOTA_Common->sOTACallBackMessage.sMulticastServerParams.u8ImageIndex == u8FoundLocation)&&
+                                (psBlockRequest->u32FileOffset >= (psOTA_Common->sOTACallBackMessage.sMulticastServerParams.u32DataStart +
+                                                                   psOTA_Common->sOTACallBackMessage.sMulticastServerParams.u8BlockSize))&&
+                                (psBlockRequest->u32FileOffset < ((uint32)OTA_MULTICAST_BITMAP_SIZE * 8 *
+                                                                  psOTA_Common->sOTACallBackMessage.sMulticastServerParams.u8BlockSize)))
+                        {
+                            /* The block will reach the client through the group, hold
+                             * it off until the multicast session is over. The first
+                             * block is still served so the client gets going, as are
+                             * blocks past what the client bitmap can record */
+                            uint32 u32Now = u32ZCL_GetUTCTime();
+                            DBG_vPrintf(TRACE_OTA_DEBUG, "OTA 98 ..\n" );
+                            sBlockResponse.u8Status = OTA_STATUS_WAIT_FOR_DATA;
+                            sBlockResponse.uMessage.sWaitForData.u32CurrentTime = 0;
+                            sBlockResponse.uMessage.sWaitForData.u32RequestTime = 1;
+                            if(psOTA_Common->sOTACallBackMessage.sMulticastServerParams.u32EndTime > u32Now)
+                            {
+                                sBlockResponse.uMessage.sWaitForData.u32RequestTime += psOTA_Common->sOTACallBackMessage.sMulticastServerParams.u32EndTime - u32Now;
+                            }
+                            sBlockResponse.uMessage.sWaitForData.u16BlockRequestDelayMs = 0;
+                            eOTA_ServerImageBlockResponse(psOTA_Common->sReceiveEventAddress.u8DstEndpoint,
+                                                                            psOTA_Common->sReceiveEventAddress.u8SrcEndpoint,
+                                                                            &sZCL_Address,
+                                                                            &sBlockResponse,
+                                                                            0,
+                                                                            psOTA_Common->sOTACustomCallBackEvent.u8TransactionSequenceNumber);
+                        }
+#endif
                         else
                         {
                             teZCL_Status eZCL_Status;
@@ -695,6 +726,98 @@ PRIVATE  teZCL_Status eOta_SendDefaultResponse(
     return(E_ZCL_SUCCESS);
 }
 #endif  /*#ifdef OTA_PAGE_REQUEST_SUPPORT*/
+
+#ifdef OTA_MULTICAST_SUPPORT
+/****************************************************************************
+ **
+ ** NAME:       vOtaHandleTimedMulticastBlock
+ **
+ ** DESCRIPTION:
+ ** Sends the next block of a multicast session to the group
+ ** PARAMETERS:                           Name                           Usage
+ ** uint8                               u8SourceEndPointId             source endpoint id
+ ** RETURN:
+ ** None
+ ****************************************************************************/
+PUBLIC  void vOtaHandleTimedMulticastBlock(uint8 u8SourceEndPointId)
+{
+    tsZCL_ClusterInstance *psClusterInstance;
+    tsZCL_EndPointDefinition *psEndPointDefinition;
+    tsOTA_Common *psCustomData;
+    tsOTA_MulticastServerParams *psMulticast;
+    tsOTA_ImageHeader sOTAHeader;
+    tsOTA_ImageBlockResponsePayload sBlockResponse;
+    tsZCL_Address sZCL_Address;
+    uint8 au8Data[OTA_MAX_BLOCK_SIZE];
+    uint32 u32FlashOffset;
+
+    if(eOtaFindCluster(u8SourceEndPointId,
+                       &psEndPointDefinition,
+                       &psClusterInstance,
+                       &psCustomData,
+                       TRUE) != E_ZCL_SUCCESS)
+    {
+        return;
+    }
+
+    psMulticast = &psCustomData->sOTACallBackMessage.sMulticastServerParams;
+    if(!psMulticast->bActive)
+    {
+        return;
+    }
+    // get EP mutex
+    #ifndef COOPERATIVE
+        eZCL_GetMutex(psEndPointDefinition);
+    #endif
+
+    eOTA_GetOtaHeader(u8SourceEndPointId, psMulticast->u8ImageIndex, &sOTAHeader);
+    if(psMulticast->u32NextOffset >= sOTAHeader.u32TotalImage)
+    {
+        /* Whole image sent, clients now request what they missed */
+        DBG_vPrintf(TRACE_OTA_DEBUG, "OTA multicast done\n");
+        psMulticast->bActive = FALSE;
+        eZCL_UpdateMsTimer(psEndPointDefinition, FALSE, 0);
+    }
+    else
+    {
+        sBlockResponse.u8Status = OTA_STATUS_SUCCESS;
+        sBlockResponse.uMessage.sBlockPayloadSuccess.u16ManufacturerCode = sOTAHeader.u16ManufacturerCode;
+        sBlockResponse.uMessage.sBlockPayloadSuccess.u16ImageType = sOTAHeader.u16ImageType;
+        sBlockResponse.uMessage.sBlockPayloadSuccess.u32FileVersion = sOTAHeader.u32FileVersion;
+        sBlockResponse.uMessage.sBlockPayloadSuccess.u32FileOffset = psMulticast->u32NextOffset;
+        sBlockResponse.uMessage.sBlockPayloadSuccess.u8DataSize = psMulticast->u8BlockSize;
+        if((sOTAHeader.u32TotalImage - psMulticast->u32NextOffset) < psMulticast->u8BlockSize)
+        {
+            sBlockResponse.uMessage.sBlockPayloadSuccess.u8DataSize = (uint8)(sOTAHeader.u32TotalImage - psMulticast->u32NextOffset);
+        }
+
+        u32FlashOffset = ( (psCustomData->sOTACallBackMessage.u8ImageStartSector[psMulticast->u8ImageIndex] *
+                          sNvmDefsStruct.u32SectorSize) * OTA_SECTOR_CONVERTION) + psMulticast->u32NextOffset;
+        vOtaFlashLockRead(psEndPointDefinition, psCustomData, u32FlashOffset, sBlockResponse.uMessage.sBlockPayloadSuccess.u8DataSize, au8Data);
+        sBlockResponse.uMessage.sBlockPayloadSuccess.pu8Data = au8Data;
+
+        sZCL_Address.eAddressMode = E_ZCL_AM_GROUP;
+        sZCL_Address.uAddress.u16GroupAddress = psMulticast->u16GroupAddress;
+        eOTA_ServerImageBlockResponse(psMulticast->u8SrcEndpoint,
+                                      psMulticast->u8DstEndpoint,
+                                      &sZCL_Address,
+                                      &sBlockResponse,
+                                      sBlockResponse.uMessage.sBlockPayloadSuccess.u8DataSize,
+                                      psMulticast->u8TransactionNumber++);
+
+        if(psMulticast->u32NextOffset == psMulticast->u32DataStart)
+        {
+            /* first block went out after the start delay, switch to the block pace */
+            eZCL_UpdateMsTimer(psEndPointDefinition, TRUE, psMulticast->u16BlockSpacingMs);
+        }
+        psMulticast->u32NextOffset += sBlockResponse.uMessage.sBlockPayloadSuccess.u8DataSize;
+    }
+    // release mutex
+    #ifndef COOPERATIVE
+        eZCL_ReleaseMutex(psEndPointDefinition);
+    #endif
+}
+#endif
 #endif
 /****************************************************************************/
 /***        END OF FILE                                                   ***/
@@ -1007,6 +1007,18 @@ PUBLIC  teZCL_Status eOTA_HandleImageVerification(uint8 u8SourceEndpoint,
         vReverseMemcpy((uint8*)&u16OtaHeaderSize,&psOTA_Common->sOTACallBackMessage.sPersistedData.au8Header[6],sizeof(uint16));
         vReverseMemcpy((uint8*)&u32TotalImageSize,&psOTA_Common->sOTACallBackMessage.sPersistedData.au8Header[52],sizeof(uint32));
         u32ImageSize = u32TotalImageSize - u16OtaHeaderSize - OTA_TAG_HEADER_SIZE;
+#if (defined OTA_DELTA_IMAGE_SUPPORT) || (defined OTA_COMPRESSED_IMAGE_SUPPORT)
+        {
+            uint16 u16TagId;
+            uint32 u32TagLength;
+            vOTA_GetTagIdandLengh(&u16TagId, &u32TagLength, psOTA_Common->sOTACallBackMessage.sPersistedData.u8ActiveTag);
+            if(bOTA_IsDecodedImageTag(u16TagId))
+            {
+                /* the slot holds the decoded image, not the received sub-element */
+                u32ImageSize = psOTA_Common->sOTACallBackMessage.sPersistedData.u32DecodedImageSize;
+            }
+        }
+#endif
         /* Check if img authentication feature is enabled and if it is the case remove the signature len for the CRC calculation
         */
         if (bOtaIsAuthenticationEnabled())
@@ -212,6 +212,19 @@ PUBLIC void vOtaReceivedDefaultResponse(
                     tsZCL_EndPointDefinition    *psEndPointDefinition,
                     tsZCL_ClusterInstance       *psClusterInstance);
 
+#ifdef OTA_DELTA_IMAGE_SUPPORT
+PUBLIC void vOtaDeltaInit(
+                    tsOTA_DeltaContext          *psDelta);
+PUBLIC teZCL_Status eOtaDeltaProcess(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    uint8                       *pu8Data,
+                    uint32                       u32Length,
+                    uint32                      *pu32Consumed);
+PUBLIC teZCL_Status eOtaDeltaFinish(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData);
+#endif
 
 #endif
 #ifdef OTA_SERVER
@@ -251,12 +264,42 @@ PUBLIC teZCL_Status eOtaReceivedPageRequest(
 #ifdef OTA_PAGE_REQUEST_SUPPORT
 PUBLIC void vOtaHandleTimedPageRequest(uint8 u8SourceEndPointId);
 #endif
+#if (defined OTA_SERVER) && (defined OTA_MULTICAST_SUPPORT)
+PUBLIC void vOtaHandleTimedMulticastBlock(uint8 u8SourceEndPointId);
+#endif
+#if (defined OTA_CLIENT) && (defined OTA_MULTICAST_SUPPORT)
+PUBLIC void vOtaHandleMulticastBlockResponse(
+                    tsOTA_Common                *psOTA_Common,
+                    tsZCL_EndPointDefinition    *psEndPointDefinition);
+#endif
 PUBLIC teZCL_Status eOTA_GetOtaHeader(
                     uint8                        u8Endpoint,
                     uint8                        u8ImageIndex,
                     tsOTA_ImageHeader           *psOTAHeader);
 #endif
 PUBLIC void vOTA_GetTagIdandLengh(uint16 *pu16TagId,uint32 *pu32TagLength,uint8 * pu8Tag);
+PUBLIC bool_t bOTA_IsUpgradeImageTag(uint16 u16TagId);
+PUBLIC bool_t bOTA_IsDecodedImageTag(uint16 u16TagId);
+#ifdef OTA_COMPRESSED_IMAGE_SUPPORT
+PUBLIC void vOtaDecompressInit(
+                    tsOTA_DecompressContext     *psDecompress,
+                    uint32                       u32TagLength,
+                    uint32                       u32FlashOffset,
+                    uint32                       u32FlashSize);
+PUBLIC teZCL_Status eOtaDecompressProcess(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    uint8                       *pu8Data,
+                    uint32                       u32Length);
+PUBLIC teZCL_Status eOtaDecompressFinish(
+                    tsOTA_DecompressContext     *psDecompress,
+                    uint32                      *pu32DecodedSize);
+PUBLIC teZCL_Status eOtaDecompressFileBlock(
+                    tsZCL_EndPointDefinition    *psEndPointDefinition,
+                    tsOTA_Common                *psCustomData,
+                    teOTA_UpgradeClusterEvents   eEventId,
+                    tsOTA_SuccessBlockResponsePayload *psBlock);
+#endif
 /****************************************************************************/
 /***        External Variables                                            ***/
 /****************************************************************************/
@@ -547,6 +547,150 @@ PUBLIC  teZCL_Status eOTA_ServerQuerySpecificFileResponse(
     }
     return eZCL_Status;
 }
+#ifdef OTA_MULTICAST_SUPPORT
+/****************************************************************************
+ **
+ ** NAME:       eOTA_ServerMulticastStart
+ **
+ ** DESCRIPTION:
+ ** Notifies a group of an image and then sends the image blocks to the group
+ ** at a fixed pace. Clients record the blocks they receive and only request
+ ** the missing ones once the session has ended.
+ **
+ ** PARAMETERS:                 Name                           Usage
+ ** uint8                     u8SourceEndpoint              Source EP Id
+ ** uint8                     u8DestinationEndpoint         Destination EP Id
+ ** uint16                    u16GroupAddress               Group to send to
+ ** uint8                     u8ImageIndex                  Image to distribute
+ ** uint8                     u8BlockSize                   Block size, multiple of 16 and at
+ **                                                         least OTA_MULTICAST_MIN_BLOCK_SIZE
+ ** uint16                    u16BlockSpacingMs             Time between blocks
+ ** uint16                    u16StartDelay                 Seconds before first block
+ **
+ ** RETURN:
+ ** teZCL_Status
+ ****************************************************************************/
+PUBLIC  teZCL_Status eOTA_ServerMulticastStart(
+                    uint8                     u8SourceEndpoint,
+                    uint8                     u8DestinationEndpoint,
+                    uint16                    u16GroupAddress,
+                    uint8                     u8ImageIndex,
+                    uint8                     u8BlockSize,
+                    uint16                    u16BlockSpacingMs,
+                    uint16                    u16StartDelay)
+{
+    teZCL_Status eZCL_Status;
+    tsZCL_ClusterInstance *psClusterInstance;
+    tsZCL_EndPointDefinition *psEndPointDefinition;
+    tsOTA_Common *psCustomData;
+    tsOTA_MulticastServerParams *psMulticast;
+    tsOTA_ImageHeader sOTAHeader;
+    tsOTA_ImageNotifyCommand sImageNotify;
+    tsZCL_Address sZCL_Address;
+    uint32 u32NumberOfBlocks;
+
+    if((u8ImageIndex >= OTA_MAX_IMAGES_PER_ENDPOINT) ||
+       (u8BlockSize < OTA_MULTICAST_MIN_BLOCK_SIZE) || ((u8BlockSize % 16) != 0) || (u8BlockSize > OTA_MAX_BLOCK_SIZE) ||
+       (u16BlockSpacingMs < OTA_MIN_TIMER_MS_RESOLUTION))
+    {
+        return E_ZCL_ERR_PARAMETER_RANGE;
+    }
+
+    if((eZCL_Status =
+        eOtaFindCluster(u8SourceEndpoint,
+                         &psEndPointDefinition,
+                           &psClusterInstance,
+                           &psCustomData,
+                           TRUE))
+                           != E_ZCL_SUCCESS)
+    {
+        return eZCL_Status;
+    }
+
+    if (!psClusterInstance->bIsServer)
+    {
+        return E_ZCL_FAIL;
+    }
+
+    eZCL_Status = eOTA_GetOtaHeader(u8SourceEndpoint, u8ImageIndex, &sOTAHeader);
+    if((eZCL_Status != E_ZCL_SUCCESS) ||
+       (sOTAHeader.u32TotalImage <= (uint32)(sOTAHeader.u16HeaderLength + OTA_TAG_HEADER_SIZE)))
+    {
+        return E_ZCL_FAIL;
+    }
+
+    sZCL_Address.eAddressMode = E_ZCL_AM_GROUP;
+    sZCL_Address.uAddress.u16GroupAddress = u16GroupAddress;
+
+    sImageNotify.ePayloadType = E_CLD_OTA_ITYPE_MDID_FVERSION_JITTER;
+    sImageNotify.u8QueryJitter = OTA_MAX_QUERY_JITTER;
+    sImageNotify.u16ManufacturerCode = sOTAHeader.u16ManufacturerCode;
+    sImageNotify.u16ImageType = sOTAHeader.u16ImageType;
+    sImageNotify.u32NewFileVersion = sOTAHeader.u32FileVersion;
+    eZCL_Status = eOTA_ServerImageNotify(u8SourceEndpoint, u8DestinationEndpoint, &sZCL_Address, &sImageNotify);
+    if(eZCL_Status != E_ZCL_SUCCESS)
+    {
+        return eZCL_Status;
+    }
+
+    /* Only the upgrade image data is sent to the group, clients fetch the
+     * OTA header themselves while the start delay runs */
+    psMulticast = &psCustomData->sOTACallBackMessage.sMulticastServerParams;
+    psMulticast->u8SrcEndpoint = u8SourceEndpoint;
+    psMulticast->u8DstEndpoint = u8DestinationEndpoint;
+    psMulticast->u8ImageIndex = u8ImageIndex;
+    psMulticast->u8BlockSize = u8BlockSize;
+    psMulticast->u16GroupAddress = u16GroupAddress;
+    psMulticast->u16BlockSpacingMs = u16BlockSpacingMs;
+    psMulticast->u32DataStart = sOTAHeader.u16HeaderLength + OTA_TAG_HEADER_SIZE;
+    psMulticast->u32NextOffset = psMulticast->u32DataStart;
+
+    u32NumberOfBlocks = (sOTAHeader.u32TotalImage - psMulticast->u32DataStart + u8BlockSize - 1) / u8BlockSize;
+    psMulticast->u32EndTime = u32ZCL_GetUTCTime() + u16StartDelay +
+                              ((u32NumberOfBlocks * u16BlockSpacingMs) / 1000) + 1;
+    psMulticast->bActive = TRUE;
+
+    return eZCL_UpdateMsTimer(psEndPointDefinition, TRUE, (uint32)u16StartDelay * 1000 + OTA_MIN_TIMER_MS_RESOLUTION);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       eOTA_ServerMulticastStop
+ **
+ ** DESCRIPTION:
+ ** Ends a multicast session, clients then request the missing blocks
+ **
+ ** PARAMETERS:                 Name                           Usage
+ ** uint8                     u8SourceEndpoint              Source EP Id
+ **
+ ** RETURN:
+ ** teZCL_Status
+ ****************************************************************************/
+PUBLIC  teZCL_Status eOTA_ServerMulticastStop(
+                    uint8                     u8SourceEndpoint)
+{
+    teZCL_Status eZCL_Status;
+    tsZCL_ClusterInstance *psClusterInstance;
+    tsZCL_EndPointDefinition *psEndPointDefinition;
+    tsOTA_Common *psCustomData;
+
+    if((eZCL_Status =
+        eOtaFindCluster(u8SourceEndpoint,
+                         &psEndPointDefinition,
+                           &psClusterInstance,
+                           &psCustomData,
+                           TRUE))
+                           == E_ZCL_SUCCESS)
+    {
+        if(psCustomData->sOTACallBackMessage.sMulticastServerParams.bActive)
+        {
+            psCustomData->sOTACallBackMessage.sMulticastServerParams.bActive = FALSE;
+            eZCL_UpdateMsTimer(psEndPointDefinition, FALSE, 0);
+        }
+    }
+    return eZCL_Status;
+}
+#endif
 #endif
 /****************************************************************************/
 /***        Local Functions                                               ***/
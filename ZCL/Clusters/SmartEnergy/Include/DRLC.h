@@ -53,6 +53,15 @@ extern "C" {
 
 #define SE_DRLC_ISSUER_EVENT_ID                                 (0x0000)
 
+/* Define DRLC_DEADLINE_SCHEDULER to keep each event list ordered by the time
+ * at which its records next need attention (effective start for scheduled,
+ * effective end for active, effective cancel time for cancelled events).
+ * The scheduler then only looks at the list heads on each tick, and
+ * eSE_DRLCGetNextEventTime() returns the earliest of them, in ZCL UTC time,
+ * for the application's own wake-up scheduling. The ZCL UTC time only advances
+ * with E_ZCL_CBET_TIMER, so the ZCL must still be ticked every second.
+ */
+
 #ifndef SE_DRLC_NUMBER_OF_CLIENT_LOAD_CONTROL_ENTRIES
 #define SE_DRLC_NUMBER_OF_CLIENT_LOAD_CONTROL_ENTRIES           (3)
 #endif
@@ -427,6 +436,13 @@ PUBLIC teSE_DRLCStatus eSE_DRLCCancelLoadControlEventSend(
                     tsZCL_Address              *psDestinationAddress,
                     tsSE_DRLCCancelLoadControlEvent *psCancelLoadControlEvent,
                     uint8                      *pu8TransactionSequenceNumber);
+
+#ifdef DRLC_DEADLINE_SCHEDULER
+PUBLIC teSE_DRLCStatus eSE_DRLCGetNextEventTime(
+                    uint8                       u8SourceEndPointId,
+                    bool_t                      bIsServer,
+                    uint32                     *pu32NextEventTime);
+#endif
 /****************************************************************************/
 /***        Exported Variables                                            ***/
 /****************************************************************************/
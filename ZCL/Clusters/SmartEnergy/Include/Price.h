@@ -76,6 +76,35 @@ extern "C" {
 #define SE_PRICE_NUMBER_OF_CALORIFIC_VALUE_ENTRIES                     (2)
 #endif
 
+/* Define PRICE_DEADLINE_SCHEDULER to only run the price, block period,
+ * conversion factor and calorific value schedulers on endpoints registered
+ * with eSE_PriceRegisterSchedulerEndPoint(), and only once the earliest start
+ * or expiry held in their tables has been reached. The cached times are
+ * dropped when the ZCL UTC time goes backwards. eSE_PriceGetNextSchedulerUpdateTime()
+ * returns the earliest of them, in ZCL UTC time, for the application's own
+ * wake-up scheduling. The ZCL UTC time only advances with E_ZCL_CBET_TIMER, so
+ * the ZCL must still be ticked every second.
+ */
+#ifndef SE_PRICE_NUMBER_OF_SCHEDULER_ENDPOINTS
+#define SE_PRICE_NUMBER_OF_SCHEDULER_ENDPOINTS                         (2)
+#endif
+
+/* Define PRICE_TABLE_INDEX to keep a start time ordered index alongside the
+ * price, block period, conversion factor and calorific value tables so that
+ * look ups by start time or position, the Get Scheduled Prices / Get Block
+ * Periods / Get Conversion Factor / Get Calorific Value range scans and the
+ * insertion of published entries use a binary search instead of walking the
+ * table lists.
+ */
+#ifdef PRICE_TABLE_INDEX
+#define SE_PRICE_TABLE_INDEX_PRICE_ENTRIES                                                      \
+    ((SE_PRICE_NUMBER_OF_SERVER_PRICE_RECORD_ENTRIES > SE_PRICE_NUMBER_OF_CLIENT_PRICE_RECORD_ENTRIES) ? \
+      SE_PRICE_NUMBER_OF_SERVER_PRICE_RECORD_ENTRIES : SE_PRICE_NUMBER_OF_CLIENT_PRICE_RECORD_ENTRIES)
+#define SE_PRICE_TABLE_INDEX_BLOCK_PERIOD_ENTRIES                                               \
+    ((SE_PRICE_NUMBER_OF_SERVER_BLOCK_PERIOD_RECORD_ENTRIES > SE_PRICE_NUMBER_OF_CLIENT_BLOCK_PERIOD_RECORD_ENTRIES) ? \
+      SE_PRICE_NUMBER_OF_SERVER_BLOCK_PERIOD_RECORD_ENTRIES : SE_PRICE_NUMBER_OF_CLIENT_BLOCK_PERIOD_RECORD_ENTRIES)
+#endif
+
 
 #ifndef CLD_P_ATTR_TIER_PRICE_LABEL_MAX_COUNT
 #define CLD_P_ATTR_TIER_PRICE_LABEL_MAX_COUNT                          (0)
@@ -610,6 +639,22 @@ typedef struct{
     tsSE_PricePublishCalorificValueCmdPayload    sPublishCalorificValueCmdPayload;
 }tsSE_PriceCalorificValueRecord;
 
+#ifdef PRICE_TABLE_INDEX
+/* One entry of the start time ordered index kept over a table alloc list */
+typedef struct {
+    uint32                                      u32StartTime;
+    DNODE                                       *psNode;
+} tsSE_PriceTableIndexEntry;
+
+typedef struct {
+    bool_t                                      bValid;
+    uint8                                       u8NumberOfEntries;
+    uint8                                       u8MaxNumberOfEntries;
+    tsSE_PriceTableIndexEntry                   *psEntries;
+    uint32                                      (*pfnGetStartTime)(DNODE *psNode);
+} tsSE_PriceTableIndex;
+#endif
+
 // Definition of Price Callback Event Structure
 typedef struct {
    teSE_PriceStatus                             ePriceStatus;
@@ -707,6 +752,25 @@ typedef struct {
     tsSE_PriceCalorificValueRecord              *psPublishCalorificValueRecord;
     uint32                                      u32CalorificArrivalTimeOfStartNowEntry;
 #endif
+#ifdef PRICE_DEADLINE_SCHEDULER
+    uint32                                      u32NextSchedulerUpdateTime;
+#endif
+#ifdef PRICE_TABLE_INDEX
+    tsSE_PriceTableIndex                        sPriceIndex;
+    tsSE_PriceTableIndexEntry                   asPriceIndexEntries[SE_PRICE_TABLE_INDEX_PRICE_ENTRIES];
+#ifdef BLOCK_CHARGING
+    tsSE_PriceTableIndex                        sBlockPeriodIndex;
+    tsSE_PriceTableIndexEntry                   asBlockPeriodIndexEntries[SE_PRICE_TABLE_INDEX_BLOCK_PERIOD_ENTRIES];
+#endif
+#ifdef PRICE_CONVERSION_FACTOR
+    tsSE_PriceTableIndex                        sConversionFactorIndex;
+    tsSE_PriceTableIndexEntry                   asConversionFactorIndexEntries[SE_PRICE_NUMBER_OF_CONVERSION_FACTOR_ENTRIES];
+#endif
+#ifdef PRICE_CALORIFIC_VALUE
+    tsSE_PriceTableIndex                        sCalorificValueIndex;
+    tsSE_PriceTableIndexEntry                   asCalorificValueIndexEntries[SE_PRICE_NUMBER_OF_CALORIFIC_VALUE_ENTRIES];
+#endif
+#endif
 
 #ifdef SE_PRICE_SERVER_AUTO_UPDATES_PRICE_FROM_CURRENT_BLOCK_PERIOD_CONSUMPTION_DELIVERED
     struct CLD_Price_tag                        *psPriceAttributes;
@@ -1447,6 +1511,15 @@ PUBLIC teSE_PriceStatus eSE_GetNumberOfFreeConversionFactorTableEntries(
          uint8                          *pu8NumberOfEntries);
 #endif
 
+#ifdef PRICE_DEADLINE_SCHEDULER
+PUBLIC teSE_PriceStatus eSE_PriceRegisterSchedulerEndPoint(
+         uint8                          u8SourceEndPointId,
+         bool_t                         bIsServer);
+
+PUBLIC teSE_PriceStatus eSE_PriceGetNextSchedulerUpdateTime(
+         uint32                         *pu32NextUpdateTime);
+#endif
+
 
 
 
@@ -310,6 +310,70 @@ PUBLIC  uint32 boCancelTimeCheck(
 
 }
 
+#ifdef DRLC_DEADLINE_SCHEDULER
+/****************************************************************************
+ **
+ ** NAME:       u32SE_DRLCGetEventDeadline
+ **
+ ** DESCRIPTION:
+ ** Gets the time at which the scheduler next has to act on an event held on
+ ** the given list. The randomisation minutes are only ever set on a client,
+ ** so the record alone is enough to give the same times as the checks above.
+ **
+ ** PARAMETERS:                         Name                        Usage
+ ** tsSE_DRLCLoadControlEventRecord     *psLoadControlEventRecord   LC Record
+ ** teSE_DRLCEventList                   eEventList                 list holding the record
+ **
+ ** RETURN:
+ ** uint32 time
+ **
+ ****************************************************************************/
+
+PUBLIC  uint32 u32SE_DRLCGetEventDeadline(
+               tsSE_DRLCLoadControlEventRecord  *psLoadControlEventRecord,
+               teSE_DRLCEventList                eEventList)
+{
+    uint8 u8RandomizationTimeInMinutes=0;
+
+    switch(eEventList)
+    {
+        case(E_SE_DRLC_EVENT_LIST_SCHEDULED):
+        {
+            // effective start time
+            if(psLoadControlEventRecord->sLoadControlEvent.u8EventControl & SE_DRLC_CONTROL_RANDOMISATION_START_TIME_MASK)
+            {
+                u8RandomizationTimeInMinutes = psLoadControlEventRecord->u8StartRandomizationMinutes;
+            }
+            return psLoadControlEventRecord->sLoadControlEvent.u32StartTime + (u8RandomizationTimeInMinutes*60);
+        }
+        case(E_SE_DRLC_EVENT_LIST_ACTIVE):
+        {
+            // effective expiry time - as u32EffectiveDuration
+            u8RandomizationTimeInMinutes = psLoadControlEventRecord->u8StartRandomizationMinutes + psLoadControlEventRecord->u8DurationRandomizationMinutes;
+            return (psLoadControlEventRecord->sLoadControlEvent.u32StartTime +
+                   (psLoadControlEventRecord->sLoadControlEvent.u16DurationInMinutes + u8RandomizationTimeInMinutes)*60);
+        }
+        case(E_SE_DRLC_EVENT_LIST_CANCELLED):
+        {
+            // effective cancel time - as boCancelTimeCheck
+            if(psLoadControlEventRecord->eCancelControl == E_SE_DRLC_CANCEL_CONTROL_USE_RANDOMISATION)
+            {
+                u8RandomizationTimeInMinutes = psLoadControlEventRecord->u8StartRandomizationMinutes + psLoadControlEventRecord->u8DurationRandomizationMinutes;
+            }
+            return psLoadControlEventRecord->u32EffectiveCancelTime + u8RandomizationTimeInMinutes*60;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    // de-allocated records keep the nominal start time order
+    return psLoadControlEventRecord->sLoadControlEvent.u32StartTime;
+
+}
+#endif
+
 /****************************************************************************
  **
  ** NAME:       u32GetEffectiveStartTime
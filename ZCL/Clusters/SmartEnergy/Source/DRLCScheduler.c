@@ -147,6 +147,9 @@ PUBLIC  teSE_DRLCStatus eSE_DRLCSchedulerUpdate(
 {
 
     tsSE_DRLCLoadControlEventRecord *psLoadControlEventRecord;
+#ifdef DRLC_DEADLINE_SCHEDULER
+    tsSE_DRLCLoadControlEventRecord *psNextLoadControlEventRecord;
+#endif
 
     uint8  u8FindDRLCClusterReturn;
     tsSE_DRLCCustomDataStructure *psDRLCCustomDataStructure;
@@ -179,6 +182,15 @@ PUBLIC  teSE_DRLCStatus eSE_DRLCSchedulerUpdate(
     // search
     while(psLoadControlEventRecord != NULL)
     {
+#ifdef DRLC_DEADLINE_SCHEDULER
+        // list is in expiry order - nothing after this one has expired either
+        if(u32SE_DRLCGetEventDeadline(psLoadControlEventRecord, E_SE_DRLC_EVENT_LIST_ACTIVE) > u32UTCtime)
+        {
+            break;
+        }
+        // get next now as the record is about to be moved onto the free list
+        psNextLoadControlEventRecord = (tsSE_DRLCLoadControlEventRecord *)psDLISTgetNext((DNODE *)&psLoadControlEventRecord->dllrlcNode);
+#endif
         // have to full search the list as the random start/stop times can change results
         if(boEffectiveExpiredTimeCheck(psLoadControlEventRecord, psEndPointDefinition, psClusterInstance, u32UTCtime))
         {
@@ -215,7 +227,11 @@ PUBLIC  teSE_DRLCStatus eSE_DRLCSchedulerUpdate(
         }
 
         // get next resource from active list
+#ifdef DRLC_DEADLINE_SCHEDULER
+        psLoadControlEventRecord = psNextLoadControlEventRecord;
+#else
         psLoadControlEventRecord = (tsSE_DRLCLoadControlEventRecord *)psDLISTgetNext((DNODE *)&psLoadControlEventRecord->dllrlcNode);
+#endif
 
     }
 
@@ -224,6 +240,15 @@ PUBLIC  teSE_DRLCStatus eSE_DRLCSchedulerUpdate(
     // search
     while(psLoadControlEventRecord != NULL)
     {
+#ifdef DRLC_DEADLINE_SCHEDULER
+        // list is in effective start order - nothing after this one has started either
+        if(u32SE_DRLCGetEventDeadline(psLoadControlEventRecord, E_SE_DRLC_EVENT_LIST_SCHEDULED) > u32UTCtime)
+        {
+            break;
+        }
+        // get next now as the record is about to be moved onto the active or cancelled list
+        psNextLoadControlEventRecord = (tsSE_DRLCLoadControlEventRecord *)psDLISTgetNext((DNODE *)&psLoadControlEventRecord->dllrlcNode);
+#endif
         // have to full search the list as the random start/stop times can change results
         if(boInEffectiveActiveTimeCheck(psLoadControlEventRecord, psEndPointDefinition, psClusterInstance, u32UTCtime))
         {
@@ -243,7 +268,11 @@ PUBLIC  teSE_DRLCStatus eSE_DRLCSchedulerUpdate(
         }
 
         // get next resource from scheduled list
+#ifdef DRLC_DEADLINE_SCHEDULER
+        psLoadControlEventRecord = psNextLoadControlEventRecord;
+#else
         psLoadControlEventRecord = (tsSE_DRLCLoadControlEventRecord *)psDLISTgetNext((DNODE *)&psLoadControlEventRecord->dllrlcNode);
+#endif
     }
 
     // get first resource from cancel list
@@ -251,6 +280,15 @@ PUBLIC  teSE_DRLCStatus eSE_DRLCSchedulerUpdate(
     // search
     while(psLoadControlEventRecord != NULL)
     {
+#ifdef DRLC_DEADLINE_SCHEDULER
+        // list is in cancel time order - nothing after this one is due either
+        if(u32SE_DRLCGetEventDeadline(psLoadControlEventRecord, E_SE_DRLC_EVENT_LIST_CANCELLED) > u32UTCtime)
+        {
+            break;
+        }
+        // get next now as the record is about to be moved onto the free list
+        psNextLoadControlEventRecord = (tsSE_DRLCLoadControlEventRecord *)psDLISTgetNext((DNODE *)&psLoadControlEventRecord->dllrlcNode);
+#endif
         // have to full search the list as the random start/stop times can change results
         if(boCancelTimeCheck(psLoadControlEventRecord, psEndPointDefinition, psClusterInstance, u32UTCtime))
         {
@@ -273,7 +311,11 @@ PUBLIC  teSE_DRLCStatus eSE_DRLCSchedulerUpdate(
         }
 
         // get next resource from cancelled list
+#ifdef DRLC_DEADLINE_SCHEDULER
+        psLoadControlEventRecord = psNextLoadControlEventRecord;
+#else
         psLoadControlEventRecord = (tsSE_DRLCLoadControlEventRecord *)psDLISTgetNext((DNODE *)&psLoadControlEventRecord->dllrlcNode);
+#endif
     }
 
     // release EP
@@ -285,6 +327,91 @@ PUBLIC  teSE_DRLCStatus eSE_DRLCSchedulerUpdate(
     return(E_ZCL_SUCCESS);
 }
 
+#ifdef DRLC_DEADLINE_SCHEDULER
+/****************************************************************************
+ **
+ ** NAME:       eSE_DRLCGetNextEventTime
+ **
+ ** DESCRIPTION:
+ ** Gets the earliest time at which eSE_DRLCSchedulerUpdate has an event to
+ ** start, expire or cancel. The lists are held in deadline order so only
+ ** their heads are looked at.
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          Source EP Id
+ ** bool_t                      bIsServer                   Is server
+ ** uint32                     *pu32NextEventTime           next event time
+ **
+ ** RETURN:
+ ** teSE_DRLCStatus - E_SE_DRLC_EVENT_NOT_FOUND if no events are pending
+ **
+ ****************************************************************************/
+
+PUBLIC  teSE_DRLCStatus eSE_DRLCGetNextEventTime(
+                            uint8   u8SourceEndPointId,
+                            bool_t  bIsServer,
+                            uint32 *pu32NextEventTime)
+{
+    tsSE_DRLCLoadControlEventRecord *psLoadControlEventRecord;
+    teSE_DRLCEventList eEventList;
+    uint32 u32Deadline;
+    bool_t bFound = FALSE;
+
+    uint8  u8FindDRLCClusterReturn;
+    tsSE_DRLCCustomDataStructure *psDRLCCustomDataStructure;
+    tsZCL_EndPointDefinition *psEndPointDefinition;
+    tsZCL_ClusterInstance *psClusterInstance;
+    DLIST *plEventList;
+
+    #ifdef STRICT_PARAM_CHECK
+        if(pu32NextEventTime==NULL)
+        {
+            return E_ZCL_ERR_PARAMETER_NULL;
+        }
+    #endif
+
+    // error check via EP number
+    u8FindDRLCClusterReturn = eSE_DRLCFindDRLCCluster(u8SourceEndPointId, bIsServer, &psEndPointDefinition, &psClusterInstance, &psDRLCCustomDataStructure);
+    if(u8FindDRLCClusterReturn != E_ZCL_SUCCESS)
+    {
+        return u8FindDRLCClusterReturn;
+    }
+
+    // get EP mutex
+    #ifndef COOPERATIVE
+        eZCL_GetMutex(psEndPointDefinition);
+    #endif
+
+    *pu32NextEventTime = 0xffffffff;
+
+    for(eEventList = E_SE_DRLC_EVENT_LIST_SCHEDULED; eEventList < E_SE_DRLC_EVENT_LIST_DEALLOCATED; eEventList++)
+    {
+        psLoadControlEventRecord = psGetListHead(psDRLCCustomDataStructure, eEventList, &plEventList);
+        if(psLoadControlEventRecord != NULL)
+        {
+            u32Deadline = u32SE_DRLCGetEventDeadline(psLoadControlEventRecord, eEventList);
+            if(u32Deadline < *pu32NextEventTime)
+            {
+                *pu32NextEventTime = u32Deadline;
+            }
+            bFound = TRUE;
+        }
+    }
+
+    // release EP
+    #ifndef COOPERATIVE
+        eZCL_ReleaseMutex(psEndPointDefinition);
+    #endif
+
+    if(!bFound)
+    {
+        return E_SE_DRLC_EVENT_NOT_FOUND;
+    }
+
+    return(E_ZCL_SUCCESS);
+}
+#endif
+
 /****************************************************************************/
 /***        Local Functions                                               ***/
 /****************************************************************************/
@@ -893,6 +893,9 @@ PUBLIC  void vSimpleAddEventToScheduler(
     tsSE_DRLCLoadControlEventRecord *psHeadLoadControlEventRecord;
     DLIST *plToEventList;
     DLIST *plFromEventList;
+#ifdef DRLC_DEADLINE_SCHEDULER
+    uint32 u32Deadline;
+#endif
 
     // no list option
     if(eFromEventList== E_SE_DRLC_EVENT_LIST_NONE)
@@ -902,10 +905,18 @@ PUBLIC  void vSimpleAddEventToScheduler(
 
     psHeadLoadControlEventRecord = psGetListHead(psDRLCCustomDataStructure, eToEventList, &plToEventList);
 
+#ifdef DRLC_DEADLINE_SCHEDULER
+    // add in the order the scheduler will next need to act on the destination list
+    u32Deadline = u32SE_DRLCGetEventDeadline(psLoadControlEventRecord, eToEventList);
+    while((psHeadLoadControlEventRecord!=NULL) &&
+          (u32SE_DRLCGetEventDeadline(psHeadLoadControlEventRecord, eToEventList) < u32Deadline)
+    )
+#else
     // add in time order
     while((psHeadLoadControlEventRecord!=NULL) &&
           (psHeadLoadControlEventRecord->sLoadControlEvent.u32StartTime < psLoadControlEventRecord->sLoadControlEvent.u32StartTime)
     )
+#endif
     {
         // get next
         psHeadLoadControlEventRecord = (tsSE_DRLCLoadControlEventRecord *)psDLISTgetNext((DNODE *)psHeadLoadControlEventRecord);
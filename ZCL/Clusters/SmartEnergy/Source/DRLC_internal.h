@@ -174,6 +174,12 @@ PUBLIC uint32 boCancelTimeCheck(
                     tsZCL_ClusterInstance      *psClusterInstance,
                     uint32                      u32UTCtime);
 
+#ifdef DRLC_DEADLINE_SCHEDULER
+PUBLIC uint32 u32SE_DRLCGetEventDeadline(
+                    tsSE_DRLCLoadControlEventRecord *psLoadControlEventRecord,
+                    teSE_DRLCEventList           eEventList);
+#endif
+
 PUBLIC teSE_DRLCStatus eSE_DRLCFindDRLCCluster(
                     uint8                        u8SourceEndPointId,
                     bool_t                       bIsServer,
@@ -372,6 +372,20 @@ PUBLIC  teZCL_Status eSE_PriceCreate(
             return(E_ZCL_ERR_PARAMETER_RANGE);
         }
     }
+#endif
+#ifdef PRICE_TABLE_INDEX
+#ifdef PRICE_CONVERSION_FACTOR
+    if(SE_PRICE_NUMBER_OF_CONVERSION_FACTOR_ENTRIES < u8NumberOfConversionFactorRecordEntries)
+    {
+        return(E_ZCL_ERR_PARAMETER_RANGE);
+    }
+#endif
+#ifdef PRICE_CALORIFIC_VALUE
+    if(SE_PRICE_NUMBER_OF_CALORIFIC_VALUE_ENTRIES < u8NumberOfCalorificValueRecordEntries)
+    {
+        return(E_ZCL_ERR_PARAMETER_RANGE);
+    }
+#endif
 #endif
     // cluster data
     vZCL_InitializeClusterInstance(
@@ -424,6 +438,15 @@ PUBLIC  teZCL_Status eSE_PriceCreate(
     psCustomDataStructure->psPublishBlockPeriodRecord =  psPublishBlockPeriodRecord;
 #endif /* BLOCK_CHARGING */
 
+#ifdef PRICE_DEADLINE_SCHEDULER
+    // nothing scheduled yet - look at the tables on the first tick
+    psCustomDataStructure->u32NextSchedulerUpdateTime = 0;
+#endif
+
+#ifdef PRICE_TABLE_INDEX
+    vSE_PriceTableIndexInit(psCustomDataStructure);
+#endif
+
     /* initialise lists for Tier */
     vDLISTinitialise(&psCustomDataStructure->lPriceAllocList);
     vDLISTinitialise(&psCustomDataStructure->lPriceDeAllocList);
@@ -58,7 +58,9 @@
 
 #ifdef BLOCK_CHARGING
 
+#ifndef PRICE_TABLE_INDEX
 PRIVATE bool_t boSearchForExisting( void *pvSearchParam, void *psNodeUnderTest);
+#endif
 
 PRIVATE teSE_PriceStatus eSE_CheckForTableOverlap(
                 tsSE_PriceCustomDataStructure              *psPriceCustomDataStructure,
@@ -253,7 +255,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetBlockPeriodEntry(
             tsSE_PricePublishBlockPeriodCmdPayload    **ppsPublishBlockPeriodCmdPayload )
 
 {
+#ifndef PRICE_TABLE_INDEX
     uint8 u8Index;
+#endif
 
     tsSE_PricePublishBlockPeriodRecord *psPublishBlockPeriodRecord;
 
@@ -281,6 +285,11 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetBlockPeriodEntry(
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psSE_PriceTableIndexGetEntry(&psPriceCustomDataStructure->sBlockPeriodIndex,
+                                                                                                   &psPriceCustomDataStructure->lBlockPeriodAllocList,
+                                                                                                   u8tableIndex);
+#else
     // get start of list
     psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lBlockPeriodAllocList);
 
@@ -291,6 +300,7 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetBlockPeriodEntry(
         psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psDLISTgetNext((DNODE *)psPublishBlockPeriodRecord);
         u8Index++;
     }
+#endif
 
     if(psPublishBlockPeriodRecord==NULL)
     {
@@ -360,9 +370,15 @@ PUBLIC  teSE_PriceStatus eSE_PriceRemoveBlockPeriodEntry(
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psSE_PriceTableIndexFind(&psPriceCustomDataStructure->sBlockPeriodIndex,
+                                                                                               &psPriceCustomDataStructure->lBlockPeriodAllocList,
+                                                                                               u32StartTime);
+#else
     // search through alloc list
     psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lBlockPeriodAllocList );
     psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psDLISTsearchForward((DNODE *)psPublishBlockPeriodRecord, boSearchForExisting, (void *)&u32StartTime);
+#endif
 
     if(psPublishBlockPeriodRecord==NULL)
     {
@@ -378,6 +394,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceRemoveBlockPeriodEntry(
     psDLISTremove(&psPriceCustomDataStructure->lBlockPeriodAllocList, (DNODE *)psPublishBlockPeriodRecord);
     // add to dealloc list
     vDLISTaddToTail(&psPriceCustomDataStructure->lBlockPeriodDeAllocList, (DNODE *)(psPublishBlockPeriodRecord));
+#ifdef PRICE_TABLE_INDEX
+    psPriceCustomDataStructure->sBlockPeriodIndex.bValid = FALSE;
+#endif
 
     // release EP
     #ifndef COOPERATIVE
@@ -427,10 +446,16 @@ PUBLIC  teSE_PriceStatus eSE_PriceDoesBlockPeriodEntryExist(uint8 u8SourceEndPoi
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psSE_PriceTableIndexFind(&psPriceCustomDataStructure->sBlockPeriodIndex,
+                                                                                               &psPriceCustomDataStructure->lBlockPeriodAllocList,
+                                                                                               u32StartTime);
+#else
     // search through alloc list
     psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psDLISTgetHead(&psPriceCustomDataStructure->lBlockPeriodAllocList);
     // search list for old entry
     psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psDLISTsearchForward((DNODE *)psPublishBlockPeriodRecord, boSearchForExisting, (void *)&u32StartTime);
+#endif
 
     if(psPublishBlockPeriodRecord==NULL)
     {
@@ -499,6 +524,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceClearAllBlockPeriodEntries(uint8 u8SourceEndPo
             vDLISTaddToTail(&psPriceCustomDataStructure->lBlockPeriodDeAllocList, (DNODE *)(psPublishBlockPeriodRecord));
         }
     } while(psPublishBlockPeriodRecord!=NULL);
+#ifdef PRICE_TABLE_INDEX
+    psPriceCustomDataStructure->sBlockPeriodIndex.bValid = FALSE;
+#endif
 
     // release EP
     #ifndef COOPERATIVE
@@ -540,6 +568,11 @@ PUBLIC  teSE_PriceStatus eSE_AddBlockPeriodEntryUsingPointer(
     teSE_PriceStatus eStatus;
     bool_t bAddThresholds = FALSE;
 
+#ifdef PRICE_DEADLINE_SCHEDULER
+    // table is about to change - have the scheduler look at it on the next tick
+    psPriceCustomDataStructure->u32NextSchedulerUpdateTime = 0;
+#endif
+
     ////////////////////////////////////////////////////////////////////////
     // Initial checks and setup
     ////////////////////////////////////////////////////////////////////////
@@ -567,6 +600,15 @@ PUBLIC  teSE_PriceStatus eSE_AddBlockPeriodEntryUsingPointer(
     {
         bAddThresholds = TRUE;  /* Add thresholds to the Attr Record */
     }
+#ifdef PRICE_TABLE_INDEX
+    psPreviousPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psSE_PriceTableIndexSearch(&psPriceCustomDataStructure->sBlockPeriodIndex,
+                                                                                                         &psPriceCustomDataStructure->lBlockPeriodAllocList,
+                                                                                                         psPublishBlockPeriodCmdPayload->u32BlockPeriodStartTime);
+    if(psPreviousPublishBlockPeriodRecord != NULL)
+    {
+        psNextPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord*)(psPreviousPublishBlockPeriodRecord->dllBlockPeriodNode.psNext);
+    }
+#else
     // No need to make adjustment for start time of zero here as we want 0 to always be first in the search
     while(  (psNextPublishBlockPeriodRecord != NULL) &&
             (psNextPublishBlockPeriodRecord->sPublishBlockPeriodCmdPayload.u32BlockPeriodStartTime <= psPublishBlockPeriodCmdPayload->u32BlockPeriodStartTime))
@@ -574,6 +616,7 @@ PUBLIC  teSE_PriceStatus eSE_AddBlockPeriodEntryUsingPointer(
         psPreviousPublishBlockPeriodRecord = psNextPublishBlockPeriodRecord;
         psNextPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord*)(psNextPublishBlockPeriodRecord->dllBlockPeriodNode.psNext);
     }
+#endif
 
     // Does new event overlap
     eStatus = eSE_CheckForTableOverlap(psPriceCustomDataStructure, psNextPublishBlockPeriodRecord,
@@ -643,6 +686,9 @@ PUBLIC  teSE_PriceStatus eSE_AddBlockPeriodEntryUsingPointer(
             // Delete the previous record
             psDLISTremove(&psPriceCustomDataStructure->lBlockPeriodAllocList, (DNODE *)psPreviousPublishBlockPeriodRecord);
             vDLISTaddToHead(&psPriceCustomDataStructure->lBlockPeriodDeAllocList, (DNODE *)psPreviousPublishBlockPeriodRecord);
+#ifdef PRICE_TABLE_INDEX
+            psPriceCustomDataStructure->sBlockPeriodIndex.bValid = FALSE;
+#endif
         }
     }
 
@@ -671,6 +717,9 @@ PUBLIC  teSE_PriceStatus eSE_AddBlockPeriodEntryUsingPointer(
             psNextPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord*)(pTempNode->psNext);
             psDLISTremove(&psPriceCustomDataStructure->lBlockPeriodAllocList, pTempNode);
             vDLISTaddToHead(&psPriceCustomDataStructure->lBlockPeriodDeAllocList, pTempNode);
+#ifdef PRICE_TABLE_INDEX
+            psPriceCustomDataStructure->sBlockPeriodIndex.bValid = FALSE;
+#endif
         }
     }
     while(eStatus != E_ZCL_SUCCESS);
@@ -698,6 +747,9 @@ PUBLIC  teSE_PriceStatus eSE_AddBlockPeriodEntryUsingPointer(
         // remove tail from alloc and put it back on the free list
         psDLISTremove(&psPriceCustomDataStructure->lBlockPeriodAllocList, (DNODE *)psPublishBlockPeriodRecord);
         vDLISTaddToHead(&psPriceCustomDataStructure->lBlockPeriodDeAllocList, (DNODE *)psPublishBlockPeriodRecord);
+#ifdef PRICE_TABLE_INDEX
+        psPriceCustomDataStructure->sBlockPeriodIndex.bValid = FALSE;
+#endif
         // try to add again
         eStatus = eSE_AddBlockPeriodEntryUsingPointer(u8SourceEndPointId, bIsServer, psPriceCustomDataStructure, bOverwritePrevious,
                 psPublishBlockPeriodCmdPayload, psBlockThresholds);
@@ -706,6 +758,9 @@ PUBLIC  teSE_PriceStatus eSE_AddBlockPeriodEntryUsingPointer(
             // restore last table back
             psDLISTremove(&psPriceCustomDataStructure->lBlockPeriodDeAllocList, (DNODE *)psPublishBlockPeriodRecord);
             vDLISTaddToTail(&psPriceCustomDataStructure->lBlockPeriodAllocList, (DNODE *)psPublishBlockPeriodRecord);
+#ifdef PRICE_TABLE_INDEX
+            psPriceCustomDataStructure->sBlockPeriodIndex.bValid = FALSE;
+#endif
             return eStatus;
         }
 
@@ -735,6 +790,9 @@ PUBLIC  teSE_PriceStatus eSE_AddBlockPeriodEntryUsingPointer(
 
        vCopyRecordIntoTable(psNewPublishBlockPeriodRecord, psPublishBlockPeriodCmdPayload,
                 psBlockThresholds);
+#ifdef PRICE_TABLE_INDEX
+    vSE_PriceTableIndexInsert(&psPriceCustomDataStructure->sBlockPeriodIndex, (DNODE *)psNewPublishBlockPeriodRecord);
+#endif
 
     // If we have just inserted a start time of now - update the Arrived fields
     if (psNewPublishBlockPeriodRecord->sPublishBlockPeriodCmdPayload.u32BlockPeriodStartTime == 0)
@@ -840,6 +898,7 @@ PRIVATE  teSE_PriceStatus eSE_CheckForTableOverlap(
     return(E_ZCL_SUCCESS);
 }
 
+#ifndef PRICE_TABLE_INDEX
 /****************************************************************************
  **
  ** NAME:       boSearchForExisting
@@ -875,6 +934,7 @@ PRIVATE  bool_t boSearchForExisting( void *pvSearchParam, void *psNodeUnderTest)
 
     return FALSE;
 }
+#endif
 
 /****************************************************************************
  **
@@ -44,7 +44,9 @@
 
 #ifdef PRICE_CALORIFIC_VALUE
 
+#ifndef PRICE_TABLE_INDEX
 PRIVATE bool_t boSearchForExisting( void *pvSearchParam, void *psNodeUnderTest);
+#endif
 PRIVATE void vCopyRecordIntoTable(tsSE_PriceCalorificValueRecord  *psTablePublishBlockPeriod,tsSE_PricePublishCalorificValueCmdPayload      *psPublishCalorificValueCmdPayload);
 
 
@@ -152,7 +154,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetCalorificValueEntry(uint8  u8SourceEndPoint
                                                                                 tsSE_PricePublishCalorificValueCmdPayload    **ppsPublishCalorificValueCmdPayload )
 
 {
+#ifndef PRICE_TABLE_INDEX
     uint8 u8Index;
+#endif
     tsSE_PriceCalorificValueRecord *psPublishCalorificValueRecord;
     teSE_PriceStatus eFindPriceClusterReturn;
     tsZCL_ClusterInstance *psClusterInstance;
@@ -178,6 +182,11 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetCalorificValueEntry(uint8  u8SourceEndPoint
         eZCL_GetMutex(psEndPointDefinition);
     #endif
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psSE_PriceTableIndexGetEntry(&psPriceCustomDataStructure->sCalorificValueIndex,
+                                                                                                   &psPriceCustomDataStructure->lCalorificValueAllocList,
+                                                                                                   u8tableIndex);
+#else
     // get start of list
     psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lCalorificValueAllocList);
     u8Index=0;
@@ -188,6 +197,7 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetCalorificValueEntry(uint8  u8SourceEndPoint
         psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTgetNext((DNODE *)psPublishCalorificValueRecord);
         u8Index++;
     }
+#endif
 
     if(psPublishCalorificValueRecord==NULL)
     {
@@ -259,9 +269,15 @@ PUBLIC  teSE_PriceStatus eSE_PriceRemoveCalorificValueEntry(
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psSE_PriceTableIndexFind(&psPriceCustomDataStructure->sCalorificValueIndex,
+                                                                                               &psPriceCustomDataStructure->lCalorificValueAllocList,
+                                                                                               u32StartTime);
+#else
     // search through alloc list
     psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lCalorificValueAllocList );
     psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTsearchForward((DNODE *)psPublishCalorificValueRecord, boSearchForExisting, (void *)&u32StartTime);
+#endif
 
     if(psPublishCalorificValueRecord==NULL)
     {
@@ -277,6 +293,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceRemoveCalorificValueEntry(
     psDLISTremove(&psPriceCustomDataStructure->lCalorificValueAllocList, (DNODE *)psPublishCalorificValueRecord);
     // add to dealloc list
     vDLISTaddToTail(&psPriceCustomDataStructure->lCalorificValueDeAllocList, (DNODE *)(psPublishCalorificValueRecord));
+#ifdef PRICE_TABLE_INDEX
+    psPriceCustomDataStructure->sCalorificValueIndex.bValid = FALSE;
+#endif
 
     // release EP
     #ifndef COOPERATIVE
@@ -328,10 +347,16 @@ PUBLIC  teSE_PriceStatus eSE_PriceDoesCalorificValueEntryExist(uint8 u8SourceEnd
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psSE_PriceTableIndexFind(&psPriceCustomDataStructure->sCalorificValueIndex,
+                                                                                               &psPriceCustomDataStructure->lCalorificValueAllocList,
+                                                                                               u32StartTime);
+#else
     // search through alloc list
     psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTgetHead(&psPriceCustomDataStructure->lCalorificValueAllocList);
     // search list for old entry
     psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTsearchForward((DNODE *)psPublishCalorificValueRecord, boSearchForExisting, (void *)&u32StartTime);
+#endif
 
     if(psPublishCalorificValueRecord==NULL)
     {
@@ -402,6 +427,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceClearAllCalorificValueEntries(uint8 u8SourceEn
                 vDLISTaddToTail(&psPriceCustomDataStructure->lCalorificValueDeAllocList, (DNODE *)(psPublishCalorificValueRecord));
             }
         } while(psPublishCalorificValueRecord!=NULL);
+#ifdef PRICE_TABLE_INDEX
+    psPriceCustomDataStructure->sCalorificValueIndex.bValid = FALSE;
+#endif
 
     // release EP
     #ifndef COOPERATIVE
@@ -441,6 +469,12 @@ PUBLIC  teSE_PriceStatus eSE_AddCalorificValueEntryUsingPointer(
                                        *psPreviousPublishCalorificValueRecord, *psNewPublishCalorificValueRecord;
     teSE_PriceStatus eStatus;
     bool_t              bEqualNodeFound=FALSE;
+
+#ifdef PRICE_DEADLINE_SCHEDULER
+    // table is about to change - have the scheduler look at it on the next tick
+    psPriceCustomDataStructure->u32NextSchedulerUpdateTime = 0;
+#endif
+
     psPreviousPublishCalorificValueRecord = NULL;
 
     psNextPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lCalorificValueAllocList );
@@ -464,6 +498,9 @@ PUBLIC  teSE_PriceStatus eSE_AddCalorificValueEntryUsingPointer(
                  psDLISTremove(&psPriceCustomDataStructure->lCalorificValueAllocList, (DNODE *) psNextPublishCalorificValueRecord);
                  vDLISTaddToTail(&psPriceCustomDataStructure->lCalorificValueDeAllocList, (DNODE *)(psNextPublishCalorificValueRecord));
                  bEqualNodeFound = TRUE;
+#ifdef PRICE_TABLE_INDEX
+                 psPriceCustomDataStructure->sCalorificValueIndex.bValid = FALSE;
+#endif
                  break;
             }
 
@@ -493,6 +530,9 @@ PUBLIC  teSE_PriceStatus eSE_AddCalorificValueEntryUsingPointer(
 
         psDLISTremove(&psPriceCustomDataStructure->lCalorificValueAllocList, (DNODE *)psPublishCalorificValueRecord);
         vDLISTaddToHead(&psPriceCustomDataStructure->lCalorificValueDeAllocList, (DNODE *)psPublishCalorificValueRecord);
+#ifdef PRICE_TABLE_INDEX
+        psPriceCustomDataStructure->sCalorificValueIndex.bValid = FALSE;
+#endif
 
        eStatus = eSE_AddCalorificValueEntryUsingPointer(u8SourceEndPointId, bIsServer, psPriceCustomDataStructure, bOverwritePrevious,
                                                             psPublishCalorificValueCmdPayload);
@@ -502,6 +542,9 @@ PUBLIC  teSE_PriceStatus eSE_AddCalorificValueEntryUsingPointer(
             // restore last table back
             psDLISTremove(&psPriceCustomDataStructure->lCalorificValueDeAllocList, (DNODE *)psPublishCalorificValueRecord);
             vDLISTaddToTail(&psPriceCustomDataStructure->lCalorificValueAllocList, (DNODE *)psPublishCalorificValueRecord);
+#ifdef PRICE_TABLE_INDEX
+            psPriceCustomDataStructure->sCalorificValueIndex.bValid = FALSE;
+#endif
             return eStatus;
         }
 
@@ -519,7 +562,7 @@ PUBLIC  teSE_PriceStatus eSE_AddCalorificValueEntryUsingPointer(
     }
     else if( bEqualNodeFound )
     {
-         vDLISTaddToTail(&psPriceCustomDataStructure->lCalorificValueAllocList, (DNODE*) psNewPublishCalorificValueRecord);
+         vDLISTaddToHead(&psPriceCustomDataStructure->lCalorificValueAllocList, (DNODE*) psNewPublishCalorificValueRecord);
     }
     else
     {
@@ -535,6 +578,9 @@ PUBLIC  teSE_PriceStatus eSE_AddCalorificValueEntryUsingPointer(
     }
 
     vCopyRecordIntoTable(psNewPublishCalorificValueRecord, psPublishCalorificValueCmdPayload);
+#ifdef PRICE_TABLE_INDEX
+    vSE_PriceTableIndexInsert(&psPriceCustomDataStructure->sCalorificValueIndex, (DNODE *)psNewPublishCalorificValueRecord);
+#endif
     // If we have just inserted a start time of now - update the Arrived fields
     if (psNewPublishCalorificValueRecord->sPublishCalorificValueCmdPayload.u32StartTime == 0)
     {
@@ -544,6 +590,7 @@ PUBLIC  teSE_PriceStatus eSE_AddCalorificValueEntryUsingPointer(
 }
 
 
+#ifndef PRICE_TABLE_INDEX
 /****************************************************************************
  **
  ** NAME:       boSearchForExisting
@@ -579,6 +626,7 @@ PRIVATE  bool_t boSearchForExisting( void *pvSearchParam, void *psNodeUnderTest)
 
     return FALSE;
 }
+#endif
 
 /****************************************************************************
  **
@@ -43,7 +43,9 @@
 
 #ifdef PRICE_CONVERSION_FACTOR
 
+#ifndef PRICE_TABLE_INDEX
 PRIVATE bool_t boSearchForExisting( void *pvSearchParam, void *psNodeUnderTest);
+#endif
 
 PRIVATE void vCopyRecordIntoTable(
         tsSE_PriceConversionFactorRecord          *psTablePublishBlockPeriod,
@@ -166,7 +168,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetConversionFactorEntry(
                     uint8                       u8tableIndex,
                     tsSE_PricePublishConversionCmdPayload    **ppsPublishConversionCmdPayload)
 {
+#ifndef PRICE_TABLE_INDEX
     uint8 u8Index;
+#endif
     tsSE_PriceConversionFactorRecord *psPublishConversionFactorRecord;
     teSE_PriceStatus eFindPriceClusterReturn;
     tsZCL_ClusterInstance *psClusterInstance;
@@ -193,6 +197,11 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetConversionFactorEntry(
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psSE_PriceTableIndexGetEntry(&psPriceCustomDataStructure->sConversionFactorIndex,
+                                                                                                       &psPriceCustomDataStructure->lConversionFactorAllocList,
+                                                                                                       u8tableIndex);
+#else
     // get start of list
     psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lConversionFactorAllocList);
 
@@ -204,6 +213,7 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetConversionFactorEntry(
         psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psDLISTgetNext((DNODE *)psPublishConversionFactorRecord);
         u8Index++;
     }
+#endif
 
     if(psPublishConversionFactorRecord==NULL)
     {
@@ -271,9 +281,15 @@ PUBLIC  teSE_PriceStatus eSE_PriceRemoveConversionFactorEntry(
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psSE_PriceTableIndexFind(&psPriceCustomDataStructure->sConversionFactorIndex,
+                                                                                                   &psPriceCustomDataStructure->lConversionFactorAllocList,
+                                                                                                   u32StartTime);
+#else
     // search through alloc list
     psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lConversionFactorAllocList );
     psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psDLISTsearchForward((DNODE *)psPublishConversionFactorRecord, boSearchForExisting, (void *)&u32StartTime);
+#endif
 
     if(psPublishConversionFactorRecord==NULL)
     {
@@ -289,6 +305,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceRemoveConversionFactorEntry(
     psDLISTremove(&psPriceCustomDataStructure->lConversionFactorAllocList, (DNODE *)psPublishConversionFactorRecord);
     // add to dealloc list
     vDLISTaddToTail(&psPriceCustomDataStructure->lConversionFactorDeAllocList, (DNODE *)(psPublishConversionFactorRecord));
+#ifdef PRICE_TABLE_INDEX
+    psPriceCustomDataStructure->sConversionFactorIndex.bValid = FALSE;
+#endif
 
     // release EP
     #ifndef COOPERATIVE
@@ -340,10 +359,16 @@ PUBLIC  teSE_PriceStatus eSE_PriceDoesConversionFactorEntryExist(
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psSE_PriceTableIndexFind(&psPriceCustomDataStructure->sConversionFactorIndex,
+                                                                                                   &psPriceCustomDataStructure->lConversionFactorAllocList,
+                                                                                                   u32StartTime);
+#else
     // search through alloc list
     psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psDLISTgetHead(&psPriceCustomDataStructure->lConversionFactorAllocList);
     // search list for old entry
     psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psDLISTsearchForward((DNODE *)psPublishConversionFactorRecord, boSearchForExisting, (void *)&u32StartTime);
+#endif
 
     if(psPublishConversionFactorRecord==NULL)
     {
@@ -413,6 +438,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceClearAllConversionFactorEntries(
                 vDLISTaddToTail(&psPriceCustomDataStructure->lConversionFactorDeAllocList, (DNODE *)(psPublishConversionFactorRecord));
             }
         } while(psPublishConversionFactorRecord!=NULL);
+#ifdef PRICE_TABLE_INDEX
+    psPriceCustomDataStructure->sConversionFactorIndex.bValid = FALSE;
+#endif
 
     // release EP
     #ifndef COOPERATIVE
@@ -434,6 +462,12 @@ PUBLIC  teSE_PriceStatus eSE_AddConversionFactorUsingPointer(
                                        *psPreviousPublishConversionFactorRecord, *psNewPublishConversionFactorRecord;
     teSE_PriceStatus eStatus;
     bool_t              bEqualNodeFound=FALSE;
+
+#ifdef PRICE_DEADLINE_SCHEDULER
+    // table is about to change - have the scheduler look at it on the next tick
+    psPriceCustomDataStructure->u32NextSchedulerUpdateTime = 0;
+#endif
+
     psPreviousPublishConversionFactorRecord = NULL;
 
     psNextPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lConversionFactorAllocList );
@@ -455,6 +489,9 @@ PUBLIC  teSE_PriceStatus eSE_AddConversionFactorUsingPointer(
                  psDLISTremove(&psPriceCustomDataStructure->lConversionFactorAllocList, (DNODE *) psNextPublishConversionFactorRecord);
                  vDLISTaddToTail(&psPriceCustomDataStructure->lConversionFactorDeAllocList, (DNODE *)(psNextPublishConversionFactorRecord));
                  bEqualNodeFound = TRUE;
+#ifdef PRICE_TABLE_INDEX
+                 psPriceCustomDataStructure->sConversionFactorIndex.bValid = FALSE;
+#endif
                  break;
             }
 
@@ -481,6 +518,9 @@ PUBLIC  teSE_PriceStatus eSE_AddConversionFactorUsingPointer(
 
        psDLISTremove(&psPriceCustomDataStructure->lConversionFactorAllocList, (DNODE *)psPublishConversionFactorRecord);
        vDLISTaddToHead(&psPriceCustomDataStructure->lConversionFactorDeAllocList, (DNODE *)psPublishConversionFactorRecord);
+#ifdef PRICE_TABLE_INDEX
+       psPriceCustomDataStructure->sConversionFactorIndex.bValid = FALSE;
+#endif
 
        eStatus = eSE_AddConversionFactorUsingPointer(u8SourceEndPointId, bIsServer, psPriceCustomDataStructure, bOverwritePrevious,
                                                             psPublishConversionCmdPayload);
@@ -490,6 +530,9 @@ PUBLIC  teSE_PriceStatus eSE_AddConversionFactorUsingPointer(
             // restore last table back
             psDLISTremove(&psPriceCustomDataStructure->lConversionFactorDeAllocList, (DNODE *)psPublishConversionFactorRecord);
             vDLISTaddToTail(&psPriceCustomDataStructure->lConversionFactorAllocList, (DNODE *)psPublishConversionFactorRecord);
+#ifdef PRICE_TABLE_INDEX
+            psPriceCustomDataStructure->sConversionFactorIndex.bValid = FALSE;
+#endif
             return eStatus;
         }
 
@@ -507,7 +550,7 @@ PUBLIC  teSE_PriceStatus eSE_AddConversionFactorUsingPointer(
     }
     else if( bEqualNodeFound )
     {
-        vDLISTaddToTail(&psPriceCustomDataStructure->lConversionFactorAllocList, (DNODE *)psNewPublishConversionFactorRecord);
+        vDLISTaddToHead(&psPriceCustomDataStructure->lConversionFactorAllocList, (DNODE *)psNewPublishConversionFactorRecord);
     }
     else
     {
@@ -523,10 +566,14 @@ PUBLIC  teSE_PriceStatus eSE_AddConversionFactorUsingPointer(
     }
 
     vCopyRecordIntoTable(psNewPublishConversionFactorRecord, psPublishConversionCmdPayload);
+#ifdef PRICE_TABLE_INDEX
+    vSE_PriceTableIndexInsert(&psPriceCustomDataStructure->sConversionFactorIndex, (DNODE *)psNewPublishConversionFactorRecord);
+#endif
 
     return(E_ZCL_SUCCESS);
 }
 
+#ifndef PRICE_TABLE_INDEX
 /****************************************************************************
  **
  ** NAME:       boSearchForExisting
@@ -562,6 +609,7 @@ PRIVATE  bool_t boSearchForExisting( void *pvSearchParam, void *psNodeUnderTest)
 
     return FALSE;
 }
+#endif
 
 /****************************************************************************
  **
@@ -299,6 +299,21 @@ PUBLIC  void vSE_HandleGetSheduledPrices(
 
     // get head of alloc list - this is always the current price
     psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lPriceAllocList );
+#ifdef PRICE_TABLE_INDEX
+    // entries ahead of the last one starting before u32StartTime have ended by then - skip them
+    if(u32StartTime != 0)
+    {
+        tsSE_PricePublishPriceRecord *psFirstPublishPriceRecord;
+
+        psFirstPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psSE_PriceTableIndexSearch(&psPriceCustomDataStructure->sPriceIndex,
+                                                                                              &psPriceCustomDataStructure->lPriceAllocList,
+                                                                                              u32StartTime - 1);
+        if(psFirstPublishPriceRecord != NULL)
+        {
+            psPublishPriceRecord = psFirstPublishPriceRecord;
+        }
+    }
+#endif
 
     // loop round event list until u8NumberOfEvents satisfied or list fully searched
     // psPublishPriceRecord == NULL will fall through - that is OK
@@ -415,6 +430,21 @@ PUBLIC  void vSE_HandleGetBlockPeriods(
 
     // get head of alloc list - this is always the current block period
     psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lBlockPeriodAllocList );
+#ifdef PRICE_TABLE_INDEX
+    // entries ahead of the last one starting before u32StartTime have ended by then - skip them
+    if(u32StartTime != 0)
+    {
+        tsSE_PricePublishBlockPeriodRecord *psFirstPublishBlockPeriodRecord;
+
+        psFirstPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psSE_PriceTableIndexSearch(&psPriceCustomDataStructure->sBlockPeriodIndex,
+                                                                                                          &psPriceCustomDataStructure->lBlockPeriodAllocList,
+                                                                                                          u32StartTime - 1);
+        if(psFirstPublishBlockPeriodRecord != NULL)
+        {
+            psPublishBlockPeriodRecord = psFirstPublishBlockPeriodRecord;
+        }
+    }
+#endif
 
     // loop round event list until u8NumberOfEvents satisfied or list fully searched
     // psPublishBlockPeriodRecord == NULL will fall through - that is OK
@@ -530,6 +560,21 @@ PUBLIC  void vSE_HandleGetCalorificValue(
 
     // get head of alloc list - this is always the current calorific value
     psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lCalorificValueAllocList );
+#ifdef PRICE_TABLE_INDEX
+    // only a start now head entry can qualify ahead of the first entry starting at or after u32StartTime
+    if(u32StartTime != 0)
+    {
+        tsSE_PriceCalorificValueRecord *psLastPublishCalorificValueRecord;
+
+        psLastPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psSE_PriceTableIndexSearch(&psPriceCustomDataStructure->sCalorificValueIndex,
+                                                                                                        &psPriceCustomDataStructure->lCalorificValueAllocList,
+                                                                                                        u32StartTime - 1);
+        if((psLastPublishCalorificValueRecord != NULL) && (psLastPublishCalorificValueRecord != psPublishCalorificValueRecord))
+        {
+            psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTgetNext((DNODE *)psLastPublishCalorificValueRecord);
+        }
+    }
+#endif
 
 
     // loop round event list until u8NumberOfEvents satisfied or list fully searched
@@ -674,6 +719,15 @@ PUBLIC  void vSE_HandleGetConversionFactor(
     if(u32StartTime == 0 && u8NumberEvents != 0 )
         u32StartTime = u32ZCL_GetUTCTime();
 
+#ifdef PRICE_TABLE_INDEX
+    // The last node with start time less than the passed start time is the node that is active at the mentioned start time.
+    if(u32StartTime != 0)
+    {
+        psPrevPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psSE_PriceTableIndexSearch(&psPriceCustomDataStructure->sConversionFactorIndex,
+                                                                                                            &psPriceCustomDataStructure->lConversionFactorAllocList,
+                                                                                                            u32StartTime - 1);
+    }
+#else
     // We iterate over the L.L to find the last node with start time less than the passed start time, this will be the node
     // that is active at the mentioned start time.
     while(psPublishConversionFactorRecord != NULL && (psPublishConversionFactorRecord->sPublishConversionCmdPayload.u32StartTime < u32StartTime))
@@ -681,6 +735,7 @@ PUBLIC  void vSE_HandleGetConversionFactor(
         psPrevPublishConversionFactorRecord = psPublishConversionFactorRecord;
         psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psDLISTgetNext((DNODE *)psPublishConversionFactorRecord);
     }
+#endif
 
     // If we have found atleast one record with start time less, is the active record
     if( psPrevPublishConversionFactorRecord != NULL )
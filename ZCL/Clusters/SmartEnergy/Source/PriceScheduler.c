@@ -51,10 +51,36 @@
 /***        Type Definitions                                              ***/
 /****************************************************************************/
 
+#ifdef PRICE_DEADLINE_SCHEDULER
+typedef struct
+{
+    uint8                           u8EndPointId;
+    bool_t                          bIsServer;
+    tsZCL_EndPointDefinition        *psEndPointDefinition;
+    tsSE_PriceCustomDataStructure   *psPriceCustomDataStructure;
+} tsSE_PriceSchedulerEndPoint;
+#endif
+
 /****************************************************************************/
 /***        Local Function Prototypes                                     ***/
 /****************************************************************************/
 
+PRIVATE void vSE_PriceSchedulerUpdateEndPoint(
+                                uint8   u8SourceEndPointId,
+                                bool_t  bIsServer,
+                                uint32  u32UTCTime);
+
+#ifdef PRICE_DEADLINE_SCHEDULER
+PRIVATE uint32 u32SE_PriceGetNextUpdateTime(
+                                tsSE_PriceCustomDataStructure *psPriceCustomDataStructure,
+                                uint32  u32UTCTime);
+
+PRIVATE void vSE_PriceKeepEarliestTime(
+                                uint32  *pu32EarliestTime,
+                                uint32  u32Time,
+                                uint32  u32UTCTime);
+#endif
+
 PRIVATE bool_t boExpiredCheck(tsSE_PriceCustomDataStructure *psPriceCustomDataStructure,
                             tsSE_PricePublishPriceRecord *psPublishPriceRecord,
                             uint32 u32UTCTime);
@@ -101,6 +127,12 @@ PRIVATE teSE_PriceStatus eSE_BlockPeriodSchedulerUpdate(
 /***        Local Variables                                               ***/
 /****************************************************************************/
 
+#ifdef PRICE_DEADLINE_SCHEDULER
+PRIVATE tsSE_PriceSchedulerEndPoint asPriceSchedulerEndPoints[SE_PRICE_NUMBER_OF_SCHEDULER_ENDPOINTS];
+PRIVATE uint8 u8NumberOfPriceSchedulerEndPoints = 0;
+PRIVATE uint32 u32PriceSchedulerLastUTCTime = 0;
+#endif
+
 /****************************************************************************
  **
  ** NAME:       vSE_PriceTimerClickCallback
@@ -119,6 +151,43 @@ PRIVATE teSE_PriceStatus eSE_BlockPeriodSchedulerUpdate(
 PUBLIC  void vSE_PriceTimerClickCallback(tsZCL_CallBackEvent *psCallBackEvent)
 {
     int i;
+#ifdef PRICE_DEADLINE_SCHEDULER
+    tsSE_PriceSchedulerEndPoint *psSchedulerEndPoint;
+    uint32 u32UTCTime = psCallBackEvent->uMessage.sTimerMessage.u32UTCTime;
+    bool_t bTimeWentBack = (u32UTCTime < u32PriceSchedulerLastUTCTime);
+
+    u32PriceSchedulerLastUTCTime = u32UTCTime;
+
+    // only registered EPs, and only once something in their tables is due
+    for(i=0; i<u8NumberOfPriceSchedulerEndPoints; i++)
+    {
+        psSchedulerEndPoint = &asPriceSchedulerEndPoints[i];
+        // the cached times were worked out against a later UTC time, eg. after vZCL_SetUTCTime
+        if(bTimeWentBack)
+        {
+            psSchedulerEndPoint->psPriceCustomDataStructure->u32NextSchedulerUpdateTime = 0;
+        }
+        if(psSchedulerEndPoint->psPriceCustomDataStructure->u32NextSchedulerUpdateTime > u32UTCTime)
+        {
+            continue;
+        }
+
+        vSE_PriceSchedulerUpdateEndPoint(psSchedulerEndPoint->u8EndPointId, psSchedulerEndPoint->bIsServer, u32UTCTime);
+
+        // get EP mutex
+        #ifndef COOPERATIVE
+            eZCL_GetMutex(psSchedulerEndPoint->psEndPointDefinition);
+        #endif
+
+        psSchedulerEndPoint->psPriceCustomDataStructure->u32NextSchedulerUpdateTime =
+            u32SE_PriceGetNextUpdateTime(psSchedulerEndPoint->psPriceCustomDataStructure, u32UTCTime);
+
+        // release EP
+        #ifndef COOPERATIVE
+            eZCL_ReleaseMutex(psSchedulerEndPoint->psEndPointDefinition);
+        #endif
+    }
+#else
     uint8 u8NumberOfendpoints;
 
     u8NumberOfendpoints = u8ZCL_GetNumberOfEndpointsRegistered();
@@ -127,29 +196,113 @@ PUBLIC  void vSE_PriceTimerClickCallback(tsZCL_CallBackEvent *psCallBackEvent)
     for(i=0; i<u8NumberOfendpoints; i++)
     {
         // deliver time to any EP-server/client
-        eSE_PriceSchedulerUpdate(u8ZCL_GetEPIdFromIndex(i), TRUE, psCallBackEvent->uMessage.sTimerMessage.u32UTCTime);
-        eSE_PriceSchedulerUpdate(u8ZCL_GetEPIdFromIndex(i), FALSE, psCallBackEvent->uMessage.sTimerMessage.u32UTCTime);
+        vSE_PriceSchedulerUpdateEndPoint(u8ZCL_GetEPIdFromIndex(i), TRUE, psCallBackEvent->uMessage.sTimerMessage.u32UTCTime);
+        vSE_PriceSchedulerUpdateEndPoint(u8ZCL_GetEPIdFromIndex(i), FALSE, psCallBackEvent->uMessage.sTimerMessage.u32UTCTime);
+    }
+#endif
 
-#ifdef BLOCK_CHARGING
-        // deliver time to any EP-server/client
-        eSE_BlockPeriodSchedulerUpdate(u8ZCL_GetEPIdFromIndex(i), TRUE, psCallBackEvent->uMessage.sTimerMessage.u32UTCTime);
-        eSE_BlockPeriodSchedulerUpdate(u8ZCL_GetEPIdFromIndex(i), FALSE, psCallBackEvent->uMessage.sTimerMessage.u32UTCTime);
-#endif /* BLOCK_CHARGING */
+}
 
-#ifdef  PRICE_CONVERSION_FACTOR
-        eSE_ConversionFactorSchedulerUpdate(u8ZCL_GetEPIdFromIndex(i),TRUE,psCallBackEvent->uMessage.sTimerMessage.u32UTCTime);
-        eSE_ConversionFactorSchedulerUpdate(u8ZCL_GetEPIdFromIndex(i),FALSE,psCallBackEvent->uMessage.sTimerMessage.u32UTCTime);
-#endif
+#ifdef PRICE_DEADLINE_SCHEDULER
+/****************************************************************************
+ **
+ ** NAME:       eSE_PriceRegisterSchedulerEndPoint
+ **
+ ** DESCRIPTION:
+ ** Registers a price server or client EP with the scheduler
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          Source EP Id
+ ** bool_t                      bIsServer                   Is server
+ **
+ ** RETURN:
+ ** teSE_PriceStatus
+ **
+ ****************************************************************************/
 
-#ifdef PRICE_CALORIFIC_VALUE
-        eSE_CalorificValueSchedulerUpdate(u8ZCL_GetEPIdFromIndex(i),TRUE,psCallBackEvent->uMessage.sTimerMessage.u32UTCTime);
-        eSE_CalorificValueSchedulerUpdate(u8ZCL_GetEPIdFromIndex(i),FALSE,psCallBackEvent->uMessage.sTimerMessage.u32UTCTime);
-#endif
+PUBLIC  teSE_PriceStatus eSE_PriceRegisterSchedulerEndPoint(
+                                uint8   u8SourceEndPointId,
+                                bool_t  bIsServer)
+{
+    int i;
+    uint8 u8FindPriceClusterReturn;
+    tsSE_PriceCustomDataStructure *psPriceCustomDataStructure;
+    tsZCL_EndPointDefinition *psEndPointDefinition;
+    tsZCL_ClusterInstance *psClusterInstance;
 
+    // error check via EP number
+    u8FindPriceClusterReturn = eSE_FindPriceCluster(u8SourceEndPointId, bIsServer, &psEndPointDefinition, &psClusterInstance, &psPriceCustomDataStructure);
+    if(u8FindPriceClusterReturn != E_ZCL_SUCCESS)
+    {
+        return u8FindPriceClusterReturn;
+    }
 
+    // already registered
+    for(i=0; i<u8NumberOfPriceSchedulerEndPoints; i++)
+    {
+        if((asPriceSchedulerEndPoints[i].u8EndPointId == u8SourceEndPointId) &&
+           (asPriceSchedulerEndPoints[i].bIsServer == bIsServer))
+        {
+            return(E_ZCL_SUCCESS);
+        }
+    }
+
+    if(u8NumberOfPriceSchedulerEndPoints >= SE_PRICE_NUMBER_OF_SCHEDULER_ENDPOINTS)
+    {
+        return(E_ZCL_ERR_INSUFFICIENT_SPACE);
+    }
+
+    asPriceSchedulerEndPoints[u8NumberOfPriceSchedulerEndPoints].u8EndPointId = u8SourceEndPointId;
+    asPriceSchedulerEndPoints[u8NumberOfPriceSchedulerEndPoints].bIsServer = bIsServer;
+    asPriceSchedulerEndPoints[u8NumberOfPriceSchedulerEndPoints].psEndPointDefinition = psEndPointDefinition;
+    asPriceSchedulerEndPoints[u8NumberOfPriceSchedulerEndPoints].psPriceCustomDataStructure = psPriceCustomDataStructure;
+    u8NumberOfPriceSchedulerEndPoints++;
+
+    // look at the tables on the next tick
+    psPriceCustomDataStructure->u32NextSchedulerUpdateTime = 0;
+
+    return(E_ZCL_SUCCESS);
+}
+
+/****************************************************************************
+ **
+ ** NAME:       eSE_PriceGetNextSchedulerUpdateTime
+ **
+ ** DESCRIPTION:
+ ** Gets the earliest time at which a registered EP has a table entry to
+ ** start or expire
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint32                     *pu32NextUpdateTime          next update time
+ **
+ ** RETURN:
+ ** teSE_PriceStatus
+ **
+ ****************************************************************************/
+
+PUBLIC  teSE_PriceStatus eSE_PriceGetNextSchedulerUpdateTime(uint32 *pu32NextUpdateTime)
+{
+    int i;
+
+    #ifdef STRICT_PARAM_CHECK
+        if(pu32NextUpdateTime==NULL)
+        {
+            return E_ZCL_ERR_PARAMETER_NULL;
+        }
+    #endif
+
+    *pu32NextUpdateTime = 0xffffffff;
+    for(i=0; i<u8NumberOfPriceSchedulerEndPoints; i++)
+    {
+        if(asPriceSchedulerEndPoints[i].psPriceCustomDataStructure->u32NextSchedulerUpdateTime < *pu32NextUpdateTime)
+        {
+            *pu32NextUpdateTime = asPriceSchedulerEndPoints[i].psPriceCustomDataStructure->u32NextSchedulerUpdateTime;
+        }
     }
 
+    return(E_ZCL_SUCCESS);
 }
+#endif
 
 /****************************************************************************
  **
@@ -318,6 +471,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceSchedulerUpdate(uint8 u8SourceEndPointId, bool
             psDLISTremove(&psPriceCustomDataStructure->lPriceAllocList, (DNODE *)psPublishPriceRecordCopy);
             // add to free list
             vDLISTaddToTail(&psPriceCustomDataStructure->lPriceDeAllocList, (DNODE *)psPublishPriceRecordCopy);
+#ifdef PRICE_TABLE_INDEX
+            psPriceCustomDataStructure->sPriceIndex.bValid = FALSE;
+#endif
 
             bDeletePriceEvent = TRUE;
         }
@@ -483,6 +639,9 @@ PRIVATE  teSE_PriceStatus eSE_CalorificValueSchedulerUpdate(
         {
                  psDLISTremove(&psPriceCustomDataStructure->lCalorificValueAllocList, (DNODE *)psPublishCalorificValueRecordCopy);
                  vDLISTaddToTail(&psPriceCustomDataStructure->lCalorificValueDeAllocList, (DNODE *)psPublishCalorificValueRecordCopy);
+#ifdef PRICE_TABLE_INDEX
+                 psPriceCustomDataStructure->sCalorificValueIndex.bValid = FALSE;
+#endif
                  bNewEvent = TRUE;
         }
         if(boDeleteThisEntry)
@@ -634,6 +793,9 @@ PUBLIC  teSE_PriceStatus eSE_ConversionFactorSchedulerUpdate(
         {
                 psDLISTremove(&psPriceCustomDataStructure->lConversionFactorAllocList, (DNODE *)psPublishConversionFactorRecordCopy);
                 vDLISTaddToTail(&psPriceCustomDataStructure->lConversionFactorDeAllocList, (DNODE *)psPublishConversionFactorRecordCopy);
+#ifdef PRICE_TABLE_INDEX
+                psPriceCustomDataStructure->sConversionFactorIndex.bValid = FALSE;
+#endif
                 bNewEvent = TRUE;
 
         }
@@ -780,6 +942,9 @@ PUBLIC  teSE_PriceStatus eSE_BlockPeriodSchedulerUpdate(
                 {
                     psPublishBlockPeriodRecordCopy->sPublishBlockPeriodCmdPayload.u32BlockPeriodStartTime =
                         u32CurrentTime;
+#ifdef PRICE_TABLE_INDEX
+                    psPriceCustomDataStructure->sBlockPeriodIndex.bValid = FALSE;
+#endif
                 }
             }
             else
@@ -788,6 +953,9 @@ PUBLIC  teSE_PriceStatus eSE_BlockPeriodSchedulerUpdate(
                 psDLISTremove(&psPriceCustomDataStructure->lBlockPeriodAllocList, (DNODE *)psPublishBlockPeriodRecordCopy);
                 // add to free list
                 vDLISTaddToTail(&psPriceCustomDataStructure->lBlockPeriodDeAllocList, (DNODE *)psPublishBlockPeriodRecordCopy);
+#ifdef PRICE_TABLE_INDEX
+                psPriceCustomDataStructure->sBlockPeriodIndex.bValid = FALSE;
+#endif
 
                 bDeleteBlockEvent = TRUE;
             }
@@ -1089,6 +1257,206 @@ PUBLIC  teSE_PriceStatus eSE_GetNumberOfFreeBlockPeriodTableEntries(
 /***        Local Functions                                               ***/
 /****************************************************************************/
 
+/****************************************************************************
+ **
+ ** NAME:       vSE_PriceSchedulerUpdateEndPoint
+ **
+ ** DESCRIPTION:
+ ** Delivers the time to each price table scheduler on an EP
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint8                       u8SourceEndPointId          Source EP Id
+ ** bool_t                      bIsServer                   Is server
+ ** uint32                      u32UTCTime                  Current time
+ **
+ ** RETURN:
+ ** nothing
+ **
+ ****************************************************************************/
+
+PRIVATE  void vSE_PriceSchedulerUpdateEndPoint(
+                                uint8   u8SourceEndPointId,
+                                bool_t  bIsServer,
+                                uint32  u32UTCTime)
+{
+    eSE_PriceSchedulerUpdate(u8SourceEndPointId, bIsServer, u32UTCTime);
+
+#ifdef BLOCK_CHARGING
+    eSE_BlockPeriodSchedulerUpdate(u8SourceEndPointId, bIsServer, u32UTCTime);
+#endif /* BLOCK_CHARGING */
+
+#ifdef  PRICE_CONVERSION_FACTOR
+    eSE_ConversionFactorSchedulerUpdate(u8SourceEndPointId, bIsServer, u32UTCTime);
+#endif
+
+#ifdef PRICE_CALORIFIC_VALUE
+    eSE_CalorificValueSchedulerUpdate(u8SourceEndPointId, bIsServer, u32UTCTime);
+#endif
+}
+
+#ifdef PRICE_DEADLINE_SCHEDULER
+/****************************************************************************
+ **
+ ** NAME:       u32SE_PriceGetNextUpdateTime
+ **
+ ** DESCRIPTION:
+ ** Finds the earliest start or expiry time after the current time across the
+ ** price, block period, conversion factor and calorific value tables. The
+ ** schedulers have nothing to do on an EP until then.
+ **
+ ** PARAMETERS:                      Name                            Usage
+ ** tsSE_PriceCustomDataStructure    *psPriceCustomDataStructure     Price data structure
+ ** uint32                            u32UTCTime                     Current time
+ **
+ ** RETURN:
+ ** uint32 time
+ **
+ ****************************************************************************/
+
+PRIVATE  uint32 u32SE_PriceGetNextUpdateTime(
+                                tsSE_PriceCustomDataStructure *psPriceCustomDataStructure,
+                                uint32  u32UTCTime)
+{
+    uint32 u32NextUpdateTime = 0xffffffff;
+    uint32 u32StartTime;
+    tsSE_PricePublishPriceRecord *psPublishPriceRecord;
+#ifdef BLOCK_CHARGING
+    tsSE_PricePublishBlockPeriodRecord *psPublishBlockPeriodRecord;
+    uint32 u32DurationInMinutes;
+#endif
+#ifdef PRICE_CONVERSION_FACTOR
+    tsSE_PriceConversionFactorRecord *psPublishConversionFactorRecord;
+#endif
+#ifdef PRICE_CALORIFIC_VALUE
+    tsSE_PriceCalorificValueRecord *psPublishCalorificValueRecord;
+#endif
+
+    psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTgetHead(&psPriceCustomDataStructure->lPriceAllocList);
+
+    // a start now head has its remaining duration brought up to date each minute
+    if (psPublishPriceRecord &&
+        psPublishPriceRecord->sPublishPriceCmdPayload.u32StartTime == 0 &&
+        psPublishPriceRecord->sPublishPriceCmdPayload.u16DurationInMinutes != E_SE_PRICE_DURATION_UNTIL_CHANGED)
+    {
+        vSE_PriceKeepEarliestTime(&u32NextUpdateTime,
+            psPriceCustomDataStructure->u32ArrivalTimeOfStartNowEntry +
+            ((u32UTCTime - psPriceCustomDataStructure->u32ArrivalTimeOfStartNowEntry) / 60 + 1) * 60,
+            u32UTCTime);
+    }
+
+    // starts and expiries as boExpiredCheck - an until changed entry expires at the next start
+    while(psPublishPriceRecord != NULL)
+    {
+        u32StartTime = psPublishPriceRecord->sPublishPriceCmdPayload.u32StartTime;
+        if(u32StartTime == 0)
+        {
+            u32StartTime = psPriceCustomDataStructure->u32ArrivalTimeOfStartNowEntry;
+            vSE_PriceKeepEarliestTime(&u32NextUpdateTime,
+                u32StartTime + psPriceCustomDataStructure->u16ArrivalDurationOfStartNowEntry*60,
+                u32UTCTime);
+        }
+        else if(psPublishPriceRecord->sPublishPriceCmdPayload.u16DurationInMinutes != E_SE_PRICE_DURATION_UNTIL_CHANGED)
+        {
+            vSE_PriceKeepEarliestTime(&u32NextUpdateTime,
+                u32StartTime + psPublishPriceRecord->sPublishPriceCmdPayload.u16DurationInMinutes*60,
+                u32UTCTime);
+        }
+        vSE_PriceKeepEarliestTime(&u32NextUpdateTime, u32StartTime, u32UTCTime);
+
+        psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTgetNext((DNODE *)psPublishPriceRecord);
+    }
+
+#ifdef BLOCK_CHARGING
+    psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psDLISTgetHead(&psPriceCustomDataStructure->lBlockPeriodAllocList);
+
+    // a start now head has its remaining duration brought up to date each minute
+    if (psPublishBlockPeriodRecord &&
+        psPublishBlockPeriodRecord->sPublishBlockPeriodCmdPayload.u32BlockPeriodStartTime == 0 &&
+        psPublishBlockPeriodRecord->sPublishBlockPeriodCmdPayload.u32BlockPeriodDurationInMins != E_SE_BLOCK_PERIOD_DURATION_UNTIL_CHANGED)
+    {
+        vSE_PriceKeepEarliestTime(&u32NextUpdateTime,
+            psPriceCustomDataStructure->u32BlockPeriodArrivalTimeOfStartNowEntry +
+            ((u32UTCTime - psPriceCustomDataStructure->u32BlockPeriodArrivalTimeOfStartNowEntry) / 60 + 1) * 60,
+            u32UTCTime);
+    }
+
+    // starts and expiries as boBlockPeriodExpiredCheck
+    while(psPublishBlockPeriodRecord != NULL)
+    {
+        u32StartTime = psPublishBlockPeriodRecord->sPublishBlockPeriodCmdPayload.u32BlockPeriodStartTime;
+        u32DurationInMinutes = psPublishBlockPeriodRecord->sPublishBlockPeriodCmdPayload.u32BlockPeriodDurationInMins;
+        if(u32StartTime == 0)
+        {
+            u32StartTime = psPriceCustomDataStructure->u32BlockPeriodArrivalTimeOfStartNowEntry;
+            u32DurationInMinutes = psPriceCustomDataStructure->u32BlockPeriodArrivalDurationOfStartNowEntry;
+        }
+        if(u32DurationInMinutes != E_SE_BLOCK_PERIOD_DURATION_UNTIL_CHANGED)
+        {
+            vSE_PriceKeepEarliestTime(&u32NextUpdateTime, u32StartTime + u32DurationInMinutes*60, u32UTCTime);
+        }
+        vSE_PriceKeepEarliestTime(&u32NextUpdateTime, u32StartTime, u32UTCTime);
+
+        psPublishBlockPeriodRecord = (tsSE_PricePublishBlockPeriodRecord *)psDLISTgetNext((DNODE *)psPublishBlockPeriodRecord);
+    }
+#endif /* BLOCK_CHARGING */
+
+#ifdef PRICE_CONVERSION_FACTOR
+    // conversion factors only change when a later entry starts
+    psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psDLISTgetHead(&psPriceCustomDataStructure->lConversionFactorAllocList);
+    while(psPublishConversionFactorRecord != NULL)
+    {
+        vSE_PriceKeepEarliestTime(&u32NextUpdateTime, psPublishConversionFactorRecord->sPublishConversionCmdPayload.u32StartTime, u32UTCTime);
+        psPublishConversionFactorRecord = (tsSE_PriceConversionFactorRecord *)psDLISTgetNext((DNODE *)psPublishConversionFactorRecord);
+    }
+#endif
+
+#ifdef PRICE_CALORIFIC_VALUE
+    // calorific values only change when a later entry starts
+    psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTgetHead(&psPriceCustomDataStructure->lCalorificValueAllocList);
+    while(psPublishCalorificValueRecord != NULL)
+    {
+        vSE_PriceKeepEarliestTime(&u32NextUpdateTime, psPublishCalorificValueRecord->sPublishCalorificValueCmdPayload.u32StartTime, u32UTCTime);
+        psPublishCalorificValueRecord = (tsSE_PriceCalorificValueRecord *)psDLISTgetNext((DNODE *)psPublishCalorificValueRecord);
+    }
+#endif
+
+#ifdef SE_PRICE_SERVER_AUTO_UPDATES_PRICE_FROM_CURRENT_BLOCK_PERIOD_CONSUMPTION_DELIVERED
+    // the current price follows the block consumption - keep checking it every tick
+    u32NextUpdateTime = u32UTCTime + 1;
+#endif
+
+    return u32NextUpdateTime;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vSE_PriceKeepEarliestTime
+ **
+ ** DESCRIPTION:
+ ** Keeps the earliest of the times seen so far that is still in the future
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** uint32                     *pu32EarliestTime            earliest time so far
+ ** uint32                      u32Time                     time to compare
+ ** uint32                      u32UTCTime                  Current time
+ **
+ ** RETURN:
+ ** nothing
+ **
+ ****************************************************************************/
+
+PRIVATE  void vSE_PriceKeepEarliestTime(
+                                uint32  *pu32EarliestTime,
+                                uint32  u32Time,
+                                uint32  u32UTCTime)
+{
+    if((u32Time > u32UTCTime) && (u32Time < *pu32EarliestTime))
+    {
+        *pu32EarliestTime = u32Time;
+    }
+}
+#endif
+
 /****************************************************************************
  **
  ** NAME:       boExpiredCheck
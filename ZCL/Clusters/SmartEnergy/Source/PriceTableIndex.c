@@ -0,0 +1,405 @@
+/****************************************************************************
+ *
+ * Copyright 2020 NXP.
+ *
+ * NXP Confidential.
+ *
+ * This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms.
+ * By expressly accepting such terms or by downloading, installing, activating
+ * and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms.
+ * If you do not agree to be bound by the applicable license terms,
+ * then you may not retain, install, activate or otherwise use the software.
+ *
+ *
+ ****************************************************************************/
+
+
+/*****************************************************************************
+ *
+ * MODULE:             Price Cluster
+ *
+ * COMPONENT:          PriceTableIndex.c
+ *
+ * DESCRIPTION:        Start time ordered index over the price table lists.
+ *
+ ****************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include <jendefs.h>
+#include <string.h>
+
+#include "dlist.h"
+
+#include "zcl.h"
+#include "zcl_customcommand.h"
+
+#include "Price.h"
+#include "Price_internal.h"
+
+#ifdef PRICE_TABLE_INDEX
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+PRIVATE void vSE_PriceTableIndexBuild(
+                tsSE_PriceTableIndex    *psIndex,
+                DLIST                   *plList);
+
+PRIVATE uint8 u8SE_PriceTableIndexUpperBound(
+                tsSE_PriceTableIndex    *psIndex,
+                uint32                  u32Time);
+
+PRIVATE uint32 u32SE_PriceGetPriceStartTime(DNODE *psNode);
+#ifdef BLOCK_CHARGING
+PRIVATE uint32 u32SE_PriceGetBlockPeriodStartTime(DNODE *psNode);
+#endif
+#ifdef PRICE_CONVERSION_FACTOR
+PRIVATE uint32 u32SE_PriceGetConversionFactorStartTime(DNODE *psNode);
+#endif
+#ifdef PRICE_CALORIFIC_VALUE
+PRIVATE uint32 u32SE_PriceGetCalorificValueStartTime(DNODE *psNode);
+#endif
+
+/****************************************************************************/
+/***        Exported Variables                                            ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+/****************************************************************************
+ **
+ ** NAME:       vSE_PriceTableIndexInit
+ **
+ ** DESCRIPTION:
+ ** Sets up the start time indexes of the price cluster tables
+ **
+ ** PARAMETERS:                     Name                        Usage
+ ** tsSE_PriceCustomDataStructure   *psPriceCustomDataStructure Price custom data
+ **
+ ** RETURN:
+ ** None
+ **
+ ****************************************************************************/
+
+PUBLIC void vSE_PriceTableIndexInit(
+                tsSE_PriceCustomDataStructure  *psPriceCustomDataStructure)
+{
+    tsSE_PriceTableIndex *psIndex;
+
+    psIndex = &psPriceCustomDataStructure->sPriceIndex;
+    psIndex->bValid = TRUE;
+    psIndex->u8NumberOfEntries = 0;
+    psIndex->u8MaxNumberOfEntries = SE_PRICE_TABLE_INDEX_PRICE_ENTRIES;
+    psIndex->psEntries = psPriceCustomDataStructure->asPriceIndexEntries;
+    psIndex->pfnGetStartTime = u32SE_PriceGetPriceStartTime;
+
+#ifdef BLOCK_CHARGING
+    psIndex = &psPriceCustomDataStructure->sBlockPeriodIndex;
+    psIndex->bValid = TRUE;
+    psIndex->u8NumberOfEntries = 0;
+    psIndex->u8MaxNumberOfEntries = SE_PRICE_TABLE_INDEX_BLOCK_PERIOD_ENTRIES;
+    psIndex->psEntries = psPriceCustomDataStructure->asBlockPeriodIndexEntries;
+    psIndex->pfnGetStartTime = u32SE_PriceGetBlockPeriodStartTime;
+#endif
+
+#ifdef PRICE_CONVERSION_FACTOR
+    psIndex = &psPriceCustomDataStructure->sConversionFactorIndex;
+    psIndex->bValid = TRUE;
+    psIndex->u8NumberOfEntries = 0;
+    psIndex->u8MaxNumberOfEntries = SE_PRICE_NUMBER_OF_CONVERSION_FACTOR_ENTRIES;
+    psIndex->psEntries = psPriceCustomDataStructure->asConversionFactorIndexEntries;
+    psIndex->pfnGetStartTime = u32SE_PriceGetConversionFactorStartTime;
+#endif
+
+#ifdef PRICE_CALORIFIC_VALUE
+    psIndex = &psPriceCustomDataStructure->sCalorificValueIndex;
+    psIndex->bValid = TRUE;
+    psIndex->u8NumberOfEntries = 0;
+    psIndex->u8MaxNumberOfEntries = SE_PRICE_NUMBER_OF_CALORIFIC_VALUE_ENTRIES;
+    psIndex->psEntries = psPriceCustomDataStructure->asCalorificValueIndexEntries;
+    psIndex->pfnGetStartTime = u32SE_PriceGetCalorificValueStartTime;
+#endif
+}
+
+/****************************************************************************
+ **
+ ** NAME:       psSE_PriceTableIndexSearch
+ **
+ ** DESCRIPTION:
+ ** Finds the last table entry whose start time is not after the given time
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsSE_PriceTableIndex        *psIndex                    Index of the table
+ ** DLIST                       *plList                     Table alloc list
+ ** uint32                      u32Time                     Time to search for
+ **
+ ** RETURN:
+ ** DNODE * - NULL if every entry starts after u32Time
+ **
+ ****************************************************************************/
+
+PUBLIC DNODE *psSE_PriceTableIndexSearch(
+                tsSE_PriceTableIndex    *psIndex,
+                DLIST                   *plList,
+                uint32                  u32Time)
+{
+    uint8 u8Position;
+
+    vSE_PriceTableIndexBuild(psIndex, plList);
+
+    u8Position = u8SE_PriceTableIndexUpperBound(psIndex, u32Time);
+    if(u8Position == 0)
+    {
+        return NULL;
+    }
+
+    return psIndex->psEntries[u8Position - 1].psNode;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       psSE_PriceTableIndexFind
+ **
+ ** DESCRIPTION:
+ ** Finds the first table entry with exactly the given start time
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsSE_PriceTableIndex        *psIndex                    Index of the table
+ ** DLIST                       *plList                     Table alloc list
+ ** uint32                      u32StartTime                Start time to match
+ **
+ ** RETURN:
+ ** DNODE * - NULL if no entry has that start time
+ **
+ ****************************************************************************/
+
+PUBLIC DNODE *psSE_PriceTableIndexFind(
+                tsSE_PriceTableIndex    *psIndex,
+                DLIST                   *plList,
+                uint32                  u32StartTime)
+{
+    uint8 u8Position;
+
+    vSE_PriceTableIndexBuild(psIndex, plList);
+
+    // entries before this one start before u32StartTime
+    u8Position = (u32StartTime == 0) ? 0 : u8SE_PriceTableIndexUpperBound(psIndex, u32StartTime - 1);
+    if((u8Position < psIndex->u8NumberOfEntries) &&
+       (psIndex->psEntries[u8Position].u32StartTime == u32StartTime))
+    {
+        return psIndex->psEntries[u8Position].psNode;
+    }
+
+    return NULL;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       psSE_PriceTableIndexGetEntry
+ **
+ ** DESCRIPTION:
+ ** Returns the table entry at the given position
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsSE_PriceTableIndex        *psIndex                    Index of the table
+ ** DLIST                       *plList                     Table alloc list
+ ** uint8                       u8Index                     Position in the table
+ **
+ ** RETURN:
+ ** DNODE * - NULL if the table holds fewer entries
+ **
+ ****************************************************************************/
+
+PUBLIC DNODE *psSE_PriceTableIndexGetEntry(
+                tsSE_PriceTableIndex    *psIndex,
+                DLIST                   *plList,
+                uint8                   u8Index)
+{
+    vSE_PriceTableIndexBuild(psIndex, plList);
+
+    if(u8Index >= psIndex->u8NumberOfEntries)
+    {
+        return NULL;
+    }
+
+    return psIndex->psEntries[u8Index].psNode;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       vSE_PriceTableIndexInsert
+ **
+ ** DESCRIPTION:
+ ** Records a node just inserted into the alloc list after any entries with
+ ** the same start time.  An index that is already stale is left to be
+ ** rebuilt by the next look up.
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsSE_PriceTableIndex        *psIndex                    Index of the table
+ ** DNODE                       *psNode                     Node added to the list
+ **
+ ** RETURN:
+ ** None
+ **
+ ****************************************************************************/
+
+PUBLIC void vSE_PriceTableIndexInsert(
+                tsSE_PriceTableIndex    *psIndex,
+                DNODE                   *psNode)
+{
+    uint8 u8Position;
+    uint32 u32StartTime;
+
+    if(!psIndex->bValid)
+    {
+        return;
+    }
+
+    if(psIndex->u8NumberOfEntries >= psIndex->u8MaxNumberOfEntries)
+    {
+        psIndex->bValid = FALSE;
+        return;
+    }
+
+    u32StartTime = psIndex->pfnGetStartTime(psNode);
+    u8Position = u8SE_PriceTableIndexUpperBound(psIndex, u32StartTime);
+
+    memmove(&psIndex->psEntries[u8Position + 1],
+            &psIndex->psEntries[u8Position],
+            (psIndex->u8NumberOfEntries - u8Position) * sizeof(tsSE_PriceTableIndexEntry));
+
+    psIndex->psEntries[u8Position].u32StartTime = u32StartTime;
+    psIndex->psEntries[u8Position].psNode = psNode;
+    psIndex->u8NumberOfEntries++;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+/****************************************************************************
+ **
+ ** NAME:       vSE_PriceTableIndexBuild
+ **
+ ** DESCRIPTION:
+ ** Rebuilds a stale index from the alloc list, which is kept in start time order
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsSE_PriceTableIndex        *psIndex                    Index of the table
+ ** DLIST                       *plList                     Table alloc list
+ **
+ ** RETURN:
+ ** None
+ **
+ ****************************************************************************/
+
+PRIVATE void vSE_PriceTableIndexBuild(
+                tsSE_PriceTableIndex    *psIndex,
+                DLIST                   *plList)
+{
+    DNODE *psNode;
+
+    if(psIndex->bValid)
+    {
+        return;
+    }
+
+    psIndex->u8NumberOfEntries = 0;
+    psNode = psDLISTgetHead(plList);
+    while((psNode != NULL) && (psIndex->u8NumberOfEntries < psIndex->u8MaxNumberOfEntries))
+    {
+        psIndex->psEntries[psIndex->u8NumberOfEntries].u32StartTime = psIndex->pfnGetStartTime(psNode);
+        psIndex->psEntries[psIndex->u8NumberOfEntries].psNode = psNode;
+        psIndex->u8NumberOfEntries++;
+        psNode = psDLISTgetNext(psNode);
+    }
+
+    psIndex->bValid = TRUE;
+}
+
+/****************************************************************************
+ **
+ ** NAME:       u8SE_PriceTableIndexUpperBound
+ **
+ ** DESCRIPTION:
+ ** Binary search for the number of index entries starting at or before a time
+ **
+ ** PARAMETERS:                 Name                        Usage
+ ** tsSE_PriceTableIndex        *psIndex                    Index of the table
+ ** uint32                      u32Time                     Time to search for
+ **
+ ** RETURN:
+ ** uint8 - position of the first entry starting after u32Time
+ **
+ ****************************************************************************/
+
+PRIVATE uint8 u8SE_PriceTableIndexUpperBound(
+                tsSE_PriceTableIndex    *psIndex,
+                uint32                  u32Time)
+{
+    uint8 u8Low = 0;
+    uint8 u8High = psIndex->u8NumberOfEntries;
+    uint8 u8Mid;
+
+    while(u8Low < u8High)
+    {
+        u8Mid = u8Low + ((u8High - u8Low) >> 1);
+        if(psIndex->psEntries[u8Mid].u32StartTime <= u32Time)
+        {
+            u8Low = u8Mid + 1;
+        }
+        else
+        {
+            u8High = u8Mid;
+        }
+    }
+
+    return u8Low;
+}
+
+PRIVATE uint32 u32SE_PriceGetPriceStartTime(DNODE *psNode)
+{
+    return ((tsSE_PricePublishPriceRecord *)psNode)->sPublishPriceCmdPayload.u32StartTime;
+}
+
+#ifdef BLOCK_CHARGING
+PRIVATE uint32 u32SE_PriceGetBlockPeriodStartTime(DNODE *psNode)
+{
+    return ((tsSE_PricePublishBlockPeriodRecord *)psNode)->sPublishBlockPeriodCmdPayload.u32BlockPeriodStartTime;
+}
+#endif
+
+#ifdef PRICE_CONVERSION_FACTOR
+PRIVATE uint32 u32SE_PriceGetConversionFactorStartTime(DNODE *psNode)
+{
+    return ((tsSE_PriceConversionFactorRecord *)psNode)->sPublishConversionCmdPayload.u32StartTime;
+}
+#endif
+
+#ifdef PRICE_CALORIFIC_VALUE
+PRIVATE uint32 u32SE_PriceGetCalorificValueStartTime(DNODE *psNode)
+{
+    return ((tsSE_PriceCalorificValueRecord *)psNode)->sPublishCalorificValueCmdPayload.u32StartTime;
+}
+#endif
+
+#endif /* PRICE_TABLE_INDEX */
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -59,7 +59,9 @@ typedef struct {
 /***        Local Function Prototypes                                     ***/
 /****************************************************************************/
 //PRIVATE bool_t boSearchForInsertPoint( void *pvSearchParam, DNODE *psNodeUnderTest);
+#ifndef PRICE_TABLE_INDEX
 PRIVATE bool_t boSearchForExisting( void *pvSearchParam, void *psNodeUnderTest);
+#endif
 
 PRIVATE teSE_PriceStatus eSE_CheckForTableOverlap(
                 tsSE_PriceCustomDataStructure      *psPriceCustomDataStructure,
@@ -250,7 +252,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetPriceEntry(
             tsSE_PricePublishPriceCmdPayload    **ppsPricePayload)
 
 {
+#ifndef PRICE_TABLE_INDEX
     int i;
+#endif
 
     tsSE_PricePublishPriceRecord *psPublishPriceRecord;
 
@@ -278,6 +282,11 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetPriceEntry(
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psSE_PriceTableIndexGetEntry(&psPriceCustomDataStructure->sPriceIndex,
+                                                                                       &psPriceCustomDataStructure->lPriceAllocList,
+                                                                                       u8tableIndex);
+#else
     // get start of list
     psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lPriceAllocList);
 
@@ -288,6 +297,7 @@ PUBLIC  teSE_PriceStatus eSE_PriceGetPriceEntry(
         psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTgetNext((DNODE *)psPublishPriceRecord);
         i++;
     }
+#endif
 
     if(psPublishPriceRecord==NULL)
     {
@@ -357,9 +367,15 @@ PUBLIC  teSE_PriceStatus eSE_PriceRemovePriceEntry(
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psSE_PriceTableIndexFind(&psPriceCustomDataStructure->sPriceIndex,
+                                                                                   &psPriceCustomDataStructure->lPriceAllocList,
+                                                                                   u32StartTime);
+#else
     // search through alloc list
     psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lPriceAllocList );
     psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTsearchForward((DNODE *)psPublishPriceRecord, boSearchForExisting, (void *)&u32StartTime);
+#endif
 
     if(psPublishPriceRecord==NULL)
     {
@@ -375,6 +391,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceRemovePriceEntry(
     psDLISTremove(&psPriceCustomDataStructure->lPriceAllocList, (DNODE *)psPublishPriceRecord);
     // add to dealloc list
     vDLISTaddToTail(&psPriceCustomDataStructure->lPriceDeAllocList, (DNODE *)(psPublishPriceRecord));
+#ifdef PRICE_TABLE_INDEX
+    psPriceCustomDataStructure->sPriceIndex.bValid = FALSE;
+#endif
 
     // release EP
     #ifndef COOPERATIVE
@@ -424,10 +443,16 @@ PUBLIC  teSE_PriceStatus eSE_PriceDoesPriceEntryExist(uint8 u8SourceEndPointId,
     #endif
 
 
+#ifdef PRICE_TABLE_INDEX
+    psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psSE_PriceTableIndexFind(&psPriceCustomDataStructure->sPriceIndex,
+                                                                                   &psPriceCustomDataStructure->lPriceAllocList,
+                                                                                   u32StartTime);
+#else
     // search through alloc list
     psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTgetHead(&psPriceCustomDataStructure->lPriceAllocList);
     // search list for old entry
     psPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTsearchForward((DNODE *)psPublishPriceRecord, boSearchForExisting, (void *)&u32StartTime);
+#endif
 
     if(psPublishPriceRecord==NULL)
     {
@@ -496,6 +521,9 @@ PUBLIC  teSE_PriceStatus eSE_PriceClearAllPriceEntries(uint8 u8SourceEndPointId,
             vDLISTaddToTail(&psPriceCustomDataStructure->lPriceDeAllocList, (DNODE *)(psPublishPriceRecord));
         }
     } while(psPublishPriceRecord!=NULL);
+#ifdef PRICE_TABLE_INDEX
+    psPriceCustomDataStructure->sPriceIndex.bValid = FALSE;
+#endif
 
     // release EP
     #ifndef COOPERATIVE
@@ -530,6 +558,11 @@ PUBLIC  teSE_PriceStatus eSE_AddPriceEntryUsingPointer(
     tsSE_PricePublishPriceRecord *psPublishPriceRecord, *psNextPublishPriceRecord, *psPreviousPublishPriceRecord, *psNewPublishPriceRecord;
     uint8 u8Status;
 
+#ifdef PRICE_DEADLINE_SCHEDULER
+    // table is about to change - have the scheduler look at it on the next tick
+    psPriceCustomDataStructure->u32NextSchedulerUpdateTime = 0;
+#endif
+
     ////////////////////////////////////////////////////////////////////////
     // Initial checks and setup
     ////////////////////////////////////////////////////////////////////////
@@ -548,6 +581,19 @@ PUBLIC  teSE_PriceStatus eSE_AddPriceEntryUsingPointer(
     // check to see if the entry exists already - search through alloc list based on start time
     // Search the list maintaining prev and next pointers.  Stop when next pointer is later than current time and
     // prev is older or equall to current time.
+#ifdef PRICE_TABLE_INDEX
+    psPreviousPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psSE_PriceTableIndexSearch(&psPriceCustomDataStructure->sPriceIndex,
+                                                                                             &psPriceCustomDataStructure->lPriceAllocList,
+                                                                                             psPublishPriceCmdPayload->u32StartTime);
+    if(psPreviousPublishPriceRecord == NULL)
+    {
+        psNextPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lPriceAllocList );
+    }
+    else
+    {
+        psNextPublishPriceRecord = (tsSE_PricePublishPriceRecord*)(psPreviousPublishPriceRecord->dllPriceNode.psNext);
+    }
+#else
     psPreviousPublishPriceRecord = NULL;
     psNextPublishPriceRecord = (tsSE_PricePublishPriceRecord *)psDLISTgetHead( &psPriceCustomDataStructure->lPriceAllocList );
 
@@ -557,6 +603,7 @@ PUBLIC  teSE_PriceStatus eSE_AddPriceEntryUsingPointer(
         psPreviousPublishPriceRecord = psNextPublishPriceRecord;
         psNextPublishPriceRecord = (tsSE_PricePublishPriceRecord*)(psNextPublishPriceRecord->dllPriceNode.psNext);
     }
+#endif
 
     // Does new event overlap
     u8Status = eSE_CheckForTableOverlap(psPriceCustomDataStructure, psNextPublishPriceRecord, psPreviousPublishPriceRecord, psPublishPriceCmdPayload->u32StartTime, psPublishPriceCmdPayload->u16DurationInMinutes);
@@ -615,6 +662,9 @@ PUBLIC  teSE_PriceStatus eSE_AddPriceEntryUsingPointer(
             // Delete the previous record
             psDLISTremove(&psPriceCustomDataStructure->lPriceAllocList, (DNODE *)psPreviousPublishPriceRecord);
             vDLISTaddToHead(&psPriceCustomDataStructure->lPriceDeAllocList, (DNODE *)psPreviousPublishPriceRecord);
+#ifdef PRICE_TABLE_INDEX
+            psPriceCustomDataStructure->sPriceIndex.bValid = FALSE;
+#endif
         }
     }
 
@@ -638,6 +688,9 @@ PUBLIC  teSE_PriceStatus eSE_AddPriceEntryUsingPointer(
             psNextPublishPriceRecord = (tsSE_PricePublishPriceRecord*)(pTempNode->psNext);
             psDLISTremove(&psPriceCustomDataStructure->lPriceAllocList, pTempNode);
             vDLISTaddToHead(&psPriceCustomDataStructure->lPriceDeAllocList, pTempNode);
+#ifdef PRICE_TABLE_INDEX
+            psPriceCustomDataStructure->sPriceIndex.bValid = FALSE;
+#endif
         }
     }
     while(u8Status != E_ZCL_SUCCESS);
@@ -663,6 +716,9 @@ PUBLIC  teSE_PriceStatus eSE_AddPriceEntryUsingPointer(
         // remove tail from alloc and put it back on the free list
         psDLISTremove(&psPriceCustomDataStructure->lPriceAllocList, (DNODE *)psPublishPriceRecord);
         vDLISTaddToHead(&psPriceCustomDataStructure->lPriceDeAllocList, (DNODE *)psPublishPriceRecord);
+#ifdef PRICE_TABLE_INDEX
+        psPriceCustomDataStructure->sPriceIndex.bValid = FALSE;
+#endif
         // try to add again
         u8Status = eSE_AddPriceEntryUsingPointer(psPriceCustomDataStructure, bOverwritePrevious, psPublishPriceCmdPayload);
         if(u8Status != E_ZCL_SUCCESS)
@@ -670,6 +726,9 @@ PUBLIC  teSE_PriceStatus eSE_AddPriceEntryUsingPointer(
             // restore last table back
             psDLISTremove(&psPriceCustomDataStructure->lPriceDeAllocList, (DNODE *)psPublishPriceRecord);
             vDLISTaddToTail(&psPriceCustomDataStructure->lPriceAllocList, (DNODE *)psPublishPriceRecord);
+#ifdef PRICE_TABLE_INDEX
+            psPriceCustomDataStructure->sPriceIndex.bValid = FALSE;
+#endif
             return u8Status;
         }
 
@@ -699,6 +758,9 @@ PUBLIC  teSE_PriceStatus eSE_AddPriceEntryUsingPointer(
     }
 
     vCopyRecordIntoTable(&psNewPublishPriceRecord->sPublishPriceCmdPayload, psPublishPriceCmdPayload);
+#ifdef PRICE_TABLE_INDEX
+    vSE_PriceTableIndexInsert(&psPriceCustomDataStructure->sPriceIndex, (DNODE *)psNewPublishPriceRecord);
+#endif
 
     // If we have just inserted a start time of now - update the Arrived fields
     if (psNewPublishPriceRecord->sPublishPriceCmdPayload.u32StartTime == 0)
@@ -796,6 +858,7 @@ PRIVATE  teSE_PriceStatus eSE_CheckForTableOverlap(
     return(E_ZCL_SUCCESS);
 }
 
+#ifndef PRICE_TABLE_INDEX
 /****************************************************************************
  **
  ** NAME:       boSearchForExisting
@@ -831,6 +894,7 @@ PRIVATE  bool_t boSearchForExisting( void *pvSearchParam, void *psNodeUnderTest)
 
     return FALSE;
 }
+#endif
 
 /****************************************************************************
  **
@@ -277,6 +277,30 @@ PUBLIC teSE_PriceStatus eSE_GetNumberOfFreeCalorificValueTableEntries(
 
 #endif
 
+#ifdef PRICE_TABLE_INDEX
+PUBLIC void vSE_PriceTableIndexInit(
+         tsSE_PriceCustomDataStructure  *psPriceCustomDataStructure);
+
+PUBLIC DNODE *psSE_PriceTableIndexSearch(
+         tsSE_PriceTableIndex           *psIndex,
+         DLIST                          *plList,
+         uint32                         u32Time);
+
+PUBLIC DNODE *psSE_PriceTableIndexFind(
+         tsSE_PriceTableIndex           *psIndex,
+         DLIST                          *plList,
+         uint32                         u32StartTime);
+
+PUBLIC DNODE *psSE_PriceTableIndexGetEntry(
+         tsSE_PriceTableIndex           *psIndex,
+         DLIST                          *plList,
+         uint8                          u8Index);
+
+PUBLIC void vSE_PriceTableIndexInsert(
+         tsSE_PriceTableIndex           *psIndex,
+         DNODE                          *psNode);
+#endif
+
 /****************************************************************************/
 /***        Exported Variables                                            ***/
 /****************************************************************************/
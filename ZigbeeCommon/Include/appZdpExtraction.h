@@ -146,6 +146,31 @@ typedef struct {
     uint8 u8SequNumber;
 }ZPS_tsAfZdpEvent;
 
+/* Header fields of a ZDP response carrying an entry list, as returned by
+ * zps_bAplZdpListIterInit(). Mgmt_Lqi_rsp, Mgmt_Rtg_rsp and Mgmt_Bind_rsp
+ * fill the table fields; Match_Desc_rsp fills u16NwkAddrOfInterest and sets
+ * u8TotalEntries/u8ListCount to the match length. */
+typedef struct {
+    uint16  u16ClusterId;
+    uint16  u16NwkAddrOfInterest;
+    uint8   u8SequNumber;
+    uint8   u8Status;
+    uint8   u8TotalEntries;
+    uint8   u8StartIndex;
+    uint8   u8ListCount;
+} ZPS_tsAplZdpListRspHeader;
+
+/* Cursor over the entry list of a ZDP response. Entries are decoded in
+ * place from the APDU one at a time, so the list is not limited by the
+ * APP_ZDP_MAX_* sizes and the APDU must not be freed while iterating. */
+typedef struct {
+    PDUM_thAPduInstance hAPduInst;
+    uint16  u16ClusterId;
+    uint16  u16Location;
+    uint16  u16PayloadSize;
+    uint8   u8EntriesLeft;
+} ZPS_tsAplZdpListIterator;
+
 
 PUBLIC bool zps_bAplZdpUnpackNwkAddressResponse(ZPS_tsAfEvent *psZdoServerEvent, 
                                                 ZPS_tsAfZdpEvent* psReturnStruct);
@@ -305,5 +330,22 @@ PUBLIC bool zps_bAplZdpUnpackMgmtCacheResponse(ZPS_tsAfEvent *psZdoServerEvent,
 PUBLIC bool zps_bAplZdpUnpackResponse (ZPS_tsAfEvent *psZdoServerEvent,
                                        ZPS_tsAfZdpEvent* psReturnStruct);
 
+PUBLIC bool zps_bAplZdpListIterInit(ZPS_tsAfEvent *psZdoServerEvent,
+                                    ZPS_tsAplZdpListRspHeader *psHeader,
+                                    ZPS_tsAplZdpListIterator *psIter);
+
+PUBLIC bool zps_bAplZdpListIterNextNtEntry(ZPS_tsAplZdpListIterator *psIter,
+                                           ZPS_tsAplZdpNtListEntry *psEntry);
+
+PUBLIC bool zps_bAplZdpListIterNextRtEntry(ZPS_tsAplZdpListIterator *psIter,
+                                           ZPS_tsAplZdpRtEntry *psEntry);
+
+PUBLIC bool zps_bAplZdpListIterNextBindEntry(ZPS_tsAplZdpListIterator *psIter,
+                                             uint64 *pu64SourceAddress,
+                                             ZPS_tsAplZdpBindingTableEntry *psEntry);
+
+PUBLIC bool zps_bAplZdpListIterNextEndpoint(ZPS_tsAplZdpListIterator *psIter,
+                                            uint8 *pu8Endpoint);
+
 
 #endif /* APPZDPEXTRACTION_H_ */
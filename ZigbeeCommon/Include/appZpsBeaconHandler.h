@@ -67,6 +67,14 @@ extern "C" {
 #define BF_ASSOC_PERMIT_MASK            ((uint16)(0x1 << BF_ASSOC_PERMIT_BIT))
 #define BF_GET_ASSOC_PERMIT(x)          (((x) & BF_ASSOC_PERMIT_MASK) >> BF_ASSOC_PERMIT_BIT)
 
+/* Number of slots in the hashed extended PAN id set built from a registered
+ * black/white list. Must be a power of two no larger than 32; lists that
+ * do not fit (more than BF_PAN_ID_HASH_SIZE - 1 entries) are searched
+ * linearly instead */
+#ifndef BF_PAN_ID_HASH_SIZE
+#define BF_PAN_ID_HASH_SIZE            16
+#endif
+
 /**************************/
 /**** TYPE DEFINITIONS ****/
 /**************************/
@@ -93,6 +101,7 @@ typedef struct
 /****************************/
 PUBLIC void ZPS_bAppAddBeaconFilter(tsBeaconFilterType *psAppBeaconStruct);
 PUBLIC void ZPS_bAppRemoveBeaconFilter(void);
+PUBLIC void ZPS_vAppRefreshBeaconFilter(void);
 PUBLIC void ZPS_bAppDiscoveryReceived(void);
 #endif /* _appZpsBeaconHandler_h_ */
 
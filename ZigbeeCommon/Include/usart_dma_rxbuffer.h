@@ -32,6 +32,14 @@ typedef struct {
   uint16_t u16Write;                     // index of newest data byte in buffer
 }tsDmaSwFifo;
 
+/* Unread bytes lying contiguously in the DMA receive buffer. The unread
+ * data is covered by at most two spans: the tail of the buffer up to the
+ * wrap point, followed by its start. */
+typedef struct {
+  uint8_t *pu8Data;
+  uint16_t u16Length;
+}tsDmaSpan;
+
 /*******************************************************************************
  * Additional USART DMA Functions
  ******************************************************************************/
@@ -39,3 +47,6 @@ void USART_DMA_Init();
 void USART_DMA_Flush();
 uint16_t USART_DMA_GetCount(void);
 uint16_t USART_DMA_ReadBytes(uint8_t *buffer,uint16_t u16Max);
+uint8_t USART_DMA_PeekSpans(tsDmaSpan asSpan[2]);
+void USART_DMA_Consume(uint16_t u16Count);
+int32_t USART_DMA_FindByte(uint8_t u8Byte, uint16_t u16Offset);
@@ -3308,3 +3308,308 @@ PUBLIC bool zps_bAplZdpUnpackResponse (ZPS_tsAfEvent *psZdoServerEvent ,ZPS_tsAf
    
     return bZdp;
 }
+
+/****************************************************************************
+ *
+ * NAME:       bZdpListIterHasEntry
+ */
+/**
+ * Checks that the iterator is walking the expected response type, has an
+ * entry left and that u16Length more bytes lie within the APDU payload.
+ * A truncated entry ends the iteration.
+ *
+ * @param psIter        iterator set up by zps_bAplZdpListIterInit
+ * @param u16ClusterId  response cluster the caller decodes
+ * @param u16Length     bytes needed from the current location
+ *
+ * @return TRUE if the bytes can be read
+ *
+ ****************************************************************************/
+PRIVATE bool bZdpListIterHasEntry(ZPS_tsAplZdpListIterator *psIter,
+                                  uint16 u16ClusterId,
+                                  uint16 u16Length)
+{
+    if( ( psIter == NULL ) ||
+        ( psIter->u16ClusterId != u16ClusterId ) ||
+        ( psIter->u8EntriesLeft == 0 ) )
+    {
+        return FALSE;
+    }
+
+    if( ( (uint32)psIter->u16Location + u16Length ) > psIter->u16PayloadSize )
+    {
+        DBG_vPrintf(TRACE_ZDP_EXTRACTION, "zps_bAplZdpListIter: cluster 0x%04x truncated, %d entries unread\n",
+                u16ClusterId, psIter->u8EntriesLeft);
+        psIter->u8EntriesLeft = 0;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/****************************************************************************
+ *
+ * NAME:       zps_bAplZdpListIterInit
+ */
+/**
+ * Reads the header of a Mgmt_Lqi_rsp, Mgmt_Rtg_rsp, Mgmt_Bind_rsp or
+ * Match_Desc_rsp and positions the iterator on its first list entry. The
+ * entries are then decoded straight from the APDU with the matching
+ * zps_bAplZdpListIterNext* function, without copying the whole list.
+ *
+ * @ingroup
+ *
+ * @param psZdoServerEvent  ZDO data indication holding the response
+ * @param psHeader          returns the response header fields
+ * @param psIter            iterator to initialise
+ *
+ * @return FALSE if the event is not one of the above responses or its
+ *         header is truncated
+ *
+ * @note The list is empty unless the status is ZPS_E_SUCCESS. The APDU
+ *       must stay allocated until the iteration is finished.
+ *
+ ****************************************************************************/
+PUBLIC bool zps_bAplZdpListIterInit(ZPS_tsAfEvent *psZdoServerEvent,
+                                    ZPS_tsAplZdpListRspHeader *psHeader,
+                                    ZPS_tsAplZdpListIterator *psIter)
+{
+    PDUM_thAPduInstance hAPduInst;
+    uint16 u16ClusterId;
+    uint16 u16Location = 0;
+    uint16 u16PayloadSize;
+
+    if( ( psZdoServerEvent == NULL ) || ( psHeader == NULL ) || ( psIter == NULL ) )
+    {
+        return FALSE;
+    }
+
+    hAPduInst = psZdoServerEvent->uEvent.sApsDataIndEvent.hAPduInst;
+    u16ClusterId = psZdoServerEvent->uEvent.sApsDataIndEvent.u16ClusterId;
+    u16PayloadSize = PDUM_u16APduInstanceGetPayloadSize(hAPduInst);
+
+    psIter->hAPduInst = hAPduInst;
+    psIter->u16ClusterId = u16ClusterId;
+    psIter->u16PayloadSize = u16PayloadSize;
+    psIter->u8EntriesLeft = 0;
+
+    memset(psHeader, 0, sizeof(ZPS_tsAplZdpListRspHeader));
+    psHeader->u16ClusterId = u16ClusterId;
+
+    switch(u16ClusterId)
+    {
+        case ZPS_ZDP_MGMT_LQI_RSP_CLUSTER_ID:
+        case ZPS_ZDP_MGMT_RTG_RSP_CLUSTER_ID:
+        case ZPS_ZDP_MGMT_BIND_RSP_CLUSTER_ID:
+            /* seq, status, entries, start index, list count */
+            if( u16PayloadSize < 5 )
+            {
+                return FALSE;
+            }
+            psHeader->u8SequNumber = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ u16Location++ ];
+            psHeader->u8Status = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ u16Location++ ];
+            psHeader->u8TotalEntries = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ u16Location++ ];
+            psHeader->u8StartIndex = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ u16Location++ ];
+            psHeader->u8ListCount = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ u16Location++ ];
+            break;
+
+        case ZPS_ZDP_MATCH_DESC_RSP_CLUSTER_ID:
+            /* seq, status, nwk addr of interest, match length */
+            if( u16PayloadSize < 5 )
+            {
+                return FALSE;
+            }
+            psHeader->u8SequNumber = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ u16Location++ ];
+            psHeader->u8Status = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ u16Location++ ];
+            APDU_BUF_READ16_INC( psHeader->u16NwkAddrOfInterest, hAPduInst, u16Location);
+            psHeader->u8ListCount = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ u16Location++ ];
+            psHeader->u8TotalEntries = psHeader->u8ListCount;
+
+            if( psHeader->u16NwkAddrOfInterest == ZPS_E_BROADCAST_RX_ON )
+            {
+                if( psZdoServerEvent->uEvent.sApsDataIndEvent.u8SrcAddrMode == ZPS_E_ADDR_MODE_SHORT )
+                {
+                    psHeader->u16NwkAddrOfInterest = psZdoServerEvent->uEvent.sApsDataIndEvent.uSrcAddress.u16Addr;
+                }
+                else
+                {
+                    psHeader->u16NwkAddrOfInterest = ZPS_u16NwkNibFindNwkAddr(ZPS_pvAplZdoGetNwkHandle(),
+                            psZdoServerEvent->uEvent.sApsDataIndEvent.uSrcAddress.u64Addr );
+                }
+            }
+            break;
+
+        default:
+            return FALSE;
+    }
+
+    psIter->u16Location = u16Location;
+    if( psHeader->u8Status == ZPS_E_SUCCESS )
+    {
+        psIter->u8EntriesLeft = psHeader->u8ListCount;
+    }
+    return TRUE;
+}
+
+/****************************************************************************
+ *
+ * NAME:       zps_bAplZdpListIterNextNtEntry
+ */
+/**
+ * Decodes the next neighbor table entry of a Mgmt_Lqi_rsp
+ *
+ * @ingroup
+ *
+ * @param psIter   iterator set up by zps_bAplZdpListIterInit
+ * @param psEntry  returns the entry
+ *
+ * @return FALSE when the list is exhausted or truncated
+ *
+ ****************************************************************************/
+PUBLIC bool zps_bAplZdpListIterNextNtEntry(ZPS_tsAplZdpListIterator *psIter,
+                                           ZPS_tsAplZdpNtListEntry *psEntry)
+{
+    PDUM_thAPduInstance hAPduInst;
+
+    /* ext pan id, ieee, nwk addr, 2 attribute bytes, depth, lqi */
+    if( !bZdpListIterHasEntry(psIter, ZPS_ZDP_MGMT_LQI_RSP_CLUSTER_ID, 22) )
+    {
+        return FALSE;
+    }
+    hAPduInst = psIter->hAPduInst;
+
+    psIter->u16Location += PDUM_u16APduInstanceReadNBO(hAPduInst, psIter->u16Location, "l", &psEntry->u64ExtPanId);
+    psIter->u16Location += PDUM_u16APduInstanceReadNBO(hAPduInst, psIter->u16Location, "l", &psEntry->u64ExtendedAddress);
+    APDU_BUF_READ16_INC( psEntry->u16NwkAddr, hAPduInst, psIter->u16Location);
+    psEntry->uAncAttrs.au8Field[0] = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ psIter->u16Location++ ];
+    psEntry->uAncAttrs.au8Field[1] = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ psIter->u16Location++ ];
+    psEntry->u8Depth = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ psIter->u16Location++ ];
+    psEntry->u8LinkQuality = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ psIter->u16Location++ ];
+
+    psIter->u8EntriesLeft--;
+    return TRUE;
+}
+
+/****************************************************************************
+ *
+ * NAME:       zps_bAplZdpListIterNextRtEntry
+ */
+/**
+ * Decodes the next routing table entry of a Mgmt_Rtg_rsp
+ *
+ * @ingroup
+ *
+ * @param psIter   iterator set up by zps_bAplZdpListIterInit
+ * @param psEntry  returns the entry
+ *
+ * @return FALSE when the list is exhausted or truncated
+ *
+ ****************************************************************************/
+PUBLIC bool zps_bAplZdpListIterNextRtEntry(ZPS_tsAplZdpListIterator *psIter,
+                                           ZPS_tsAplZdpRtEntry *psEntry)
+{
+    PDUM_thAPduInstance hAPduInst;
+
+    /* destination, flags, next hop */
+    if( !bZdpListIterHasEntry(psIter, ZPS_ZDP_MGMT_RTG_RSP_CLUSTER_ID, 5) )
+    {
+        return FALSE;
+    }
+    hAPduInst = psIter->hAPduInst;
+
+    APDU_BUF_READ16_INC( psEntry->u16NwkDstAddr, hAPduInst, psIter->u16Location);
+    psEntry->u8Flags = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ psIter->u16Location++ ];
+    APDU_BUF_READ16_INC( psEntry->u16NwkNxtHopAddr, hAPduInst, psIter->u16Location);
+
+    psIter->u8EntriesLeft--;
+    return TRUE;
+}
+
+/****************************************************************************
+ *
+ * NAME:       zps_bAplZdpListIterNextBindEntry
+ */
+/**
+ * Decodes the next binding table entry of a Mgmt_Bind_rsp
+ *
+ * @ingroup
+ *
+ * @param psIter             iterator set up by zps_bAplZdpListIterInit
+ * @param pu64SourceAddress  returns the source IEEE address of the entry
+ * @param psEntry            returns the entry
+ *
+ * @return FALSE when the list is exhausted or truncated
+ *
+ * @note A group destination is carried as a 16 bit address with no
+ *       endpoint; u8DstEndPoint is then returned as 0.
+ *
+ ****************************************************************************/
+PUBLIC bool zps_bAplZdpListIterNextBindEntry(ZPS_tsAplZdpListIterator *psIter,
+                                             uint64 *pu64SourceAddress,
+                                             ZPS_tsAplZdpBindingTableEntry *psEntry)
+{
+    PDUM_thAPduInstance hAPduInst;
+    uint8 u8DstAddrMode;
+
+    /* source ieee, source endpoint, cluster, dst addr mode */
+    if( !bZdpListIterHasEntry(psIter, ZPS_ZDP_MGMT_BIND_RSP_CLUSTER_ID, 12) )
+    {
+        return FALSE;
+    }
+    hAPduInst = psIter->hAPduInst;
+
+    /* ieee dst + endpoint or group dst, checked before anything is consumed */
+    u8DstAddrMode = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ psIter->u16Location + 11 ];
+    if( !bZdpListIterHasEntry(psIter, ZPS_ZDP_MGMT_BIND_RSP_CLUSTER_ID,
+                              ( u8DstAddrMode == 0x3 ) ? 21 : 14) )
+    {
+        return FALSE;
+    }
+
+    psIter->u16Location += PDUM_u16APduInstanceReadNBO(hAPduInst, psIter->u16Location, "l", pu64SourceAddress);
+    psEntry->u8SourceEndpoint = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ psIter->u16Location++ ];
+    APDU_BUF_READ16_INC( psEntry->u16ClusterId, hAPduInst, psIter->u16Location);
+    psEntry->u8DstAddrMode = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ psIter->u16Location++ ];
+
+    if( u8DstAddrMode == 0x3 )
+    {
+        psIter->u16Location += PDUM_u16APduInstanceReadNBO(hAPduInst, psIter->u16Location, "l", &psEntry->uDstAddress.u64Addr);
+        psEntry->u8DstEndPoint = (( pdum_tsAPduInstance* )hAPduInst )->au8Storage[ psIter->u16Location++ ];
+    }
+    else
+    {
+        APDU_BUF_READ16_INC( psEntry->uDstAddress.u16Addr, hAPduInst, psIter->u16Location);
+        psEntry->u8DstEndPoint = 0;
+    }
+
+    psIter->u8EntriesLeft--;
+    return TRUE;
+}
+
+/****************************************************************************
+ *
+ * NAME:       zps_bAplZdpListIterNextEndpoint
+ */
+/**
+ * Returns the next matching endpoint of a Match_Desc_rsp
+ *
+ * @ingroup
+ *
+ * @param psIter       iterator set up by zps_bAplZdpListIterInit
+ * @param pu8Endpoint  returns the endpoint
+ *
+ * @return FALSE when the list is exhausted or truncated
+ *
+ ****************************************************************************/
+PUBLIC bool zps_bAplZdpListIterNextEndpoint(ZPS_tsAplZdpListIterator *psIter,
+                                            uint8 *pu8Endpoint)
+{
+    if( !bZdpListIterHasEntry(psIter, ZPS_ZDP_MATCH_DESC_RSP_CLUSTER_ID, 1) )
+    {
+        return FALSE;
+    }
+
+    *pu8Endpoint = (( pdum_tsAPduInstance* )psIter->hAPduInst )->au8Storage[ psIter->u16Location++ ];
+
+    psIter->u8EntriesLeft--;
+    return TRUE;
+}
@@ -31,19 +31,59 @@
 
 #include "appZpsBeaconHandler.h"
 #include "mac_sap.h"
+#include <string.h>
 #ifdef BEACON_ENABLE
 #include "dbg.h"
 #endif
 /************************/
 /**** MACROS/DEFINES ****/
 /************************/
+
+#if ((BF_PAN_ID_HASH_SIZE) & ((BF_PAN_ID_HASH_SIZE) - 1)) || ((BF_PAN_ID_HASH_SIZE) > 32)
+#error BF_PAN_ID_HASH_SIZE must be a power of two no larger than 32
+#endif
+
+/* Beacon properties packed into one byte so that all flag filters are
+ * checked with a single mask compare */
+#define BF_FLAG_PERMIT_JOIN            0x01
+#define BF_FLAG_CAP_ENDDEVICE          0x02
+#define BF_FLAG_CAP_ROUTER             0x04
+#define BF_FLAG_PRIORITY_PARENT        0x08
+#define BF_FLAG_SHORT_PAN              0x10
+
+/* Device depth is a 4 bit field, so this limit never rejects a beacon */
+#define BF_NO_DEPTH_LIMIT              16
+
+#define BF_LIST_NONE                   0
+#define BF_LIST_BLACK                  1
+#define BF_LIST_WHITE                  2
+
 /**************************/
 /**** TYPE DEFINITIONS ****/
 /**************************/
+
+/* Registered filter reduced to what is needed per beacon */
+typedef struct
+{
+    uint64    au64PanIdSet[BF_PAN_ID_HASH_SIZE];
+    uint32    u32SlotUsed;
+    uint16    u16Panid;
+    uint8     u8RequiredFlags;
+    uint8     u8MinLqi;
+    uint8     u8DepthLimit;
+    uint8     u8ListMode;
+    bool_t    bPassAll;
+    bool_t    bHashed;
+} tsCompiledBeaconFilter;
+
 /******************************/
 /**** FORWARD DECLARATIONS ****/
 /******************************/
 
+PRIVATE void vCompileBeaconFilter(void);
+PRIVATE uint8 u8PanIdSlot(uint64 u64ExtendedPanId);
+PRIVATE bool_t bPanIdListed(uint64 u64ExtendedPanId);
+
 /*****************/
 /**** IMPORTS ****/
 /*****************/
@@ -63,6 +103,7 @@ tsBeaconFilterType *psBeaconFilter = NULL;
 
 /**** LOCAL SCOPE ****/
 PRIVATE bool_t bDiscovery = 0;
+PRIVATE tsCompiledBeaconFilter sCompiledFilter;
 /**** MODULE SCOPE ****/
 
 /*************************/
@@ -70,6 +111,159 @@ PRIVATE bool_t bDiscovery = 0;
 /**** PRIVATE METHODS ****/
 /*************************/
 /*************************/
+
+/****************************************************************************
+ *
+ * NAME:       u8PanIdSlot
+ */
+/**
+ * @param
+ *            uint64 extended PAN id
+ * @return
+ *            home slot of the PAN id in the hashed set
+ * @note
+ *
+ ****************************************************************************/
+PRIVATE uint8 u8PanIdSlot(uint64 u64ExtendedPanId)
+{
+    uint32 u32Hash = (uint32)u64ExtendedPanId ^ (uint32)(u64ExtendedPanId >> 32);
+
+    u32Hash *= 0x9E3779B1UL;
+    return (uint8)((u32Hash >> 24) & (BF_PAN_ID_HASH_SIZE - 1));
+}
+
+/****************************************************************************
+ *
+ * NAME:       vCompileBeaconFilter
+ */
+/**
+ * @param
+ *
+ * @return
+ *
+ * @note
+ *
+ * Reduces the registered filter to a hashed PAN id set, a mask of beacon
+ * flags that must be set and LQI/depth limits, so that each beacon is
+ * accepted or rejected in constant time. The black/white list is copied
+ * here; lists too long for the set are searched in place instead.
+ ****************************************************************************/
+PRIVATE void vCompileBeaconFilter(void)
+{
+    uint16 u16FilterMap;
+    uint8 u8Traverse;
+    uint8 u8Slot;
+
+    memset(&sCompiledFilter, 0, sizeof(tsCompiledBeaconFilter));
+    sCompiledFilter.u8DepthLimit = BF_NO_DEPTH_LIMIT;
+
+    u16FilterMap = psBeaconFilter->u16FilterMap;
+    if(((u16FilterMap & BF_USED_BITMASK) == 0) ||
+       ((u16FilterMap & (BF_BITMAP_BLACKLIST|BF_BITMAP_WHITELIST)) == (BF_BITMAP_BLACKLIST|BF_BITMAP_WHITELIST)))
+    {
+        sCompiledFilter.bPassAll = TRUE; /* invalid filter pass the beacons upwards */
+        return;
+    }
+
+    if(u16FilterMap & (BF_BITMAP_BLACKLIST|BF_BITMAP_WHITELIST))
+    {
+        sCompiledFilter.u8ListMode = (u16FilterMap & BF_BITMAP_BLACKLIST) ? BF_LIST_BLACK : BF_LIST_WHITE;
+
+        /* keep at least one slot free so that a miss always ends the probe */
+        if(psBeaconFilter->u8ListSize < BF_PAN_ID_HASH_SIZE)
+        {
+            sCompiledFilter.bHashed = TRUE;
+            for(u8Traverse = 0; u8Traverse < psBeaconFilter->u8ListSize; u8Traverse++)
+            {
+                u8Slot = u8PanIdSlot(psBeaconFilter->pu64ExtendPanIdList[u8Traverse]);
+                while(sCompiledFilter.u32SlotUsed & (1UL << u8Slot))
+                {
+                    if(sCompiledFilter.au64PanIdSet[u8Slot] == psBeaconFilter->pu64ExtendPanIdList[u8Traverse])
+                    {
+                        break;
+                    }
+                    u8Slot = (u8Slot + 1) & (BF_PAN_ID_HASH_SIZE - 1);
+                }
+                sCompiledFilter.au64PanIdSet[u8Slot] = psBeaconFilter->pu64ExtendPanIdList[u8Traverse];
+                sCompiledFilter.u32SlotUsed |= (1UL << u8Slot);
+            }
+        }
+    }
+
+    if(u16FilterMap & BF_BITMAP_PERMIT_JOIN)
+    {
+        sCompiledFilter.u8RequiredFlags |= BF_FLAG_PERMIT_JOIN;
+    }
+    if(u16FilterMap & BF_BITMAP_CAP_ENDDEVICE)
+    {
+        sCompiledFilter.u8RequiredFlags |= BF_FLAG_CAP_ENDDEVICE;
+    }
+    if(u16FilterMap & BF_BITMAP_CAP_ROUTER)
+    {
+        sCompiledFilter.u8RequiredFlags |= BF_FLAG_CAP_ROUTER;
+    }
+    if(u16FilterMap & BF_BITMAP_PRIORITY_PARENT)
+    {
+        sCompiledFilter.u8RequiredFlags |= BF_FLAG_PRIORITY_PARENT;
+    }
+    if(u16FilterMap & BF_BITMAP_SHORT_PAN)
+    {
+        sCompiledFilter.u8RequiredFlags |= BF_FLAG_SHORT_PAN;
+        sCompiledFilter.u16Panid = psBeaconFilter->u16Panid;
+    }
+
+    if(u16FilterMap & BF_BITMAP_LQI)
+    {
+        sCompiledFilter.u8MinLqi = psBeaconFilter->u8Lqi;
+    }
+
+    if(u16FilterMap & BF_BITMAP_DEPTH)
+    {
+        /* 0xFF means only hear from the Coordinator ie depth 0 */
+        sCompiledFilter.u8DepthLimit = (psBeaconFilter->u8Depth == 0xFF) ? 1 : psBeaconFilter->u8Depth;
+    }
+}
+
+/****************************************************************************
+ *
+ * NAME:       bPanIdListed
+ */
+/**
+ * @param
+ *            uint64 extended PAN id
+ * @return
+ *            TRUE if the PAN id is on the registered black/white list
+ * @note
+ *
+ ****************************************************************************/
+PRIVATE bool_t bPanIdListed(uint64 u64ExtendedPanId)
+{
+    uint8 u8Traverse;
+    uint8 u8Slot;
+
+    if(!sCompiledFilter.bHashed)
+    {
+        for(u8Traverse = 0; u8Traverse < psBeaconFilter->u8ListSize; u8Traverse++)
+        {
+            if(u64ExtendedPanId == psBeaconFilter->pu64ExtendPanIdList[u8Traverse])
+            {
+                return TRUE;
+            }
+        }
+        return FALSE;
+    }
+
+    u8Slot = u8PanIdSlot(u64ExtendedPanId);
+    while(sCompiledFilter.u32SlotUsed & (1UL << u8Slot))
+    {
+        if(sCompiledFilter.au64PanIdSet[u8Slot] == u64ExtendedPanId)
+        {
+            return TRUE;
+        }
+        u8Slot = (u8Slot + 1) & (BF_PAN_ID_HASH_SIZE - 1);
+    }
+    return FALSE;
+}
 /************************/
 /************************/
 /**** MODULE METHODS ****/
@@ -95,12 +289,42 @@ PRIVATE bool_t bDiscovery = 0;
  *
  * @note
  *
- * Function is called by application to enable filtering
+ * Function is called by application to enable filtering. The filter is
+ * compiled on registration; if the application changes it afterwards it
+ * must call ZPS_vAppRefreshBeaconFilter or register it again
  ****************************************************************************/
 
 PUBLIC void ZPS_bAppAddBeaconFilter(tsBeaconFilterType *psAppBeaconStruct)
 {
     psBeaconFilter = psAppBeaconStruct;
+    if(psBeaconFilter)
+    {
+        vCompileBeaconFilter();
+    }
+}
+
+
+/****************************************************************************
+ *
+ * NAME:       ZPS_vAppRefreshBeaconFilter
+ */
+/**
+ * @param
+ *
+ * @return
+ *
+ * @note
+ *
+ * Recompiles the registered filter after the application has changed its
+ * fields or list contents. Does nothing if no filter is registered
+ ****************************************************************************/
+
+PUBLIC void ZPS_vAppRefreshBeaconFilter(void)
+{
+    if(psBeaconFilter)
+    {
+        vCompileBeaconFilter();
+    }
 }
 
 
@@ -147,7 +371,6 @@ PUBLIC void ZPS_bAppRemoveBeaconFilter(void)
 
 PUBLIC bool_t ZPS_bAppPassBeaconToHigherLayer(MAC_MlmeDcfmInd_s* psBeaconIndication)
 {
-    uint8 u8Traverse;
         /* we only want zigbee beacons */
     if((( psBeaconIndication->uParam.sIndBeacon.u8SDUlength > 0) &&
         ( psBeaconIndication->uParam.sIndBeacon.u8SDUlength >= 15) &&
@@ -184,115 +407,42 @@ PUBLIC bool_t ZPS_bAppPassBeaconToHigherLayer(MAC_MlmeDcfmInd_s* psBeaconIndicat
         /* Is filter registered */
         if(psBeaconFilter)
         {
-            if(psBeaconFilter->u16FilterMap & BF_USED_BITMASK)
-            {
-                if((psBeaconFilter->u16FilterMap & (BF_BITMAP_BLACKLIST|BF_BITMAP_WHITELIST)) == (BF_BITMAP_BLACKLIST|BF_BITMAP_WHITELIST))
-                {
-                    return TRUE; /* invalid bitmask pass the upwards*/
-                }
-
-                if(psBeaconFilter->u16FilterMap & (BF_BITMAP_BLACKLIST|BF_BITMAP_WHITELIST))
-                {
-                    for(u8Traverse=0; u8Traverse < psBeaconFilter->u8ListSize; u8Traverse++)
-                    {
-                        uint64 u64ExtendedPanId = zps_u64NwkLibFromPayload(BF_BCN_PL_EXT_PAN_ID_PTR(psBeaconIndication->uParam.sIndBeacon.u8SDU));
-
-                        if((u64ExtendedPanId == psBeaconFilter->pu64ExtendPanIdList[u8Traverse])
-                           && psBeaconFilter->u16FilterMap & BF_BITMAP_BLACKLIST)
-                        {
-                            return FALSE;
-                        }
-
-                        if((u64ExtendedPanId == psBeaconFilter->pu64ExtendPanIdList[u8Traverse])
-                            && psBeaconFilter->u16FilterMap & BF_BITMAP_WHITELIST)
-                        {
-                            break;
-                        }
-                    }
-
-                    if((psBeaconFilter->u16FilterMap & BF_BITMAP_WHITELIST) &&
-                    (u8Traverse == psBeaconFilter->u8ListSize))
-                    {
-                        return FALSE; /* Not in Whitelist */
-                    }
-                }
-
-                /*check for any other filters */
-
-                if((psBeaconFilter->u16FilterMap & BF_BITMAP_PERMIT_JOIN))
-                {
-                    if(BF_GET_ASSOC_PERMIT(psBeaconIndication->uParam.sIndBeacon.sPANdescriptor.u16SuperframeSpec) == 0)
-                    {
-                        return FALSE; /* Association not permitted */
-                    }
-
-                }
-
-                if((psBeaconFilter->u16FilterMap & BF_BITMAP_CAP_ENDDEVICE))
-                {
-                    if(BF_BCN_PL_ZED_CAPACITY(psBeaconIndication->uParam.sIndBeacon.u8SDU) == 0)
-                    {
-                        return FALSE;/* no End device capacity  */
-                    }
-                }
-
-                if((psBeaconFilter->u16FilterMap & BF_BITMAP_CAP_ROUTER))
-                {
-                    if(BF_BCN_PL_ZR_CAPACITY(psBeaconIndication->uParam.sIndBeacon.u8SDU) == 0)
-                    {
-                        return FALSE;/* no Router capacity  */
-                    }
-                }
+            uint8 *pu8Payload = psBeaconIndication->uParam.sIndBeacon.u8SDU;
+            uint8 u8Flags;
 
-                if((psBeaconFilter->u16FilterMap & BF_BITMAP_LQI))
-                {
-                    if(psBeaconIndication->uParam.sIndBeacon.sPANdescriptor.u8LinkQuality < psBeaconFilter->u8Lqi)
-                    {
-                        return FALSE; /* link quality isn't good enough */
-                    }
-                }
-
-                if((psBeaconFilter->u16FilterMap & BF_BITMAP_SHORT_PAN))
-                {
-                    if ( psBeaconIndication->uParam.sIndBeacon.sPANdescriptor.sCoord.u16PanId != psBeaconFilter->u16Panid )
-                    {
-                        return FALSE; /* Association not permitted */
-                    }
+            if(sCompiledFilter.bPassAll)
+            {
+                return TRUE; /* invalid filter pass the beacon upwards */
+            }
 
-                }
-                if((psBeaconFilter->u16FilterMap & BF_BITMAP_DEPTH))
-                {
-                    if(psBeaconFilter->u8Depth == 0xFF)
-                    {
-                        if((BF_BCN_PL_DEVICE_DEPTH(psBeaconIndication->uParam.sIndBeacon.u8SDU) > 0 ) )
-                        {
-                            return FALSE; /* Depth is greater than 0 ignore it since we only want to hear from Coordinators */
-                        }
-                    }
-                    
-                    if((BF_BCN_PL_DEVICE_DEPTH(psBeaconIndication->uParam.sIndBeacon.u8SDU) >= psBeaconFilter->u8Depth) )
-                    {
-                        return FALSE; /* depth isn't good enough */
-                    }
-                }
+            if(sCompiledFilter.u8ListMode != BF_LIST_NONE)
+            {
+                bool_t bListed = bPanIdListed(zps_u64NwkLibFromPayload(BF_BCN_PL_EXT_PAN_ID_PTR(pu8Payload)));
 
-                if((psBeaconFilter->u16FilterMap & BF_BITMAP_PRIORITY_PARENT))
+                if(bListed == (sCompiledFilter.u8ListMode == BF_LIST_BLACK))
                 {
-                    if(( BF_PL_RESERVED_BITS(psBeaconIndication->uParam.sIndBeacon.u8SDU) & 0x2 ) == 0  )
-                    {
-                        return FALSE; /* No connectivity to TC   */
-                    }
-
+                    return FALSE; /* Blacklisted or not in Whitelist */
                 }
-                /* passed all the filter tests */
-                return TRUE;
-
+            }
 
+            u8Flags = (uint8)BF_GET_ASSOC_PERMIT(psBeaconIndication->uParam.sIndBeacon.sPANdescriptor.u16SuperframeSpec);
+            u8Flags |= BF_BCN_PL_ZED_CAPACITY(pu8Payload) ? BF_FLAG_CAP_ENDDEVICE : 0;
+            u8Flags |= BF_BCN_PL_ZR_CAPACITY(pu8Payload) ? BF_FLAG_CAP_ROUTER : 0;
+            u8Flags |= (BF_PL_RESERVED_BITS(pu8Payload) & 0x2) ? BF_FLAG_PRIORITY_PARENT : 0;
+            if(psBeaconIndication->uParam.sIndBeacon.sPANdescriptor.sCoord.u16PanId == sCompiledFilter.u16Panid)
+            {
+                u8Flags |= BF_FLAG_SHORT_PAN;
             }
-            else
+
+            if(((u8Flags & sCompiledFilter.u8RequiredFlags) != sCompiledFilter.u8RequiredFlags) ||
+               (psBeaconIndication->uParam.sIndBeacon.sPANdescriptor.u8LinkQuality < sCompiledFilter.u8MinLqi) ||
+               (BF_BCN_PL_DEVICE_DEPTH(pu8Payload) >= sCompiledFilter.u8DepthLimit))
             {
-                return TRUE; /* invalid filter pass the beacon upwards */
+                return FALSE; /* failed a permit join, capacity, PAN, LQI or depth test */
             }
+
+            /* passed all the filter tests */
+            return TRUE;
         }
         else /* no filter registered pass the beacon upwards */
         {
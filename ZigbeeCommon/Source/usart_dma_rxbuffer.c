@@ -141,48 +141,95 @@ uint16_t USART_DMA_GetCount(void)
 
 uint16_t USART_DMA_ReadBytes(uint8_t *buffer,uint16_t u16Max)
 {
+	tsDmaSpan asSpan[2];
+	uint8_t u8Spans = USART_DMA_PeekSpans(asSpan);
+	uint16_t u16Copied = 0;
+	uint8_t i;
 
-	uint32_t buffercount = USART_DMA_GetCount();
+	for (i = 0; (i < u8Spans) && (u16Copied < u16Max); i++)
+	{
+		uint16_t u16Len = asSpan[i].u16Length;
 
-	//PRINTF("DMA COUNT:%d\r\n",buffercount);
-	//PRINTF("writeptr:%d readptr:%d \r\n",sSwFifo.u16Write,sSwFifo.u16Read);
+		// If you are requesting more than is received just return the received amount
+		if (u16Len > (u16Max - u16Copied)) u16Len = u16Max - u16Copied;
 
-	// If you are requesting more than is received just return the received amount
-	if (buffercount<u16Max) u16Max=buffercount;
+		memcpy(&buffer[u16Copied], asSpan[i].pu8Data, u16Len);
+		u16Copied += u16Len;
+	}
 
-	// Check if there is no data
-	if (buffercount==0) return 0;
+	USART_DMA_Consume(u16Copied);
 
-	if(sSwFifo.u16Read > sSwFifo.u16Write){
-		uint32_t maxcount = DMA_BUFFER_LENGTH- sSwFifo.u16Read;
+	//Return number of bytes read
+	return u16Copied;
+}
 
-		if( (maxcount ) > u16Max) maxcount = u16Max;
-		// Copy the end of the dma buffer
-		memcpy(buffer,&g_rxBuffer[sSwFifo.u16Read],maxcount);
+/*
+ * Returns the unread bytes as up to two spans pointing into the DMA buffer,
+ * without consuming them. The spans stay valid until USART_DMA_Consume()
+ * releases them, provided the DMA does not lap the read pointer.
+ */
+uint8_t USART_DMA_PeekSpans(tsDmaSpan asSpan[2])
+{
+	uint16_t u16Count = USART_DMA_GetCount();
+	uint16_t u16First = DMA_BUFFER_LENGTH - sSwFifo.u16Read;
 
-		// do we have additional data at the start of the dma buffer?
-		if (sSwFifo.u16Write != 0){
-			if(u16Max>maxcount) {
-				maxcount = u16Max-maxcount;
-				if( (maxcount ) > sSwFifo.u16Write)
-				{
-					maxcount = sSwFifo.u16Write;
-				}
+	if (u16Count == 0) return 0;
 
-				memcpy(&buffer[DMA_BUFFER_LENGTH-sSwFifo.u16Read],&g_rxBuffer[0],maxcount);
-			}
-		}
-	}
-	else{
-		memcpy(buffer,&g_rxBuffer[sSwFifo.u16Read],u16Max);
+	asSpan[0].pu8Data = &g_rxBuffer[sSwFifo.u16Read];
+	if (u16Count <= u16First)
+	{
+		asSpan[0].u16Length = u16Count;
+		return 1;
 	}
 
+	// The data wraps round to the start of the dma buffer
+	asSpan[0].u16Length = u16First;
+	asSpan[1].pu8Data = &g_rxBuffer[0];
+	asSpan[1].u16Length = u16Count - u16First;
+	return 2;
+}
+
+/*
+ * Releases u16Count bytes previously returned by USART_DMA_PeekSpans().
+ */
+void USART_DMA_Consume(uint16_t u16Count)
+{
+	uint16_t u16Avail = USART_DMA_GetCount();
+
+	if (u16Count > u16Avail) u16Count = u16Avail;
+
 	// Update the readptr
-	sSwFifo.u16Read += u16Max;
+	sSwFifo.u16Read += u16Count;
 	if(sSwFifo.u16Read >=DMA_BUFFER_LENGTH) sSwFifo.u16Read -= DMA_BUFFER_LENGTH;
+}
 
-	//Return number of bytes read
-	return (uint16_t) u16Max;
+/*
+ * Searches the unread bytes in place for u8Byte, starting u16Offset bytes
+ * past the read pointer. Returns its offset from the read pointer, or -1
+ * if it has not been received yet.
+ */
+int32_t USART_DMA_FindByte(uint8_t u8Byte, uint16_t u16Offset)
+{
+	tsDmaSpan asSpan[2];
+	uint8_t u8Spans = USART_DMA_PeekSpans(asSpan);
+	uint16_t u16Base = 0;
+	uint8_t i;
+
+	for (i = 0; i < u8Spans; i++)
+	{
+		if (u16Offset < (u16Base + asSpan[i].u16Length))
+		{
+			uint16_t u16Skip = (u16Offset > u16Base) ? (u16Offset - u16Base) : 0;
+			uint8_t *pu8Found = memchr(&asSpan[i].pu8Data[u16Skip], u8Byte, asSpan[i].u16Length - u16Skip);
+
+			if (pu8Found != NULL)
+			{
+				return (int32_t)(u16Base + (pu8Found - asSpan[i].pu8Data));
+			}
+		}
+		u16Base += asSpan[i].u16Length;
+	}
+	return -1;
 }
 
 
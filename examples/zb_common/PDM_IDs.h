@@ -34,6 +34,7 @@ extern "C" {
 #define PDM_ID_APP_CLD_GP_SINK_PROXY_TABLE        (0xA104)
 #define PDM_ID_POWER_ON_COUNTER                   (0xA106)
 #define PDM_ID_OTA_APP                            (0xA109) /* Application OTA data */
+#define PDM_ID_BDB_REJOIN_HISTORY                 (0xA10A) /* BDB_REJOIN_HISTORY */
 
 
 /****************************************************************************/
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+#
+# Copyright 2020 NXP.
+#
+# Converts the upgrade image sub-element (tag 0x0000) of a Zigbee OTA file
+# into a compressed image sub-element (tag 0xF0C0) that the OTA cluster
+# decompresses while it is being downloaded (OTA_COMPRESSED_IMAGE_SUPPORT).
+#
+# usage: ota_compress.py <input.ota> <output.ota> [window bits] [lookahead bits]
+#
+# The window bits must not exceed OTA_DECOMPRESS_WINDOW_BITS of the receiving
+# devices (8 by default).
+
+import struct
+import sys
+
+OTA_FILE_IDENTIFIER = 0x0BEEF11E
+TAG_UPGRADE_IMAGE = 0x0000
+TAG_COMPRESSED_IMAGE = 0xF0C0
+COMPRESSED_IMAGE_MAGIC = 0x535A4C5A
+TOTAL_IMAGE_SIZE_OFFSET = 52
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.bits = 0
+
+    def put(self, value, bits):
+        self.acc = (self.acc << bits) | (value & ((1 << bits) - 1))
+        self.bits += bits
+        while self.bits >= 8:
+            self.bits -= 8
+            self.out.append((self.acc >> self.bits) & 0xFF)
+        self.acc &= (1 << self.bits) - 1
+
+    def flush(self):
+        if self.bits:
+            self.out.append((self.acc << (8 - self.bits)) & 0xFF)
+            self.acc = 0
+            self.bits = 0
+        return bytes(self.out)
+
+
+def compress(data, window_bits, lookahead_bits):
+    window = 1 << window_bits
+    max_count = 1 << lookahead_bits
+    # a back reference costs 1 + W + L bits, a literal 9
+    min_match = (1 + window_bits + lookahead_bits) // 9 + 1
+    chains = {}
+    writer = BitWriter()
+    pos = 0
+
+    while pos < len(data):
+        best_len = 0
+        best_dist = 0
+        key = data[pos:pos + 3]
+        if len(key) == 3:
+            for start in reversed(chains.get(key, [])):
+                dist = pos - start
+                if dist > window:
+                    break
+                length = 0
+                limit = min(max_count, len(data) - pos)
+                while length < limit and data[start + length] == data[pos + length]:
+                    length += 1
+                if length > best_len:
+                    best_len = length
+                    best_dist = dist
+                    if length == limit:
+                        break
+
+        if best_len >= min_match:
+            writer.put(0, 1)
+            writer.put(best_dist - 1, window_bits)
+            writer.put(best_len - 1, lookahead_bits)
+            step = best_len
+        else:
+            writer.put(1, 1)
+            writer.put(data[pos], 8)
+            step = 1
+
+        for i in range(pos, pos + step):
+            k = data[i:i + 3]
+            if len(k) == 3:
+                chain = chains.setdefault(k, [])
+                chain.append(i)
+                if len(chain) > 64:
+                    del chain[0]
+        pos += step
+
+    return writer.flush()
+
+
+def main(argv):
+    if len(argv) < 3:
+        sys.exit("usage: ota_compress.py <input.ota> <output.ota> [window bits] [lookahead bits]")
+
+    window_bits = int(argv[3]) if len(argv) > 3 else 8
+    lookahead_bits = int(argv[4]) if len(argv) > 4 else 4
+    if not 4 <= window_bits <= 12 or not 2 <= lookahead_bits < window_bits:
+        sys.exit("window bits must be 4..12 and lookahead bits 2..window bits - 1")
+
+    with open(argv[1], "rb") as f:
+        ota = bytearray(f.read())
+
+    identifier, = struct.unpack_from("<I", ota, 0)
+    header_length, = struct.unpack_from("<H", ota, 6)
+    if identifier != OTA_FILE_IDENTIFIER:
+        sys.exit("not an OTA file")
+
+    output = bytearray(ota[:header_length])
+    offset = header_length
+    found = False
+    while offset + 6 <= len(ota):
+        tag_id, tag_length = struct.unpack_from("<HI", ota, offset)
+        payload = bytes(ota[offset + 6:offset + 6 + tag_length])
+        if tag_id == TAG_UPGRADE_IMAGE and not found:
+            stream = compress(payload, window_bits, lookahead_bits)
+            element = struct.pack("<IIBBH", COMPRESSED_IMAGE_MAGIC, len(payload),
+                                  window_bits, lookahead_bits, 0) + stream
+            output += struct.pack("<HI", TAG_COMPRESSED_IMAGE, len(element)) + element
+            print("image %d -> %d bytes" % (len(payload), len(element)))
+            found = True
+        else:
+            output += ota[offset:offset + 6 + tag_length]
+        offset += 6 + tag_length
+
+    if not found:
+        sys.exit("no upgrade image sub-element")
+
+    struct.pack_into("<I", output, TOTAL_IMAGE_SIZE_OFFSET, len(output))
+    with open(argv[2], "wb") as f:
+        f.write(output)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,51 @@
+/****************************************************************************
+ *
+ * Copyright 2020 NXP.
+ *
+ * NXP Confidential.
+ *
+ * This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms.
+ * By expressly accepting such terms or by downloading, installing, activating
+ * and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms.
+ * If you do not agree to be bound by the applicable license terms,
+ * then you may not retain, install, activate or otherwise use the software.
+ *
+ *
+ ****************************************************************************/
+
+
+/*****************************************************************************
+ *
+ * MODULE:             Host tests
+ *
+ * COMPONENT:          ColourControlConversionsFloat.c
+ *
+ * DESCRIPTION:        Floating point colour conversions, built under other
+ *                     names so that they can be linked next to the Q16 ones
+ *                     and used as the reference
+ *
+ *****************************************************************************/
+
+#ifdef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
+#error "The reference conversions must be built without CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS"
+#endif
+
+#define eCLD_ColourControl_GetRGB                       eCLD_ColourControlFloat_GetRGB
+#define eCLD_ColourControl_HSV2xyY                      eCLD_ColourControlFloat_HSV2xyY
+#define vCLD_ColourControl_CCT2xyY                      vCLD_ColourControlFloat_CCT2xyY
+#define eCLD_ColourControl_xyY2HSV                      eCLD_ColourControlFloat_xyY2HSV
+#define vCLD_ColourControl_xyY2CCT                      vCLD_ColourControlFloat_xyY2CCT
+#define eCLD_ColourControlCalculateConversionMatrices   eCLD_ColourControlFloatCalculateConversionMatrices
+#define CS_bTransitionIsValid                           CS_bFloatTransitionIsValid
+
+#include "ColourControlConversions.c"
+
+/* Custom data laid out for the float conversions */
+PRIVATE tsCLD_ColourControlCustomDataStructure sFloatCustomData;
+
+PUBLIC void *pvColourControlFloatCustomData(void)
+{
+    return &sFloatCustomData;
+}
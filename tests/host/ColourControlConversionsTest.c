@@ -0,0 +1,359 @@
+/****************************************************************************
+ *
+ * Copyright 2020 NXP.
+ *
+ * NXP Confidential.
+ *
+ * This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms.
+ * By expressly accepting such terms or by downloading, installing, activating
+ * and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms.
+ * If you do not agree to be bound by the applicable license terms,
+ * then you may not retain, install, activate or otherwise use the software.
+ *
+ *
+ ****************************************************************************/
+
+
+/*****************************************************************************
+ *
+ * MODULE:             Host tests
+ *
+ * COMPONENT:          ColourControlConversionsTest.c
+ *
+ * DESCRIPTION:        Compares the Q16 colour conversions with the floating
+ *                     point ones over the attribute ranges and fails if any
+ *                     result is further away than the bounds documented in
+ *                     ColourControlConversionsFixedPoint.c
+ *
+ *****************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <jendefs.h>
+
+#include "zcl.h"
+#include "zcl_customcommand.h"
+#include "ColourControl.h"
+#include "ColourControl_internal.h"
+
+#ifndef CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS
+#error "The conversions under test must be built with CLD_COLOURCONTROL_FIXED_POINT_CONVERSIONS"
+#endif
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* Largest differences allowed, in attribute units */
+#define MAX_ERROR_XY                    (5)     /* CurrentX/Y, 1/65536 */
+#define MAX_ERROR_SATURATION            (1)
+#define MAX_ERROR_VALUE                 (1)
+#define MAX_ERROR_CCT_XY                (2)
+#define MAX_ERROR_TRANSITION            (2)     /* clipped CurrentX/Y */
+#define MAX_ERROR_MIRED                 (1)     /* down to 1000K */
+#define MAX_ERROR_MIRED_PERMILLE        (10)    /* below 1000K, relative */
+
+/* Hue gets less defined as the colour approaches white, so its error is
+ * allowed to grow as saturation falls, keeping error x saturation bounded */
+#define MAX_ERROR_HUE(u8Sat)            (2 + 256 / (u8Sat))
+
+/* Away from the gamut X and Z are many times Y, so the RGB error is allowed
+ * to grow as y falls */
+#define MAX_ERROR_RGB(u16y)             (1 + 640 / (u16y))
+
+/* The interpolation gets steep below this, 1000K */
+#define MIRED_ABSOLUTE_LIMIT            (1000)
+
+/*
+ * The reference rejects x = 0 because its number check treats 0 as too small,
+ * the Q16 conversions accept it, so that column is compared only when both
+ * succeed
+ */
+#define STATUS_MISMATCH(eFloat, eFixed, u16x)   (((eFloat) != (eFixed)) && ((u16x) != 0))
+
+/* Below this saturation the hue of the reference is not meaningful */
+#define HUE_MIN_SATURATION              (3)
+
+#define TEST_ENDPOINT                   (1)
+
+#ifndef MAX
+#define MAX(A,B)                        (((A) > (B)) ? (A) : (B))
+#endif
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+/* Reference conversions from ColourControlConversionsFloat.c */
+PUBLIC void *pvColourControlFloatCustomData(void);
+PUBLIC teZCL_Status eCLD_ColourControlFloat_GetRGB(uint8 u8SourceEndPointId, uint8 *pu8Red, uint8 *pu8Green, uint8 *pu8Blue);
+PUBLIC teZCL_Status eCLD_ColourControlFloat_HSV2xyY(uint8 u8SourceEndPointId, uint16 u16Hue, uint8 u8Saturation, uint8 u8Value,
+                                                    uint16 *pu16x, uint16 *pu16y, uint8 *pu8Y);
+PUBLIC void vCLD_ColourControlFloat_CCT2xyY(uint16 u16ColourTemperatureMired, uint16 *pu16x, uint16 *pu16y, uint8 *pu8Y);
+PUBLIC teZCL_Status eCLD_ColourControlFloat_xyY2HSV(void *psCustomDataStructPtr, uint16 u16x, uint16 u16y, uint8 u8Y,
+                                                    uint16 *pu16Hue, uint8 *pu8Saturation, uint8 *pu8Value);
+PUBLIC void vCLD_ColourControlFloat_xyY2CCT(uint16 u16x, uint16 u16y, uint8 u8Y, uint16 *pu16ColourTemperature);
+PUBLIC teZCL_Status eCLD_ColourControlFloatCalculateConversionMatrices(void *psCustomDataStructure,
+                                                    float fRedX, float fRedY, float fGreenX, float fGreenY,
+                                                    float fBlueX, float fBlueY, float fWhiteX, float fWhiteY);
+PUBLIC bool_t CS_bFloatTransitionIsValid(uint16 u16X1, uint16 u16Y1, uint16 u16X2, uint16 u16Y2,
+                                         uint16 *pu16X, uint16 *pu16Y);
+
+PRIVATE int iCheck(const char *pcName, int iMaxError, int iBound);
+PRIVATE int iCheckScaled(const char *pcName, int iMaxError, const char *pcBound, int iOverBound);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+PRIVATE tsCLD_ColourControlCustomDataStructure sFixedCustomData;
+PRIVATE tsCLD_ColourControl sColourControl;
+PRIVATE tsZCL_ClusterInstance sClusterInstance = { .pvEndPointSharedStructPtr = &sColourControl };
+PRIVATE tsZCL_EndPointDefinition sEndPointDefinition;
+PRIVATE void *pvCustomData;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+PUBLIC teZCL_Status eZCL_FindCluster(
+                uint16                      u16ClusterId,
+                uint8                       u8SourceEndPointId,
+                bool_t                      bIsServer,
+                tsZCL_EndPointDefinition  **ppsEndPointDefinition,
+                tsZCL_ClusterInstance     **ppsClusterInstance,
+                void                      **ppsCustomDataStructure)
+{
+    *ppsEndPointDefinition = &sEndPointDefinition;
+    *ppsClusterInstance = &sClusterInstance;
+    *ppsCustomDataStructure = pvCustomData;
+    return E_ZCL_SUCCESS;
+}
+
+int main(void)
+{
+    int iFailures = 0;
+    int iStatusMismatches = 0;
+    int iMaxXY = 0, iMaxY = 0, iMaxHue = 0, iMaxSat = 0, iMaxVal = 0, iMaxRGB = 0;
+    int iHueOverBound = INT_MIN, iRGBOverBound = INT_MIN;
+    int iEdgeTargets = 0;
+    int iHue, iSat, iVal, iX, iY, iLum, iMired;
+    void *pvFloatCustomData = pvColourControlFloatCustomData();
+
+    eCLD_ColourControlFloatCalculateConversionMatrices(pvFloatCustomData,
+            CLD_COLOURCONTROL_RED_X, CLD_COLOURCONTROL_RED_Y,
+            CLD_COLOURCONTROL_GREEN_X, CLD_COLOURCONTROL_GREEN_Y,
+            CLD_COLOURCONTROL_BLUE_X, CLD_COLOURCONTROL_BLUE_Y,
+            CLD_COLOURCONTROL_WHITE_X, CLD_COLOURCONTROL_WHITE_Y);
+    eCLD_ColourControlCalculateConversionMatrices(&sFixedCustomData,
+            CLD_COLOURCONTROL_RED_X, CLD_COLOURCONTROL_RED_Y,
+            CLD_COLOURCONTROL_GREEN_X, CLD_COLOURCONTROL_GREEN_Y,
+            CLD_COLOURCONTROL_BLUE_X, CLD_COLOURCONTROL_BLUE_Y,
+            CLD_COLOURCONTROL_WHITE_X, CLD_COLOURCONTROL_WHITE_Y);
+
+    /* HSV -> xyY, every saturation and value, hue sampled across its range */
+    for(iHue = 0; iHue <= 0xffff; iHue += (iHue == 0xff00) ? 0xff : 0x100)
+    {
+        for(iSat = 0; iSat <= 0xff; iSat++)
+        {
+            for(iVal = 0; iVal <= 0xff; iVal++)
+            {
+                uint16 u16FloatX, u16FloatY, u16FixedX, u16FixedY;
+                uint8 u8FloatY, u8FixedY;
+                teZCL_Status eFloat, eFixed;
+
+                pvCustomData = pvFloatCustomData;
+                eFloat = eCLD_ColourControlFloat_HSV2xyY(TEST_ENDPOINT, iHue, iSat, iVal, &u16FloatX, &u16FloatY, &u8FloatY);
+                pvCustomData = &sFixedCustomData;
+                eFixed = eCLD_ColourControl_HSV2xyY(TEST_ENDPOINT, iHue, iSat, iVal, &u16FixedX, &u16FixedY, &u8FixedY);
+
+                if(eFloat != eFixed)
+                {
+                    iStatusMismatches++;
+                }
+                else if(eFloat == E_ZCL_SUCCESS)
+                {
+                    iMaxXY = MAX(iMaxXY, abs(u16FloatX - u16FixedX));
+                    iMaxXY = MAX(iMaxXY, abs(u16FloatY - u16FixedY));
+                    iMaxY  = MAX(iMaxY,  abs(u8FloatY - u8FixedY));
+                }
+            }
+        }
+    }
+    iFailures += iCheck("HSV2xyY x/y", iMaxXY, MAX_ERROR_XY);
+    iFailures += iCheck("HSV2xyY Y", iMaxY, MAX_ERROR_VALUE);
+
+    /* xyY -> HSV, the whole x/y plane at a range of luminances */
+    for(iX = 0; iX <= 0xffff; iX += (iX == 0xffc0) ? 0x3f : 0x40)
+    {
+        for(iY = 0; iY <= 0xffff; iY += (iY == 0xffc0) ? 0x3f : 0x40)
+        {
+            for(iLum = 0; iLum <= 0xff; iLum += (iLum == 0xf0) ? 0x0f : 0x10)
+            {
+                uint16 u16FloatHue, u16FixedHue;
+                uint8 u8FloatSat, u8FloatVal, u8FixedSat, u8FixedVal;
+                teZCL_Status eFloat, eFixed;
+                int iHueError;
+
+                eFloat = eCLD_ColourControlFloat_xyY2HSV(pvFloatCustomData, iX, iY, iLum, &u16FloatHue, &u8FloatSat, &u8FloatVal);
+                eFixed = eCLD_ColourControl_xyY2HSV(&sFixedCustomData, iX, iY, iLum, &u16FixedHue, &u8FixedSat, &u8FixedVal);
+
+                if(STATUS_MISMATCH(eFloat, eFixed, iX))
+                {
+                    iStatusMismatches++;
+                }
+                else if((eFloat == E_ZCL_SUCCESS) && (eFixed == E_ZCL_SUCCESS))
+                {
+                    iHueError = abs(u16FloatHue - u16FixedHue);
+                    if(iHueError > 0x8000)
+                    {
+                        /* Hue wraps round */
+                        iHueError = 0x10000 - iHueError;
+                    }
+                    if(u8FloatSat >= HUE_MIN_SATURATION)
+                    {
+                        iMaxHue = MAX(iMaxHue, iHueError);
+                        iHueOverBound = MAX(iHueOverBound, iHueError - MAX_ERROR_HUE(u8FloatSat));
+                    }
+                    iMaxSat = MAX(iMaxSat, abs(u8FloatSat - u8FixedSat));
+                    iMaxVal = MAX(iMaxVal, abs(u8FloatVal - u8FixedVal));
+                }
+            }
+        }
+    }
+    iFailures += iCheckScaled("xyY2HSV hue", iMaxHue, "2 + 256 / S", iHueOverBound);
+    iFailures += iCheck("xyY2HSV saturation", iMaxSat, MAX_ERROR_SATURATION);
+    iFailures += iCheck("xyY2HSV value", iMaxVal, MAX_ERROR_VALUE);
+
+    /* CCT -> xyY, every mired value */
+    iMaxXY = 0;
+    iMaxY = 0;
+    for(iMired = 0; iMired <= 0xffff; iMired++)
+    {
+        uint16 u16FloatX, u16FloatY, u16FixedX, u16FixedY;
+        uint8 u8FloatY, u8FixedY;
+
+        vCLD_ColourControlFloat_CCT2xyY(iMired, &u16FloatX, &u16FloatY, &u8FloatY);
+        vCLD_ColourControl_CCT2xyY(iMired, &u16FixedX, &u16FixedY, &u8FixedY);
+        iMaxXY = MAX(iMaxXY, abs(u16FloatX - u16FixedX));
+        iMaxXY = MAX(iMaxXY, abs(u16FloatY - u16FixedY));
+        iMaxY  = MAX(iMaxY,  abs(u8FloatY - u8FixedY));
+    }
+    iFailures += iCheck("CCT2xyY x/y", iMaxXY, MAX_ERROR_CCT_XY);
+    iFailures += iCheck("CCT2xyY Y", iMaxY, 0);
+
+    /* xyY -> CCT, every x on the curve, the float version divides by zero off its ends */
+    {
+        int iMaxMired = 0, iMaxPermille = 0;
+        uint16 u16FirstX, u16LastX, u16Mired;
+        uint8 u8Y;
+
+        vCLD_ColourControl_CCT2xyY(0xffff, &u16FirstX, &u16Mired, &u8Y);
+        vCLD_ColourControl_CCT2xyY(1, &u16LastX, &u16Mired, &u8Y);
+        for(iX = u16LastX + 1; iX < u16FirstX; iX++)
+        {
+            uint16 u16FloatMired, u16FixedMired;
+
+            vCLD_ColourControlFloat_xyY2CCT(iX, 0, 0, &u16FloatMired);
+            vCLD_ColourControl_xyY2CCT(iX, 0, 0, &u16FixedMired);
+            if(u16FloatMired <= MIRED_ABSOLUTE_LIMIT)
+            {
+                iMaxMired = MAX(iMaxMired, abs(u16FloatMired - u16FixedMired));
+            }
+            else
+            {
+                iMaxPermille = MAX(iMaxPermille, (abs(u16FloatMired - u16FixedMired) * 1000 + u16FloatMired - 1) / u16FloatMired);
+            }
+        }
+        iFailures += iCheck("xyY2CCT mired", iMaxMired, MAX_ERROR_MIRED);
+        iFailures += iCheck("xyY2CCT permille", iMaxPermille, MAX_ERROR_MIRED_PERMILLE);
+    }
+
+    /* xy -> RGB over the whole plane */
+    for(iX = 0; iX <= 0xffff; iX += (iX == 0xffc0) ? 0x3f : 0x40)
+    {
+        for(iY = 0; iY <= 0xffff; iY += (iY == 0xffc0) ? 0x3f : 0x40)
+        {
+            uint8 au8Float[3], au8Fixed[3];
+            teZCL_Status eFloat, eFixed;
+            int i;
+
+            sColourControl.u16CurrentX = iX;
+            sColourControl.u16CurrentY = iY;
+            pvCustomData = pvFloatCustomData;
+            eFloat = eCLD_ColourControlFloat_GetRGB(TEST_ENDPOINT, &au8Float[0], &au8Float[1], &au8Float[2]);
+            pvCustomData = &sFixedCustomData;
+            eFixed = eCLD_ColourControl_GetRGB(TEST_ENDPOINT, &au8Fixed[0], &au8Fixed[1], &au8Fixed[2]);
+
+            if(STATUS_MISMATCH(eFloat, eFixed, iX))
+            {
+                iStatusMismatches++;
+            }
+            else if((eFloat == E_ZCL_SUCCESS) && (eFixed == E_ZCL_SUCCESS))
+            {
+                for(i = 0; i < 3; i++)
+                {
+                    iMaxRGB = MAX(iMaxRGB, abs(au8Float[i] - au8Fixed[i]));
+                    iRGBOverBound = MAX(iRGBOverBound, abs(au8Float[i] - au8Fixed[i]) - MAX_ERROR_RGB(iY));
+                }
+            }
+        }
+    }
+    iFailures += iCheckScaled("GetRGB", iMaxRGB, "1 + 640 / y", iRGBOverBound);
+
+    /* Transitions to every target on the plane, clipped to the gamut edge */
+    iMaxXY = 0;
+    for(iX = 0; iX <= 0xffff; iX += (iX == 0xffc0) ? 0x3f : 0x40)
+    {
+        for(iY = 0; iY <= 0xffff; iY += (iY == 0xffc0) ? 0x3f : 0x40)
+        {
+            uint16 u16FloatX = iX, u16FloatY = iY, u16FixedX = iX, u16FixedY = iY;
+            bool_t bFloat, bFixed;
+
+            bFloat = CS_bFloatTransitionIsValid(0, 0, iX, iY, &u16FloatX, &u16FloatY);
+            bFixed = CS_bTransitionIsValid(0, 0, iX, iY, &u16FixedX, &u16FixedY);
+
+            /* Targets on the gamut edge may get either verdict, the clipped
+             * point must still agree */
+            if(bFloat != bFixed)
+            {
+                iEdgeTargets++;
+            }
+            iMaxXY = MAX(iMaxXY, abs(u16FloatX - u16FixedX));
+            iMaxXY = MAX(iMaxXY, abs(u16FloatY - u16FixedY));
+        }
+    }
+    iFailures += iCheck("transition x/y", iMaxXY, MAX_ERROR_TRANSITION);
+    printf("%-20s %5d\n", "edge targets", iEdgeTargets);
+    iFailures += iCheck("status mismatches", iStatusMismatches, 0);
+
+    printf("%s\n", iFailures ? "FAIL" : "PASS");
+    return iFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+PRIVATE int iCheck(const char *pcName, int iMaxError, int iBound)
+{
+    printf("%-20s max %5d  bound %5d  %s\n", pcName, iMaxError, iBound, (iMaxError > iBound) ? "FAIL" : "ok");
+    return (iMaxError > iBound) ? 1 : 0;
+}
+
+PRIVATE int iCheckScaled(const char *pcName, int iMaxError, const char *pcBound, int iOverBound)
+{
+    printf("%-20s max %5d  bound %s  %s\n", pcName, iMaxError, pcBound, (iOverBound > 0) ? "FAIL" : "ok");
+    return (iOverBound > 0) ? 1 : 0;
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
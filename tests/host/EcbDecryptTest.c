@@ -0,0 +1,151 @@
+/****************************************************************************
+ *
+ * Copyright 2020 NXP.
+ *
+ * NXP Confidential.
+ *
+ * This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms.
+ * By expressly accepting such terms or by downloading, installing, activating
+ * and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms.
+ * If you do not agree to be bound by the applicable license terms,
+ * then you may not retain, install, activate or otherwise use the software.
+ *
+ *
+ ****************************************************************************/
+
+
+/*****************************************************************************
+ *
+ * MODULE:             Host tests
+ *
+ * COMPONENT:          EcbDecryptTest.c
+ *
+ * DESCRIPTION:        Known answer tests for the software AES-128 decrypt
+ *                     used by touchlink, from FIPS-197 appendix C.1 and
+ *                     SP 800-38A F.1.2 (ECB-AES128.Decrypt)
+ *
+ *****************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <jendefs.h>
+
+#include "bdb_api.h"
+#include "bdb_tl.h"
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    uint8 au8Cipher[16];
+    uint8 au8Plain[16];
+} tsEcbVector;
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+PRIVATE int iCheck(const char *pcName, int iBlock, const uint8 *pu8Result, const uint8 *pu8Expected);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+/* FIPS-197 C.1 */
+PRIVATE const uint8 au8Fips197Key[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+PRIVATE const tsEcbVector asFips197[] = {
+    {{0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a},
+     {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff}}
+};
+
+/* SP 800-38A F.1.2 */
+PRIVATE const uint8 au8Sp80038aKey[16] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+
+PRIVATE const tsEcbVector asSp80038a[] = {
+    {{0x3a, 0xd7, 0x7b, 0xb4, 0x0d, 0x7a, 0x36, 0x60, 0xa8, 0x9e, 0xca, 0xf3, 0x24, 0x66, 0xef, 0x97},
+     {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a}},
+    {{0xf5, 0xd3, 0xd5, 0x85, 0x03, 0xb9, 0x69, 0x9d, 0xe7, 0x85, 0x89, 0x5a, 0x96, 0xfd, 0xba, 0xaf},
+     {0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51}},
+    {{0x43, 0xb1, 0xcd, 0x7f, 0x59, 0x8e, 0xce, 0x23, 0x88, 0x1b, 0x00, 0xe3, 0xed, 0x03, 0x06, 0x88},
+     {0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef}},
+    {{0x7b, 0x0c, 0x78, 0x5e, 0x27, 0xe8, 0xad, 0x3f, 0x82, 0x23, 0x20, 0x71, 0x04, 0x72, 0x5d, 0xd4},
+     {0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10}}
+};
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+int main(void)
+{
+    int iFailures = 0;
+    int i;
+    uint8 au8Key[16];
+    uint8 au8In[16];
+    uint8 au8Out[16];
+    tsECB_DecryptContext sContext;
+
+    /* One shot decrypt */
+    memcpy(au8Key, au8Fips197Key, sizeof(au8Key));
+    memcpy(au8In, asFips197[0].au8Cipher, sizeof(au8In));
+    vECB_Decrypt(au8Key, au8In, au8Out);
+    iFailures += iCheck("FIPS-197 C.1", 0, au8Out, asFips197[0].au8Plain);
+
+    memcpy(au8Key, au8Sp80038aKey, sizeof(au8Key));
+    for(i = 0; i < (int)(sizeof(asSp80038a) / sizeof(asSp80038a[0])); i++)
+    {
+        memcpy(au8In, asSp80038a[i].au8Cipher, sizeof(au8In));
+        vECB_Decrypt(au8Key, au8In, au8Out);
+        iFailures += iCheck("SP 800-38A F.1.2", i, au8Out, asSp80038a[i].au8Plain);
+    }
+
+    /* Round keys expanded once and reused for every block */
+    memcpy(au8Key, au8Sp80038aKey, sizeof(au8Key));
+    vECB_DecryptInit(&sContext, au8Key);
+    for(i = 0; i < (int)(sizeof(asSp80038a) / sizeof(asSp80038a[0])); i++)
+    {
+        memcpy(au8In, asSp80038a[i].au8Cipher, sizeof(au8In));
+        vECB_DecryptBlock(&sContext, au8In, au8Out);
+        iFailures += iCheck("SP 800-38A context", i, au8Out, asSp80038a[i].au8Plain);
+    }
+
+    /* The same context set up again for another key */
+    memcpy(au8Key, au8Fips197Key, sizeof(au8Key));
+    vECB_DecryptInit(&sContext, au8Key);
+    memcpy(au8In, asFips197[0].au8Cipher, sizeof(au8In));
+    vECB_DecryptBlock(&sContext, au8In, au8Out);
+    iFailures += iCheck("FIPS-197 context", 0, au8Out, asFips197[0].au8Plain);
+
+    printf("%s\n", iFailures ? "FAIL" : "PASS");
+    return iFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+PRIVATE int iCheck(const char *pcName, int iBlock, const uint8 *pu8Result, const uint8 *pu8Expected)
+{
+    bool_t bMatch = (memcmp(pu8Result, pu8Expected, 16) == 0);
+
+    printf("%-20s block %d  %s\n", pcName, iBlock, bMatch ? "ok" : "FAIL");
+    return bMatch ? 0 : 1;
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
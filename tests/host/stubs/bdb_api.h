@@ -0,0 +1,7 @@
+/* Host build replacement for bdb_api.h, the AES code needs none of the stack */
+#ifndef BDB_API_INCLUDED
+#define BDB_API_INCLUDED
+
+typedef struct tsBDB_ZCLEvent tsBDB_ZCLEvent;
+
+#endif
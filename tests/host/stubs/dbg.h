@@ -0,0 +1,7 @@
+/* Host build replacement for the SDK dbg.h */
+#ifndef DBG_INCLUDED
+#define DBG_INCLUDED
+
+#define DBG_vPrintf(bStream, ...)
+
+#endif
@@ -0,0 +1,27 @@
+/* Host build replacement for the SDK jendefs.h */
+#ifndef JENDEFS_INCLUDED
+#define JENDEFS_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t         uint8;
+typedef uint16_t        uint16;
+typedef uint32_t        uint32;
+typedef uint64_t        uint64;
+typedef int8_t          int8;
+typedef int16_t         int16;
+typedef int32_t         int32;
+typedef int64_t         int64;
+typedef uint8_t         bool_t;
+typedef char            char_t;
+
+#define PUBLIC
+#define PRIVATE         static
+#define INLINE          inline
+#define ALWAYS_INLINE   __attribute__((always_inline))
+
+#define TRUE            (1)
+#define FALSE           (0)
+
+#endif
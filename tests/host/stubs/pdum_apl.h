@@ -0,0 +1,8 @@
+/* Host build replacement for the SDK pdum_apl.h, handles only */
+#ifndef PDUM_APL_INCLUDED
+#define PDUM_APL_INCLUDED
+
+typedef void *PDUM_thAPdu;
+typedef void *PDUM_thAPduInstance;
+
+#endif
@@ -0,0 +1,11 @@
+/* Cluster options for the host tests */
+#ifndef ZCL_OPTIONS_H
+#define ZCL_OPTIONS_H
+
+#define CLD_COLOUR_CONTROL
+#define COLOUR_CONTROL_SERVER
+#define CLD_COLOURCONTROL_COLOUR_CAPABILITIES   (COLOUR_CAPABILITY_HUE_SATURATION_SUPPORTED | \
+                                                 COLOUR_CAPABILITY_XY_SUPPORTED             | \
+                                                 COLOUR_CAPABILITY_COLOUR_TEMPERATURE_SUPPORTED)
+
+#endif
@@ -0,0 +1 @@
+/* Host build replacement for the SDK zps_apl.h */
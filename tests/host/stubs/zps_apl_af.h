@@ -0,0 +1,26 @@
+/* Host build replacement for the SDK zps_apl_af.h, types used by zcl.h only */
+#ifndef ZPS_APL_AF_INCLUDED
+#define ZPS_APL_AF_INCLUDED
+
+typedef uint8 ZPS_teStatus;
+typedef uint8 ZPS_teAplAfBroadcastMode;
+
+typedef union
+{
+    uint16 u16Addr;
+    uint64 u64Addr;
+} ZPS_tuAddress;
+
+typedef struct
+{
+    uint8           eMode;
+    uint16          u16PanId;
+    ZPS_tuAddress   uAddress;
+} ZPS_tsInterPanAddress;
+
+typedef struct
+{
+    uint8 eType;
+} ZPS_tsAfEvent;
+
+#endif